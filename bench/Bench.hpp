@@ -0,0 +1,65 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  Bench.hpp                                                       */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#ifndef Bench_hpp
+#define Bench_hpp
+
+// *******************************************************************
+// Core library: system includes, scanner and tree
+#include "DirStatsCore.hpp"
+
+// *******************************************************************
+// Benchmark system includes
+#include <random>
+#include <limits>
+
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_APPLE)
+#include <sys/resource.h>
+#include <sys/ioctl.h>
+#endif
+
+#ifdef PLATFORM_LINUX
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#endif
+
+// *******************************************************************
+// CLI11 include
+#include "CLI11.hpp"
+
+// *******************************************************************
+// Benchmark includes
+#include "TreeGenerator.hpp"
+#include "ScanBenchmark.hpp"
+
+#endif /* Bench_hpp */
@@ -0,0 +1,327 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  BenchMain.cpp                                                   */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#include "Bench.hpp"
+
+namespace
+{
+    std::filesystem::path GetDefaultBenchDirectory()
+    {
+        // tmpfs keeps the disk out of the measurement
+        std::error_code error;
+        if(std::filesystem::is_directory("/dev/shm", error))
+            return "/dev/shm/dirstats_bench";
+        
+        return std::filesystem::temp_directory_path(error) / "dirstats_bench";
+    }
+    
+    std::vector<std::size_t> GetDefaultThreadCounts()
+    {
+        const std::size_t hardwareThreads = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+        
+        // Powers of two up to the number of hardware threads, and that number itself
+        std::vector<std::size_t> threadCounts;
+        for(std::size_t count = 1; count < hardwareThreads; count *= 2)
+            threadCounts.push_back(count);
+        
+        threadCounts.push_back(hardwareThreads);
+        return threadCounts;
+    }
+    
+    // Levels of full directories until there are entryCount entries, the last level has only files
+    std::vector<MemoryFileSystem::Level> GetBalancedLevels(const uint64_t directoryCount, const uint64_t fileCount, const uint64_t entryCount)
+    {
+        std::vector<MemoryFileSystem::Level> levels;
+        uint64_t directoriesOnLevel = 1;
+        uint64_t createdCount = 0;
+        
+        while(createdCount < entryCount)
+        {
+            if(directoryCount == 0 || createdCount + directoriesOnLevel * (directoryCount + fileCount) >= entryCount)
+            {
+                const uint64_t missingCount = entryCount - createdCount;
+                levels.push_back({0, (missingCount + directoriesOnLevel - 1) / directoriesOnLevel});
+                break;
+            }
+            
+            levels.push_back({directoryCount, fileCount});
+            createdCount += directoriesOnLevel * (directoryCount + fileCount);
+            directoriesOnLevel *= directoryCount;
+        }
+        
+        return levels;
+    }
+    
+    // Simulated counterparts of the generated trees, without links
+    std::vector<MemoryFileSystem::Level> GetMockLevels(const TreeGenerator::Shape shape, const uint64_t entryCount)
+    {
+        switch(shape)
+        {
+            case TreeGenerator::Shape::WIDE:
+                return {{0, entryCount}};
+                
+            case TreeGenerator::Shape::DEEP:
+            {
+                // No PATH_MAX in memory, so deeper than on disk
+                const uint64_t depth = std::clamp<uint64_t>(entryCount / 8, 1, 5000);
+                const uint64_t fileCount = std::max<uint64_t>(entryCount / depth, 2) - 1;
+                
+                std::vector<MemoryFileSystem::Level> levels(depth, {1, fileCount});
+                levels.back().directoryCount = 0;
+                return levels;
+            }
+                
+            case TreeGenerator::Shape::TINY_FILES:
+                return GetBalancedLevels(8, 1000, entryCount);
+                
+            case TreeGenerator::Shape::MIXED:
+            case TreeGenerator::Shape::LINKS:
+                return GetBalancedLevels(4, 24, entryCount);
+        }
+        
+        return {};
+    }
+    
+    // Records all scans while it exists and writes them to file, if one is given
+    class TraceRecording
+    {
+    private:
+        std::string m_File;
+        
+    public:
+        explicit TraceRecording(std::string file) : m_File(std::move(file))
+        {
+            if(m_File.empty())
+                return;
+            
+            Tracer::SetThreadName("bench");
+            Tracer::Enable();
+        }
+        
+        ~TraceRecording()
+        {
+            if(m_File.empty())
+                return;
+            
+            Tracer::Disable();
+            
+            std::string errorMessage;
+            if(!Tracer::WriteChromeTrace(m_File, errorMessage))
+                std::cerr << "Writing trace failed: " << errorMessage << std::endl;
+        }
+        
+        TraceRecording(const TraceRecording&) = delete;
+        TraceRecording& operator=(const TraceRecording&) = delete;
+    };
+    
+    // Budget per entry, 0 for the defaults of the backends, negative for none
+    bool IsOverAllocationBudget(const std::vector<ScanBenchmark::Result>& results, const double maxAllocationsPerEntry)
+    {
+        if(!AllocationCounter::IsEnabled() || maxAllocationsPerEntry < 0.0)
+            return false;
+        
+        bool isOverBudget = false;
+        for(const ScanBenchmark::Result& result : results)
+        {
+            const double budget = (maxAllocationsPerEntry > 0.0) ? maxAllocationsPerEntry : ScanBenchmark::GetAllocationBudget(result.backend);
+            const double allocationsPerEntry = result.GetAllocationsPerEntry();
+            
+            if(allocationsPerEntry > budget)
+            {
+                std::cerr << ScanBenchmark::GetBackendName(result.backend) << " with " << result.threadCount << " threads: " << allocationsPerEntry << " allocations per entry, budget is " << budget << std::endl;
+                isOverBudget = true;
+            }
+        }
+        
+        return isOverBudget;
+    }
+    
+    bool RunBenchmarks(ScanBenchmark& benchmark, const std::filesystem::path& path, const std::vector<ScanBenchmark::Backend>& backends, const std::vector<std::size_t>& threadCounts, const std::size_t repetitionCount, const double maxAllocationsPerEntry, bool& out_isOverBudget)
+    {
+        std::vector<ScanBenchmark::Result> results;
+        
+        for(const ScanBenchmark::Backend backend : backends)
+        {
+            for(const std::size_t threadCount : threadCounts)
+            {
+                ScanBenchmark::Result result;
+                if(!benchmark.Run(path, backend, threadCount, repetitionCount, result))
+                {
+                    std::cerr << benchmark.GetLastErrorMessage() << std::endl;
+                    return false;
+                }
+                
+                results.push_back(result);
+                
+                // Single threaded backends are measured once
+                if(!ScanBenchmark::IsParallel(backend))
+                    break;
+            }
+        }
+        
+        ScanBenchmark::PrintResults(std::cout, results);
+        std::cout << std::endl;
+        
+        if(IsOverAllocationBudget(results, maxAllocationsPerEntry))
+            out_isOverBudget = true;
+        
+        return true;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    CLI::App cliApp("Measures the scan speed of DirStatsTUI on generated directory trees.", "DirStatsTUI_bench");
+    
+    std::string benchDirectory = GetDefaultBenchDirectory().string();
+    std::string scanPath = "";
+    std::vector<std::string> shapeNames = {"wide", "deep", "tiny", "mixed", "links"};
+    std::vector<std::string> backendNames = {"iterate", "tree"};
+    std::vector<std::size_t> threadCounts = GetDefaultThreadCounts();
+    std::size_t entryCount = 100000;
+    uint64_t seed = 1;
+    std::size_t repetitionCount = 3;
+    bool keepTrees = false;
+    bool isMocking = false;
+    uint64_t directoryLatency = 0;
+    uint64_t entryLatency = 0;
+    double maxAllocationsPerEntry = 0.0;
+    std::string traceFile = "";
+    bool isOverBudget = false;
+    
+    cliApp.add_option("--dir", benchDirectory, "Directory the trees are generated in")->capture_default_str();
+    CLI::Option* pathOption = cliApp.add_option("--path", scanPath, "Scan this existing directory instead of generated trees");
+    cliApp.add_option("--shape", shapeNames, "Generated trees: wide, deep, tiny, mixed, links")->excludes(pathOption)->check(CLI::IsMember({"wide", "deep", "tiny", "mixed", "links"}))->capture_default_str();
+    cliApp.add_option("-n,--entries", entryCount, "Entries per generated tree")->excludes(pathOption)->check(CLI::Range(std::size_t(1), std::size_t(1000000000)))->capture_default_str();
+    cliApp.add_option("--seed", seed, "Seed of the generator, the same seed gives the same trees")->excludes(pathOption)->capture_default_str();
+    cliApp.add_option("--backend", backendNames, "Scan backends: iterate, tree, rollup (tree keeping the 10 largest files per directory)")->check(CLI::IsMember({"iterate", "tree", "rollup"}))->capture_default_str();
+    cliApp.add_option("-j,--threads", threadCounts, "Thread counts of the parallel backends")->check(CLI::Range(std::size_t(1), std::size_t(1024)))->capture_default_str();
+    cliApp.add_option("-r,--repeat", repetitionCount, "Timed scans per measurement, the fastest one counts")->check(CLI::Range(std::size_t(1), std::size_t(1000)))->capture_default_str();
+    CLI::Option* keepOption = cliApp.add_flag("--keep", keepTrees, "Keep the generated trees, they are reused by the next run with the same options");
+    CLI::Option* mockOption = cliApp.add_flag("--mock", isMocking, "Scan simulated trees in memory instead of generating them on disk, measures the scanner without the kernel (tree backend only, no links)")->excludes(pathOption)->excludes(keepOption);
+    cliApp.add_option("--mock-latency", directoryLatency, "Simulated latency of reading a directory with --mock, in microseconds")->needs(mockOption)->capture_default_str();
+    cliApp.add_option("--mock-entry-latency", entryLatency, "Simulated latency per entry of a directory with --mock, in nanoseconds")->needs(mockOption)->capture_default_str();
+    
+    cliApp.add_option("--max-allocs-per-entry", maxAllocationsPerEntry, "Fail if a scan allocates more often per entry, 0 for the budgets of the backends, -1 for no limit (needs DIRSTATS_COUNT_ALLOCATIONS)")->capture_default_str();
+    
+    cliApp.add_option("--trace", traceFile, "Write the spans of all scans as Chrome trace JSON to FILE, for ui.perfetto.dev");
+    
+    CLI11_PARSE(cliApp, argc, argv);
+    
+    std::vector<ScanBenchmark::Backend> backends;
+    for(const std::string& name : backendNames)
+    {
+        ScanBenchmark::Backend backend;
+        if(ScanBenchmark::GetBackendFromName(name, backend))
+            backends.push_back(backend);
+    }
+    
+    const TraceRecording traceRecording(traceFile);
+    ScanBenchmark benchmark;
+    if(!benchmark.IsCountingSyscalls())
+        std::cout << "System calls can't be counted (needs perf events and tracefs)" << std::endl << std::endl;
+    
+    if(!AllocationCounter::IsEnabled())
+        std::cout << "Allocations aren't counted, configure with -DDIRSTATS_COUNT_ALLOCATIONS=ON to check the budgets" << std::endl << std::endl;
+    
+    // Existing directory
+    if(!scanPath.empty())
+    {
+        std::cout << scanPath << std::endl;
+        if(!RunBenchmarks(benchmark, scanPath, backends, threadCounts, repetitionCount, maxAllocationsPerEntry, isOverBudget))
+            return -1;
+        
+        return isOverBudget ? -2 : 0;
+    }
+    
+    // Simulated trees
+    if(isMocking)
+    {
+        std::erase(backends, ScanBenchmark::Backend::ITERATE);
+        
+        for(const std::string& name : shapeNames)
+        {
+            TreeGenerator::Shape shape = TreeGenerator::Shape::MIXED;
+            TreeGenerator::GetShapeFromName(name, shape);
+            
+            if(shape == TreeGenerator::Shape::LINKS)
+                continue;
+            
+            const std::string root = "/dirstats_mock/" + name;
+            std::shared_ptr<MemoryFileSystem> fileSystem = std::make_shared<MemoryFileSystem>(root, GetMockLevels(shape, entryCount), seed);
+            fileSystem->SetLatency(std::chrono::microseconds(directoryLatency), std::chrono::nanoseconds(entryLatency));
+            
+            std::cout << name << ": " << fileSystem->GetEntryCount() << " simulated entries" << std::endl;
+            
+            benchmark.SetVirtualFileSystem(fileSystem);
+            if(!RunBenchmarks(benchmark, root, backends, threadCounts, repetitionCount, maxAllocationsPerEntry, isOverBudget))
+                return -1;
+        }
+        
+        return isOverBudget ? -2 : 0;
+    }
+    
+    // Generated trees
+    for(const std::string& name : shapeNames)
+    {
+        TreeGenerator::Options options;
+        options.entryCount = entryCount;
+        options.seed = seed;
+        TreeGenerator::GetShapeFromName(name, options.shape);
+        
+        const std::filesystem::path treeDirectory = std::filesystem::path(benchDirectory) / name;
+        
+        std::cout << name << ": " << entryCount << " entries in " << treeDirectory.string() << std::endl;
+        
+        TreeGenerator generator;
+        if(!generator.Generate(treeDirectory, options))
+        {
+            std::cerr << generator.GetLastErrorMessage() << std::endl;
+            return -1;
+        }
+        
+        const bool isSuccess = RunBenchmarks(benchmark, treeDirectory, backends, threadCounts, repetitionCount, maxAllocationsPerEntry, isOverBudget);
+        
+        if(!keepTrees)
+        {
+            std::error_code error;
+            std::filesystem::remove_all(treeDirectory, error);
+            std::filesystem::remove(treeDirectory.string() + ".generated", error);
+        }
+        
+        if(!isSuccess)
+            return -1;
+    }
+    
+    return isOverBudget ? -2 : 0;
+}
@@ -0,0 +1,286 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  RenderBenchmark.cpp                                             */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#include "UIBench.hpp"
+
+namespace
+{
+    const std::string MOCK_ROOT = "/dirstats_mock/ui";
+    
+    std::string FormatFixed(const double value, const int precision)
+    {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.*f", precision, value);
+        return buffer;
+    }
+    
+    // Value at share (0..1) of the sorted values
+    double GetPercentile(const std::vector<double>& sortedValues, const double share) noexcept
+    {
+        if(sortedValues.empty())
+            return 0.0;
+        
+        const std::size_t index = static_cast<std::size_t>(share * static_cast<double>(sortedValues.size()));
+        return sortedValues[std::min(index, sortedValues.size() - 1)];
+    }
+    
+    bool GetNamedEvent(const std::string_view name, ftxui::Event& out_event)
+    {
+        static const std::pair<std::string_view, ftxui::Event> namedEvents[] =
+        {
+            {"up", ftxui::Event::ArrowUp},
+            {"down", ftxui::Event::ArrowDown},
+            {"left", ftxui::Event::ArrowLeft},
+            {"right", ftxui::Event::ArrowRight},
+            {"pageup", ftxui::Event::PageUp},
+            {"pagedown", ftxui::Event::PageDown},
+            {"home", ftxui::Event::Home},
+            {"end", ftxui::Event::End},
+            {"enter", ftxui::Event::Return},
+            {"back", ftxui::Event::Backspace},
+            {"escape", ftxui::Event::Escape},
+            {"tab", ftxui::Event::Tab},
+            {"space", ftxui::Event::Character(' ')}
+        };
+        
+        for(const auto& [eventName, event] : namedEvents)
+        {
+            if(name == eventName)
+            {
+                out_event = event;
+                return true;
+            }
+        }
+        
+        if(name.size() == 1)
+        {
+            out_event = ftxui::Event::Character(name[0]);
+            return true;
+        }
+        
+        return false;
+    }
+}
+
+bool RenderBenchmark::ParseScript(const std::string& script, std::vector<ftxui::Event>& out_events)
+{
+    out_events.clear();
+    
+    std::size_t position = 0;
+    while(position < script.size())
+    {
+        if(script[position] == ' ')
+        {
+            position++;
+            continue;
+        }
+        
+        const std::size_t end = std::min(script.find(' ', position), script.size());
+        const std::string_view token = std::string_view(script).substr(position, end - position);
+        position = end;
+        
+        // Key and repetitions
+        const std::size_t star = token.find('*', 1);
+        const std::string_view name = token.substr(0, star);
+        std::size_t repetitionCount = 1;
+        
+        if(star != std::string_view::npos)
+        {
+            const std::string countText(token.substr(star + 1));
+            char* countEnd = nullptr;
+            repetitionCount = static_cast<std::size_t>(std::strtoull(countText.c_str(), &countEnd, 10));
+            
+            if(countText.empty() || *countEnd != '\0')
+            {
+                m_LastErrorMessage = "Invalid repetition in \"" + std::string(token) + "\"";
+                return false;
+            }
+        }
+        
+        ftxui::Event event;
+        if(!GetNamedEvent(name, event))
+        {
+            m_LastErrorMessage = "Unknown key \"" + std::string(name) + "\"";
+            return false;
+        }
+        
+        out_events.insert(out_events.end(), repetitionCount, event);
+    }
+    
+    return true;
+}
+
+bool RenderBenchmark::Run(const uint64_t entryCount, const std::vector<ftxui::Event>& events, Result& out_result)
+{
+    out_result = Result();
+    out_result.entryCount = entryCount;
+    
+    const uint64_t directoryCount = entryCount / 10;
+    const std::vector<MemoryFileSystem::Level> levels = {{directoryCount, entryCount - directoryCount}, {0, 10}};
+    
+    ProcessStats::ResetPeakResidentBytes();
+    
+    std::vector<double> frameTimes;
+    frameTimes.reserve(events.size() + 1);
+    
+    AllocationCounter::PhaseCounts firstCounts = {};
+    AllocationCounter::PhaseCounts lastCounts = {};
+    std::size_t outputBytes = 0;
+    
+    {
+        // Never looped, so the events AppUI posts to it are dropped
+        ftxui::ScreenInteractive screenInteractive = ftxui::ScreenInteractive::FixedSize(m_Width, m_Height);
+        ftxui::Screen screen(m_Width, m_Height);
+        
+        std::shared_ptr<AppUI> appUI = std::make_shared<AppUI>(&screenInteractive, [] {});
+        appUI->SetVirtualFileSystem(std::make_shared<MemoryFileSystem>(MOCK_ROOT, levels));
+        appUI->SetStartingPath(MOCK_ROOT);
+        appUI->SetShowAllFiles(true);
+        
+        const std::chrono::steady_clock::time_point loadStart = std::chrono::steady_clock::now();
+        
+        appUI->StartScan();
+        while(appUI->IsScanning())
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        
+        if(!appUI->UpdateMainView())
+        {
+            m_LastErrorMessage = "Nothing scanned";
+            return false;
+        }
+        
+        out_result.loadSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - loadStart).count();
+        out_result.residentBytes = ProcessStats::GetResidentBytes();
+        
+        auto renderFrame = [&](const ftxui::Event* event)
+        {
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            
+            if(event)
+                appUI->OnEvent(*event);
+            
+            screen.Clear();
+            ftxui::Element element = appUI->Render();
+            
+            {
+                const AllocationCounter::ScopedPhase allocationPhase(AllocationCounter::Phase::UI_DRAW);
+                ftxui::Render(screen, element);
+            }
+            
+            {
+                const AllocationCounter::ScopedPhase allocationPhase(AllocationCounter::Phase::UI_OUTPUT);
+                outputBytes += screen.ToString().size();
+            }
+            
+            frameTimes.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        };
+        
+        // Only this thread renders, the allocations of the scanner and the spinner don't count
+        firstCounts = AllocationCounter::GetThreadCounts();
+        
+        renderFrame(nullptr);
+        for(const ftxui::Event& event : events)
+            renderFrame(&event);
+        
+        lastCounts = AllocationCounter::GetThreadCounts();
+    }
+    
+    out_result.peakResidentBytes = ProcessStats::GetPeakResidentBytes();
+    
+    const double frameCount = static_cast<double>(frameTimes.size());
+    out_result.frameCount = frameTimes.size();
+    out_result.allocations = AllocationCounter::GetDifference(lastCounts, firstCounts);
+    
+    const AllocationCounter::Counts allocationTotal = AllocationCounter::GetTotal(out_result.allocations);
+    out_result.allocationsPerFrame = static_cast<double>(allocationTotal.allocations) / frameCount;
+    out_result.allocatedBytesPerFrame = static_cast<double>(allocationTotal.bytes) / frameCount;
+    out_result.outputBytesPerFrame = static_cast<double>(outputBytes) / frameCount;
+    
+    std::sort(frameTimes.begin(), frameTimes.end());
+    out_result.frameMedian = GetPercentile(frameTimes, 0.5);
+    out_result.frame90th = GetPercentile(frameTimes, 0.9);
+    out_result.frame99th = GetPercentile(frameTimes, 0.99);
+    out_result.frameMax = frameTimes.back();
+    
+    return true;
+}
+
+void RenderBenchmark::PrintResults(std::ostream& out, const std::vector<Result>& results)
+{
+    out << "    Entries   Load ms  Frames    p50 ms    p90 ms    p99 ms    max ms  Allocs/frame  Alloc/frame  Output/frame         RSS    Peak RSS" << std::endl;
+    
+    for(const Result& result : results)
+    {
+        std::string line = Format::PadLeft(std::to_string(result.entryCount), 11);
+        line += Format::PadLeft(FormatFixed(result.loadSeconds * 1000.0, 1), 10);
+        line += Format::PadLeft(std::to_string(result.frameCount), 8);
+        line += Format::PadLeft(FormatFixed(result.frameMedian * 1000.0, 3), 10);
+        line += Format::PadLeft(FormatFixed(result.frame90th * 1000.0, 3), 10);
+        line += Format::PadLeft(FormatFixed(result.frame99th * 1000.0, 3), 10);
+        line += Format::PadLeft(FormatFixed(result.frameMax * 1000.0, 3), 10);
+        
+        // Without the counting hooks there is nothing to show
+        if(AllocationCounter::IsEnabled())
+        {
+            line += Format::PadLeft(FormatFixed(result.allocationsPerFrame, 1), 14);
+            line += Format::PadLeft(Format::HumanReadableSize(static_cast<uintmax_t>(result.allocatedBytesPerFrame)), 13);
+        }
+        else
+        {
+            line += Format::PadLeft("n/a", 14);
+            line += Format::PadLeft("n/a", 13);
+        }
+        
+        line += Format::PadLeft(Format::HumanReadableSize(static_cast<uintmax_t>(result.outputBytesPerFrame)), 14);
+        line += Format::PadLeft(Format::HumanReadableSize(result.residentBytes), 12);
+        line += Format::PadLeft(Format::HumanReadableSize(result.peakResidentBytes), 12);
+        
+        out << line << std::endl;
+    }
+    
+    if(!AllocationCounter::IsEnabled())
+        return;
+    
+    for(const Result& result : results)
+    {
+        out << std::endl << "Allocations by phase, " << result.entryCount << " entries:" << std::endl;
+        AllocationCounter::PrintCounts(out, result.allocations, result.frameCount, "frame");
+    }
+}
+
+double RenderBenchmark::GetAllocationBudget(const int height) noexcept
+{
+    // The elements of the visible rows are built anew every frame, a few per row.
+    // Raise only when an allocation is added on purpose, never for the entry count.
+    return 32.0 * static_cast<double>(height) + 200.0;
+}
@@ -0,0 +1,91 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  RenderBenchmark.hpp                                             */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#ifndef RenderBenchmark_hpp
+#define RenderBenchmark_hpp
+
+// Renders AppUI into an off-screen ftxui::Screen of fixed size, no terminal needed.
+// The tree is scanned from a MemoryFileSystem, then a script of key events is replayed.
+// A frame is handling one event, rendering the components, drawing the elements into
+// the screen and converting it to terminal output, as ScreenInteractive would.
+class RenderBenchmark
+{
+public:
+    struct Result
+    {
+        uint64_t    entryCount = 0;     // Entries of the directory shown first
+        double      loadSeconds = 0.0;  // Scan and first listing
+        
+        // Frame times in seconds, the first frame is rendered without an event
+        std::size_t frameCount = 0;
+        double      frameMedian = 0.0;
+        double      frame90th = 0.0;
+        double      frame99th = 0.0;
+        double      frameMax = 0.0;
+        
+        // Allocations of all frames by phase, only counted with DST_COUNT_ALLOCATIONS
+        AllocationCounter::PhaseCounts  allocations = {};
+        double      allocationsPerFrame = 0.0;
+        double      allocatedBytesPerFrame = 0.0;
+        double      outputBytesPerFrame = 0.0;  // Terminal output
+        
+        uint64_t    residentBytes = 0;      // After loading
+        uint64_t    peakResidentBytes = 0;
+    };
+    
+private:
+    int             m_Width = 120;
+    int             m_Height = 40;
+    
+    std::string     m_LastErrorMessage;
+    
+public:
+    RenderBenchmark(int width, int height) noexcept : m_Width(width), m_Height(height) {}
+    
+    // Key events of a script like "down*100 pagedown enter back t", *N repeats a key.
+    // Keys: up, down, left, right, pageup, pagedown, home, end, enter, back, escape,
+    // tab, space or a single character.
+    bool    ParseScript(const std::string& script, std::vector<ftxui::Event>& out_events); // May throw std::bad_alloc
+    
+    // The first directory shown has entryCount entries, a tenth of them directories with 10 files each
+    bool    Run(uint64_t entryCount, const std::vector<ftxui::Event>& events, Result& out_result); // May throw std::bad_alloc
+    
+    const std::string&  GetLastErrorMessage() const noexcept { return m_LastErrorMessage; }
+    
+    static void         PrintResults(std::ostream& out, const std::vector<Result>& results);
+    
+    // Allocations per frame the renderer must stay under, independent of the entry count
+    static double       GetAllocationBudget(int height) noexcept;
+};
+
+#endif /* RenderBenchmark_hpp */
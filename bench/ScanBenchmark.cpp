@@ -0,0 +1,322 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  ScanBenchmark.cpp                                               */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#include "Bench.hpp"
+
+namespace
+{
+#ifdef PLATFORM_LINUX
+    // Id of the tracepoint every system call passes, -1 if tracefs isn't available
+    long long GetSyscallTracepointId()
+    {
+        for(const char* const file : {"/sys/kernel/tracing/events/raw_syscalls/sys_enter/id", "/sys/kernel/debug/tracing/events/raw_syscalls/sys_enter/id"})
+        {
+            std::FILE* const stream = std::fopen(file, "r");
+            if(!stream)
+                continue;
+            
+            long long id = -1;
+            const int readCount = std::fscanf(stream, "%lld", &id);
+            std::fclose(stream);
+            
+            if(readCount == 1)
+                return id;
+        }
+        
+        return -1;
+    }
+#endif
+    
+    std::string FormatRate(const double perSecond)
+    {
+        const char* const units[] = {"", " K", " M", " G"};
+        double value = perSecond;
+        std::size_t unit = 0;
+        
+        while(value >= 1000.0 && unit < 3)
+        {
+            value /= 1000.0;
+            unit++;
+        }
+        
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.1f%s", value, units[unit]);
+        return buffer;
+    }
+    
+    std::string FormatFixed(const double value, const int precision)
+    {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.*f", precision, value);
+        return buffer;
+    }
+}
+
+double ScanBenchmark::Result::GetAllocationsPerEntry() const noexcept
+{
+    if(entryCount == 0)
+        return 0.0;
+    
+    return static_cast<double>(AllocationCounter::GetTotal(allocations).allocations) / static_cast<double>(entryCount);
+}
+
+ScanBenchmark::ScanBenchmark()
+{
+#ifdef PLATFORM_LINUX
+    const long long tracepointId = GetSyscallTracepointId();
+    if(tracepointId < 0)
+        return;
+    
+    // Counts for this thread and all threads started later, i.e. the scan workers
+    perf_event_attr attributes;
+    std::memset(&attributes, 0, sizeof(attributes));
+    attributes.type = PERF_TYPE_TRACEPOINT;
+    attributes.size = sizeof(attributes);
+    attributes.config = static_cast<uint64_t>(tracepointId);
+    attributes.disabled = 1;
+    attributes.inherit = 1;
+    
+    m_SyscallCounter = static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, PERF_FLAG_FD_CLOEXEC));
+#endif
+}
+
+ScanBenchmark::~ScanBenchmark()
+{
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_APPLE)
+    if(m_SyscallCounter >= 0)
+        close(m_SyscallCounter);
+#endif
+}
+
+void ScanBenchmark::StartMeasurement() noexcept
+{
+    ProcessStats::ResetPeakResidentBytes();
+    
+#ifdef PLATFORM_LINUX
+    if(m_SyscallCounter >= 0)
+    {
+        ioctl(m_SyscallCounter, PERF_EVENT_IOC_RESET, 0);
+        ioctl(m_SyscallCounter, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+}
+
+void ScanBenchmark::StopMeasurement(int64_t& out_syscallCount, uint64_t& out_peakRss) noexcept
+{
+    out_syscallCount = -1;
+    
+#ifdef PLATFORM_LINUX
+    if(m_SyscallCounter >= 0)
+    {
+        ioctl(m_SyscallCounter, PERF_EVENT_IOC_DISABLE, 0);
+        
+        uint64_t count = 0;
+        if(read(m_SyscallCounter, &count, sizeof(count)) == sizeof(count))
+            out_syscallCount = static_cast<int64_t>(count);
+    }
+#endif
+    
+    out_peakRss = ProcessStats::GetPeakResidentBytes();
+}
+
+bool ScanBenchmark::RunOnce(const std::filesystem::path& path, const Backend backend, const std::size_t threadCount, uintmax_t& out_entryCount)
+{
+    FileSystem fileSystem(m_VirtualFileSystem);
+    bool isSuccess = false;
+    
+    switch(backend)
+    {
+        case Backend::ITERATE:
+        {
+            std::vector<FileSystem::DirectoryEntry> entries;
+            isSuccess = fileSystem.IterateDirectoryRecursively(path, entries);
+            out_entryCount = entries.size();
+            break;
+        }
+            
+        case Backend::TREE:
+        case Backend::ROLLUP:
+        {
+            DirectoryTree tree;
+            const std::atomic<bool> stop = false;
+            
+            if(backend == Backend::ROLLUP)
+                fileSystem.SetFileNodeLimit(ROLLUP_FILE_COUNT);
+            
+            isSuccess = fileSystem.ScanDirectoryTree(path, tree, stop, threadCount);
+            out_entryCount = (tree.GetRoot() == DirectoryTree::INVALID_NODE) ? 0 : tree.GetNode(tree.GetRoot()).count;
+            break;
+        }
+    }
+    
+    if(!isSuccess)
+        m_LastErrorMessage = "Can't scan " + path.string() + ": " + fileSystem.GetLastError().GetMessage();
+    
+    return isSuccess;
+}
+
+bool ScanBenchmark::Run(const std::filesystem::path& path, const Backend backend, const std::size_t threadCount, const std::size_t repetitionCount, Result& out_result)
+{
+    out_result = Result();
+    out_result.backend = backend;
+    out_result.threadCount = IsParallel(backend) ? threadCount : 1;
+    out_result.seconds = std::numeric_limits<double>::max();
+    
+    uintmax_t entryCount = 0;
+    if(!RunOnce(path, backend, out_result.threadCount, entryCount))
+        return false;
+    
+    for(std::size_t i = 0; i < std::max<std::size_t>(repetitionCount, 1); i++)
+    {
+        StartMeasurement();
+        const AllocationCounter::PhaseCounts firstCounts = AllocationCounter::GetProcessCounts();
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        
+        const bool isSuccess = RunOnce(path, backend, out_result.threadCount, entryCount);
+        
+        const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+        const AllocationCounter::PhaseCounts lastCounts = AllocationCounter::GetProcessCounts();
+        
+        int64_t syscallCount = -1;
+        uint64_t peakRss = 0;
+        StopMeasurement(syscallCount, peakRss);
+        
+        if(!isSuccess)
+            return false;
+        
+        // Keep the counts of the fastest run, the peak of all
+        if(duration.count() < out_result.seconds)
+        {
+            out_result.seconds = duration.count();
+            out_result.syscallCount = syscallCount;
+            out_result.allocations = AllocationCounter::GetDifference(lastCounts, firstCounts);
+        }
+        
+        out_result.entryCount = entryCount;
+        out_result.peakRss = std::max(out_result.peakRss, peakRss);
+    }
+    
+    return true;
+}
+
+void ScanBenchmark::PrintResults(std::ostream& out, const std::vector<Result>& results)
+{
+    constexpr std::size_t BAR_WIDTH = 30;
+    
+    double maxRate = 0.0;
+    for(const Result& result : results)
+        maxRate = std::max(maxRate, static_cast<double>(result.entryCount) / std::max(result.seconds, 1e-9));
+    
+    out << "Backend  Threads     Entries     Time ms   Entries/s  Syscalls/entry  Allocs/entry    Peak RSS  Speedup" << std::endl;
+    
+    const Result* baseline = nullptr;
+    
+    for(const Result& result : results)
+    {
+        if(!baseline || baseline->backend != result.backend)
+            baseline = &result;
+        
+        const double rate = static_cast<double>(result.entryCount) / std::max(result.seconds, 1e-9);
+        const double speedup = baseline->seconds / std::max(result.seconds, 1e-9);
+        const std::string syscallsPerEntry = (result.syscallCount < 0 || result.entryCount == 0) ? "n/a" : FormatFixed(static_cast<double>(result.syscallCount) / static_cast<double>(result.entryCount), 2);
+        const std::string allocationsPerEntry = AllocationCounter::IsEnabled() ? FormatFixed(result.GetAllocationsPerEntry(), 2) : "n/a";
+        const std::size_t barLength = (maxRate > 0.0) ? static_cast<std::size_t>(std::lround(rate / maxRate * BAR_WIDTH)) : 0;
+        
+        std::string line = GetBackendName(result.backend);
+        line.resize(7, ' ');
+        line += Format::PadLeft(std::to_string(result.threadCount), 9);
+        line += Format::PadLeft(std::to_string(result.entryCount), 12);
+        line += Format::PadLeft(FormatFixed(result.seconds * 1000.0, 1), 12);
+        line += Format::PadLeft(FormatRate(rate), 12);
+        line += Format::PadLeft(syscallsPerEntry, 16);
+        line += Format::PadLeft(allocationsPerEntry, 14);
+        line += Format::PadLeft(Format::HumanReadableSize(result.peakRss), 12);
+        line += Format::PadLeft(FormatFixed(speedup, 2), 9);
+        line += "  " + std::string(barLength, '#');
+        
+        out << line << std::endl;
+    }
+    
+    if(!AllocationCounter::IsEnabled())
+        return;
+    
+    // The counts barely depend on the thread count
+    for(std::size_t i = 0; i < results.size(); i++)
+    {
+        if(i > 0 && results[i - 1].backend == results[i].backend)
+            continue;
+        
+        out << std::endl << "Allocations by phase, " << GetBackendName(results[i].backend) << ":" << std::endl;
+        AllocationCounter::PrintCounts(out, results[i].allocations, results[i].entryCount, "entry");
+    }
+}
+
+const char* ScanBenchmark::GetBackendName(const Backend backend) noexcept
+{
+    switch(backend)
+    {
+        case Backend::ITERATE:  return "iterate";
+        case Backend::TREE:     return "tree";
+        case Backend::ROLLUP:   return "rollup";
+    }
+    
+    return "";
+}
+
+double ScanBenchmark::GetAllocationBudget(const Backend backend) noexcept
+{
+    // Slightly above the worst shape, raise only when an allocation is added on purpose.
+    // Iterating allocates a path per entry and level, the tree a name per new directory.
+    switch(backend)
+    {
+        case Backend::ITERATE:  return 13.0;
+        case Backend::TREE:     return 2.0;
+        case Backend::ROLLUP:   return 2.0;
+    }
+    
+    return 0.0;
+}
+
+bool ScanBenchmark::GetBackendFromName(const std::string_view name, Backend& out_backend) noexcept
+{
+    for(const Backend backend : {Backend::ITERATE, Backend::TREE, Backend::ROLLUP})
+    {
+        if(name == GetBackendName(backend))
+        {
+            out_backend = backend;
+            return true;
+        }
+    }
+    
+    return false;
+}
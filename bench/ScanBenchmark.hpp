@@ -0,0 +1,107 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  ScanBenchmark.hpp                                               */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#ifndef ScanBenchmark_hpp
+#define ScanBenchmark_hpp
+
+// Times the scan backends of FileSystem on a directory and measures entries per
+// second, system calls per entry, allocations per entry and peak resident memory of each run.
+class ScanBenchmark
+{
+public:
+    enum class Backend : uint8_t
+    {
+        ITERATE = 0,    // IterateDirectoryRecursively(), std::filesystem iterators, one thread, always the disk
+        TREE,           // ScanDirectoryTree() into a DirectoryTree, parallel, reads the virtual file system
+        ROLLUP          // Like TREE, but only the ROLLUP_FILE_COUNT largest files of each directory become nodes
+    };
+    
+    static constexpr uint32_t ROLLUP_FILE_COUNT = 10;
+    
+    struct Result
+    {
+        Backend     backend = Backend::TREE;
+        std::size_t threadCount = 1;
+        
+        uintmax_t   entryCount = 0;
+        double      seconds = 0.0;  // Fastest of the repetitions
+        int64_t     syscallCount = -1;  // -1 if system calls can't be counted
+        uint64_t    peakRss = 0;    // Bytes, highest of the repetitions
+        
+        // Allocations of the fastest run by phase, only counted with DST_COUNT_ALLOCATIONS
+        AllocationCounter::PhaseCounts  allocations = {};
+        
+        double      GetAllocationsPerEntry() const noexcept;
+    };
+    
+private:
+    std::string     m_LastErrorMessage;
+    
+    std::shared_ptr<VirtualFileSystem>  m_VirtualFileSystem = RealFileSystem::GetInstance();
+    
+    // Counter of system calls entered by this process and its threads, -1 if unavailable
+    int             m_SyscallCounter = -1;
+    
+    void            StartMeasurement() noexcept;
+    void            StopMeasurement(int64_t& out_syscallCount, uint64_t& out_peakRss) noexcept;
+    bool            RunOnce(const std::filesystem::path& path, Backend backend, std::size_t threadCount, uintmax_t& out_entryCount); // May throw std::bad_alloc
+    
+public:
+    ScanBenchmark();
+    ~ScanBenchmark();
+    
+    ScanBenchmark(const ScanBenchmark&) = delete;
+    ScanBenchmark& operator=(const ScanBenchmark&) = delete;
+    
+    // Scans path repetitionCount times after one untimed run, which warms the caches
+    bool                Run(const std::filesystem::path& path, Backend backend, std::size_t threadCount, std::size_t repetitionCount, Result& out_result); // May throw std::bad_alloc
+    
+    // E.g. a MemoryFileSystem, to measure the scanner without the kernel
+    void                SetVirtualFileSystem(std::shared_ptr<VirtualFileSystem> virtualFileSystem) noexcept { m_VirtualFileSystem = std::move(virtualFileSystem); }
+    
+    bool                IsCountingSyscalls() const noexcept { return m_SyscallCounter >= 0; }
+    const std::string&  GetLastErrorMessage() const noexcept { return m_LastErrorMessage; }
+    
+    // Table of results with entries/s as bar and the speedup over the first result of each backend,
+    // then the allocations by phase of the first result of each backend
+    static void         PrintResults(std::ostream& out, const std::vector<Result>& results);
+    
+    static const char*  GetBackendName(Backend backend) noexcept;
+    static bool         GetBackendFromName(std::string_view name, Backend& out_backend) noexcept;
+    static bool         IsParallel(Backend backend) noexcept { return backend != Backend::ITERATE; }
+    
+    // Allocations per entry the backend must stay under, measured on the generated trees
+    static double       GetAllocationBudget(Backend backend) noexcept;
+};
+
+#endif /* ScanBenchmark_hpp */
@@ -0,0 +1,320 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  TreeGenerator.cpp                                               */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#include "Bench.hpp"
+
+namespace
+{
+    // Increase when the generated trees change, so old ones aren't reused
+    constexpr uint32_t GENERATOR_VERSION = 1;
+    
+    struct ShapeParameters
+    {
+        std::size_t minFiles = 0;       // Per directory
+        std::size_t maxFiles = 0;
+        std::size_t minDirectories = 0; // Per directory
+        std::size_t maxDirectories = 0;
+        std::size_t maxDepth = 0;
+        uint32_t    maxSizeBits = 0;    // Sizes are spread evenly over the powers of two below 2^maxSizeBits
+        uint32_t    symlinkPermille = 0;
+        uint32_t    hardLinkPermille = 0;
+    };
+    
+    ShapeParameters GetShapeParameters(const TreeGenerator::Shape shape, const std::size_t entryCount)
+    {
+        ShapeParameters parameters;
+        
+        switch(shape)
+        {
+            case TreeGenerator::Shape::WIDE:
+                parameters.minFiles = entryCount;
+                parameters.maxFiles = entryCount;
+                parameters.maxSizeBits = 16;
+                break;
+                
+            case TreeGenerator::Shape::DEEP:
+            {
+                // Stay well below PATH_MAX with names of two characters per level
+                const std::size_t depth = std::clamp<std::size_t>(entryCount / 8, 1, 1024);
+                parameters.minFiles = std::max<std::size_t>(entryCount / depth, 2) - 1;
+                parameters.maxFiles = parameters.minFiles;
+                parameters.minDirectories = 1;
+                parameters.maxDirectories = 1;
+                parameters.maxDepth = depth;
+                parameters.maxSizeBits = 16;
+                break;
+            }
+                
+            case TreeGenerator::Shape::TINY_FILES:
+                parameters.minFiles = 500;
+                parameters.maxFiles = 1500;
+                parameters.minDirectories = 4;
+                parameters.maxDirectories = 8;
+                parameters.maxDepth = 8;
+                parameters.maxSizeBits = 12;
+                break;
+                
+            case TreeGenerator::Shape::MIXED:
+            case TreeGenerator::Shape::LINKS:
+                parameters.minFiles = 0;
+                parameters.maxFiles = 48;
+                parameters.minDirectories = 1;
+                parameters.maxDirectories = 6;
+                parameters.maxDepth = 32;
+                parameters.maxSizeBits = 32;
+                
+                if(shape == TreeGenerator::Shape::LINKS)
+                {
+                    parameters.symlinkPermille = 150;
+                    parameters.hardLinkPermille = 150;
+                }
+                break;
+        }
+        
+        return parameters;
+    }
+    
+    // Same numbers on every platform, unlike the std distributions
+    uint64_t RandomBelow(std::mt19937_64& random, const uint64_t limit)
+    {
+        return (limit == 0) ? 0 : random() % limit;
+    }
+    
+    std::size_t RandomBetween(std::mt19937_64& random, const std::size_t min, const std::size_t max)
+    {
+        return min + static_cast<std::size_t>(RandomBelow(random, max - min + 1));
+    }
+    
+    std::string GetMarkerContent(const TreeGenerator::Options& options)
+    {
+        return "dirstats_bench " + std::to_string(GENERATOR_VERSION) + " " + TreeGenerator::GetShapeName(options.shape) + " "
+            + std::to_string(options.entryCount) + " " + std::to_string(options.seed) + "\n";
+    }
+    
+    bool ReadFile(const std::filesystem::path& file, std::string& out_content)
+    {
+        std::FILE* const stream = std::fopen(file.string().c_str(), "rb");
+        if(!stream)
+            return false;
+        
+        char buffer[256];
+        const std::size_t length = std::fread(buffer, 1, sizeof(buffer), stream);
+        std::fclose(stream);
+        
+        out_content.assign(buffer, length);
+        return true;
+    }
+    
+    bool WriteFile(const std::filesystem::path& file, const std::string& content)
+    {
+        std::FILE* const stream = std::fopen(file.string().c_str(), "wb");
+        if(!stream)
+            return false;
+        
+        const bool isWritten = std::fwrite(content.data(), 1, content.size(), stream) == content.size();
+        return (std::fclose(stream) == 0) && isWritten;
+    }
+    
+    bool CreateFile(const std::string& path, const uint64_t size, std::error_code& out_error)
+    {
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_APPLE)
+        const int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+        if(fd < 0)
+        {
+            out_error.assign(errno, std::generic_category());
+            return false;
+        }
+        
+        const bool isResized = (size == 0) || (ftruncate(fd, static_cast<off_t>(size)) == 0);
+        if(!isResized)
+            out_error.assign(errno, std::generic_category());
+        
+        close(fd);
+        return isResized;
+#else
+        std::FILE* const stream = std::fopen(path.c_str(), "wb");
+        if(!stream)
+        {
+            out_error.assign(errno, std::generic_category());
+            return false;
+        }
+        
+        std::fclose(stream);
+        
+        std::filesystem::resize_file(path, size, out_error);
+        return !out_error;
+#endif
+    }
+}
+
+const char* TreeGenerator::GetShapeName(const Shape shape) noexcept
+{
+    switch(shape)
+    {
+        case Shape::WIDE:       return "wide";
+        case Shape::DEEP:       return "deep";
+        case Shape::TINY_FILES: return "tiny";
+        case Shape::MIXED:      return "mixed";
+        case Shape::LINKS:      return "links";
+    }
+    
+    return "";
+}
+
+bool TreeGenerator::GetShapeFromName(const std::string_view name, Shape& out_shape) noexcept
+{
+    for(const Shape shape : {Shape::WIDE, Shape::DEEP, Shape::TINY_FILES, Shape::MIXED, Shape::LINKS})
+    {
+        if(name == GetShapeName(shape))
+        {
+            out_shape = shape;
+            return true;
+        }
+    }
+    
+    return false;
+}
+
+bool TreeGenerator::Generate(const std::filesystem::path& directory, const Options& options)
+{
+    // The marker next to the tree tells which options it was generated with
+    const std::filesystem::path markerFile = directory.string() + ".generated";
+    const std::string markerContent = GetMarkerContent(options);
+    
+    std::string existingMarker;
+    if(ReadFile(markerFile, existingMarker) && existingMarker == markerContent)
+        return true;
+    
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    if(error || !std::filesystem::is_empty(directory, error))
+    {
+        m_LastErrorMessage = directory.string() + (error ? ": " + error.message() : " is not empty");
+        return false;
+    }
+    
+    // Outdated or partly generated tree
+    std::filesystem::remove(markerFile, error);
+    
+    const ShapeParameters parameters = GetShapeParameters(options.shape, options.entryCount);
+    std::mt19937_64 random(options.seed);
+    
+    // Recent regular files, targets of links
+    constexpr std::size_t LINK_TARGET_COUNT = 4096;
+    std::vector<std::string> linkTargets;
+    std::size_t nextLinkTarget = 0;
+    
+    // Directories are filled breadth first until there are enough entries
+    std::deque<std::pair<std::string, std::size_t>> pendingDirectories;
+    pendingDirectories.emplace_back(directory.string(), 0);
+    
+    std::size_t createdCount = 0;
+    std::string path;
+    
+    auto fail = [this, &path](const std::error_code& pathError)
+    {
+        m_LastErrorMessage = "Can't create " + path + ": " + pathError.message();
+        return false;
+    };
+    
+    while(!pendingDirectories.empty() && createdCount < options.entryCount)
+    {
+        const auto [parentPath, depth] = std::move(pendingDirectories.front());
+        pendingDirectories.pop_front();
+        
+        // Files and links
+        const std::size_t fileCount = std::min(RandomBetween(random, parameters.minFiles, parameters.maxFiles), options.entryCount - createdCount);
+        
+        for(std::size_t i = 0; i < fileCount; i++)
+        {
+            path = parentPath + "/f" + std::to_string(i);
+            const uint64_t roll = RandomBelow(random, 1000);
+            
+            if(roll < parameters.symlinkPermille && !linkTargets.empty())
+            {
+                // Every tenth link is dangling
+                const std::string& target = linkTargets[RandomBelow(random, linkTargets.size())];
+                std::filesystem::create_symlink((roll % 10 == 0) ? target + ".missing" : target, path, error);
+            }
+            else if(roll < parameters.symlinkPermille + parameters.hardLinkPermille && !linkTargets.empty())
+            {
+                std::filesystem::create_hard_link(linkTargets[RandomBelow(random, linkTargets.size())], path, error);
+            }
+            else
+            {
+                const uint64_t sizeBits = RandomBelow(random, parameters.maxSizeBits + 1);
+                const uint64_t size = (sizeBits == 0) ? 0 : (uint64_t(1) << (sizeBits - 1)) + RandomBelow(random, uint64_t(1) << (sizeBits - 1));
+                
+                if(CreateFile(path, size, error))
+                {
+                    if(linkTargets.size() < LINK_TARGET_COUNT)
+                        linkTargets.push_back(path);
+                    else
+                        linkTargets[nextLinkTarget++ % LINK_TARGET_COUNT] = path;
+                }
+            }
+            
+            if(error)
+                return fail(error);
+        }
+        
+        createdCount += fileCount;
+        
+        // Subdirectories
+        if(depth >= parameters.maxDepth)
+            continue;
+        
+        const std::size_t directoryCount = std::min(RandomBetween(random, parameters.minDirectories, parameters.maxDirectories), options.entryCount - createdCount);
+        
+        for(std::size_t i = 0; i < directoryCount; i++)
+        {
+            path = parentPath + "/d" + std::to_string(i);
+            
+            std::filesystem::create_directory(path, error);
+            if(error)
+                return fail(error);
+            
+            pendingDirectories.emplace_back(path, depth + 1);
+        }
+        
+        createdCount += directoryCount;
+    }
+    
+    if(!WriteFile(markerFile, markerContent))
+    {
+        m_LastErrorMessage = "Can't write " + markerFile.string() + ": " + std::strerror(errno);
+        return false;
+    }
+    
+    return true;
+}
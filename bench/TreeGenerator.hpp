@@ -0,0 +1,75 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  TreeGenerator.hpp                                               */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#ifndef TreeGenerator_hpp
+#define TreeGenerator_hpp
+
+// Builds reproducible directory trees for benchmarking the scanner. The same
+// shape, entry count and seed always give the same names, sizes and links.
+// File contents are never written, sizes are set with ftruncate (sparse).
+class TreeGenerator
+{
+public:
+    enum class Shape : uint8_t
+    {
+        WIDE = 0,   // All files in one directory
+        DEEP,       // Long chain of directories with a few files each
+        TINY_FILES, // Many directories full of files below 4 KiB
+        MIXED,      // Random fanout, sizes spread from bytes to GiB
+        LINKS       // Like MIXED, with symbolic links and hard links
+    };
+    
+    struct Options
+    {
+        Shape       shape = Shape::MIXED;
+        std::size_t entryCount = 100000;    // Files, directories and links, without the root
+        uint64_t    seed = 1;
+    };
+    
+private:
+    std::string     m_LastErrorMessage;
+    
+public:
+    TreeGenerator() = default;
+    
+    // Creates the tree in directory (created if missing, must be empty otherwise).
+    // A tree generated before with the same options is kept and not created again.
+    bool                Generate(const std::filesystem::path& directory, const Options& options); // May throw std::bad_alloc
+    
+    const std::string&  GetLastErrorMessage() const noexcept { return m_LastErrorMessage; }
+    
+    static const char*  GetShapeName(Shape shape) noexcept;
+    static bool         GetShapeFromName(std::string_view name, Shape& out_shape) noexcept;
+};
+
+#endif /* TreeGenerator_hpp */
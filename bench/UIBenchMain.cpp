@@ -0,0 +1,99 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  UIBenchMain.cpp                                                 */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#include "UIBench.hpp"
+
+int main(int argc, char** argv)
+{
+    CLI::App cliApp("Measures the rendering of the DirStatsTUI user interface off-screen, without a terminal.", "DirStatsTUI_uibench");
+    
+    std::vector<uint64_t> entryCounts = {10, 1000, 100000};
+    std::string script = "down*100 pagedown*10 end home enter down*10 back t down*10 t";
+    int width = 120;
+    int height = 40;
+    double maxAllocationsPerFrame = 0.0;
+    
+    cliApp.add_option("-n,--entries", entryCounts, "Sizes of the directory shown, up to 10M entries")->check(CLI::Range(uint64_t(1), uint64_t(100000000)))->capture_default_str();
+    cliApp.add_option("-s,--script", script, "Keys replayed, one frame each: up, down, left, right, pageup, pagedown, home, end, enter, back, escape, tab, space or a character, *N repeats")->capture_default_str();
+    cliApp.add_option("--width", width, "Columns of the screen")->check(CLI::Range(20, 1000))->capture_default_str();
+    cliApp.add_option("--height", height, "Rows of the screen")->check(CLI::Range(10, 1000))->capture_default_str();
+    cliApp.add_option("--max-allocs-per-frame", maxAllocationsPerFrame, "Fail if a frame allocates more often on average, 0 for the budget of the screen height, -1 for no limit (needs DIRSTATS_COUNT_ALLOCATIONS)")->capture_default_str();
+    
+    CLI11_PARSE(cliApp, argc, argv);
+    
+    RenderBenchmark benchmark(width, height);
+    
+    std::vector<ftxui::Event> events;
+    if(!benchmark.ParseScript(script, events))
+    {
+        std::cerr << benchmark.GetLastErrorMessage() << std::endl;
+        return -1;
+    }
+    
+    std::vector<RenderBenchmark::Result> results;
+    
+    for(const uint64_t entryCount : entryCounts)
+    {
+        RenderBenchmark::Result result;
+        if(!benchmark.Run(entryCount, events, result))
+        {
+            std::cerr << benchmark.GetLastErrorMessage() << std::endl;
+            return -1;
+        }
+        
+        results.push_back(result);
+    }
+    
+    RenderBenchmark::PrintResults(std::cout, results);
+    
+    // Allocation budget
+    if(AllocationCounter::IsEnabled() && maxAllocationsPerFrame >= 0.0)
+    {
+        const double budget = (maxAllocationsPerFrame > 0.0) ? maxAllocationsPerFrame : RenderBenchmark::GetAllocationBudget(height);
+        
+        bool isOverBudget = false;
+        for(const RenderBenchmark::Result& result : results)
+        {
+            if(result.allocationsPerFrame > budget)
+            {
+                std::cerr << result.entryCount << " entries: " << result.allocationsPerFrame << " allocations per frame, budget is " << budget << std::endl;
+                isOverBudget = true;
+            }
+        }
+        
+        if(isOverBudget)
+            return -2;
+    }
+    
+    return 0;
+}
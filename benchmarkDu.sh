@@ -0,0 +1,112 @@
+#!/bin/bash
+
+################################################################################
+# Script for comparing "DirStatsTUI du" against GNU du                         #
+#                                                                              #
+# (C) 2024 Marc Schöndorf                                                      #
+# Licensed under the zlib License. See LICENSE.md                              #
+################################################################################
+
+# Usage: benchmarkDu.sh [BINARY] [RUNS]
+BINARY=${1:-build/bin/release/DirStatsTUI}
+RUNS=${2:-5}
+TREE_DIR=$(mktemp -d "${TMPDIR:-/tmp}/dirstats-bench.XXXXXX")
+
+trap 'rm -rf "$TREE_DIR"' EXIT
+
+################################################################################
+# Predefine colors
+BOLD="\033[1m"
+BOLDRED="\033[1;31m"
+ITALICGREEN="\033[3;32m"
+ENDCOLOR="\033[0m"
+
+if [[ ! -x "$BINARY" ]]
+then
+	echo -e "${BOLDRED}Error: ${BINARY} not found. Build the release version first or pass the binary as first argument.${ENDCOLOR}"
+	exit 1
+fi
+
+################################################################################
+# Generate trees
+# GenerateTree NAME DEPTH FANOUT FILES_PER_DIR FILE_SIZE
+GenerateTree()
+{
+	local root="$TREE_DIR/$1"
+	local depth=$2 fanout=$3 files=$4 size=$5
+	local level dir i
+	local current=("$root")
+	
+	mkdir -p "$root"
+	
+	for ((level = 0; level < depth; level++))
+	do
+		local next=()
+		
+		for dir in "${current[@]}"
+		do
+			for ((i = 0; i < fanout; i++))
+			do
+				mkdir "$dir/d$i"
+				next+=("$dir/d$i")
+			done
+		done
+		
+		current=("${next[@]}")
+	done
+	
+	# Files in every directory, printf is a builtin and needs no process per file
+	local content
+	content=$(printf "%${size}s" "")
+	
+	find "$root" -type d | while read -r dir
+	do
+		for ((i = 0; i < files; i++))
+		do
+			printf "%s" "$content" > "$dir/f$i"
+		done
+	done
+}
+
+echo -e "${ITALICGREEN}Info: Generating trees in ${TREE_DIR}${ENDCOLOR}"
+GenerateTree "wide" 2 40 10 100        # Many directories, few levels
+GenerateTree "deep" 10 2 2 4096        # Many levels
+GenerateTree "flat" 0 0 20000 10       # One large directory
+
+################################################################################
+# Run one command RUNS times and print the average wall time in ms
+TimeCommand()
+{
+	local start end total=0 run
+	
+	for ((run = 0; run < RUNS; run++))
+	do
+		start=$(date +%s%N)
+		"$@" > /dev/null
+		end=$(date +%s%N)
+		total=$((total + end - start))
+	done
+	
+	echo $((total / RUNS / 1000000))
+}
+
+printf "${BOLD}%-8s %-18s %10s %14s  %s${ENDCOLOR}\n" "Tree" "Arguments" "du [ms]" "DirStats [ms]" "Output"
+
+for tree in wide deep flat
+do
+	for args in "-s" "-sh" "-d 2" "-a" "-ab --max-depth=1"
+	do
+		# Same output as du?
+		if cmp -s <(du $args "$TREE_DIR/$tree") <("$BINARY" du $args "$TREE_DIR/$tree")
+		then
+			result="identical"
+		else
+			result="${BOLDRED}differs${ENDCOLOR}"
+		fi
+		
+		duTime=$(TimeCommand du $args "$TREE_DIR/$tree")
+		ownTime=$(TimeCommand "$BINARY" du $args "$TREE_DIR/$tree")
+		
+		printf "%-8s %-18s %10s %14s  %b\n" "$tree" "$args" "$duTime" "$ownTime" "$result"
+	done
+done
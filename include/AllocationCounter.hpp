@@ -0,0 +1,110 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  AllocationCounter.hpp                                           */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#ifndef AllocationCounter_hpp
+#define AllocationCounter_hpp
+
+// Counts heap allocations by phase of the scanner and the UI. Only built with
+// DIRSTATS_COUNT_ALLOCATIONS (DST_COUNT_ALLOCATIONS), which replaces the global
+// operator new. Otherwise all counts stay 0 and the phases cost nothing.
+// Counting builds are for counting, their timings are slightly off.
+namespace AllocationCounter
+{
+    enum class Phase : uint8_t
+    {
+        OTHER = 0,
+        SCAN_READ,      // Reading a directory listing
+        SCAN_LINKS,     // Looking up hard links
+        SCAN_TREE,      // Adding the entries to the tree
+        SCAN_QUEUE,     // Queueing the subdirectories
+        UI_EVENT,       // Handling a key or mouse event
+        UI_LISTING,     // Filling the menu with the current directory
+        UI_RENDER,      // Building the element tree of a frame
+        UI_DRAW,        // Drawing the elements into the screen
+        UI_OUTPUT,      // Converting the screen to terminal output
+        COUNT
+    };
+    
+    struct Counts
+    {
+        uint64_t    allocations = 0;
+        uint64_t    bytes = 0;
+    };
+    
+    using PhaseCounts = std::array<Counts, static_cast<std::size_t>(Phase::COUNT)>;
+    
+    // Are the counting hooks built in?
+    bool        IsEnabled() noexcept;
+    
+    // Allocations of the calling thread since it started, or of all threads since the start
+    PhaseCounts GetThreadCounts() noexcept;
+    PhaseCounts GetProcessCounts() noexcept;
+    
+    Counts      GetTotal(const PhaseCounts& counts) noexcept;
+    PhaseCounts GetDifference(const PhaseCounts& later, const PhaseCounts& earlier) noexcept;
+    const char* GetPhaseName(Phase phase) noexcept;
+    
+    // Phases with allocations, counts divided by unitCount (e.g. entries or frames).
+    // An empty unitName prints the counts as they are.
+    void        PrintCounts(std::ostream& out, const PhaseCounts& counts, uint64_t unitCount, const std::string& unitName);
+    
+    // Phase of the calling thread, returns the previous one
+    Phase       SetThreadPhase(Phase phase) noexcept;
+    
+#ifdef DST_COUNT_ALLOCATIONS
+    // Allocations of the calling thread count for phase while this exists
+    class ScopedPhase
+    {
+    private:
+        Phase   m_PreviousPhase;
+        
+    public:
+        explicit ScopedPhase(const Phase phase) noexcept : m_PreviousPhase(SetThreadPhase(phase)) {}
+        ~ScopedPhase() { SetThreadPhase(m_PreviousPhase); }
+        
+        ScopedPhase(const ScopedPhase&) = delete;
+        ScopedPhase& operator=(const ScopedPhase&) = delete;
+    };
+#else
+    class ScopedPhase
+    {
+    public:
+        explicit ScopedPhase(const Phase) noexcept {}
+        
+        ScopedPhase(const ScopedPhase&) = delete;
+        ScopedPhase& operator=(const ScopedPhase&) = delete;
+    };
+#endif
+};
+
+#endif /* AllocationCounter_hpp */
@@ -43,13 +43,58 @@ private:
     // CLI
     std::unique_ptr<CLI::App>   m_CLIApp = nullptr;
     bool                        m_CLIShowAllFiles = false;
+    bool                        m_CLIBuildNameIndex = false;
+    uint32_t                    m_CLITreemapDepth = 2;
+    double                      m_CLIHotPathThreshold = 50.0;
     FileSystem::Path            m_CLIStartingPath = "";
+    std::string                 m_CLIOutputFormat = "";
+    std::string                 m_CLIOutputFile = "";
+    double                      m_CLIFoldedThreshold = 0.01;
+    std::string                 m_CLIImportFile = "";
+    uint32_t                    m_CLIThreadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    std::string                 m_CLIStatsFormat = "";
+    std::string                 m_CLITraceFile = "";
+    uint32_t                    m_CLIRollupFileCount = FileSystem::ALL_FILES;
+    uintmax_t                   m_CLIMemoryLimit = 0; // MiB, 0: None
+    
+    // Background indexer
+    bool                        m_CLIRunDaemon = false;
+    bool                        m_CLIAttach = false;
+    std::string                 m_CLISocketPath = DaemonProtocol::GetDefaultSocketPath();
+    uint32_t                    m_CLIRefreshInterval = 3600;
+    
+    // Shared memory snapshots
+    std::string                 m_CLIPublishFile = "";
+    std::string                 m_CLISnapshotFile = "";
+    std::vector<std::string>    m_CLIDiffFiles;
+    
+    // Scan history
+    std::string                 m_CLIRecordHistoryFile = "";
+    std::string                 m_CLIHistoryFile = "";
+    uintmax_t                   m_CLIHistoryMinSize = 100; // MiB
+    uint32_t                    m_CLIForecastDays = 30;
+    
+    // Prometheus metrics
+    std::string                 m_CLIPrometheusFile = "";
+    uint32_t                    m_CLIPrometheusDepth = 2;
+    uintmax_t                   m_CLIPrometheusMinSize = 0; // MiB, 0: None
+    
+    // du compatible mode
+    CLI::App*                   m_CLIDiskUsageCommand = nullptr;
+    DiskUsage::Options          m_CLIDiskUsageOptions;
+    std::vector<std::pair<CLI::Option*, DiskUsage::Unit>> m_CLIDiskUsageUnitOptions; // -b, -k, -m, -h and --si
+    std::vector<std::string>    m_CLIDiskUsagePaths;
     
     // UI
     ftxui::ScreenInteractive    m_Screen;
     std::shared_ptr<AppUI>      m_AppUI = nullptr;
     
     void ParseCommandLine();
+    int  RunMode();
+    int  RunHeadless();
+    int  RunPublish();
+    int  RunHistory();
+    int  RunStatistics();
     
 public:
     App(int argc, char** argv);
@@ -49,16 +49,105 @@ private:
     // File system instance
     FileSystem          m_FileSystem;
     
+    // Source of the scanned listings, the disk unless simulated (e.g. for benchmarks)
+    std::shared_ptr<VirtualFileSystem>  m_VirtualFileSystem = RealFileSystem::GetInstance();
+    
     // State
     FileSystem::Path    m_StartingPath = "";
     bool                m_ShowAllFiles = false;
-    //Sorting             m_FileSorting = Sorting::SIZE_DESCENDING;
+    Sorting             m_FileSorting = Sorting::SIZE_DESCENDING;
     
     std::function<void()> m_QuitFunction;
     
+    // Scanned tree
+    DirectoryTree       m_Tree;
+    std::thread         m_ScanThread;
+    std::atomic<bool>   m_IsScanning = false;
+    std::atomic<bool>   m_StopScan = false;
+    std::size_t         m_ScanThreadCount = std::thread::hardware_concurrency();
+    ScanProgress        m_ScanProgress;
+    uint32_t            m_FileNodeLimit = FileSystem::ALL_FILES;
+    uint64_t            m_MemoryLimit = 0;
+    bool                m_HasReachedMemoryLimit = false;
+    bool                m_IsFileDropPending = false; // Waits for a search or deletion to finish
+    
+    // ncdu export loaded instead of scanning, the file system is not touched then
+    FileSystem::Path    m_ImportFile = "";
+    
+    // Tree of a running daemon, mirrored on demand instead of scanning
+    std::string                     m_DaemonSocketPath = "";
+    std::unique_ptr<DaemonClient>   m_DaemonClient = nullptr;
+    
+    // Loads from the daemon run on m_DaemonPool and post an event when done, rendering never
+    // waits for the socket. The UI thread uses the client only under m_DaemonClientMutex.
+    // Loads requested before the last attach are dropped. Of a directory only the largest
+    // children are loaded, in steps while scrolling down, all of them when sorted by name.
+    static constexpr uint32_t       DAEMON_WINDOW_STEP = 1000;
+    
+    std::mutex                      m_DaemonClientMutex;
+    std::atomic<uint64_t>           m_DaemonAttachCount = 0;
+    std::atomic<bool>               m_IsQueryingDaemon = false;
+    std::set<std::tuple<DirectoryTree::NodeIndex, uint32_t, uint32_t>> m_RequestedDaemonLoads; // Node, depth, window. UI thread only.
+    ThreadPool                      m_DaemonPool{1};
+    
+    // Snapshot of another process, mapped instead of scanning. Read-only.
+    FileSystem::Path    m_SnapshotFile = "";
+    TreeSnapshot        m_Snapshot;
+    
+    // Changes between two snapshots, the new one is mapped into m_Tree. Both stay as loaded.
+    FileSystem::Path                    m_DiffBaseFile = "";
+    FileSystem::Path                    m_DiffNewFile = "";
+    DirectoryTree                       m_DiffBaseTree;
+    TreeSnapshot                        m_DiffBaseSnapshot;
+    TreeDiff                            m_Diff;
+    TreeDiff::NodeIndex                 m_DiffNode = TreeDiff::INVALID_NODE;
+    std::vector<TreeDiff::NodeIndex>    m_DiffEntries;
+    std::vector<TreeDiff::NodeIndex>    m_GrowthPath;
+    
+    // Failed import, daemon connection or snapshot, shown in the status line
+    std::string         m_ErrorMessage = "";
+    
+    // Global name search
+    TrigramIndex        m_NameIndex;
+    std::mutex          m_NameIndexMutex;
+    std::thread         m_SearchThread;
+    std::atomic<bool>   m_IsSearching = false;
+    bool                m_BuildNameIndex = false;
+    bool                m_IsSearchInputActive = false;
+    std::string         m_SearchQuery = "";
+    
+    // Current view, either a directory of the tree or a virtual directory (search results)
+    DirectoryTree::NodeIndex                m_CurrentNode = DirectoryTree::INVALID_NODE;
+    std::vector<DirectoryTree::NodeIndex>   m_ViewEntries;
+    bool                                    m_IsVirtualView = false;
+    std::string                             m_VirtualViewTitle = "";
+    
+    // Details of the selected entry, loaded in background
+    EntryDetails                            m_EntryDetails;
+    
+    // Marked entries and their deletion
+    std::unordered_set<DirectoryTree::NodeIndex>    m_MarkedNodes;
+    Deleter                                         m_Deleter{m_Tree};
+    bool                                            m_IsDeleteConfirmActive = false;
+    std::string                                     m_DeleteConfirmText = "";
+    
+    // Hot path: chain of heaviest children, shown as breadcrumb
+    std::vector<DirectoryTree::NodeIndex>   m_HotPath;
+    double                                  m_HotPathThreshold = 0.5;
+    
+    // Treemap view
+    Treemap                     m_Treemap;
+    std::vector<Treemap::Rect>  m_TreemapRects;
+    bool                        m_ShowTreemap = false;
+    ftxui::Box                  m_MainViewBox;
+    
     // UI
     std::string     m_SpaceInfoText = "";
     float           m_GaugeValueUsedSpace = 0.0f;
+    uint64_t        m_FrameCount = 0;
+    
+    // Performance overlay, toggled with 'p'
+    PerformanceOverlay  m_PerformanceOverlay;
     
     // Spinner
     std::atomic<uint32_t>   m_SpinnerValue = 0;
@@ -70,20 +159,78 @@ private:
     
     // Methods
     void            UpdateSpinnerTask() noexcept;
+    void            ScanTask();
+    void            SearchTask(const std::string& pattern);
+    
+    void            ShowSearchResult(const std::string& pattern, const TrigramIndex::SearchResult& result);
+    void            SortViewEntries();
+    ftxui::Element  RenderTreemap();
+    ftxui::Element  RenderDetails();
+    void            SelectNode(DirectoryTree::NodeIndex node);
+    DirectoryTree::NodeIndex GetSelectedNode() const;
+    
+    void            OnMenuEnter();
+    void            NavigateUp();
+    void            FollowHotPath();
+    void            ToggleMark();
+    void            RequestDeletion();
+    void            OnDeletionFinished();
+    void            AttachToDaemon();
+    void            ReloadFromDaemon();
+    void            LoadSnapshot();
+    void            CheckForUpdates();
+    void            RequestDaemonLoad(DirectoryTree::NodeIndex node, uint32_t depth, uint32_t window);
+    void            RestoreDaemonLocation(std::vector<std::string> names, std::string selectedName);
+    uint32_t        GetDaemonWindow() const;
+    void            OnDaemonLoaded(uint64_t attachCount, bool isOk, bool isStale, const std::string& errorMessage);
+    void            OnDaemonError(bool isStale, const std::string& message);
+    
+    bool            IsDiffView() const noexcept { return !m_DiffBaseFile.empty(); }
+    void            LoadDiff();
+    void            UpdateDiffView();
+    void            SelectDiffNode(TreeDiff::NodeIndex node);
+    TreeDiff::NodeIndex GetSelectedDiffNode() const;
+    void            OnDiffEnter();
+    void            NavigateUpDiff();
+    void            FollowGrowthPath();
+    ftxui::Element  RenderDiffDetails();
+    ftxui::Element  RenderDiffHeader();
+    
+    // Current directory and selection by name, to find them again in a replaced tree
+    void            SaveLocation(std::vector<std::string>& out_names, std::string& out_selectedName);
+    void            RestoreLocation(const std::vector<std::string>& names, const std::string& selectedName);
+    void            ResetView();
+    void            OnMemoryLimitReached();
+    void            DropPendingFileNodes();
+    void            AccountMemory(MemoryAccounting& accounting);
+    bool            OnSearchInputEvent(ftxui::Event event);
     
 public:
     AppUI(ftxui::ScreenInteractive* screen, std::function<void()> quit);
     virtual ~AppUI();
     
     bool            UpdateSpaceInfo();
+    void            StartScan();
     
     bool            UpdateMainView();
+    bool            IsScanning() const noexcept { return m_IsScanning; }
     
     ftxui::Element  Render() override;
     bool            OnEvent(ftxui::Event event) override;
     
     void SetStartingPath(const FileSystem::Path& path) noexcept { m_StartingPath = path; }
     void SetShowAllFiles(bool showAll) noexcept { m_ShowAllFiles = showAll; }
+    void SetBuildNameIndex(bool build) noexcept { m_BuildNameIndex = build; }
+    void SetTreemapDepth(uint32_t depth) noexcept { m_Treemap.SetMaxDepth(depth); }
+    void SetHotPathThreshold(double threshold) noexcept { m_HotPathThreshold = threshold; }
+    void SetScanThreadCount(std::size_t count) noexcept { m_ScanThreadCount = count; }
+    void SetFileNodeLimit(uint32_t count) noexcept { m_FileNodeLimit = count; }
+    void SetMemoryLimit(uint64_t bytes) noexcept { m_MemoryLimit = bytes; }
+    void SetImportFile(const FileSystem::Path& file) noexcept { m_ImportFile = file; }
+    void SetDaemonSocket(const std::string& socketPath) { m_DaemonSocketPath = socketPath; }
+    void SetSnapshotFile(const FileSystem::Path& file) { m_SnapshotFile = file; }
+    void SetVirtualFileSystem(std::shared_ptr<VirtualFileSystem> virtualFileSystem) noexcept { m_VirtualFileSystem = std::move(virtualFileSystem); }
+    void SetDiffFiles(const FileSystem::Path& oldFile, const FileSystem::Path& newFile) { m_DiffBaseFile = oldFile; m_DiffNewFile = newFile; }
 };
 
 
@@ -0,0 +1,132 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  BatchExporter.hpp                                               */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#ifndef BatchExporter_hpp
+#define BatchExporter_hpp
+
+// Headless scan that streams one record per directory as soon as its subtree
+// is complete (children before their parent). Only the open directories with
+// the names of their subdirectories are kept in memory, output is written in
+// fixed size chunks. Listings of the next subdirectories are read ahead on a
+// pool of workers, sizes and hard links are counted like the scanner does.
+class BatchExporter
+{
+public:
+    enum class OutputFormat : uint8_t
+    {
+        JSON = 0,   // One array of records
+        NDJSON = 1, // One record per line
+        CSV = 2,
+        FOLDED = 3, // Folded stacks for flame graphs, only from a scanned tree
+    };
+    
+private:
+    // Listing of one directory, read by a worker
+    struct Listing
+    {
+        std::string                             path = "";
+        std::vector<std::string>                names;
+        std::vector<DirectoryTree::Entry>       entries;
+        std::vector<VirtualFileSystem::FileId>  ids;
+        
+        bool        isComplete = false;
+        int         error = 0;
+        bool        isOutOfMemory = false;
+        bool        isReady = false; // Guarded by m_ListingMutex
+    };
+    
+    struct Frame
+    {
+        std::vector<std::pair<std::string, uintmax_t>>  subdirectories; // Name and own size
+        std::size_t                                     nextSubdirectory = 0;
+        std::size_t                                     nextReadAhead = 0;
+        std::deque<std::shared_ptr<Listing>>            readAhead; // Of the subdirectories from nextSubdirectory on
+        
+        std::size_t                         pathLength = 0; // Length of the directory path in m_CurrentPath
+        uintmax_t                           size = 0;
+        uintmax_t                           count = 0;
+        bool                                hasError = false;
+    };
+    
+    static constexpr std::size_t READ_AHEAD_PER_THREAD = 2;
+    static constexpr std::size_t CHUNK_SIZE = 1024 * 1024;
+    
+    OutputFormat    m_Format = OutputFormat::NDJSON;
+    std::FILE*      m_Output = nullptr;
+    std::string     m_Buffer = "";
+    std::string     m_CurrentPath = "";
+    uintmax_t       m_RecordCount = 0;
+    double          m_FoldedThreshold = 0.0; // Share of the total size
+    
+    Error           m_LastError;
+    
+    std::mutex                  m_ListingMutex;
+    std::condition_variable     m_ListingReady;
+    
+    void            ReadListing(VirtualFileSystem& fileSystem, Listing& listing);
+    void            WaitForListing(Listing& listing);
+    static void     AddListing(Listing& listing, Frame& out_frame, FileSystem::InodeSet& inodes); // May throw std::bad_alloc
+    
+    bool            OpenOutput(const FileSystem::Path& outputFile);
+    bool            CloseOutput(bool isWriteOk);
+    
+    void            WriteBegin();
+    void            WriteRecord(uintmax_t size, uintmax_t count, bool hasError); // Of m_CurrentPath
+    void            WriteEnd();
+    bool            Flush();
+    
+    bool            ExportFolded(const DirectoryTree& tree, const FileSystem::Path& outputFile); // May throw std::bad_alloc
+    static void     AppendFrameName(std::string& out, std::string_view name);
+    
+public:
+    explicit BatchExporter(OutputFormat format) noexcept : m_Format(format) {}
+    
+    // Scan path and write the records to outputFile, or stdout if empty. Totals are the
+    // same as of Export() with a scanned tree. Directories which can't be read completely,
+    // including entries which can't be examined, are flagged in their record.
+    bool            Run(const FileSystem::Path& path, const FileSystem::Path& outputFile, const std::atomic<bool>& stop, std::size_t threadCount = std::thread::hardware_concurrency()); // May throw std::bad_alloc
+    
+    // Same records from an already scanned tree, e.g. a mapped snapshot. Caller holds a shared lock on the tree.
+    // FOLDED writes a line "root;dir;file size" per entry in depth-first order, and one per directory
+    // with its own size. Entries smaller than the threshold are added to their directory's line.
+    bool            Export(const DirectoryTree& tree, const FileSystem::Path& outputFile); // May throw std::bad_alloc
+    
+    // Share (0..1) of the total size an entry needs to get its own folded stack line
+    void            SetFoldedThreshold(double minShare) noexcept { m_FoldedThreshold = minShare; }
+    
+    Error           GetLastError() const noexcept { return m_LastError; }
+    
+    static bool     ParseFormat(const std::string& name, OutputFormat& out_format) noexcept;
+};
+
+#endif /* BatchExporter_hpp */
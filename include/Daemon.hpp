@@ -0,0 +1,105 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  Daemon.hpp                                                      */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#ifndef Daemon_hpp
+#define Daemon_hpp
+
+// Background indexer: scans a directory tree once, keeps it in memory and serves
+// it to attached UIs over a Unix domain socket (see DaemonProtocol.hpp).
+// The served tree is refreshed periodically in place (see FileSystem::RefreshDirectoryTree()):
+// only directories with added, removed or renamed entries are read again, the files of the
+// others are examined where they are. Clients see the changes by the incremented generation.
+// Only if a scan failed or ran out of memory, the next one is a full scan into a new tree.
+class Daemon
+{
+private:
+    struct Connection
+    {
+        int                 fd = -1;
+        std::thread         thread;
+        std::atomic<bool>   isDone = false;
+    };
+    
+    FileSystem::Path        m_Path = "";
+    std::string             m_SocketPath = "";
+    std::chrono::seconds    m_RefreshInterval{0}; // 0: Never
+    std::size_t             m_ThreadCount = std::thread::hardware_concurrency();
+    uint32_t                m_FileNodeLimit = FileSystem::ALL_FILES; // See FileSystem::SetFileNodeLimit()
+    uint64_t                m_MemoryLimit = 0; // Bytes, 0: None, see FileSystem::SetMemoryLimit()
+    FileSystem::Path        m_PublishFile = ""; // Snapshot written after every complete scan
+    FileSystem::Path        m_HistoryFile = ""; // Large directories appended after every complete scan
+    uintmax_t               m_HistoryMinSize = 0;
+    FileSystem::Path        m_PrometheusFile = ""; // Metrics written after every complete scan
+    uint32_t                m_PrometheusMaxDepth = 0;
+    uintmax_t               m_PrometheusMinSize = 0;
+    
+    // Current tree, refreshed in place or replaced as a whole by a full scan
+    std::mutex                      m_TreeMutex;
+    std::shared_ptr<DirectoryTree>  m_Tree;
+    uint64_t                        m_Generation = 0;
+    std::atomic<bool>               m_IsScanning = false;
+    
+    // Held shared by every request, exclusively to move nodes (compacting, dropping files)
+    // and increment the generation, so no request mixes node indices of both layouts
+    std::shared_mutex               m_LayoutMutex;
+    
+    std::atomic<bool>               m_Stop = false;
+    std::mutex                      m_StopMutex;
+    std::condition_variable         m_StopCondition;
+    
+    std::list<Connection>           m_Connections;
+    
+    void            ScanTask();
+    void            ConnectionTask(Connection& connection);
+    void            HandleRequest(const std::string& request, std::string& out_response); // May throw std::bad_alloc
+    void            JoinConnections(bool all);
+    void            RequestStop();
+    
+    int             CreateListenSocket(); // -1 on error
+    
+    static void     Log(const std::string& message);
+    
+public:
+    Daemon(const FileSystem::Path& path, const std::string& socketPath, std::chrono::seconds refreshInterval, std::size_t threadCount);
+    
+    // Serve until SIGINT or SIGTERM, returns the exit code
+    int             Run();
+    
+    void            SetPublishFile(const FileSystem::Path& file) { m_PublishFile = file; }
+    void            SetHistoryFile(const FileSystem::Path& file, uintmax_t minSize) { m_HistoryFile = file; m_HistoryMinSize = minSize; }
+    void            SetPrometheusFile(const FileSystem::Path& file, uint32_t maxDepth, uintmax_t minSize) { m_PrometheusFile = file; m_PrometheusMaxDepth = maxDepth; m_PrometheusMinSize = minSize; }
+    void            SetFileNodeLimit(uint32_t count) noexcept { m_FileNodeLimit = count; }
+    void            SetMemoryLimit(uint64_t bytes) noexcept { m_MemoryLimit = bytes; }
+};
+
+#endif /* Daemon_hpp */
@@ -0,0 +1,108 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  DaemonClient.hpp                                                */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#ifndef DaemonClient_hpp
+#define DaemonClient_hpp
+
+// Connection of the UI to a running daemon. The daemon's tree is mirrored into a
+// local DirectoryTree on demand: only directories that are shown get their children
+// loaded, many directories per request, and of large ones only the largest children
+// (a window, see DirectoryTree::AddMirroredChildren()). Local node indices differ from
+// the daemon's. Every call waits at most REPLY_TIMEOUT for the daemon. Not thread safe.
+class DaemonClient
+{
+public:
+    static constexpr uint32_t ALL_CHILDREN = UINT32_MAX;
+    
+    struct Info
+    {
+        uint64_t                    generation = 0;
+        bool                        isScanning = false;
+        uint64_t                    nodeCount = 0;
+        std::string                 rootPath = "";
+        DaemonProtocol::Record      root; // Only valid if nodeCount > 0
+    };
+    
+private:
+    static constexpr std::size_t MAX_SUBTREE_NODES = 20000; // Loaded per LoadSubtree() call
+    
+    // A daemon not answering in time is dropped, the stream would be out of step
+    static constexpr std::chrono::seconds REPLY_TIMEOUT{10};
+    
+    int             m_Socket = -1;
+    uint64_t        m_Generation = 0;
+    bool            m_IsStale = false;
+    std::string     m_LastErrorMessage = "";
+    
+    // Per local node: its index in the daemon's tree, its number of children there and
+    // how many of them (the largest) are loaded
+    std::vector<DirectoryTree::NodeIndex>   m_RemoteNodes;
+    std::vector<uint32_t>                   m_ChildCounts;
+    std::vector<uint32_t>                   m_LoadedCounts;
+    uint64_t                                m_LoadedRecordCount = 0;
+    
+    std::string     m_Request = "";
+    std::string     m_Response = "";
+    
+    bool            Exchange();
+    bool            ReadResponseHeader(DaemonProtocol::Reader& reader);
+    
+public:
+    DaemonClient() = default;
+    ~DaemonClient();
+    
+    DaemonClient(const DaemonClient&) = delete;
+    DaemonClient& operator=(const DaemonClient&) = delete;
+    
+    bool            Connect(const std::string& socketPath);
+    void            Disconnect() noexcept;
+    
+    bool            QueryInfo(Info& out_info); // May throw std::bad_alloc
+    
+    // Replace the content of tree with the root of the daemon's current tree, without its children
+    bool            Attach(DirectoryTree& tree, bool& out_isScanning); // May throw std::bad_alloc
+    
+    // Make sure the window largest children of the nodes are in the tree. Only this thread may
+    // modify the tree, others may read it with a shared lock. Don't hold a lock on the tree.
+    bool            LoadChildren(DirectoryTree& tree, const std::vector<DirectoryTree::NodeIndex>& nodes, uint32_t window = ALL_CHILDREN); // May throw std::bad_alloc
+    bool            LoadSubtree(DirectoryTree& tree, DirectoryTree::NodeIndex node, uint32_t depth, uint32_t window = ALL_CHILDREN); // May throw std::bad_alloc
+    bool            LoadHeaviestPath(DirectoryTree& tree, DirectoryTree::NodeIndex node, double minShare); // May throw std::bad_alloc
+    
+    bool            IsConnected() const noexcept { return m_Socket >= 0; }
+    bool            IsStale() const noexcept { return m_IsStale; } // Daemon swapped in a refreshed tree, Attach() again
+    uint64_t        GetGeneration() const noexcept { return m_Generation; }
+    uint64_t        GetLoadedRecordCount() const noexcept { return m_LoadedRecordCount; } // Grows with every load
+    std::string     GetLastErrorMessage() const { return m_LastErrorMessage; }
+};
+
+#endif /* DaemonClient_hpp */
@@ -0,0 +1,118 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  DaemonProtocol.hpp                                              */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#ifndef DaemonProtocol_hpp
+#define DaemonProtocol_hpp
+
+// Binary protocol between the daemon and attached clients over a Unix domain socket.
+// Every message is a frame: 32 bit little endian payload length, then the payload.
+// Integers in payloads are LEB128 varints, strings are length prefixed.
+//
+// Request:  type (1 byte), fields
+// Response: status (1 byte), generation, fields
+//
+// INFO:     -> version, isScanning (1 byte), node count, root path, record of the root
+// CHILDREN: generation, n, n x (node, offset, limit) -> for each node: child count,
+//           record count r, then r records of its children starting at offset
+//
+// Children are ordered by size, largest first, so a client can load just the part it shows.
+// A reply is cut once it reaches MAX_REPLY_SIZE, the remaining nodes get fewer or no
+// records and are requested again from their new offset. The first node of a request
+// always gets at least one record, so every request makes progress.
+//
+// Node indices are those of the daemon's tree. They stay valid until the generation
+// changes (the tree was refreshed), requests for an old one get STALE_GENERATION.
+namespace DaemonProtocol
+{
+    constexpr uint64_t VERSION = 3;
+    constexpr uint32_t MAX_FRAME_SIZE = 64 * 1024 * 1024;
+    constexpr uint32_t MAX_REPLY_SIZE = 4 * 1024 * 1024;    // Records are added up to this size
+    constexpr uint64_t MAX_REQUEST_NODES = 4096;            // Directories per CHILDREN request
+    constexpr uint64_t MAX_PAGE_RECORDS = 65536;            // Children per directory and reply
+    
+    enum class RequestType : uint8_t
+    {
+        INFO = 1,
+        CHILDREN = 2,
+    };
+    
+    enum class Status : uint8_t
+    {
+        OK = 0,
+        INVALID_REQUEST = 1,
+        STALE_GENERATION = 2,
+    };
+    
+    // One node with its totals
+    struct Record
+    {
+        DirectoryTree::NodeIndex    node = DirectoryTree::INVALID_NODE;
+        uint32_t                    childCount = 0;
+        std::string                 name = "";
+        DirectoryTree::Entry        entry; // Name is not set
+    };
+    
+    // Sequential reader of a payload, any read past the end marks it as failed
+    class Reader
+    {
+    private:
+        std::string_view    m_Data;
+        std::size_t         m_Position = 0;
+        bool                m_IsOk = true;
+        
+    public:
+        explicit Reader(std::string_view data) noexcept : m_Data(data) {}
+        
+        uint8_t             ReadByte() noexcept;
+        uint64_t            ReadVarint() noexcept;
+        std::string_view    ReadString() noexcept;
+        bool                ReadRecord(Record& out_record);
+        
+        bool                IsOk() const noexcept { return m_IsOk; }
+        bool                IsAtEnd() const noexcept { return m_Position >= m_Data.size(); }
+        std::size_t         GetPosition() const noexcept { return m_Position; }
+    };
+    
+    // $XDG_RUNTIME_DIR/dirstats.sock, or /tmp/dirstats-<uid>.sock
+    std::string GetDefaultSocketPath();
+    
+    void AppendVarint(std::string& out, uint64_t value);
+    void AppendString(std::string& out, std::string_view text);
+    void AppendRecord(std::string& out, const DirectoryTree& tree, DirectoryTree::NodeIndex node); // Caller holds a shared lock on the tree
+    
+    // Blocking, false on error or closed connection
+    bool SendFrame(int fd, const std::string& payload);
+    bool ReceiveFrame(int fd, std::string& out_payload);
+};
+
+#endif /* DaemonProtocol_hpp */
@@ -0,0 +1,124 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  Deleter.hpp                                                     */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#ifndef Deleter_hpp
+#define Deleter_hpp
+
+// Deletes entries of a DirectoryTree from disk on a pool of worker threads.
+// Directories are processed in parallel with fd relative unlinkat(), large
+// directories are split into batches. Removed entries are subtracted from the
+// tree right away, so no rescan is needed afterwards.
+// Subdirectories wait in a queue and are processed depth first. Descriptors of
+// directories waiting for their children are closed when too many are open
+// and reopened on demand.
+class Deleter
+{
+private:
+    struct DirectoryState
+    {
+        int                                 fd = -1;    // Guarded by m_DirectoryMutex
+        std::size_t                         users = 0;  // Guarded by m_DirectoryMutex, closed only without users
+        std::list<DirectoryState*>::iterator    openPosition;
+        
+        std::string                         name = "";
+        std::filesystem::path               path;       // Only for the directory containing a target
+        DirectoryTree::NodeIndex            node = DirectoryTree::INVALID_NODE;
+        std::shared_ptr<DirectoryState>     parent = nullptr;
+        
+        std::atomic<std::size_t>            pending = 1; // Listing of this directory, running batches and subdirectories
+        bool                                isTargetParent = false; // Directory containing a target, is not removed
+        bool                                isOpened = false;       // Opening for the listing succeeded
+    };
+    
+    static constexpr std::size_t MAX_OPEN_DIRECTORIES = 256;
+    static constexpr std::size_t BATCH_SIZE = 1024;
+    
+    DirectoryTree&              m_Tree;
+    std::thread                 m_ControlThread;
+    
+    std::atomic<bool>           m_IsRunning = false;
+    std::atomic<bool>           m_Stop = false;
+    std::atomic<uintmax_t>      m_RemovedEntries = 0;
+    std::atomic<uintmax_t>      m_RemovedBytes = 0;
+    std::atomic<uintmax_t>      m_ErrorCount = 0;
+    
+    // Open directory descriptors, least recently used at the back
+    std::mutex                                          m_DirectoryMutex;
+    std::list<DirectoryState*>                          m_OpenDirectories;
+    std::vector<std::shared_ptr<DirectoryState>>        m_PendingDirectories; // Newest at the back
+    
+    std::mutex                  m_ErrorMutex;
+    std::string                 m_LastErrorMessage = "";
+    
+    std::function<void()>       m_OnFinishedFunction;
+    
+    // Destroyed first, so no worker outlives the members above
+    ThreadPool                  m_Pool;
+    
+    void            ControlTask(std::vector<DirectoryTree::NodeIndex> nodes);
+    void            RecordError(const std::string& name, const std::string& message);
+    
+    static std::string GetSystemErrorMessage(); // Message for the current errno
+    
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_APPLE)
+    void            QueueDirectory(std::shared_ptr<DirectoryState> state);
+    void            ProcessNewestDirectory();
+    void            ProcessDirectory(const std::shared_ptr<DirectoryState>& state);
+    void            RemoveBatch(const std::shared_ptr<DirectoryState>& state, const std::vector<std::pair<std::string, DirectoryTree::NodeIndex>>& files);
+    void            ReleaseDirectory(std::shared_ptr<DirectoryState> state);
+    
+    // Descriptor of the directory, reopened if it was closed. Returns -1 and sets errno on error.
+    int             AcquireDescriptor(DirectoryState& state);
+    void            ReleaseDescriptor(DirectoryState& state);
+    void            CloseDescriptor(DirectoryState& state); // Caller must hold m_DirectoryMutex
+#endif
+    
+public:
+    explicit Deleter(DirectoryTree& tree, std::size_t threadCount = std::thread::hardware_concurrency());
+    ~Deleter();
+    
+    // Delete the given nodes in background. Returns false if a deletion is already running.
+    bool            Start(const std::vector<DirectoryTree::NodeIndex>& nodes);
+    void            Stop() noexcept { m_Stop = true; }
+    
+    bool            IsRunning() const noexcept { return m_IsRunning; }
+    uintmax_t       GetRemovedEntries() const noexcept { return m_RemovedEntries; }
+    uintmax_t       GetRemovedBytes() const noexcept { return m_RemovedBytes; }
+    uintmax_t       GetErrorCount() const noexcept { return m_ErrorCount; }
+    std::string     GetLastErrorMessage();
+    
+    // Called from the background thread when all deletions are done
+    void            SetOnFinishedFunction(std::function<void()> func) noexcept { m_OnFinishedFunction = func; }
+};
+
+#endif /* Deleter_hpp */
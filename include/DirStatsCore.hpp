@@ -0,0 +1,154 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  DirStatsCore.hpp                                                */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#ifndef DirStatsCore_hpp
+#define DirStatsCore_hpp
+
+// Everything but the UI: scanner, tree, aggregation, exports and persistence.
+// Built as the dirstats_core library, which needs no FTXUI, CLI11 or GTK.
+// Programs embedding it include this header; C programs use DirStatsCore.h.
+
+// *******************************************************************
+// Pre-processor settings
+
+// Enable printing of platform specific error code and message,
+// additionally to the platform independent ones
+#define DST_PRINT_PLATFORM_SPECIFIC_ERROR_DESCRIPTION
+
+#include "PlatformMacros.hpp"
+
+// *******************************************************************
+// System includes
+#include <iostream>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <locale>
+#include <codecvt>
+#include <vector>
+#include <array>
+#include <unordered_map>
+#include <map>
+#include <set>
+#include <tuple>
+#include <string_view>
+#include <span>
+#include <memory>
+#include <algorithm>
+#include <numeric>
+#include <bit>
+#include <cstring>
+#include <cmath>
+#include <iomanip>
+#include <functional>
+#include <system_error>
+#include <filesystem>
+//#include <future>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <unordered_set>
+#include <ctime>
+#include <chrono>
+#include <csignal>
+
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_APPLE)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <sys/xattr.h>
+#include <pwd.h>
+#include <grp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#endif
+
+#if defined(PLATFORM_LINUX) && defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+// USDT probes, the semaphores tell if a tracer is attached
+#ifdef DST_USDT_PROBES
+#define _SDT_HAS_SEMAPHORES 1
+#include <sys/sdt.h>
+#endif
+
+#ifdef PLATFORM_WINDOWS
+#define NOMINMAX
+#include <Windows.h>
+#undef ERROR
+#endif
+
+// *******************************************************************
+// Project includes
+#include "Error.hpp"
+#include "Format.hpp"
+#include "AllocationCounter.hpp"
+#include "Tracer.hpp"
+#include "Probes.hpp"
+#include "MemoryAccounting.hpp"
+#include "NamePool.hpp"
+#include "DirectoryTree.hpp"
+#include "TrigramIndex.hpp"
+#include "ThreadPool.hpp"
+#include "ScanStatistics.hpp"
+#include "ScanProgress.hpp"
+#include "ProcessStats.hpp"
+#include "EntryDetails.hpp"
+#include "Deleter.hpp"
+#include "VirtualFileSystem.hpp"
+#include "MemoryFileSystem.hpp"
+#include "FileSystem.hpp"
+#include "BatchExporter.hpp"
+#include "DiskUsage.hpp"
+#include "NcduImporter.hpp"
+#include "TreeSnapshot.hpp"
+#include "TreeDiff.hpp"
+#include "HistoryStore.hpp"
+#include "PrometheusExporter.hpp"
+#include "DaemonProtocol.hpp"
+#include "Daemon.hpp"
+#include "DaemonClient.hpp"
+#include "dirstats/DirStatsCore.h"
+
+#endif /* DirStatsCore_hpp */
@@ -0,0 +1,205 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  DirectoryTree.hpp                                               */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#ifndef DirectoryTree_hpp
+#define DirectoryTree_hpp
+
+// In-memory tree of a scanned directory. Nodes live in one array and the
+// children of a directory are stored contiguously, so a directory is added in
+// one go when its listing is complete. Sizes and counts are summed up to the
+// root while adding, so totals are always up to date during a running scan.
+class DirectoryTree
+{
+public:
+    using NodeIndex = uint32_t;
+    static constexpr NodeIndex INVALID_NODE = UINT32_MAX;
+    
+    enum class NodeType : uint8_t
+    {
+        REGULAR_FILE = 0,
+        DIRECTORY,
+        SYMLINK,
+        OTHER
+    };
+    
+    struct Node
+    {
+        NamePool::NameID    name = NamePool::INVALID_NAME;
+        NodeIndex           parent = INVALID_NODE;
+        NodeIndex           firstChild = INVALID_NODE;
+        uint32_t            childCount = 0;
+        NodeIndex           heaviestChild = INVALID_NODE; // Child with the largest size
+        uint32_t            changeStamp = 0;    // Directories: low bits of the status change time in ns, see FileSystem::RefreshDirectoryTree()
+        
+        uintmax_t           size = 0;           // Apparent size, recursive for directories
+        uintmax_t           allocatedSize = 0;  // Size on disk, recursive for directories
+        uintmax_t           count = 0;          // Number of entries below this node
+        int64_t             lastWriteTime = 0;  // Seconds since epoch
+        
+        NodeType            type = NodeType::REGULAR_FILE;
+        bool                hasError = false;   // Directory could not be read completely
+        bool                isRemoved = false;  // Deleted from disk, kept in the array but skipped everywhere
+        bool                isHardLink = false; // Further link to a file counted elsewhere, has no size
+        uint16_t            maxDepth = 0;       // Levels of directories below this node
+    };
+    
+    // One entry of a directory listing, input for AddChildren()
+    struct Entry
+    {
+        std::string_view    name;
+        NodeType            type = NodeType::REGULAR_FILE;
+        uintmax_t           size = 0;
+        uintmax_t           allocatedSize = 0;
+        int64_t             lastWriteTime = 0;
+        bool                isHardLink = false;
+        bool                hasError = false;
+        uint32_t            changeStamp = 0;
+        
+        // Totals of directories, only used by AddMirroredChildren()
+        uintmax_t           count = 0;
+        uint16_t            maxDepth = 0;
+    };
+    
+    // Files of a listing only counted into the totals of their directory, without nodes
+    struct FoldedFiles
+    {
+        uintmax_t           size = 0;
+        uintmax_t           allocatedSize = 0;
+        uintmax_t           count = 0;
+    };
+    
+    // Children of a directory added with AddDetachedChildren()
+    struct ChildBlock
+    {
+        NodeIndex           firstChild = INVALID_NODE;
+        uint32_t            childCount = 0;
+    };
+    
+private:
+    mutable std::shared_mutex   m_Mutex;
+    
+    std::vector<Node>           m_Nodes;
+    NamePool                    m_Names;
+    
+    // Nodes of a mapped snapshot, used instead of m_Nodes while the mapping is set
+    std::span<const Node>       m_MappedNodes;
+    std::shared_ptr<const void> m_Mapping = nullptr;
+    
+    // Nodes no longer reachable from the root, freed by Compact()
+    std::size_t                 m_GarbageCount = 0;
+    
+    void        PropagateUp(NodeIndex node, uintmax_t size, uintmax_t allocatedSize, uintmax_t count) noexcept;
+    void        UpdateHeaviestChild(NodeIndex node, NodeIndex grownChild) noexcept;
+    void        SubtractUp(NodeIndex node, NodeIndex shrunkChild, uintmax_t size, uintmax_t allocatedSize, uintmax_t count) noexcept;
+    // Totals of child changed by the differences (modulo 2^64), shrunk if isShrunk
+    void        AdjustUp(NodeIndex child, uint16_t childOldDepth, uintmax_t size, uintmax_t allocatedSize, uintmax_t count, bool isShrunk) noexcept;
+    void        RecomputeChildAggregates(NodeIndex node) noexcept;
+    std::size_t MarkSubtreeRemoved(NodeIndex node); // Returns the number of nodes marked
+    std::size_t CopyReachable(bool keepFiles); // May throw std::bad_alloc
+    void        LinkChildren(NodeIndex node, const ChildBlock& block) noexcept;
+    
+public:
+    DirectoryTree() = default;
+    
+    // Modification. These lock the tree by themselves.
+    void        Clear();
+    NodeIndex   CreateRoot(const std::string& path, uintmax_t size = 0, uintmax_t allocatedSize = 0); // May throw std::bad_alloc
+    NodeIndex   AddChildren(NodeIndex parent, const std::vector<Entry>& entries, const FoldedFiles& folded); // Once per directory. May throw std::bad_alloc
+    void        SetError(NodeIndex node) noexcept;
+    
+    // Bottom-up construction, for imports listing a directory only after the contents of
+    // its subdirectories. Adds a block of entries without parent, the directories in it
+    // get the children in childBlocks (one per entry) and their totals.
+    NodeIndex   AddDetachedChildren(const std::vector<Entry>& entries, const std::vector<ChildBlock>& childBlocks); // May throw std::bad_alloc
+    void        AttachChildren(NodeIndex node, const ChildBlock& block) noexcept;
+    
+    // Partial copy of another tree (e.g. of the daemon), loaded one directory at a time.
+    // Entries carry their final totals, nothing is summed up. The block gets childCount
+    // nodes (at least the entries), those without entry are placeholders skipped like
+    // removed nodes until FillMirroredChildren() loads them from offset on.
+    NodeIndex   AddMirroredChildren(NodeIndex parent, const std::vector<Entry>& entries, std::size_t childCount); // Once per directory. May throw std::bad_alloc
+    void        FillMirroredChildren(NodeIndex parent, std::size_t offset, const std::vector<Entry>& entries); // May throw std::bad_alloc
+    void        SetMirroredTotals(NodeIndex node, const Entry& totals) noexcept;
+    
+    // Use nodes and names of a mapped snapshot (see TreeSnapshot) without copying them.
+    // The tree is read-only then, until Clear() or CreateRoot(). It keeps mapping alive.
+    void        AttachMapped(std::span<const Node> nodes, const char* names, const uint64_t* nameOffsets, std::size_t nameCount, std::shared_ptr<const void> mapping);
+    
+    // Nodes deleted from disk. All nodes must have the same parent. Their sizes are
+    // subtracted up to the root and they are marked as removed.
+    void        RemoveNodes(const std::vector<NodeIndex>& siblings); // May throw std::bad_alloc
+    
+    // Keep only the directories, to free memory. Their totals still include the files.
+    // All node indices change, nobody may hold one. Returns the number of nodes dropped.
+    std::size_t DropFileNodes(); // May throw std::bad_alloc
+    
+    // Refresh of a directory whose listing changed (see FileSystem::RefreshDirectoryTree()).
+    // self holds its own size, time and change stamp. The children get a new block at the end:
+    // subdirectories still there (same name) keep their subtree, all other old children are
+    // removed. Removed nodes stay in the array, unreachable, so held indices stay valid.
+    // Kept subdirectories then come after their children, Compact() restores the order
+    // TreeSnapshot needs. out_isKept tells for every entry if it is such a subdirectory.
+    // Returns the first child.
+    NodeIndex   ReplaceChildren(NodeIndex node, const Entry& self, const std::vector<Entry>& entries, const FoldedFiles& folded, std::vector<bool>& out_isKept); // May throw std::bad_alloc
+    
+    // New size, allocated size and time of files, whose listing didn't change
+    void        UpdateEntries(const std::vector<std::pair<NodeIndex, Entry>>& updates) noexcept;
+    
+    // Free the removed and unreachable nodes. All node indices change, nobody may hold one.
+    std::size_t Compact(); // May throw std::bad_alloc
+    std::size_t GetGarbageCount() const noexcept { return m_GarbageCount; }
+    
+    // Read access. Hold a shared lock on GetMutex() while another thread may modify the tree.
+    std::shared_mutex&  GetMutex() const noexcept { return m_Mutex; }
+    
+    NodeIndex           GetRoot() const noexcept { return (GetNodeCount() == 0) ? INVALID_NODE : 0; }
+    std::size_t         GetNodeCount() const noexcept { return m_Mapping ? m_MappedNodes.size() : m_Nodes.size(); }
+    const Node&         GetNode(const NodeIndex node) const noexcept { return m_Mapping ? m_MappedNodes[node] : m_Nodes[node]; }
+    std::string_view    GetName(const NodeIndex node) const noexcept { return m_Names.Get(GetNode(node).name); }
+    bool                IsMapped() const noexcept { return m_Mapping != nullptr; }
+    const NamePool&     GetNamePool() const noexcept { return m_Names; }
+    void                AccountMemory(MemoryAccounting& accounting) const; // May throw std::bad_alloc
+    
+    std::filesystem::path   GetPath(NodeIndex node) const;
+    bool                    IsAncestor(NodeIndex ancestor, NodeIndex node) const noexcept;
+    void                    GetChildren(NodeIndex node, std::vector<NodeIndex>& out_children) const;
+    
+    // Entries directly in node which were only counted into its totals (see FoldedFiles), O(children)
+    uintmax_t               GetFoldedCount(NodeIndex node) const noexcept;
+    
+    // Follow the heaviest children down from node, as long as a child holds at least
+    // minShare (0..1) of its parent's size. O(depth), node itself is not included.
+    void                    GetHeaviestPath(NodeIndex node, double minShare, std::vector<NodeIndex>& out_path) const;
+};
+
+#endif /* DirectoryTree_hpp */
@@ -0,0 +1,87 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  DiskUsage.hpp                                                   */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#ifndef DiskUsage_hpp
+#define DiskUsage_hpp
+
+// du(1) compatible output of the scanned tree, for use in scripts.
+// Uses the parallel scanner, sizes and formats follow GNU du.
+class DiskUsage
+{
+public:
+    // How sizes are printed. Like du, the last of the options given counts.
+    enum class Unit : uint8_t
+    {
+        KILOBYTES = 0,  // -k, the default
+        BYTES,          // -b, also means --apparent-size
+        MEGABYTES,      // -m
+        HUMAN_READABLE, // -h, powers of 1024
+        SI              // --si, powers of 1000
+    };
+    
+    struct Options
+    {
+        bool            summarize = false;      // -s, same as max depth 0
+        int32_t         maxDepth = -1;          // -d, negative for no limit
+        bool            all = false;            // -a, files too
+        bool            apparentSize = false;   // --apparent-size instead of allocated size, set by -b too
+        Unit            unit = Unit::KILOBYTES;
+        bool            nullTerminated = false; // -0
+        bool            total = false;          // -c
+        std::size_t     threadCount = std::thread::hardware_concurrency();
+    };
+    
+private:
+    static constexpr std::size_t CHUNK_SIZE = 256 * 1024;
+    
+    Options         m_Options;
+    uintmax_t       m_BlockSize = 1024;
+    std::string     m_Buffer = "";
+    bool            m_HasWriteError = false;
+    
+    // Everything counted so far, with several paths each entry is only counted once
+    FileSystem::InodeSet    m_SeenInodes;
+    
+    void            PrintTree(const DirectoryTree& tree, const std::string& rootPath, bool& out_hasError);
+    void            PrintLine(uintmax_t size, const std::string& path);
+    std::string     FormatSize(uintmax_t size) const;
+    void            Flush();
+    
+public:
+    explicit DiskUsage(const Options& options);
+    
+    // Returns the exit code, 1 if any path or directory could not be read or writing the output failed
+    int             Run(const std::vector<std::string>& paths);
+};
+
+#endif /* DiskUsage_hpp */
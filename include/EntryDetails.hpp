@@ -0,0 +1,137 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  EntryDetails.hpp                                                */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#ifndef EntryDetails_hpp
+#define EntryDetails_hpp
+
+// Loads details of directory entries (owner, permissions, timestamps, ...) on a
+// small thread pool, so slow name service lookups never block the UI.
+// Results are kept in a LRU cache keyed by device and inode.
+class EntryDetails
+{
+public:
+    struct Details
+    {
+        bool            isValid = false;
+        std::string     errorMessage = "";
+        
+        std::string     owner = "";
+        std::string     group = "";
+        uint32_t        userID = 0;
+        uint32_t        groupID = 0;
+        std::string     permissions = "";   // e.g. "drwxr-xr-x"
+        
+        int64_t         accessTime = -1;    // Seconds since epoch, -1 if unknown
+        int64_t         modificationTime = -1;
+        int64_t         changeTime = -1;
+        int64_t         birthTime = -1;
+        
+        uint64_t        device = 0;
+        uint64_t        inode = 0;
+        uint64_t        linkCount = 0;
+        uintmax_t       apparentSize = 0;
+        uintmax_t       allocatedSize = 0;
+        uint32_t        xattrCount = 0;
+    };
+    
+private:
+    struct Key
+    {
+        uint64_t device = 0;
+        uint64_t inode = 0;
+        
+        bool operator==(const Key& other) const noexcept { return device == other.device && inode == other.inode; }
+    };
+    
+    struct KeyHash
+    {
+        std::size_t operator()(const Key& key) const noexcept { return std::hash<uint64_t>()(key.inode ^ (key.device << 32)); }
+    };
+    
+    struct PendingRequest
+    {
+        DirectoryTree::NodeIndex    node = DirectoryTree::INVALID_NODE;
+        std::filesystem::path       path;
+        uint64_t                    generation = 0;
+    };
+    
+    struct Failure
+    {
+        Details                                 details;
+        std::chrono::steady_clock::time_point   time;
+    };
+    
+    using LRUList = std::list<std::pair<Key, Details>>;
+    
+    static constexpr std::size_t CACHE_CAPACITY = 4096;
+    static constexpr std::size_t MAX_PENDING = 16;
+    static constexpr std::chrono::seconds FAILURE_RETRY_INTERVAL = std::chrono::seconds(2);
+    
+    std::mutex                                                      m_Mutex;
+    LRUList                                                         m_LRU; // Most recently used first
+    std::unordered_map<Key, LRUList::iterator, KeyHash>             m_LRUIndex;
+    std::unordered_map<DirectoryTree::NodeIndex, Key>               m_NodeKeys;
+    std::unordered_map<DirectoryTree::NodeIndex, Failure>           m_Failures; // Shown for a while, then retried
+    std::deque<PendingRequest>                                      m_Pending; // Newest at the back
+    std::unordered_set<DirectoryTree::NodeIndex>                    m_Queued;
+    uint64_t                                                        m_Generation = 0; // Incremented by Clear()
+    
+    // Name service results
+    std::mutex                                      m_NameMutex;
+    std::unordered_map<uint32_t, std::string>       m_UserNames;
+    std::unordered_map<uint32_t, std::string>       m_GroupNames;
+    
+    std::function<void()>   m_OnReadyFunction;
+    
+    // Destroyed first, so no worker outlives the members above
+    ThreadPool              m_Pool;
+    
+    void            ProcessNewestRequest();
+    void            LoadDetails(const std::filesystem::path& path, Details& out_details, Key& out_key);
+    std::string     GetUserName(uint32_t userID);
+    std::string     GetGroupName(uint32_t groupID);
+    
+public:
+    explicit EntryDetails(std::size_t threadCount = 2);
+    
+    // Returns cached details or queues a lookup and returns false.
+    // The on ready function is called from a worker when a lookup finished.
+    bool    Get(DirectoryTree::NodeIndex node, Details& out_details);
+    void    Request(DirectoryTree::NodeIndex node, const std::filesystem::path& path);
+    void    Clear();
+    void    AccountMemory(MemoryAccounting& accounting); // May throw std::bad_alloc
+    
+    void    SetOnReadyFunction(std::function<void()> func) noexcept { m_OnReadyFunction = func; }
+};
+
+#endif /* EntryDetails_hpp */
@@ -52,6 +52,16 @@ public:
         bool        isRegularFile = false;
     };
     
+    // Device and inode of entries already counted
+    struct InodeHash
+    {
+        std::size_t operator()(const std::pair<uint64_t, uint64_t>& key) const noexcept { return std::hash<uint64_t>()(key.second ^ (key.first << 32)); }
+    };
+    
+    using InodeSet = std::unordered_set<std::pair<uint64_t, uint64_t>, InodeHash>;
+    
+    static constexpr uint32_t ALL_FILES = UINT32_MAX;
+    
     struct DirectoryStats
     {
         bool isDirectory = false;
@@ -63,23 +73,99 @@ public:
 private:
     Error   m_LastError;
     
+    // Source of the listings of ScanDirectoryTree()
+    std::shared_ptr<VirtualFileSystem>  m_VirtualFileSystem = RealFileSystem::GetInstance();
+    
+    // Counts ScanDirectoryTree(), if set
+    ScanStatistics*                     m_ScanStatistics = nullptr;
+    
+    // Progress of ScanDirectoryTree(), if set
+    ScanProgress*                       m_ScanProgress = nullptr;
+    
+    // Largest files of a directory kept as nodes by ScanDirectoryTree(), the others only count into its totals
+    uint32_t                            m_FileNodeLimit = ALL_FILES;
+    
+    // Resident memory at which ScanDirectoryTree() stops adding file nodes, 0 for no limit
+    uint64_t                            m_MemoryLimit = 0;
+    bool                                m_HasReachedMemoryLimit = false;
+    
+    // Files with more than one link, kept over a scan and the refreshes of its tree, if set
+    InodeSet*                           m_LinkedInodes = nullptr;
+    
+    // Reading the resident memory costs a file read, it is checked every few directories
+    static constexpr uint64_t           MEMORY_CHECK_INTERVAL = 256;
+    
     template<typename IteratorType>
     bool IterateDirectoryT(const Path& path, std::vector<DirectoryEntry>& out_iteratedDirectoryInfo);
     
     void DebugPrintDirectoryEntry(const DirectoryEntry& entry);
     
+    // State shared by the workers of one ScanDirectoryTree() call
+    struct ScanContext;
+    
+    static bool ReadDirectory(ScanContext& context, const std::string& path, bool isRoot, std::vector<std::string>& out_names, std::vector<DirectoryTree::Entry>& out_entries, std::vector<VirtualFileSystem::FileId>& out_ids); // May throw std::bad_alloc
+    static bool ScanDirectoryJob(ScanContext& context, DirectoryTree::NodeIndex node, const std::string& path, uint64_t device, bool isMountRoot);
+    static bool RefreshDirectoryJob(ScanContext& context, DirectoryTree::NodeIndex node, const std::string& path);
+    static bool IsOverMemoryLimit(ScanContext& context) noexcept;
+    static void FoldFiles(std::vector<DirectoryTree::Entry>& entries, std::vector<VirtualFileSystem::FileId>& ids, uint32_t keepCount, DirectoryTree::FoldedFiles& out_folded); // May throw std::bad_alloc
+    
 public:
     FileSystem() = default;
+    explicit FileSystem(std::shared_ptr<VirtualFileSystem> virtualFileSystem) : m_VirtualFileSystem(std::move(virtualFileSystem)) {}
     //~FileSystem();
     
     Error   GetLastError() const noexcept { return m_LastError; }
     
+    // Counts the following scans into statistics, which must outlive them. nullptr stops counting.
+    void    SetScanStatistics(ScanStatistics* statistics) noexcept { m_ScanStatistics = statistics; }
+    
+    // Reports the progress of the following scans to progress, which must outlive them. nullptr stops it.
+    void    SetScanProgress(ScanProgress* progress) noexcept { m_ScanProgress = progress; }
+    
+    // Rollup: only the count largest files of every directory are added as nodes by the
+    // following scans, the others only count into the totals of their directory, which
+    // stay exact. 0 keeps directories only, ALL_FILES (the default) keeps every file.
+    // GetSizesOfDirectoryRecursively() keeps only that many files of path in its map.
+    void    SetFileNodeLimit(uint32_t count) noexcept { m_FileNodeLimit = count; }
+    
+    // Once the resident memory of the process exceeds bytes during a scan, files are only
+    // counted into the totals of their directory, no nodes are added for them anymore.
+    // Directory totals stay exact. 0 removes the limit.
+    void    SetMemoryLimit(uint64_t bytes) noexcept { m_MemoryLimit = bytes; }
+    bool    HasReachedMemoryLimit() const noexcept { return m_HasReachedMemoryLimit; } // In the last scan
+    
+    // Remember the files with more than one link in inodes, which must outlive the following
+    // scans. Needed to refresh a tree, so a further link found then isn't counted again.
+    void    SetLinkedInodes(InodeSet* inodes) noexcept { m_LinkedInodes = inodes; }
+    
     bool    GetSpaceInfo(const Path& path, uintmax_t& out_capacity, uintmax_t& out_free, uintmax_t& out_available) noexcept;
     
     bool    IterateDirectory(const Path& path, std::vector<DirectoryEntry>& out_iteratedDirectoryInfo); // May throw std::bad_alloc
     bool    IterateDirectoryRecursively(const Path& path, std::vector<DirectoryEntry>& out_iteratedDirectoryInfo); // May throw std::bad_alloc
     
+    // Size of every entry of path, recursive for directories, and their total
     bool    GetSizesOfDirectoryRecursively(const Path& path, std::unordered_map<Path, DirectoryStats>& out_directorySizes, uintmax_t& out_totalSize);
+    
+    // Scan path into out_tree, directories are read by threadCount workers in parallel.
+    // Unreadable directories are flagged in the tree and skipped. Further links to a
+    // file already seen are added without size. If seenInodes is given, it is kept over
+    // several scans and directories are included too (like du with several paths).
+    // Returns false if path itself can't be read or the scan was stopped.
+    // Listings come from the VirtualFileSystem given on construction, the disk by default.
+    bool    ScanDirectoryTree(const Path& path, DirectoryTree& out_tree, const std::atomic<bool>& stop, std::size_t threadCount = std::thread::hardware_concurrency(), InodeSet* seenInodes = nullptr); // May throw std::bad_alloc
+    
+    // Bring a scanned tree up to date in place, other threads may read it meanwhile. Only
+    // directories whose change stamp differs (an entry was added, removed or renamed) are
+    // read again, the files of the others are examined where they are and new sizes summed
+    // up. Subdirectories still there keep their nodes, new ones are scanned. Removed nodes
+    // stay in the tree until DirectoryTree::Compact(). Uses the same file node and memory
+    // limits and linked inodes (see SetLinkedInodes()) as the scan. If the counted link of
+    // a file is removed, its other links stay without size until the tree is scanned again.
+    // out_changeCount is the number of directories and files changed.
+    bool    RefreshDirectoryTree(DirectoryTree& tree, const std::atomic<bool>& stop, std::size_t& out_changeCount, std::size_t threadCount = std::thread::hardware_concurrency()); // May throw std::bad_alloc
+    
+    // Seconds since epoch
+    static int64_t ToUnixTime(const std::filesystem::file_time_type& time) noexcept;
 };
 
 #endif /* FileSystem_hpp */
@@ -0,0 +1,67 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  Format.hpp                                                      */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#ifndef Format_hpp
+#define Format_hpp
+
+namespace Format
+{
+    // Size with unit, e.g. "12.3 GiB". Uses powers of 1000 ("12.3 GB") if si is set.
+    std::string HumanReadableSize(uintmax_t bytes, bool si = false);
+    
+    // Signed size difference, e.g. "+1.2 GiB" or "-300.0 MiB"
+    std::string HumanReadableDelta(int64_t bytes, bool si = false);
+    
+    // Right aligns text in a field of the given width
+    std::string PadLeft(const std::string& text, std::size_t width);
+    
+    // Local date and time "YYYY-MM-DD hh:mm:ss" of seconds since epoch, "-" if negative
+    std::string DateTime(int64_t secondsSinceEpoch);
+    
+    // Append text as quoted JSON string, control characters are escaped.
+    // Bytes that aren't valid UTF-8 (file names may have any) become U+FFFD.
+    void AppendJsonString(std::string& out, std::string_view text);
+    
+    // Length of the UTF-8 sequence at position, 0 if it is invalid (RFC 3629:
+    // no overlong forms, surrogates or code points beyond U+10FFFF)
+    std::size_t GetUtf8SequenceLength(std::string_view text, std::size_t position) noexcept;
+    bool IsValidUtf8(std::string_view text) noexcept;
+    
+    // Two lowercase hex digits per byte
+    void AppendHex(std::string& out, std::string_view bytes);
+    
+    // Append text as CSV field (RFC 4180), quoted only if needed
+    void AppendCsvField(std::string& out, std::string_view text);
+};
+
+#endif /* Format_hpp */
@@ -0,0 +1,126 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  HistoryStore.hpp                                                */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#ifndef HistoryStore_hpp
+#define HistoryStore_hpp
+
+// Totals of large directories from many scans in one append-only file, for trends and
+// to forecast when the volume is full. Each scan appends one block with the directories
+// of at least a minimum size, so months of daily scans take little space.
+//
+// Layout: "DSTHIST\0", version (1 byte), then blocks. Integers are varints and strings
+// are length prefixed, as in DaemonProtocol. A block is a string containing:
+//   time, volume capacity, volume available, root path, directory count n,
+//   then four columns, each a string: paths, sizes, allocated sizes, entry counts.
+// Paths are relative to the root ("" is the root itself), sorted and front coded
+// (length shared with the previous path, then the rest). Values are zigzag deltas to
+// the value of the same path in the previous block, 0 if it wasn't in there or the
+// block is a keyframe, so unchanged directories take one byte per column.
+// Every KEYFRAME_INTERVAL blocks, and when the root changes, a keyframe starts a new
+// chain of deltas. Each block is followed by a fixed size trailer with its start, time
+// and keyframe flag, so appending and querying walk back from the end of the file and
+// only read the blocks since the keyframe before the requested time.
+class HistoryStore
+{
+public:
+    static constexpr uint8_t VERSION = 2;
+    static constexpr std::size_t KEYFRAME_INTERVAL = 16;
+    
+    // One scan, for a single path
+    struct Sample
+    {
+        int64_t     time = 0;           // Seconds since epoch
+        uintmax_t   capacity = 0;       // Of the volume
+        uintmax_t   available = 0;
+        
+        bool        isFound = false;    // Path was below the minimum size or not scanned
+        uintmax_t   size = 0;
+        uintmax_t   allocatedSize = 0;
+        uintmax_t   count = 0;
+    };
+    
+    struct Forecast
+    {
+        bool        isValid = false;        // At least two samples in the window
+        double      usedPerDay = 0.0;       // Growth of the used space of the volume, bytes
+        double      sizePerDay = 0.0;       // Growth of the path, bytes
+        int64_t     fullTime = -1;          // When the volume is full at this rate, -1 if it doesn't grow
+    };
+    
+private:
+    struct Values
+    {
+        uintmax_t   size = 0;
+        uintmax_t   allocatedSize = 0;
+        uintmax_t   count = 0;
+    };
+    
+    // From the trailer of a block
+    struct BlockInfo
+    {
+        uint64_t    start = 0;          // Offset of the block in the file
+        uint64_t    end = 0;            // Offset of its trailer
+        int64_t     time = 0;
+        bool        isKeyframe = false;
+    };
+    
+    std::string     m_LastErrorMessage = "";
+    
+    // Checks the file header, nullptr on error
+    std::FILE*      OpenFile(const FileSystem::Path& file, uint64_t& out_fileSize);
+    // Blocks from the last keyframe at least windowSeconds older than the newest block to the end,
+    // oldest first. windowSeconds < 0: All blocks. An interrupted append is excluded from out_validSize.
+    bool            ReadIndex(std::FILE* input, const FileSystem::Path& file, uint64_t fileSize, int64_t windowSeconds, std::vector<BlockInfo>& out_blocks, uint64_t& out_validSize); // May throw std::bad_alloc
+    bool            ReadBlock(std::FILE* input, const FileSystem::Path& file, const BlockInfo& info, std::string& out_data, std::string_view& out_block); // May throw std::bad_alloc
+    // Values of a block, given those of the previous one
+    static bool     DecodeBlock(std::string_view block, bool isKeyframe, std::string& out_root, std::unordered_map<std::string, Values>& out_values); // May throw std::bad_alloc
+    // Samples of the path from the blocks of the index
+    bool            QueryBlocks(std::FILE* input, const FileSystem::Path& file, const std::vector<BlockInfo>& blocks, const std::string& target, int64_t windowSeconds, std::vector<Sample>& out_samples); // May throw std::bad_alloc
+    static std::string RelativePath(const std::string& root, const std::string& path, bool& out_isInside);
+    
+public:
+    HistoryStore() = default;
+    
+    // Append the directories of at least minSize bytes, the root always. Caller holds a shared lock on the tree.
+    bool            Append(const DirectoryTree& tree, const FileSystem::Path& file, uintmax_t minSize, uintmax_t capacity, uintmax_t available); // May throw std::bad_alloc
+    
+    // One sample per scan of the last windowSeconds before the newest one, oldest first. windowSeconds < 0: All scans.
+    bool            Query(const FileSystem::Path& file, const FileSystem::Path& path, int64_t windowSeconds, std::vector<Sample>& out_samples); // May throw std::bad_alloc
+    
+    // Least squares fit over the samples of the last windowSeconds
+    static Forecast ForecastFill(const std::vector<Sample>& samples, int64_t windowSeconds);
+    
+    const std::string&  GetLastErrorMessage() const noexcept { return m_LastErrorMessage; }
+};
+
+#endif /* HistoryStore_hpp */
@@ -35,37 +35,15 @@ the following restrictions:
 #define Main_hpp
 
 // *******************************************************************
-// Pre-processor settings
-
-// Enable printing of platform specific error code and message,
-// additionally to the platform independent ones
-#define DST_PRINT_PLATFORM_SPECIFIC_ERROR_DESCRIPTION
-
-#include "PlatformMacros.hpp"
+// Core library: system includes and everything but the UI
+#include "DirStatsCore.hpp"
 
 // *******************************************************************
-// System includes
-#include <iostream>
-#include <cstdint>
-#include <string>
-#include <locale>
-#include <codecvt>
-#include <vector>
-#include <functional>
-#include <system_error>
-#include <filesystem>
-//#include <future>
-#include <thread>
-#include <atomic>
-
+// UI platform includes
 #ifdef PLATFORM_APPLE
 #include <CoreFoundation/CoreFoundation.h>
 #elif defined(PLATFORM_LINUX)
 #include <gtk/gtk.h>
-#elif defined(PLATFORM_WINDOWS)
-#define NOMINMAX
-#include <Windows.h>
-#undef ERROR
 #endif
 
 // *******************************************************************
@@ -81,10 +59,10 @@ the following restrictions:
 // *******************************************************************
 // Project includes
 #include "DirStatsTUIVersion.hpp"
-#include "Error.hpp"
 #include "MessageBox.hpp"
-#include "FileSystem.hpp"
+#include "Treemap.hpp"
 #include "MenuComponent.hpp"
+#include "PerformanceOverlay.hpp"
 #include "AppUI.hpp"
 #include "App.hpp"
 
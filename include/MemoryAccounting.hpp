@@ -0,0 +1,96 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  MemoryAccounting.hpp                                            */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#ifndef MemoryAccounting_hpp
+#define MemoryAccounting_hpp
+
+// Bytes held by the large data structures, which add themselves with AccountMemory().
+// Arrays and blocks count their capacity. Hash tables and lists count their buckets and
+// nodes as laid out by the standard library, without what malloc rounds up per node.
+// Memory of a mapped snapshot is listed, but not counted as heap memory.
+class MemoryAccounting
+{
+public:
+    struct Item
+    {
+        std::string name;
+        uint64_t    bytes = 0;
+        uint64_t    count = 0;  // Elements, 0 if it has none countable
+        bool        isMapped = false;
+    };
+    
+private:
+    std::vector<Item>   m_Items;
+    
+public:
+    MemoryAccounting() = default;
+    
+    void    Add(std::string_view name, uint64_t bytes, uint64_t count = 0, bool isMapped = false); // May throw std::bad_alloc
+    void    Clear() noexcept { m_Items.clear(); }
+    
+    const std::vector<Item>&    GetItems() const noexcept { return m_Items; }
+    uint64_t                    GetHeapBytes() const noexcept;
+    uint64_t                    GetMappedBytes() const noexcept;
+    
+    // Report as text, or as JSON object appended to json
+    void    WriteText(std::ostream& out) const; // May throw std::bad_alloc
+    void    AppendJson(std::string& json) const; // May throw std::bad_alloc
+    
+    template<typename T>
+    static uint64_t GetVectorBytes(const std::vector<T>& vector) noexcept
+    {
+        return vector.capacity() * sizeof(T);
+    }
+    
+    // Node: next pointer, cached hash and the value
+    template<typename T>
+    static uint64_t GetHashTableBytes(const T& table) noexcept
+    {
+        return table.bucket_count() * sizeof(void*) + table.size() * (sizeof(void*) + sizeof(std::size_t) + sizeof(typename T::value_type));
+    }
+    
+    // Node: both pointers and the value
+    template<typename T>
+    static uint64_t GetListBytes(const T& list) noexcept
+    {
+        return list.size() * (2 * sizeof(void*) + sizeof(typename T::value_type));
+    }
+    
+    // Heap memory of a string beyond the small string buffer
+    static uint64_t GetStringBytes(const std::string& text) noexcept
+    {
+        return (text.capacity() > std::string().capacity()) ? text.capacity() + 1 : 0;
+    }
+};
+
+#endif /* MemoryAccounting_hpp */
@@ -0,0 +1,83 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  MemoryFileSystem.hpp                                            */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#ifndef MemoryFileSystem_hpp
+#define MemoryFileSystem_hpp
+
+// Simulated tree for measuring the scanner without the kernel. Listings are generated
+// from the shape on every read and never stored, so even trees of 100M entries need
+// no memory. A directory on level i (the root is level 0) has the subdirectories
+// d0, d1, ... and files f0, f1, ... given by levels[i], deeper ones are empty.
+// File sizes are pseudo random, but always the same for the same seed. Reads can be
+// delayed like on a slow disk or network file system.
+class MemoryFileSystem final : public VirtualFileSystem
+{
+public:
+    struct Level
+    {
+        uint64_t    directoryCount = 0;
+        uint64_t    fileCount = 0;
+    };
+    
+private:
+    std::string         m_Root;
+    std::vector<Level>  m_Levels;
+    uint64_t            m_Seed = 1;
+    
+    // Slept once per read, for the directory plus each entry
+    std::chrono::nanoseconds    m_DirectoryLatency = std::chrono::nanoseconds(0);
+    std::chrono::nanoseconds    m_EntryLatency = std::chrono::nanoseconds(0);
+    
+    std::atomic<uint64_t>       m_ReadCount = 0;
+    
+    // Level and hash of a simulated directory, false if there is none at path
+    bool        FindDirectory(const std::string& path, std::size_t& out_level, uint64_t& out_hash) const noexcept;
+    
+public:
+    MemoryFileSystem(const std::string& root, const std::vector<Level>& levels, uint64_t seed = 1);
+    
+    bool        ReadDirectory(const std::string& path, bool isRoot, std::vector<std::string>& out_names, std::vector<DirectoryTree::Entry>& out_entries, std::vector<FileId>& out_ids) override; // May throw std::bad_alloc
+    void        GetDirectorySize(const std::string& path, uintmax_t& out_size, uintmax_t& out_allocatedSize) noexcept override;
+    
+    void        SetLatency(std::chrono::nanoseconds perDirectory, std::chrono::nanoseconds perEntry) noexcept;
+    
+    // Entries below the root, saturates at UINT64_MAX
+    uint64_t    GetEntryCount() const noexcept;
+    
+    // Directories read so far
+    uint64_t    GetReadCount() const noexcept { return m_ReadCount; }
+    
+    const std::string&  GetRoot() const noexcept { return m_Root; }
+};
+
+#endif /* MemoryFileSystem_hpp */
@@ -43,6 +43,10 @@ public:
         
         bool isDirectory = false;
         uintmax_t count = 0;
+        uintmax_t size = 0;
+        bool isMarked = false;
+        
+        std::string sizeLabel = ""; // Shown instead of the size if set
     };
     
 private:
@@ -65,6 +69,7 @@ public:
     
     void            AddEntry(const MenuEntry& entry);
     void            ClearEntries();
+    void            SetSelection(int32_t selection);
     
     ftxui::Element  Render() override;
     bool            OnEvent(ftxui::Event event) override;
@@ -76,6 +81,10 @@ public:
     // Getter
     int32_t         GetCurrentSelection() const noexcept { return m_CurrentSelection; }
     int32_t         GetCurrentFocus() const noexcept { return m_CurrentFocus; }
+    std::size_t     GetEntryCount() const noexcept { return m_Entries.size(); }
+    
+    // The entries, the FTXUI components showing them are not included
+    void            AccountMemory(MemoryAccounting& accounting) const;
 };
 
 #endif /* MenuComponent_hpp */
@@ -0,0 +1,86 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  NamePool.hpp                                                    */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#ifndef NamePool_hpp
+#define NamePool_hpp
+
+// Stores every distinct file name exactly once. Names are kept in large
+// fixed-size blocks, so the returned string views stay valid until Clear().
+// Alternatively the names of a mapped snapshot are used in place, read-only.
+// Not thread safe, the owner (DirectoryTree) is responsible for locking.
+class NamePool
+{
+public:
+    using NameID = uint32_t;
+    static constexpr NameID INVALID_NAME = UINT32_MAX;
+    
+private:
+    static constexpr std::size_t BLOCK_SIZE = 1024 * 1024;
+    
+    std::vector<std::unique_ptr<char[]>>            m_Blocks;
+    std::size_t                                     m_BlockUsed = BLOCK_SIZE;
+    std::size_t                                     m_BlockBytes = 0;
+    
+    std::vector<std::string_view>                   m_Names;
+    std::unordered_map<std::string_view, NameID>    m_Lookup;
+    
+    // Mapped names: name i is data[offsets[i]] up to data[offsets[i + 1]]
+    const char*                                     m_MappedData = nullptr;
+    const uint64_t*                                 m_MappedOffsets = nullptr;
+    std::size_t                                     m_MappedCount = 0;
+    
+    std::string_view    Store(std::string_view name);
+    
+public:
+    NamePool() = default;
+    
+    NameID              Intern(std::string_view name); // May throw std::bad_alloc. Not for mapped names.
+    void                Clear() noexcept;
+    
+    // Use count names from memory owned by the caller. offsets has count + 1 entries.
+    void                Map(const char* data, const uint64_t* offsets, std::size_t count) noexcept;
+    
+    std::string_view    Get(const NameID id) const noexcept
+    {
+        if(m_MappedOffsets)
+            return std::string_view(m_MappedData + m_MappedOffsets[id], static_cast<std::size_t>(m_MappedOffsets[id + 1] - m_MappedOffsets[id]));
+        
+        return m_Names[id];
+    }
+    
+    std::size_t         GetCount() const noexcept { return m_MappedOffsets ? m_MappedCount : m_Names.size(); }
+    
+    void                AccountMemory(MemoryAccounting& accounting) const; // May throw std::bad_alloc
+};
+
+#endif /* NamePool_hpp */
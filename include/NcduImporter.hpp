@@ -0,0 +1,116 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  NcduImporter.hpp                                                */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#ifndef NcduImporter_hpp
+#define NcduImporter_hpp
+
+// Loads an export of ncdu ("ncdu -o file") into a DirectoryTree. The file is
+// parsed in one pass over a fixed read buffer without building a document:
+// each directory is added to the tree as soon as its closing bracket is read.
+class NcduImporter
+{
+private:
+    // Fields of an ncdu info object we use, the others are skipped
+    struct Info
+    {
+        std::string     name = "";
+        uintmax_t       apparentSize = 0;
+        uintmax_t       diskSize = 0;
+        int64_t         modificationTime = 0;
+        uint64_t        device = 0;
+        uint64_t        inode = 0;
+        bool            hasDevice = false;
+        bool            isHardLink = false;
+        bool            hasReadError = false;
+        bool            isNotRegular = false;
+        bool            isExcluded = false;
+    };
+    
+    // Directory whose closing bracket was not read yet
+    struct OpenDirectory
+    {
+        DirectoryTree::Entry                                self;
+        std::string                                         selfName = "";
+        uint64_t                                            device = 0;
+        DirectoryTree::ChildBlock                           selfBlock;
+        
+        // Names of the entries back to back, views are set when the directory is added
+        std::vector<DirectoryTree::Entry>                   entries;
+        std::vector<DirectoryTree::ChildBlock>              childBlocks;
+        std::string                                         names = "";
+        std::vector<std::pair<std::size_t, std::size_t>>    nameRanges;
+    };
+    
+    static constexpr std::size_t READ_BUFFER_SIZE = 1024 * 1024;
+    
+    // Reader
+    std::FILE*          m_File = nullptr;
+    std::vector<char>   m_Buffer;
+    std::size_t         m_Position = 0;
+    std::size_t         m_End = 0;
+    uint64_t            m_Offset = 0; // Of the start of the buffer in the file
+    
+    // Parser state, kept over directories to reuse their memory
+    std::vector<OpenDirectory>  m_Stack;
+    Info                        m_Info;
+    std::string                 m_Key = "";
+    FileSystem::InodeSet        m_HardLinks;
+    
+    std::string         m_LastErrorMessage = "";
+    
+    bool                Refill();
+    int32_t             Peek();
+    int32_t             Get();
+    void                SkipWhitespace();
+    bool                Expect(char expected);
+    bool                Fail(const std::string& message);
+    
+    bool                ParseString(std::string& out_string);
+    bool                ParseNumber(uint64_t& out_number, bool& out_isNegative);
+    bool                ParseUnsigned(uint64_t& out_number);
+    bool                ParseBool(bool& out_value);
+    bool                ParseInfo(Info& out_info);
+    bool                SkipValue();
+    
+    void                AddEntry(OpenDirectory& directory, const Info& info, const DirectoryTree::ChildBlock& block, bool isDirectory);
+    
+public:
+    NcduImporter() = default;
+    
+    // Import file ("-" for stdin) into out_tree
+    bool                Import(const FileSystem::Path& file, DirectoryTree& out_tree, const std::atomic<bool>& stop); // May throw std::bad_alloc
+    
+    std::string         GetLastErrorMessage() const noexcept { return m_LastErrorMessage; }
+};
+
+#endif /* NcduImporter_hpp */
@@ -0,0 +1,83 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  PerformanceOverlay.hpp                                          */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#ifndef PerformanceOverlay_hpp
+#define PerformanceOverlay_hpp
+
+// Frame time, input latency, redraws, scan throughput and memory, drawn over the main
+// window. Nothing is measured while it is hidden. Shown, frames are timed and everything
+// else is sampled once per SAMPLE_INTERVAL; the text is only built then.
+class PerformanceOverlay
+{
+public:
+    using Clock = std::chrono::steady_clock;
+    
+    static constexpr std::chrono::milliseconds SAMPLE_INTERVAL{1000};
+    static constexpr std::size_t MAX_WORKER_LINES = 16;
+    
+private:
+    bool    m_IsVisible = false;
+    
+    // Since the last sample
+    uint64_t            m_FrameCount = 0;
+    Clock::duration     m_FrameTime{};
+    Clock::duration     m_MaxFrameTime{};
+    uint64_t            m_InputCount = 0;
+    Clock::duration     m_InputLatency{};
+    Clock::duration     m_MaxInputLatency{};
+    
+    // First input not drawn yet
+    Clock::time_point   m_PendingInputTime;
+    bool                m_IsInputPending = false;
+    
+    Clock::time_point       m_SampleTime;
+    ScanProgress::Sample    m_ScanSample;
+    std::vector<std::string> m_Lines;
+    
+public:
+    PerformanceOverlay() = default;
+    
+    void    Toggle();
+    bool    IsVisible() const noexcept { return m_IsVisible; }
+    
+    // An event of the user, its latency lasts until the end of the next frame
+    void    OnInput() noexcept;
+    
+    // End of a frame started at frameStart. Returns true if Sample() is due.
+    bool    OnFrame(Clock::time_point frameStart) noexcept;
+    void    Sample(const ScanProgress& progress, const MemoryAccounting& memory); // May throw std::bad_alloc
+    
+    ftxui::Element  Render() const;
+};
+
+#endif /* PerformanceOverlay_hpp */
@@ -0,0 +1,82 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  Probes.hpp                                                      */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#ifndef Probes_hpp
+#define Probes_hpp
+
+// USDT probes of provider "dirstats" for bpftrace, SystemTap and perf, e.g.
+//   bpftrace -e 'usdt:./DirStatsTUI:dirstats:stat_latency { @ns = hist(arg1); }'
+// A probe is a nop instruction until a tracer attaches. Arguments that need extra
+// work, like timing, are only computed while a tracer is attached (DST_PROBE_ENABLED).
+// Built into dirstats_core if sys/sdt.h is found (DIRSTATS_USDT_PROBES).
+//
+//   directory_open   (path, fd or -errno)
+//   directory_close  (path, entries, complete)
+//   entry_batch      (path, entries, subdirectories queued)
+//   stat_latency     (name, nanoseconds)
+//   scan_error       (path, errno)
+//   scan_phase       (phase, path)         "scan", "stopped", "done", "import", "index", "ready"
+//   ui_frame         (frame, nanoseconds)  Building the elements of a frame
+
+#ifdef DST_USDT_PROBES
+// Counted up by a tracer while attached
+extern "C"
+{
+    extern volatile unsigned short dirstats_directory_open_semaphore;
+    extern volatile unsigned short dirstats_directory_close_semaphore;
+    extern volatile unsigned short dirstats_entry_batch_semaphore;
+    extern volatile unsigned short dirstats_stat_latency_semaphore;
+    extern volatile unsigned short dirstats_scan_error_semaphore;
+    extern volatile unsigned short dirstats_scan_phase_semaphore;
+    extern volatile unsigned short dirstats_ui_frame_semaphore;
+}
+
+#define DST_PROBE_ENABLED(name)         __builtin_expect(dirstats_##name##_semaphore != 0, 0)
+#define DST_PROBE2(name, a, b)          DTRACE_PROBE2(dirstats, name, a, b)
+#define DST_PROBE3(name, a, b, c)       DTRACE_PROBE3(dirstats, name, a, b, c)
+#else
+// The arguments are not evaluated
+#define DST_PROBE_ENABLED(name)         false
+#define DST_PROBE2(name, a, b)          ((void)sizeof(a), (void)sizeof(b))
+#define DST_PROBE3(name, a, b, c)       ((void)sizeof(a), (void)sizeof(b), (void)sizeof(c))
+#endif
+
+// For the UI, which is built without the probe macros
+namespace Probes
+{
+    bool    IsUIFrameEnabled() noexcept;
+    void    UIFrame(uint64_t frame, uint64_t nanoseconds) noexcept;
+    void    ScanPhase(const char* phase, const char* path) noexcept;
+};
+
+#endif /* Probes_hpp */
@@ -0,0 +1,51 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  ProcessStats.hpp                                                */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#ifndef ProcessStats_hpp
+#define ProcessStats_hpp
+
+// Memory of the own process, for the benchmarks and the performance overlay
+namespace ProcessStats
+{
+    // Resident memory now, 0 if unknown
+    uint64_t GetResidentBytes() noexcept;
+    
+    // Highest resident memory since the last reset, or since the start of the process
+    uint64_t GetPeakResidentBytes() noexcept;
+    
+    // Returns freed heap memory to the system and starts a new peak at the
+    // current resident memory. Only on Linux, the peak stays elsewhere.
+    void ResetPeakResidentBytes() noexcept;
+};
+
+#endif /* ProcessStats_hpp */
@@ -0,0 +1,66 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  PrometheusExporter.hpp                                          */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#ifndef PrometheusExporter_hpp
+#define PrometheusExporter_hpp
+
+// Gauges of a scanned tree for the textfile collector of the Prometheus node_exporter.
+// Directories down to a maximum depth are written, and deeper ones of at least a
+// minimum size. The file is written to a temporary file and renamed over the old
+// one, so the collector never reads a partial file.
+class PrometheusExporter
+{
+public:
+    struct ScanInfo
+    {
+        int64_t     time = 0;                   // End of the scan, seconds since epoch
+        double      durationSeconds = -1.0;     // Not written if negative
+    };
+    
+private:
+    uint32_t        m_MaxDepth = 2;
+    uintmax_t       m_MinSize = UINTMAX_MAX;    // No deeper directories
+    std::string     m_LastErrorMessage = "";
+    
+    static void     AppendLabel(std::string& out, std::string_view path);
+    
+public:
+    PrometheusExporter(uint32_t maxDepth, uintmax_t minSize) noexcept : m_MaxDepth(maxDepth), m_MinSize(minSize) {}
+    
+    // Caller holds a shared lock on the tree
+    bool            Write(const DirectoryTree& tree, const FileSystem::Path& file, const ScanInfo& info); // May throw std::bad_alloc
+    
+    const std::string&  GetLastErrorMessage() const noexcept { return m_LastErrorMessage; }
+};
+
+#endif /* PrometheusExporter_hpp */
@@ -0,0 +1,93 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  ScanProgress.hpp                                                */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#ifndef ScanProgress_hpp
+#define ScanProgress_hpp
+
+// Live progress of FileSystem::ScanDirectoryTree(), read by another thread while the scan
+// runs. Each worker counts into its own cache line once per directory, so unlike
+// ScanStatistics it is cheap enough to stay attached to every scan.
+class ScanProgress
+{
+public:
+    // Workers of larger pools count into the last one
+    static constexpr std::size_t MAX_WORKER_COUNT = 256;
+    
+    struct Worker
+    {
+        uint64_t    directoryCount = 0;
+        uint64_t    entryCount = 0;
+    };
+    
+    struct Sample
+    {
+        std::chrono::steady_clock::time_point   time;
+        std::vector<Worker>                     workers;
+        uint64_t                                queuedDirectories = 0; // Submitted to the pool, not started yet
+        bool                                    isRunning = false;
+    };
+    
+private:
+    struct alignas(64) WorkerCounters
+    {
+        std::atomic<uint64_t>   directoryCount = 0;
+        std::atomic<uint64_t>   entryCount = 0;
+    };
+    
+    std::array<WorkerCounters, MAX_WORKER_COUNT>    m_Workers;
+    std::atomic<std::size_t>                        m_WorkerCount = 0;
+    std::atomic<int64_t>                            m_QueuedDirectories = 0;
+    std::atomic<bool>                               m_IsRunning = false;
+    
+public:
+    ScanProgress() = default;
+    
+    ScanProgress(const ScanProgress&) = delete;
+    ScanProgress& operator=(const ScanProgress&) = delete;
+    
+    // Called by FileSystem around each scan, starting resets the counters
+    void    StartScan(std::size_t threadCount) noexcept;
+    void    StopScan() noexcept;
+    
+    // Called by FileSystem for each directory, from any thread
+    void    OnDirectoryQueued() noexcept { m_QueuedDirectories.fetch_add(1, std::memory_order_relaxed); }
+    void    OnDirectoryStarted() noexcept { m_QueuedDirectories.fetch_sub(1, std::memory_order_relaxed); }
+    void    OnDirectoryRead(uint64_t entryCount) noexcept;
+    
+    bool    IsRunning() const noexcept { return m_IsRunning; }
+    
+    // Counters as of now. Sums are exact after the scan, while it runs they may lag a directory.
+    void    GetSample(Sample& out_sample) const; // May throw std::bad_alloc
+};
+
+#endif /* ScanProgress_hpp */
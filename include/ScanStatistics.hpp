@@ -0,0 +1,183 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  ScanStatistics.hpp                                              */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#ifndef ScanStatistics_hpp
+#define ScanStatistics_hpp
+
+// Counters of FileSystem::ScanDirectoryTree(): what was read, where the time went and
+// which directories and mounts were slow. Every worker thread counts into its own
+// Counters, so counting needs no lock; they are merged when the report is written.
+// Scans without statistics only check a pointer per directory and entry.
+class ScanStatistics
+{
+public:
+    enum class Phase : uint8_t
+    {
+        OPEN = 0,   // Opening a directory
+        LIST,       // Reading the names (getdents), per directory
+        STAT,       // Per entry
+        LINKS,      // Looking up hard links, per directory
+        TREE,       // Adding the entries to the tree, per directory
+        COUNT
+    };
+    
+    // Bucket 0 counts calls under 1 µs, bucket i those from 2^(i-1) to 2^i µs, the last all longer ones
+    static constexpr std::size_t LATENCY_BUCKET_COUNT = 32;
+    static constexpr std::size_t SLOW_DIRECTORY_COUNT = 10;
+    
+    struct PhaseCounters
+    {
+        uint64_t    callCount = 0;
+        uint64_t    nanoseconds = 0;
+        uint64_t    maxNanoseconds = 0;
+        std::array<uint64_t, LATENCY_BUCKET_COUNT> latencyBuckets = {};
+    };
+    
+    // Time of opening, listing and stat'ing one directory
+    struct Directory
+    {
+        std::string path;
+        uint64_t    nanoseconds = 0;
+        uint64_t    entryCount = 0;
+    };
+    
+    // Directories of one device, path is the topmost one scanned
+    struct Mount
+    {
+        std::string path;
+        uint64_t    directoryCount = 0;
+        uint64_t    entryCount = 0;
+        uint64_t    nanoseconds = 0;
+        uint64_t    maxNanoseconds = 0;
+    };
+    
+    struct Counters
+    {
+        uint64_t    directoriesOpened = 0;
+        uint64_t    entriesRead = 0;
+        uint64_t    getdentsBytes = 0;  // Size of the records read, 0 for simulated file systems
+        uint64_t    busyNanoseconds = 0; // Time in scan jobs, of all threads
+        
+        std::map<int, uint64_t>     errors; // Count of unreadable directories by errno
+        std::array<PhaseCounters, static_cast<std::size_t>(Phase::COUNT)> phases = {};
+        
+        std::vector<Directory>      slowestDirectories; // Slowest first
+        std::map<uint64_t, Mount>   mounts;             // By device
+        
+        void    AddPhase(Phase phase, uint64_t nanoseconds) noexcept;
+        void    AddDirectory(const std::string& path, uint64_t device, bool isMountRoot, uint64_t nanoseconds, uint64_t entryCount); // May throw std::bad_alloc
+        void    Add(const Counters& other); // May throw std::bad_alloc
+    };
+    
+    // Counts the calling thread into counters while it exists, nullptr counts nothing
+    class ThreadScope
+    {
+    private:
+        Counters*   m_Counters = nullptr;
+        Counters*   m_PreviousCounters = nullptr;
+        std::chrono::steady_clock::time_point   m_Start;
+        
+    public:
+        explicit ThreadScope(ScanStatistics* statistics); // May throw std::bad_alloc
+        ~ThreadScope();
+        
+        ThreadScope(const ThreadScope&) = delete;
+        ThreadScope& operator=(const ThreadScope&) = delete;
+    };
+    
+    // Adds its lifetime to phase of the calling thread, if it is counted
+    class PhaseTimer
+    {
+    private:
+        Counters*   m_Counters = nullptr;
+        Phase       m_Phase = Phase::OPEN;
+        std::chrono::steady_clock::time_point   m_Start;
+        
+    public:
+        explicit PhaseTimer(Phase phase) noexcept;
+        ~PhaseTimer();
+        
+        PhaseTimer(const PhaseTimer&) = delete;
+        PhaseTimer& operator=(const PhaseTimer&) = delete;
+    };
+    
+private:
+    struct ThreadCounters
+    {
+        std::thread::id id;
+        Counters        counters;
+    };
+    
+    const uint64_t  m_Id;
+    
+    // Only locked when a thread counts for the first time, deque keeps them in place
+    mutable std::mutex          m_Mutex;
+    std::deque<ThreadCounters>  m_ThreadCounters;
+    
+    // Of all scans
+    uint64_t        m_ScanCount = 0;
+    double          m_WallSeconds = 0.0;
+    double          m_UserSeconds = 0.0;    // CPU time of the process
+    double          m_SystemSeconds = 0.0;
+    std::size_t     m_MaxThreadCount = 0;
+    
+    std::chrono::steady_clock::time_point   m_ScanStart;
+    double          m_ScanStartUserSeconds = 0.0;
+    double          m_ScanStartSystemSeconds = 0.0;
+    
+    Counters&       GetThreadCounters(); // May throw std::bad_alloc
+    
+public:
+    ScanStatistics() noexcept;
+    
+    ScanStatistics(const ScanStatistics&) = delete;
+    ScanStatistics& operator=(const ScanStatistics&) = delete;
+    
+    // Called by FileSystem around each scan
+    void        StartScan(std::size_t threadCount) noexcept;
+    void        StopScan() noexcept;
+    
+    // Sum of all threads, only while no scan is running
+    Counters    GetTotal() const; // May throw std::bad_alloc
+    
+    // Report of all scans, as text or as JSON object. Includes memory if given.
+    void        WriteText(std::ostream& out, const MemoryAccounting* memory = nullptr) const; // May throw std::bad_alloc
+    void        WriteJson(std::ostream& out, const MemoryAccounting* memory = nullptr) const; // May throw std::bad_alloc
+    
+    // Counters of the calling thread, nullptr if it isn't counted
+    static Counters*    GetCurrentCounters() noexcept;
+    static std::size_t  GetLatencyBucket(uint64_t nanoseconds) noexcept;
+    static const char*  GetPhaseName(Phase phase) noexcept;
+};
+
+#endif /* ScanStatistics_hpp */
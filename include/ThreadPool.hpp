@@ -0,0 +1,72 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  ThreadPool.hpp                                                  */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#ifndef ThreadPool_hpp
+#define ThreadPool_hpp
+
+// Fixed number of worker threads processing submitted jobs in FIFO order.
+// Jobs still queued on destruction are dropped, running ones are waited for.
+class ThreadPool
+{
+private:
+    std::vector<std::thread>            m_Workers;
+    std::deque<std::function<void()>>   m_Jobs;
+    
+    std::mutex                  m_Mutex;
+    std::condition_variable     m_JobAvailable;
+    std::condition_variable     m_Idle;
+    
+    std::size_t     m_RunningJobs = 0;
+    bool            m_Stop = false;
+    
+    void            WorkerTask(std::size_t index);
+    
+public:
+    static constexpr std::size_t NO_WORKER = SIZE_MAX;
+    
+    explicit ThreadPool(std::size_t threadCount);
+    ~ThreadPool();
+    
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    
+    void            Submit(std::function<void()> job);
+    void            WaitIdle(); // Blocks until no job is queued or running
+    
+    std::size_t     GetThreadCount() const noexcept { return m_Workers.size(); }
+    
+    // Index of the calling thread in its pool, NO_WORKER if it is no worker
+    static std::size_t GetCurrentWorkerIndex() noexcept;
+};
+
+#endif /* ThreadPool_hpp */
@@ -0,0 +1,82 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  Tracer.hpp                                                      */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#ifndef Tracer_hpp
+#define Tracer_hpp
+
+// Spans of the scanner and the UI for chrome://tracing and Perfetto. Each thread
+// writes into its own ring buffer, which keeps its latest spans and needs no lock.
+// While disabled a span only checks a flag. The trace is written after the traced
+// work is done, spans still being written then may be garbled.
+namespace Tracer
+{
+    enum class Category : uint8_t
+    {
+        SCAN = 0,
+        UI
+    };
+    
+    // Starts a new trace, each thread keeps its latest spansPerThread spans
+    void        Enable(std::size_t spansPerThread = 16384);
+    void        Disable() noexcept;
+    bool        IsEnabled() noexcept;
+    
+    // Name of the calling thread in the trace, a string literal
+    void        SetThreadName(const char* name) noexcept;
+    
+    // Chrome trace event JSON of the spans recorded since Enable()
+    bool        WriteChromeTrace(const std::filesystem::path& path, std::string& out_errorMessage); // May throw std::bad_alloc
+    
+    // Records its lifetime as span, name is a string literal
+    class ScopedSpan
+    {
+    private:
+        const char* m_Name = nullptr;   // nullptr if not recording
+        const char* m_ArgumentName = nullptr;
+        uint64_t    m_ArgumentValue = 0;
+        uint64_t    m_Start = 0;
+        Category    m_Category = Category::SCAN;
+        
+    public:
+        ScopedSpan(Category category, const char* name) noexcept;
+        ~ScopedSpan();
+        
+        ScopedSpan(const ScopedSpan&) = delete;
+        ScopedSpan& operator=(const ScopedSpan&) = delete;
+        
+        // Shown in the details of the span, e.g. the number of entries
+        void    SetArgument(const char* name, uint64_t value) noexcept { m_ArgumentName = name; m_ArgumentValue = value; }
+    };
+};
+
+#endif /* Tracer_hpp */
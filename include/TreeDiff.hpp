@@ -0,0 +1,109 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  TreeDiff.hpp                                                    */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#ifndef TreeDiff_hpp
+#define TreeDiff_hpp
+
+// Differences between two trees of the same path, e.g. two snapshots of different days.
+// Both trees are walked together: the children of a directory are sorted by name on
+// both sides and merged, so matching entries are found in one linear pass. Only
+// changed, added and removed entries are kept. Directories with the same totals and
+// modification time on both sides count as unchanged and are not descended into.
+class TreeDiff
+{
+public:
+    using NodeIndex = uint32_t;
+    static constexpr NodeIndex INVALID_NODE = UINT32_MAX;
+    
+    enum class ChangeType : uint8_t
+    {
+        CHANGED = 0,    // In both trees
+        ADDED,          // Only in the new tree, its subtree is not listed
+        REMOVED,        // Only in the old tree, its subtree is not listed
+    };
+    
+    struct Node
+    {
+        DirectoryTree::NodeIndex    oldNode = DirectoryTree::INVALID_NODE;
+        DirectoryTree::NodeIndex    newNode = DirectoryTree::INVALID_NODE;
+        NodeIndex                   parent = INVALID_NODE;
+        NodeIndex                   firstChild = INVALID_NODE;
+        uint32_t                    childCount = 0;
+        ChangeType                  change = ChangeType::CHANGED;
+        
+        int64_t                     sizeDelta = 0;  // Apparent size, new minus old
+        int64_t                     countDelta = 0; // Entries below
+        
+        // Recursive, entries that were added or removed as a whole
+        uintmax_t                   addedSize = 0;
+        uintmax_t                   addedCount = 0;
+        uintmax_t                   removedSize = 0;
+        uintmax_t                   removedCount = 0;
+    };
+    
+private:
+    const DirectoryTree*    m_OldTree = nullptr;
+    const DirectoryTree*    m_NewTree = nullptr;
+    std::vector<Node>       m_Nodes;
+    
+    void            AddNode(NodeIndex parent, DirectoryTree::NodeIndex oldNode, DirectoryTree::NodeIndex newNode, ChangeType change);
+    static void     GetSortedChildren(const DirectoryTree& tree, DirectoryTree::NodeIndex node, std::vector<DirectoryTree::NodeIndex>& out_children);
+    
+public:
+    TreeDiff() = default;
+    
+    // Both trees must stay unchanged while the diff is used. Caller holds shared locks on them.
+    void            Compute(const DirectoryTree& oldTree, const DirectoryTree& newTree); // May throw std::bad_alloc
+    void            Clear() noexcept;
+    
+    bool            IsEmpty() const noexcept { return m_Nodes.empty(); }
+    NodeIndex       GetRoot() const noexcept { return m_Nodes.empty() ? INVALID_NODE : 0; }
+    const Node&     GetNode(const NodeIndex node) const noexcept { return m_Nodes[node]; }
+    std::size_t     GetNodeCount() const noexcept { return m_Nodes.size(); }
+    
+    // Of the new entry, or of the old one if it was removed
+    const DirectoryTree::Node&  GetTreeNode(NodeIndex node) const noexcept;
+    std::string_view            GetName(NodeIndex node) const noexcept;
+    std::filesystem::path       GetPath(NodeIndex node) const;
+    uintmax_t                   GetOldSize(NodeIndex node) const noexcept;
+    uintmax_t                   GetNewSize(NodeIndex node) const noexcept;
+    
+    // Children sorted by growth, largest first
+    void            GetChildren(NodeIndex node, std::vector<NodeIndex>& out_children) const;
+    
+    // Follow the children with the largest growth down from node, as long as a child holds at
+    // least minShare (0..1) of the growth of its parent. Node itself is not included.
+    void            GetGrowthPath(NodeIndex node, double minShare, std::vector<NodeIndex>& out_path) const;
+};
+
+#endif /* TreeDiff_hpp */
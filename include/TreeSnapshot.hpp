@@ -0,0 +1,101 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  TreeSnapshot.hpp                                                */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#ifndef TreeSnapshot_hpp
+#define TreeSnapshot_hpp
+
+// A finished tree published as one read-only file, meant for shared memory (/dev/shm).
+// Readers map it and use nodes and names in place, so any number of UIs and exports
+// share one copy. A new snapshot is written to a temporary file and renamed over the
+// old one: readers of the old snapshot keep their mapping, new readers get the new one.
+//
+// Layout: Header, nodes (DirectoryTree::Node as in memory), name offsets (nameCount + 1
+// times uint64_t), name bytes. Only readers of the same build and architecture can map
+// it, which the header checks. Indices in the nodes are checked while loading.
+class TreeSnapshot
+{
+public:
+    static constexpr uint32_t VERSION = 1;
+    
+    struct Header
+    {
+        char        magic[8] = {'D', 'S', 'T', 'S', 'N', 'A', 'P', '\0'};
+        uint32_t    version = VERSION;
+        uint32_t    headerSize = sizeof(Header);
+        uint32_t    nodeSize = sizeof(DirectoryTree::Node);
+        uint32_t    byteOrder = 0x01020304;
+        uint64_t    generation = 0;     // Counts up with every snapshot published to the same file
+        int64_t     createdTime = 0;    // Seconds since epoch
+        uint64_t    nodeCount = 0;
+        uint64_t    nameCount = 0;
+        uint64_t    nodesOffset = 0;
+        uint64_t    nameOffsetsOffset = 0;
+        uint64_t    namesOffset = 0;
+        uint64_t    fileSize = 0;
+    };
+    
+private:
+    // Unmapped when the last tree using it is cleared
+    struct Mapping
+    {
+        void*       data = nullptr;
+        std::size_t size = 0;
+        
+        ~Mapping();
+    };
+    
+    static constexpr std::size_t CHUNK_SIZE = 1024 * 1024;
+    
+    Header          m_Header;
+    std::string     m_LastErrorMessage = "";
+    
+    bool            ReadHeader(const FileSystem::Path& file, Header& out_header) const;
+    bool            IsValid(const Header& header, uintmax_t fileSize) const noexcept;
+    
+public:
+    TreeSnapshot() = default;
+    
+    // Write tree to file atomically. Caller holds a shared lock on the tree.
+    bool            Publish(const DirectoryTree& tree, const FileSystem::Path& file); // May throw std::bad_alloc
+    
+    // Map file and let out_tree use it in place
+    bool            Load(const FileSystem::Path& file, DirectoryTree& out_tree); // May throw std::bad_alloc
+    
+    // A newer snapshot was published to file since Load()
+    bool            IsReplaced(const FileSystem::Path& file) const;
+    
+    const Header&   GetHeader() const noexcept { return m_Header; }
+    std::string     GetLastErrorMessage() const { return m_LastErrorMessage; }
+};
+
+#endif /* TreeSnapshot_hpp */
@@ -0,0 +1,89 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  Treemap.hpp                                                     */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#ifndef Treemap_hpp
+#define Treemap_hpp
+
+// Squarified treemap layout of a DirectoryTree in terminal cells.
+// The layout of the children of each node is cached per node and size of its
+// rectangle. It is only computed again if the node changed (size or number of
+// children), so unchanged subtrees are reused while a scan updates the totals.
+class Treemap
+{
+public:
+    struct Rect
+    {
+        int32_t x = 0;
+        int32_t y = 0;
+        int32_t width = 0;
+        int32_t height = 0;
+        
+        DirectoryTree::NodeIndex    node = DirectoryTree::INVALID_NODE;
+        uint32_t                    depth = 0; // 1 for children of the laid out node
+    };
+    
+private:
+    struct CacheEntry
+    {
+        int32_t     width = 0;
+        int32_t     height = 0;
+        uintmax_t   size = 0;
+        uint32_t    childCount = 0;
+        
+        std::vector<Rect>   rects; // Children, relative to the origin of the node
+    };
+    
+    static constexpr std::size_t MAX_CACHE_ENTRIES = 8192;
+    
+    std::unordered_map<DirectoryTree::NodeIndex, CacheEntry>    m_Cache;
+    uint32_t    m_MaxDepth = 2;
+    
+    static void Squarify(const DirectoryTree& tree, DirectoryTree::NodeIndex node, int32_t width, int32_t height, std::vector<Rect>& out_rects);
+    
+    const std::vector<Rect>&    GetChildLayout(const DirectoryTree& tree, DirectoryTree::NodeIndex node, int32_t width, int32_t height);
+    void                        LayoutRecursive(const DirectoryTree& tree, const Rect& rect, std::vector<Rect>& out_rects);
+    
+public:
+    Treemap() = default;
+    
+    // Lay out the subtree of node into width x height cells, down to the max depth.
+    // Parents come before their children in out_rects. Caller holds a shared lock on the tree.
+    void        Layout(const DirectoryTree& tree, DirectoryTree::NodeIndex node, int32_t width, int32_t height, std::vector<Rect>& out_rects);
+    void        Clear() noexcept { m_Cache.clear(); }
+    void        AccountMemory(MemoryAccounting& accounting) const; // May throw std::bad_alloc
+    
+    void        SetMaxDepth(uint32_t depth) noexcept { m_MaxDepth = std::max<uint32_t>(depth, 1); }
+    uint32_t    GetMaxDepth() const noexcept { return m_MaxDepth; }
+};
+
+#endif /* Treemap_hpp */
@@ -0,0 +1,93 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  TrigramIndex.hpp                                                */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#ifndef TrigramIndex_hpp
+#define TrigramIndex_hpp
+
+// Index over all interned names of a DirectoryTree for fast global search.
+// Every name is split into its (ASCII lower case) trigrams, a query only has to
+// verify the names which contain all trigrams of the query and map them to their
+// nodes, so the cost follows the number of candidates and not the tree size.
+// Names and nodes added to the tree after Build() are still found by a linear
+// scan, as are patterns without any trigram.
+class TrigramIndex
+{
+public:
+    struct SearchResult
+    {
+        std::vector<DirectoryTree::NodeIndex>   nodes;  // Sorted by size, descending
+        
+        uintmax_t   totalSize = 0;  // Matches inside of other matches are only counted once
+        uintmax_t   totalCount = 0;
+    };
+    
+private:
+    using Trigram = uint32_t;
+    
+    // Trigram -> name IDs, stored as compressed rows
+    std::vector<Trigram>                    m_Trigrams; // Sorted
+    std::vector<uint32_t>                   m_PostingOffsets;
+    std::vector<NamePool::NameID>           m_Postings;
+    
+    // Name ID -> nodes, stored as compressed rows
+    std::vector<uint32_t>                   m_NodeOffsets;
+    std::vector<DirectoryTree::NodeIndex>   m_NodesByName;
+    
+    std::size_t     m_IndexedNameCount = 0;
+    std::size_t     m_IndexedNodeCount = 0;
+    bool            m_IsBuilt = false;
+    
+    static void     CollectTrigrams(std::string_view text, std::vector<Trigram>& out_trigrams);
+    static void     CollectPatternTrigrams(std::string_view pattern, bool isGlob, std::vector<Trigram>& out_trigrams);
+    
+    std::span<const NamePool::NameID>   GetPostings(Trigram trigram) const noexcept;
+    
+public:
+    TrigramIndex() = default;
+    
+    // Caller must hold a shared lock on the tree for Build() and Search()
+    void    Build(const DirectoryTree& tree); // May throw std::bad_alloc
+    void    Clear() noexcept;
+    bool    IsBuilt() const noexcept { return m_IsBuilt; }
+    void    AccountMemory(MemoryAccounting& accounting) const; // May throw std::bad_alloc
+    
+    // A pattern containing *, ? or [ is matched as a glob against the whole name,
+    // anything else as a substring. Matching ignores ASCII case.
+    void    Search(const DirectoryTree& tree, std::string_view pattern, SearchResult& out_result) const; // May throw std::bad_alloc
+    
+    static bool IsGlobPattern(std::string_view pattern) noexcept;
+    static bool MatchGlob(std::string_view pattern, std::string_view name) noexcept;
+    static bool ContainsSubstring(std::string_view name, std::string_view pattern) noexcept;
+};
+
+#endif /* TrigramIndex_hpp */
@@ -0,0 +1,87 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  VirtualFileSystem.hpp                                           */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#ifndef VirtualFileSystem_hpp
+#define VirtualFileSystem_hpp
+
+// Source of the directory listings FileSystem::ScanDirectoryTree() reads. RealFileSystem
+// reads the disk, MemoryFileSystem simulates trees, so the scanner can be measured
+// without the cost of the kernel. Called by all scan workers at the same time.
+class VirtualFileSystem
+{
+public:
+    // Identity of an entry, to find further links to a file already counted
+    struct FileId
+    {
+        uint64_t    device = 0;
+        uint64_t    inode = 0;
+        uint64_t    linkCount = 1;
+    };
+    
+    virtual ~VirtualFileSystem() = default;
+    
+    // Entries of a directory without "." and "..", the outputs are cleared first. The names
+    // of out_entries are left empty, out_names holds them. Symbolic links are not followed,
+    // except if the directory itself is one and isRoot is set. Returns false and sets errno
+    // if the directory can't be read completely, the outputs keep what could be read.
+    virtual bool    ReadDirectory(const std::string& path, bool isRoot, std::vector<std::string>& out_names, std::vector<DirectoryTree::Entry>& out_entries, std::vector<FileId>& out_ids) = 0; // May throw std::bad_alloc
+    
+    // Own size of a directory, not of its contents. Stays 0 if unknown.
+    virtual void    GetDirectorySize(const std::string& path, uintmax_t& out_size, uintmax_t& out_allocatedSize) noexcept = 0;
+    
+    // Own size, time and change stamp (see DirectoryTree::Node) of a directory, for refreshes.
+    // Returns false and sets errno, ENOENT or ENOTDIR if it is gone. The default has no
+    // change stamps and fails with ENOTSUP, a refresh reads every directory again then.
+    virtual bool    StatDirectory(const std::string& path, DirectoryTree::Entry& out_entry) noexcept;
+    
+    // Size, allocated size and time of the named entries of a directory whose listing didn't
+    // change, in the order of names. Returns false and sets errno if the directory can't be
+    // opened or an entry is gone, then it has to be read again.
+    virtual bool    StatEntries(const std::string& path, const std::vector<std::string>& names, std::vector<DirectoryTree::Entry>& out_entries); // May throw std::bad_alloc
+};
+
+class RealFileSystem final : public VirtualFileSystem
+{
+public:
+    RealFileSystem() = default;
+    
+    bool    ReadDirectory(const std::string& path, bool isRoot, std::vector<std::string>& out_names, std::vector<DirectoryTree::Entry>& out_entries, std::vector<FileId>& out_ids) override; // May throw std::bad_alloc
+    void    GetDirectorySize(const std::string& path, uintmax_t& out_size, uintmax_t& out_allocatedSize) noexcept override;
+    bool    StatDirectory(const std::string& path, DirectoryTree::Entry& out_entry) noexcept override;
+    bool    StatEntries(const std::string& path, const std::vector<std::string>& names, std::vector<DirectoryTree::Entry>& out_entries) override; // May throw std::bad_alloc
+    
+    // It has no state, all scans share one
+    static std::shared_ptr<VirtualFileSystem> GetInstance();
+};
+
+#endif /* VirtualFileSystem_hpp */
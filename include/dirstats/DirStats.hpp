@@ -0,0 +1,215 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  DirStats.hpp                                                    */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#ifndef DirStats_hpp
+#define DirStats_hpp
+
+// C++ interface of the dirstats_core library, a thin inline wrapper of the
+// C interface in DirStatsCore.h. Only that is exported from the library, so
+// programs don't depend on its internal classes and compiler settings.
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <functional>
+#include <exception>
+#include <new>
+#include <utility>
+
+#include "DirStatsCore.h"
+
+namespace DirStats
+{
+using Node = dirstats_node;
+inline constexpr Node INVALID_NODE = DIRSTATS_INVALID_NODE;
+
+enum class NodeType : uint8_t
+{
+    REGULAR_FILE = DIRSTATS_REGULAR_FILE,
+    DIRECTORY = DIRSTATS_DIRECTORY,
+    SYMLINK = DIRSTATS_SYMLINK,
+    OTHER = DIRSTATS_OTHER
+};
+
+// Sizes and counts are recursive for directories. name is valid as long as the tree is not modified.
+struct Entry
+{
+    std::string_view    name;
+    Node                parent = INVALID_NODE;
+    uint32_t            childCount = 0;
+    uint64_t            size = 0;           // Apparent size
+    uint64_t            allocatedSize = 0;  // Size on disk
+    uint64_t            count = 0;          // Entries below
+    int64_t             lastWriteTime = 0;  // Seconds since epoch
+    NodeType            type = NodeType::REGULAR_FILE;
+    bool                hasError = false;   // Directory could not be read completely
+};
+
+// Scanned tree or loaded snapshot. Not thread safe, except for RequestStop().
+// Functions returning bool tell why they failed with GetLastErrorMessage().
+class Tree
+{
+public:
+    // Return true to stop
+    using ProgressCallback = std::function<bool(uint64_t entryCount)>;
+    using DirectoryCallback = std::function<bool(std::string_view path, const Entry& entry)>;
+    
+private:
+    dirstats_tree*  m_Tree = nullptr;
+    
+    // Exceptions of callbacks are passed through the C interface like this
+    template<typename Callback, typename... Args>
+    static int Call(const Callback& callback, std::exception_ptr& out_exception, Args&&... args) noexcept
+    {
+        try {
+            return callback(std::forward<Args>(args)...) ? 1 : 0;
+        }
+        catch (...) {
+            out_exception = std::current_exception();
+            return 1;
+        }
+    }
+    
+    static Entry ToEntry(const dirstats_entry& entry) noexcept
+    {
+        Entry result;
+        result.name = std::string_view(entry.name, entry.name_length);
+        result.parent = entry.parent;
+        result.childCount = entry.child_count;
+        result.size = entry.size;
+        result.allocatedSize = entry.allocated_size;
+        result.count = entry.count;
+        result.lastWriteTime = entry.last_write_time;
+        result.type = static_cast<NodeType>(entry.type);
+        result.hasError = (entry.has_error != 0);
+        
+        return result;
+    }
+    
+public:
+    Tree() : m_Tree(dirstats_tree_create()) // May throw std::bad_alloc
+    {
+        if(!m_Tree)
+            throw std::bad_alloc();
+    }
+    
+    ~Tree() { dirstats_tree_destroy(m_Tree); }
+    
+    Tree(const Tree&) = delete;
+    Tree& operator=(const Tree&) = delete;
+    Tree(Tree&& other) noexcept : m_Tree(std::exchange(other.m_Tree, nullptr)) {}
+    Tree& operator=(Tree&& other) noexcept { std::swap(m_Tree, other.m_Tree); return *this; }
+    
+    // Replaces the contents, threadCount 0 uses all cores. Progress is called about every 100 ms.
+    bool Scan(const std::string& path, uint32_t threadCount = 0, const ProgressCallback& progress = nullptr)
+    {
+        std::exception_ptr exception = nullptr;
+        std::pair<const ProgressCallback*, std::exception_ptr*> context(&progress, &exception);
+        
+        const int result = dirstats_scan(m_Tree, path.c_str(), threadCount, progress ? +[](const uint64_t entryCount, void* const userData)
+        {
+            const auto* const current = static_cast<std::pair<const ProgressCallback*, std::exception_ptr*>*>(userData);
+            return Call(*current->first, *current->second, entryCount);
+        } : nullptr, &context);
+        
+        if(exception)
+            std::rethrow_exception(exception);
+        
+        return result == 0;
+    }
+    
+    void RequestStop() noexcept { dirstats_request_stop(m_Tree); }
+    
+    // Query
+    Node GetRoot() const noexcept { return dirstats_root(m_Tree); }
+    
+    bool GetEntry(const Node node, Entry& out_entry) const noexcept
+    {
+        dirstats_entry entry;
+        if(dirstats_get_entry(m_Tree, node, &entry) != 0)
+            return false;
+        
+        out_entry = ToEntry(entry);
+        return true;
+    }
+    
+    std::vector<Node> GetChildren(const Node node) const // May throw std::bad_alloc
+    {
+        std::vector<Node> children(dirstats_get_children(m_Tree, node, nullptr, 0));
+        children.resize(dirstats_get_children(m_Tree, node, children.data(), children.size()));
+        
+        return children;
+    }
+    
+    // Below the root, absolute or relative to it. INVALID_NODE if not found.
+    Node Find(const std::string& path) const noexcept { return dirstats_find(m_Tree, path.c_str()); }
+    
+    std::string GetPath(const Node node) const // May throw std::bad_alloc
+    {
+        std::string path(dirstats_get_path(m_Tree, node, nullptr, 0), '\0');
+        dirstats_get_path(m_Tree, node, path.data(), path.size() + 1);
+        
+        return path;
+    }
+    
+    // Directories below node down to maxDepth levels (0: node only), children before their parent
+    bool WalkDirectories(const Node node, const uint32_t maxDepth, const DirectoryCallback& callback) const
+    {
+        std::exception_ptr exception = nullptr;
+        std::pair<const DirectoryCallback*, std::exception_ptr*> context(&callback, &exception);
+        
+        const int result = dirstats_walk_directories(m_Tree, node, maxDepth, [](const char* const path, const dirstats_entry* const entry, void* const userData)
+        {
+            const auto* const current = static_cast<std::pair<const DirectoryCallback*, std::exception_ptr*>*>(userData);
+            return Call(*current->first, *current->second, std::string_view(path), ToEntry(*entry));
+        }, &context);
+        
+        if(exception)
+            std::rethrow_exception(exception);
+        
+        return result == 0;
+    }
+    
+    // Persistence. A loaded snapshot is mapped and read-only.
+    bool PublishSnapshot(const std::string& file) { return dirstats_snapshot_publish(m_Tree, file.c_str()) == 0; }
+    bool LoadSnapshot(const std::string& file) { return dirstats_snapshot_load(m_Tree, file.c_str()) == 0; }
+    
+    std::string GetLastErrorMessage() const { return dirstats_last_error(m_Tree); }
+    
+    // For the C interface
+    dirstats_tree* GetHandle() const noexcept { return m_Tree; }
+};
+}
+
+#endif /* DirStats_hpp */
@@ -0,0 +1,138 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  DirStatsCore.h                                                  */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#ifndef DirStatsCore_h
+#define DirStatsCore_h
+
+/*
+    C interface of the dirstats_core library, for programs in other languages.
+    A tree is an opaque handle, nodes are indices into it. Functions returning int
+    return 0 on success and -1 on error, dirstats_last_error() tells why.
+    A tree must not be used by several threads at once, except for
+    dirstats_request_stop().
+    Only the functions declared here are exported from the library. Define
+    DIRSTATS_STATIC when linking the static library (CMake does it).
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(DIRSTATS_STATIC)
+#define DIRSTATS_API
+#elif defined(_WIN32) && defined(DIRSTATS_BUILDING_CORE)
+#define DIRSTATS_API __declspec(dllexport)
+#elif defined(_WIN32)
+#define DIRSTATS_API __declspec(dllimport)
+#else
+#define DIRSTATS_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DIRSTATS_API_VERSION 1
+#define DIRSTATS_INVALID_NODE UINT32_MAX
+
+typedef struct dirstats_tree dirstats_tree;
+typedef uint32_t dirstats_node;
+
+typedef enum dirstats_type
+{
+    DIRSTATS_REGULAR_FILE = 0,
+    DIRSTATS_DIRECTORY = 1,
+    DIRSTATS_SYMLINK = 2,
+    DIRSTATS_OTHER = 3
+} dirstats_type;
+
+/* Sizes and counts are recursive for directories. name is not terminated and
+   valid as long as the tree is not modified or destroyed. */
+typedef struct dirstats_entry
+{
+    const char*     name;
+    size_t          name_length;
+    dirstats_node   parent;
+    uint32_t        child_count;
+    uint64_t        size;               /* Apparent size */
+    uint64_t        allocated_size;     /* Size on disk */
+    uint64_t        count;              /* Entries below */
+    int64_t         last_write_time;    /* Seconds since epoch */
+    uint8_t         type;               /* dirstats_type */
+    uint8_t         has_error;          /* Directory could not be read completely */
+} dirstats_entry;
+
+/* Called about every 100 ms while scanning, with the number of entries so far.
+   Return nonzero to stop the scan. */
+typedef int (*dirstats_progress_callback)(uint64_t entry_count, void* user_data);
+
+/* Called for every directory in depth-first order, children before their parent.
+   path is terminated and only valid during the call. Return nonzero to stop. */
+typedef int (*dirstats_directory_callback)(const char* path, const dirstats_entry* entry, void* user_data);
+
+DIRSTATS_API int                 dirstats_api_version(void);
+
+DIRSTATS_API dirstats_tree*      dirstats_tree_create(void);
+DIRSTATS_API void                dirstats_tree_destroy(dirstats_tree* tree);
+DIRSTATS_API const char*         dirstats_last_error(const dirstats_tree* tree);
+
+/* Scan path into the tree, replacing its contents. thread_count 0 uses all cores.
+   progress may be NULL. A stopped scan keeps what was scanned and returns -1. */
+DIRSTATS_API int                 dirstats_scan(dirstats_tree* tree, const char* path, uint32_t thread_count, dirstats_progress_callback progress, void* user_data);
+DIRSTATS_API void                dirstats_request_stop(dirstats_tree* tree);
+
+/* Query */
+DIRSTATS_API dirstats_node       dirstats_root(const dirstats_tree* tree);
+DIRSTATS_API int                 dirstats_get_entry(const dirstats_tree* tree, dirstats_node node, dirstats_entry* out_entry);
+
+/* Writes up to capacity children to out_children, returns their total number */
+DIRSTATS_API size_t              dirstats_get_children(const dirstats_tree* tree, dirstats_node node, dirstats_node* out_children, size_t capacity);
+
+/* Node of a path below the root, absolute or relative to it. DIRSTATS_INVALID_NODE if not found. */
+DIRSTATS_API dirstats_node       dirstats_find(const dirstats_tree* tree, const char* path);
+
+/* Writes the terminated path to buffer, returns its length without the terminator
+   like snprintf(). The path is complete if the result is less than size. */
+DIRSTATS_API size_t              dirstats_get_path(const dirstats_tree* tree, dirstats_node node, char* buffer, size_t size);
+
+/* Stream the directories below node down to max_depth levels (0: node only) */
+DIRSTATS_API int                 dirstats_walk_directories(const dirstats_tree* tree, dirstats_node node, uint32_t max_depth, dirstats_directory_callback callback, void* user_data);
+
+/* Persistence, see TreeSnapshot. A loaded snapshot is mapped and read-only. */
+DIRSTATS_API int                 dirstats_snapshot_publish(dirstats_tree* tree, const char* file);
+DIRSTATS_API int                 dirstats_snapshot_load(dirstats_tree* tree, const char* file);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DirStatsCore_h */
@@ -0,0 +1,253 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  AllocationCounter.cpp                                           */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#include "DirStatsCore.hpp"
+
+namespace
+{
+    constexpr std::size_t PHASE_COUNT = static_cast<std::size_t>(AllocationCounter::Phase::COUNT);
+    
+    // Plain values, usable while a thread is started or torn down
+    thread_local constinit AllocationCounter::Phase threadPhase = AllocationCounter::Phase::OTHER;
+    
+#ifdef DST_COUNT_ALLOCATIONS
+    thread_local constinit AllocationCounter::PhaseCounts threadCounts = {};
+    
+    // One cache line per phase, the workers of a scan share them
+    struct alignas(64) SharedCounts
+    {
+        std::atomic<uint64_t>   allocations = 0;
+        std::atomic<uint64_t>   bytes = 0;
+    };
+    
+    constinit SharedCounts processCounts[PHASE_COUNT];
+    
+    void* CountedAllocate(const std::size_t size) noexcept
+    {
+        const std::size_t phase = static_cast<std::size_t>(threadPhase);
+        
+        threadCounts[phase].allocations++;
+        threadCounts[phase].bytes += size;
+        
+        processCounts[phase].allocations.fetch_add(1, std::memory_order_relaxed);
+        processCounts[phase].bytes.fetch_add(size, std::memory_order_relaxed);
+        
+        return std::malloc((size == 0) ? 1 : size);
+    }
+#endif
+}
+
+bool AllocationCounter::IsEnabled() noexcept
+{
+#ifdef DST_COUNT_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+}
+
+AllocationCounter::PhaseCounts AllocationCounter::GetThreadCounts() noexcept
+{
+#ifdef DST_COUNT_ALLOCATIONS
+    return threadCounts;
+#else
+    return {};
+#endif
+}
+
+AllocationCounter::PhaseCounts AllocationCounter::GetProcessCounts() noexcept
+{
+    PhaseCounts counts = {};
+    
+#ifdef DST_COUNT_ALLOCATIONS
+    for(std::size_t i = 0; i < PHASE_COUNT; i++)
+    {
+        counts[i].allocations = processCounts[i].allocations.load(std::memory_order_relaxed);
+        counts[i].bytes = processCounts[i].bytes.load(std::memory_order_relaxed);
+    }
+#endif
+    
+    return counts;
+}
+
+AllocationCounter::Counts AllocationCounter::GetTotal(const PhaseCounts& counts) noexcept
+{
+    Counts total;
+    
+    for(const Counts& phaseCounts : counts)
+    {
+        total.allocations += phaseCounts.allocations;
+        total.bytes += phaseCounts.bytes;
+    }
+    
+    return total;
+}
+
+AllocationCounter::PhaseCounts AllocationCounter::GetDifference(const PhaseCounts& later, const PhaseCounts& earlier) noexcept
+{
+    PhaseCounts difference = {};
+    
+    for(std::size_t i = 0; i < PHASE_COUNT; i++)
+    {
+        difference[i].allocations = later[i].allocations - earlier[i].allocations;
+        difference[i].bytes = later[i].bytes - earlier[i].bytes;
+    }
+    
+    return difference;
+}
+
+const char* AllocationCounter::GetPhaseName(const Phase phase) noexcept
+{
+    switch(phase)
+    {
+        case Phase::OTHER:      return "other";
+        case Phase::SCAN_READ:  return "scan: read directory";
+        case Phase::SCAN_LINKS: return "scan: hard links";
+        case Phase::SCAN_TREE:  return "scan: add to tree";
+        case Phase::SCAN_QUEUE: return "scan: queue subdirectories";
+        case Phase::UI_EVENT:   return "ui: handle event";
+        case Phase::UI_LISTING: return "ui: fill listing";
+        case Phase::UI_RENDER:  return "ui: build elements";
+        case Phase::UI_DRAW:    return "ui: draw";
+        case Phase::UI_OUTPUT:  return "ui: terminal output";
+        case Phase::COUNT:      break;
+    }
+    
+    return "";
+}
+
+void AllocationCounter::PrintCounts(std::ostream& out, const PhaseCounts& counts, const uint64_t unitCount, const std::string& unitName)
+{
+    const double divisor = static_cast<double>(std::max<uint64_t>(unitCount, 1));
+    
+    auto printLine = [&out, divisor](const std::string& name, const Counts& phaseCounts)
+    {
+        char values[64];
+        std::snprintf(values, sizeof(values), "%12.2f", static_cast<double>(phaseCounts.allocations) / divisor);
+        
+        std::string line = "  " + name;
+        line.resize(30, ' ');
+        line += values;
+        line += Format::PadLeft(Format::HumanReadableSize(static_cast<uintmax_t>(static_cast<double>(phaseCounts.bytes) / divisor)), 12);
+        
+        out << line << std::endl;
+    };
+    
+    const std::string perUnit = unitName.empty() ? "" : "/" + unitName;
+    out << "  Phase" << std::string(24, ' ') << Format::PadLeft("Allocs" + perUnit, 12) << Format::PadLeft("Bytes" + perUnit, 12) << std::endl;
+    
+    for(std::size_t i = 0; i < PHASE_COUNT; i++)
+    {
+        if(counts[i].allocations != 0)
+            printLine(GetPhaseName(static_cast<Phase>(i)), counts[i]);
+    }
+    
+    printLine("total", GetTotal(counts));
+}
+
+AllocationCounter::Phase AllocationCounter::SetThreadPhase(const Phase phase) noexcept
+{
+    const Phase previousPhase = threadPhase;
+    threadPhase = phase;
+    
+    return previousPhase;
+}
+
+#ifdef DST_COUNT_ALLOCATIONS
+// *******************************************************************
+// Replaced global allocation functions, the memory comes from malloc.
+// The aligned variants are not replaced and not counted.
+
+// GCC sees the free() of memory from operator new where it inlines these
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(const std::size_t size)
+{
+    void* const memory = CountedAllocate(size);
+    if(!memory)
+        throw std::bad_alloc();
+    
+    return memory;
+}
+
+void* operator new[](const std::size_t size)
+{
+    void* const memory = CountedAllocate(size);
+    if(!memory)
+        throw std::bad_alloc();
+    
+    return memory;
+}
+
+void* operator new(const std::size_t size, const std::nothrow_t&) noexcept
+{
+    return CountedAllocate(size);
+}
+
+void* operator new[](const std::size_t size, const std::nothrow_t&) noexcept
+{
+    return CountedAllocate(size);
+}
+
+void operator delete(void* const memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* const memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* const memory, const std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* const memory, const std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* const memory, const std::nothrow_t&) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* const memory, const std::nothrow_t&) noexcept
+{
+    std::free(memory);
+}
+#endif
@@ -39,7 +39,6 @@ App::App(int argc, char** argv)
     , m_Screen(ftxui::ScreenInteractive::Fullscreen())
 {
     m_CLIApp = std::make_unique<CLI::App>(GetDescription(), GetAppName());
-    m_AppUI = std::make_shared<AppUI>(&m_Screen, m_Screen.ExitLoopClosure());
 }
 
 void App::ParseCommandLine()
@@ -64,6 +63,56 @@ void App::ParseCommandLine()
     // Command line options
     m_CLIApp->add_option("-p,--path", startPathStr, "Path to start scanning in");
     m_CLIApp->add_flag("-a,--all", m_CLIShowAllFiles, "Show hidden files");//->group("SETTINGS");
+    m_CLIApp->add_flag("--index-names", m_CLIBuildNameIndex, "Build the global name search index right after scanning, instead of on first search");
+    m_CLIApp->add_option("--treemap-depth", m_CLITreemapDepth, "Number of directory levels shown in the treemap view")->check(CLI::Range(1, 16));
+    CLI::Option* outputOption = m_CLIApp->add_option("--output", m_CLIOutputFormat, "Don't start the UI, write the size of every directory as json, ndjson or csv, or folded stacks for flame graphs (folded)")->check(CLI::IsMember({"json", "ndjson", "csv", "folded"}));
+    m_CLIApp->add_option("--output-file", m_CLIOutputFile, "File for --output instead of stdout")->needs(outputOption);
+    m_CLIApp->add_option("--folded-threshold", m_CLIFoldedThreshold, "Entries smaller than this percentage of the total are merged into their directory with --output folded")->needs(outputOption)->check(CLI::Range(0.0, 100.0))->capture_default_str();
+    m_CLIApp->add_option("--hot-path-threshold", m_CLIHotPathThreshold, "Hot path (key 'h') follows the largest child while it holds at least this percentage of its parent")->check(CLI::Range(0.0, 100.0));
+    
+    CLI::Option* importOption = m_CLIApp->add_option("--import", m_CLIImportFile, "Browse an export of ncdu (ncdu -o FILE) instead of scanning")->excludes(outputOption);
+    
+    CLI::Option* daemonOption = m_CLIApp->add_flag("--daemon", m_CLIRunDaemon, "Don't start the UI, keep the scanned tree in memory and serve it to --attach")->excludes(outputOption)->excludes(importOption);
+    CLI::Option* attachOption = m_CLIApp->add_flag("--attach", m_CLIAttach, "Browse the tree of a running --daemon instead of scanning")->excludes(daemonOption)->excludes(outputOption)->excludes(importOption);
+    m_CLIApp->add_option("--socket", m_CLISocketPath, "Unix socket of the daemon")->capture_default_str();
+    m_CLIApp->add_option("--refresh-interval", m_CLIRefreshInterval, "Seconds between refreshes of the daemon tree, 0 to never refresh")->needs(daemonOption)->capture_default_str();
+    
+    CLI::Option* publishOption = m_CLIApp->add_option("--publish", m_CLIPublishFile, "Don't start the UI, scan and publish the tree as snapshot FILE (e.g. /dev/shm/dirstats). Every run is a full scan, with --daemon the tree is published after every refresh instead")->excludes(outputOption)->excludes(importOption);
+    CLI::Option* snapshotOption = m_CLIApp->add_option("--snapshot", m_CLISnapshotFile, "Browse a snapshot of --publish instead of scanning, or export it with --output")->excludes(publishOption)->excludes(importOption)->excludes(daemonOption);
+    m_CLIApp->add_option("--diff", m_CLIDiffFiles, "Browse the changes between two snapshots OLD NEW, sorted by growth")->expected(2)->excludes(snapshotOption)->excludes(publishOption)->excludes(importOption)->excludes(daemonOption)->excludes(attachOption)->excludes(outputOption);
+    
+    CLI::Option* recordHistoryOption = m_CLIApp->add_option("--record-history", m_CLIRecordHistoryFile, "Don't start the UI, scan and append the totals of large directories to history FILE, after every scan with --daemon")->excludes(outputOption)->excludes(importOption)->excludes(snapshotOption);
+    m_CLIApp->add_option("--history-min-size", m_CLIHistoryMinSize, "Directories recorded in the history are at least this large, in MiB")->needs(recordHistoryOption)->capture_default_str();
+    CLI::Option* historyOption = m_CLIApp->add_option("--history", m_CLIHistoryFile, "Don't start the UI, print the recorded totals of --path of the last --forecast-days days from history FILE and forecast when the volume is full")->excludes(recordHistoryOption)->excludes(outputOption)->excludes(daemonOption);
+    m_CLIApp->add_option("--forecast-days", m_CLIForecastDays, "Days of history printed and the forecast is based on")->needs(historyOption)->check(CLI::Range(1u, 36500u))->capture_default_str();
+    
+    CLI::Option* prometheusOption = m_CLIApp->add_option("--prometheus", m_CLIPrometheusFile, "Don't start the UI, write directory sizes as Prometheus metrics to FILE for the node_exporter textfile collector. Every run is a full scan, with --daemon the metrics are written after every refresh, with --snapshot without scanning")->excludes(outputOption)->excludes(importOption)->excludes(attachOption)->excludes(historyOption);
+    m_CLIApp->add_option("--prometheus-depth", m_CLIPrometheusDepth, "Directories down to this depth below --path are written as metrics")->needs(prometheusOption)->check(CLI::Range(0u, 64u))->capture_default_str();
+    m_CLIApp->add_option("--prometheus-min-size", m_CLIPrometheusMinSize, "Deeper directories are written if they are at least this large, in MiB, 0 for none")->needs(prometheusOption)->capture_default_str();
+    m_CLIApp->add_option("-j,--threads", m_CLIThreadCount, "Number of threads for scanning")->check(CLI::Range(1u, 1024u));
+    m_CLIApp->add_option("--trace", m_CLITraceFile, "Record what the scanner and UI threads do and write it to FILE on exit, as Chrome trace JSON for ui.perfetto.dev");
+    m_CLIApp->add_option("--rollup", m_CLIRollupFileCount, "Keep only the K largest files of every directory, the others just count into its totals (which stay exact), 0 for directories only")->check(CLI::Range(0u, FileSystem::ALL_FILES - 1))->excludes(importOption);
+    m_CLIApp->add_option("--memory-limit", m_CLIMemoryLimit, "Resident memory in MiB at which a scan keeps only directories, files just count into their totals, 0 for none. A streamed export keeps no tree and ignores it")->capture_default_str();
+    m_CLIApp->add_option("--stats", m_CLIStatsFormat, "Don't start the UI, scan and report where the time went (phases, latencies, errors, slowest directories and mounts) and the memory of every data structure as text or json")->check(CLI::IsMember({"text", "json"}))->excludes(outputOption)->excludes(importOption)->excludes(daemonOption)->excludes(attachOption)->excludes(publishOption)->excludes(snapshotOption)->excludes(recordHistoryOption)->excludes(historyOption)->excludes(prometheusOption);
+    
+    // du compatible mode: DirStatsTUI du [OPTIONS] [PATHS]
+    m_CLIDiskUsageCommand = m_CLIApp->add_subcommand("du", "Print disk usage like du(1) and exit");
+    m_CLIDiskUsageCommand->set_help_flag("--help", "Display help and exit");
+    m_CLIDiskUsageCommand->fallthrough(); // Allow --threads after du
+    m_CLIDiskUsageCommand->add_flag("-s,--summarize", m_CLIDiskUsageOptions.summarize, "Display only a total for each argument");
+    m_CLIDiskUsageCommand->add_option("-d,--max-depth", m_CLIDiskUsageOptions.maxDepth, "Print the total for a directory only if it is N or fewer levels below the argument")->check(CLI::NonNegativeNumber);
+    m_CLIDiskUsageCommand->add_flag("-a,--all", m_CLIDiskUsageOptions.all, "Write counts for all files, not just directories");
+    m_CLIDiskUsageCommand->add_flag("--apparent-size", m_CLIDiskUsageOptions.apparentSize, "Print apparent sizes rather than disk usage");
+    m_CLIDiskUsageUnitOptions = {
+        {m_CLIDiskUsageCommand->add_flag("-b,--bytes", "Equivalent to --apparent-size --block-size=1"), DiskUsage::Unit::BYTES},
+        {m_CLIDiskUsageCommand->add_flag("-k", "Block size of 1K (default)"), DiskUsage::Unit::KILOBYTES},
+        {m_CLIDiskUsageCommand->add_flag("-m", "Block size of 1M"), DiskUsage::Unit::MEGABYTES},
+        {m_CLIDiskUsageCommand->add_flag("-h,--human-readable", "Print sizes in human readable format (e.g. 1K 234M 2G)"), DiskUsage::Unit::HUMAN_READABLE},
+        {m_CLIDiskUsageCommand->add_flag("--si", "Like -h, but use powers of 1000 not 1024"), DiskUsage::Unit::SI}
+    };
+    m_CLIDiskUsageCommand->add_flag("-0,--null", m_CLIDiskUsageOptions.nullTerminated, "End each output line with NUL, not newline");
+    m_CLIDiskUsageCommand->add_flag("-c,--total", m_CLIDiskUsageOptions.total, "Produce a grand total");
+    m_CLIDiskUsageCommand->add_option("paths", m_CLIDiskUsagePaths, "Files and directories, the current directory if none");
     
     m_CLIApp->set_version_flag("-v,--version", GetVersionString)->group("INFO");
     m_CLIApp->set_help_flag("-h,--help", "Display help and exit")->group("INFO");
@@ -84,19 +133,365 @@ int App::Run()
         return m_CLIApp->exit(e);
     }
     
+    if(m_CLITraceFile.empty())
+        return RunMode();
+    
+    Tracer::SetThreadName("main");
+    Tracer::Enable();
+    
+    const int result = RunMode();
+    
+    Tracer::Disable();
+    
+    std::string errorMessage;
+    if(!Tracer::WriteChromeTrace(CLI::to_path(m_CLITraceFile), errorMessage))
+        std::cerr << "Writing trace failed: " << errorMessage << std::endl;
+    
+    return result;
+}
+
+int App::RunMode()
+{
+    // du compatible mode
+    if(m_CLIDiskUsageCommand->parsed())
+    {
+        if(m_CLIDiskUsagePaths.empty())
+            m_CLIDiskUsagePaths.push_back(".");
+        
+        m_CLIDiskUsageOptions.threadCount = m_CLIThreadCount;
+        
+        // Like du the last unit option counts, -b means apparent sizes anyway
+        for(const CLI::Option* option : m_CLIDiskUsageCommand->parse_order())
+        {
+            const auto unit = std::find_if(m_CLIDiskUsageUnitOptions.begin(), m_CLIDiskUsageUnitOptions.end(), [option](const auto& i) { return i.first == option; });
+            if(unit == m_CLIDiskUsageUnitOptions.end())
+                continue;
+            
+            m_CLIDiskUsageOptions.unit = unit->second;
+            
+            if(unit->second == DiskUsage::Unit::BYTES)
+                m_CLIDiskUsageOptions.apparentSize = true;
+        }
+        
+        try {
+            return DiskUsage(m_CLIDiskUsageOptions).Run(m_CLIDiskUsagePaths);
+        }
+        catch (const std::bad_alloc&) {
+            std::cerr << "du: Out of memory" << std::endl;
+            return 1;
+        }
+    }
+    
+    // Headless mode, no UI at all
+    if(!m_CLIOutputFormat.empty())
+        return RunHeadless();
+    
+    if(!m_CLIStatsFormat.empty())
+        return RunStatistics();
+    
+    // Background indexer, no UI either
+    if(m_CLIRunDaemon)
+    {
+        Daemon daemon(m_CLIStartingPath, m_CLISocketPath, std::chrono::seconds(m_CLIRefreshInterval), m_CLIThreadCount);
+        daemon.SetPublishFile(CLI::to_path(m_CLIPublishFile));
+        daemon.SetHistoryFile(CLI::to_path(m_CLIRecordHistoryFile), m_CLIHistoryMinSize * 1024 * 1024);
+        daemon.SetPrometheusFile(CLI::to_path(m_CLIPrometheusFile), m_CLIPrometheusDepth, m_CLIPrometheusMinSize ? m_CLIPrometheusMinSize * 1024 * 1024 : UINTMAX_MAX);
+        daemon.SetFileNodeLimit(m_CLIRollupFileCount);
+        daemon.SetMemoryLimit(m_CLIMemoryLimit * 1024 * 1024);
+        
+        return daemon.Run();
+    }
+    
+    if(!m_CLIPublishFile.empty() || !m_CLIRecordHistoryFile.empty() || !m_CLIPrometheusFile.empty())
+        return RunPublish();
+    
+    if(!m_CLIHistoryFile.empty())
+        return RunHistory();
+    
+    m_AppUI = std::make_shared<AppUI>(&m_Screen, m_Screen.ExitLoopClosure());
+    
     // Set arguments from CLI
     m_AppUI->SetStartingPath(m_CLIStartingPath);
     m_AppUI->SetShowAllFiles(m_CLIShowAllFiles);
+    m_AppUI->SetBuildNameIndex(m_CLIBuildNameIndex);
+    m_AppUI->SetTreemapDepth(m_CLITreemapDepth);
+    m_AppUI->SetHotPathThreshold(m_CLIHotPathThreshold / 100.0);
+    m_AppUI->SetScanThreadCount(m_CLIThreadCount);
+    m_AppUI->SetFileNodeLimit(m_CLIRollupFileCount);
+    m_AppUI->SetMemoryLimit(m_CLIMemoryLimit * 1024 * 1024);
+    m_AppUI->SetImportFile(CLI::to_path(m_CLIImportFile));
+    
+    m_AppUI->SetSnapshotFile(CLI::to_path(m_CLISnapshotFile));
+    
+    if(m_CLIDiffFiles.size() == 2)
+        m_AppUI->SetDiffFiles(CLI::to_path(m_CLIDiffFiles[0]), CLI::to_path(m_CLIDiffFiles[1]));
     
-    if(!m_AppUI->UpdateSpaceInfo())
+    if(m_CLIAttach)
+        m_AppUI->SetDaemonSocket(m_CLISocketPath);
+    
+    // Space of the local file system means nothing for an import, the daemon and snapshot know their path
+    if(m_CLIImportFile.empty() && !m_CLIAttach && m_CLISnapshotFile.empty() && m_CLIDiffFiles.empty() && !m_AppUI->UpdateSpaceInfo())
         return -5;
     
+    // Scan in background while the UI is running
+    m_AppUI->StartScan();
+    
     // Run UI
     m_Screen.Loop(m_AppUI);
     
     return 0;
 }
 
+int App::RunHeadless()
+{
+    BatchExporter::OutputFormat format = BatchExporter::OutputFormat::NDJSON;
+    BatchExporter::ParseFormat(m_CLIOutputFormat, format);
+    
+    BatchExporter exporter(format);
+    exporter.SetFoldedThreshold(m_CLIFoldedThreshold / 100.0);
+    const std::atomic<bool> stop = false;
+    
+    try {
+        // Export a mapped snapshot without scanning. Folded stacks need the
+        // whole tree for the threshold, it is scanned first.
+        if(!m_CLISnapshotFile.empty() || format == BatchExporter::OutputFormat::FOLDED)
+        {
+            DirectoryTree tree;
+            TreeSnapshot snapshot;
+            FileSystem fileSystem;
+            fileSystem.SetFileNodeLimit(m_CLIRollupFileCount);
+            fileSystem.SetMemoryLimit(m_CLIMemoryLimit * 1024 * 1024);
+            
+            if(!m_CLISnapshotFile.empty() && !snapshot.Load(CLI::to_path(m_CLISnapshotFile), tree))
+            {
+                std::cerr << "Export failed: " << snapshot.GetLastErrorMessage() << std::endl;
+                return -6;
+            }
+            
+            if(m_CLISnapshotFile.empty() && !fileSystem.ScanDirectoryTree(m_CLIStartingPath, tree, stop, m_CLIThreadCount))
+            {
+                std::cerr << "Export failed: " << fileSystem.GetLastError().GetMessage() << std::endl;
+                return -6;
+            }
+            
+            if(fileSystem.HasReachedMemoryLimit())
+            {
+                const std::size_t droppedCount = tree.DropFileNodes();
+                std::cerr << "Memory limit reached: files folded into their directories, " << droppedCount << " file nodes dropped" << std::endl;
+            }
+            
+            if(!exporter.Export(tree, CLI::to_path(m_CLIOutputFile)))
+            {
+                std::cerr << "Export failed: " << exporter.GetLastError().GetMessage() << std::endl;
+                return -6;
+            }
+            
+            return 0;
+        }
+        
+        if(!exporter.Run(m_CLIStartingPath, CLI::to_path(m_CLIOutputFile), stop, m_CLIThreadCount))
+        {
+            std::cerr << "Export failed: " << exporter.GetLastError().GetMessage() << std::endl;
+            return -6;
+        }
+    }
+    catch (const std::bad_alloc&) {
+        std::cerr << "Export failed: Out of memory" << std::endl;
+        return -6;
+    }
+    
+    return 0;
+}
+
+int App::RunPublish()
+{
+    DirectoryTree tree;
+    FileSystem fileSystem;
+    TreeSnapshot snapshot;
+    const std::atomic<bool> stop = false;
+    
+    fileSystem.SetFileNodeLimit(m_CLIRollupFileCount);
+    fileSystem.SetMemoryLimit(m_CLIMemoryLimit * 1024 * 1024);
+    
+    try {
+        PrometheusExporter::ScanInfo scanInfo;
+        
+        // Metrics of a snapshot published by the daemon need no scan at all
+        if(!m_CLISnapshotFile.empty())
+        {
+            if(!snapshot.Load(CLI::to_path(m_CLISnapshotFile), tree))
+            {
+                std::cerr << "Loading snapshot failed: " << snapshot.GetLastErrorMessage() << std::endl;
+                return -7;
+            }
+            
+            scanInfo.time = snapshot.GetHeader().createdTime;
+        }
+        else
+        {
+            // A full scan on every run, nothing is kept between runs. Periodic publishing
+            // is cheaper with --daemon, which refreshes only the changed directories.
+            const auto start = std::chrono::steady_clock::now();
+            
+            if(!fileSystem.ScanDirectoryTree(m_CLIStartingPath, tree, stop, m_CLIThreadCount))
+            {
+                std::cerr << "Scan failed: " << fileSystem.GetLastError().GetMessage() << std::endl;
+                return -7;
+            }
+            
+            scanInfo.time = static_cast<int64_t>(std::time(nullptr));
+            scanInfo.durationSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            
+            if(fileSystem.HasReachedMemoryLimit())
+            {
+                const std::size_t droppedCount = tree.DropFileNodes();
+                std::cerr << "Memory limit reached: files folded into their directories, " << droppedCount << " file nodes dropped" << std::endl;
+            }
+        }
+        
+        if(!m_CLIPublishFile.empty() && !snapshot.Publish(tree, CLI::to_path(m_CLIPublishFile)))
+        {
+            std::cerr << "Publishing failed: " << snapshot.GetLastErrorMessage() << std::endl;
+            return -7;
+        }
+        
+        if(!m_CLIRecordHistoryFile.empty())
+        {
+            uintmax_t capacity = 0;
+            uintmax_t free = 0;
+            uintmax_t available = 0;
+            
+            if(!fileSystem.GetSpaceInfo(m_CLIStartingPath, capacity, free, available))
+            {
+                std::cerr << "Recording history failed: " << fileSystem.GetLastError().GetMessage() << std::endl;
+                return -8;
+            }
+            
+            HistoryStore history;
+            if(!history.Append(tree, CLI::to_path(m_CLIRecordHistoryFile), m_CLIHistoryMinSize * 1024 * 1024, capacity, available))
+            {
+                std::cerr << "Recording history failed: " << history.GetLastErrorMessage() << std::endl;
+                return -8;
+            }
+        }
+        
+        if(!m_CLIPrometheusFile.empty())
+        {
+            PrometheusExporter exporter(m_CLIPrometheusDepth, m_CLIPrometheusMinSize ? m_CLIPrometheusMinSize * 1024 * 1024 : UINTMAX_MAX);
+            
+            if(!exporter.Write(tree, CLI::to_path(m_CLIPrometheusFile), scanInfo))
+            {
+                std::cerr << "Writing metrics failed: " << exporter.GetLastErrorMessage() << std::endl;
+                return -9;
+            }
+        }
+    }
+    catch (const std::bad_alloc&) {
+        std::cerr << "Publishing failed: Out of memory" << std::endl;
+        return -7;
+    }
+    
+    return 0;
+}
+
+int App::RunHistory()
+{
+    HistoryStore history;
+    std::vector<HistoryStore::Sample> samples;
+    
+    try {
+        if(!history.Query(CLI::to_path(m_CLIHistoryFile), m_CLIStartingPath, static_cast<int64_t>(m_CLIForecastDays) * 24 * 60 * 60, samples))
+        {
+            std::cerr << "Reading history failed: " << history.GetLastErrorMessage() << std::endl;
+            return -8;
+        }
+    }
+    catch (const std::bad_alloc&) {
+        std::cerr << "Reading history failed: Out of memory" << std::endl;
+        return -8;
+    }
+    
+    // One line per scan
+    std::cout << Format::PadLeft("Time", 19) << Format::PadLeft("Size", 12) << Format::PadLeft("Allocated", 12) << Format::PadLeft("Entries", 12)
+              << Format::PadLeft("Used", 12) << Format::PadLeft("Available", 12) << "\n";
+    
+    for(const HistoryStore::Sample& sample : samples)
+    {
+        const uintmax_t used = sample.capacity - std::min(sample.available, sample.capacity);
+        
+        std::cout << Format::DateTime(sample.time)
+                  << Format::PadLeft(sample.isFound ? Format::HumanReadableSize(sample.size) : "-", 12)
+                  << Format::PadLeft(sample.isFound ? Format::HumanReadableSize(sample.allocatedSize) : "-", 12)
+                  << Format::PadLeft(sample.isFound ? std::to_string(sample.count) : "-", 12)
+                  << Format::PadLeft(Format::HumanReadableSize(used), 12)
+                  << Format::PadLeft(Format::HumanReadableSize(sample.available), 12) << "\n";
+    }
+    
+    // Trend of the last days
+    const HistoryStore::Forecast forecast = HistoryStore::ForecastFill(samples, static_cast<int64_t>(m_CLIForecastDays) * 24 * 60 * 60);
+    if(!forecast.isValid)
+    {
+        std::cout << "\nNot enough scans in the last " << m_CLIForecastDays << " days for a forecast" << std::endl;
+        return 0;
+    }
+    
+    auto perDay = [](const double bytes)
+    {
+        return Format::HumanReadableDelta(static_cast<int64_t>(bytes)) + " per day";
+    };
+    
+    std::cout << "\nLast " << m_CLIForecastDays << " days: " << m_CLIStartingPath.string() << " " << perDay(forecast.sizePerDay)
+              << ", used space of the volume " << perDay(forecast.usedPerDay) << "\n";
+    
+    if(forecast.fullTime < 0)
+        std::cout << "The volume doesn't fill up at this rate" << std::endl;
+    else
+        std::cout << "The volume is full in " << (forecast.fullTime - samples.back().time) / (24 * 60 * 60) << " days at this rate, on " << Format::DateTime(forecast.fullTime) << std::endl;
+    
+    return 0;
+}
+
+int App::RunStatistics()
+{
+    DirectoryTree tree;
+    FileSystem fileSystem;
+    ScanStatistics statistics;
+    const std::atomic<bool> stop = false;
+    
+    fileSystem.SetScanStatistics(&statistics);
+    fileSystem.SetFileNodeLimit(m_CLIRollupFileCount);
+    fileSystem.SetMemoryLimit(m_CLIMemoryLimit * 1024 * 1024);
+    
+    try {
+        if(!fileSystem.ScanDirectoryTree(m_CLIStartingPath, tree, stop, m_CLIThreadCount))
+        {
+            std::cerr << "Scan failed: " << fileSystem.GetLastError().GetMessage() << std::endl;
+            return -10;
+        }
+        
+        // Degrade like the UI does, the report shows what is left
+        if(fileSystem.HasReachedMemoryLimit())
+        {
+            const std::size_t droppedCount = tree.DropFileNodes();
+            std::cerr << "Memory limit reached: files folded into their directories, " << droppedCount << " file nodes dropped" << std::endl;
+        }
+        
+        MemoryAccounting memory;
+        tree.AccountMemory(memory);
+        
+        if(m_CLIStatsFormat == "json")
+            statistics.WriteJson(std::cout, &memory);
+        else
+            statistics.WriteText(std::cout, &memory);
+    }
+    catch (const std::bad_alloc&) {
+        std::cerr << "Scan failed: Out of memory" << std::endl;
+        return -10;
+    }
+    
+    return 0;
+}
+
 int32_t App::GetVersionMajor() noexcept
 {
     return DirStatsTUI::CM_VERSION_MAJOR;
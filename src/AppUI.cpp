@@ -45,6 +45,8 @@ void OnChange()
 
 void AppUI::UpdateSpinnerTask() noexcept
 {
+    uint32_t tick = 0;
+    
     while(!m_StopSpinnerThread)
     {
         m_SpinnerValue++;
@@ -52,6 +54,16 @@ void AppUI::UpdateSpinnerTask() noexcept
         if(m_SpinnerValue > 199)
             m_SpinnerValue = 0;
         
+        tick++;
+        
+        // Refresh the listing about once a second while the scan updates the totals
+        if((m_IsScanning || m_Deleter.IsRunning()) && (tick % 10) == 0)
+            m_Screen->Post([this] { UpdateMainView(); });
+        
+        // Look for new totals of an attached daemon or a new snapshot every few seconds
+        if((tick % 30) == 0)
+            m_Screen->Post([this] { CheckForUpdates(); });
+        
         // Post a custom event to request rendering a new frame
         m_Screen->Post(ftxui::Event::Custom);
         
@@ -66,11 +78,16 @@ AppUI::AppUI(ftxui::ScreenInteractive* screen, std::function<void()> quit)
 {
     // Add main menu component
     m_Menu = std::make_shared<MenuComponent>();
-    m_Menu->SetOnEnterFunction(m_QuitFunction);
+    m_Menu->SetOnEnterFunction([this] { OnMenuEnter(); });
     m_Menu->SetOnChangeFunction(OnChange);
     
     this->Add(m_Menu);
     
+    // Redraw when details of an entry are loaded
+    m_EntryDetails.SetOnReadyFunction([this] { m_Screen->Post(ftxui::Event::Custom); });
+    
+    m_Deleter.SetOnFinishedFunction([this] { m_Screen->Post([this] { OnDeletionFinished(); }); });
+    
     //UpdateMainView();
     
     // Start spinner task
@@ -83,6 +100,133 @@ AppUI::~AppUI()
     // Wait for spinner thread to join
     m_StopSpinnerThread = true;
     m_SpinnerUpdateThread.join();
+    
+    // Stop a running scan
+    m_StopScan = true;
+    if(m_ScanThread.joinable())
+        m_ScanThread.join();
+    
+    if(m_SearchThread.joinable())
+        m_SearchThread.join();
+}
+
+void AppUI::StartScan()
+{
+    // Two snapshots are compared, nothing is scanned
+    if(IsDiffView())
+    {
+        LoadDiff();
+        return;
+    }
+    
+    // The daemon scanned already, attaching is instant
+    if(!m_DaemonSocketPath.empty())
+    {
+        AttachToDaemon();
+        return;
+    }
+    
+    // Mapping a snapshot is instant as well
+    if(!m_SnapshotFile.empty())
+    {
+        LoadSnapshot();
+        return;
+    }
+    
+    m_IsScanning = true;
+    m_ScanThread = std::thread(&AppUI::ScanTask, this);
+}
+
+void AppUI::ScanTask()
+{
+    Tracer::SetThreadName("ui scan");
+    
+    // Own instance, m_FileSystem is used by the UI thread
+    FileSystem fileSystem(m_VirtualFileSystem);
+    fileSystem.SetScanProgress(&m_ScanProgress);
+    fileSystem.SetFileNodeLimit(m_FileNodeLimit);
+    fileSystem.SetMemoryLimit(m_MemoryLimit);
+    
+    bool hasReachedMemoryLimit = false;
+    
+    try {
+        if(m_ImportFile.empty())
+        {
+            fileSystem.ScanDirectoryTree(m_StartingPath, m_Tree, m_StopScan, m_ScanThreadCount);
+            hasReachedMemoryLimit = fileSystem.HasReachedMemoryLimit();
+        }
+        else
+        {
+            Probes::ScanPhase("import", m_ImportFile.string().c_str());
+            
+            NcduImporter importer;
+            if(!importer.Import(m_ImportFile, m_Tree, m_StopScan))
+                m_Screen->Post([this, message = importer.GetLastErrorMessage()] { m_ErrorMessage = "Import failed: " + message; });
+        }
+        
+        // Build the name index now if requested, or rebuild it if a search
+        // built it early while the scan was still running
+        std::lock_guard indexLock(m_NameIndexMutex);
+        if((m_BuildNameIndex || m_NameIndex.IsBuilt()) && !m_StopScan && !hasReachedMemoryLimit)
+        {
+            std::shared_lock treeLock(m_Tree.GetMutex());
+            
+            Probes::ScanPhase("index", m_StartingPath.string().c_str());
+            m_NameIndex.Build(m_Tree);
+        }
+    }
+    catch (const std::bad_alloc&) {
+        // Keep what was scanned so far
+    }
+    
+    Probes::ScanPhase("ready", m_StartingPath.string().c_str());
+    m_IsScanning = false;
+    m_Screen->Post([this, hasReachedMemoryLimit]
+    {
+        if(hasReachedMemoryLimit)
+            OnMemoryLimitReached();
+        
+        UpdateMainView();
+    });
+}
+
+void AppUI::SearchTask(const std::string& pattern)
+{
+    TrigramIndex::SearchResult result;
+    
+    {
+        std::lock_guard indexLock(m_NameIndexMutex);
+        std::shared_lock treeLock(m_Tree.GetMutex());
+        
+        // Build the index on first use. Entries added afterwards are still found.
+        if(!m_NameIndex.IsBuilt())
+            m_NameIndex.Build(m_Tree);
+        
+        m_NameIndex.Search(m_Tree, pattern, result);
+    }
+    
+    // Still searching until the result is shown, the tree must not be replaced before
+    m_Screen->Post([this, pattern, result]
+    {
+        ShowSearchResult(pattern, result);
+        m_IsSearching = false;
+        
+        // Reached during the search, the result view is left again then
+        DropPendingFileNodes();
+    });
+}
+
+void AppUI::ShowSearchResult(const std::string& pattern, const TrigramIndex::SearchResult& result)
+{
+    // Show the results as a virtual directory
+    m_IsVirtualView = true;
+    m_HotPath.clear();
+    m_ViewEntries = result.nodes;
+    m_VirtualViewTitle = "Search \"" + pattern + "\": " + std::to_string(result.nodes.size()) + " matches, "
+                        + Format::HumanReadableSize(result.totalSize) + " in " + std::to_string(result.totalCount) + " entries";
+    
+    UpdateMainView();
+    m_Menu->SetSelection(0);
 }
 
 bool AppUI::UpdateSpaceInfo()
@@ -107,61 +251,1411 @@ bool AppUI::UpdateSpaceInfo()
 
 bool AppUI::UpdateMainView()
 {
+    const AllocationCounter::ScopedPhase allocationPhase(AllocationCounter::Phase::UI_LISTING);
+    const Tracer::ScopedSpan span(Tracer::Category::UI, "listing");
+    
+    if(IsDiffView())
+    {
+        UpdateDiffView();
+        return !m_Diff.IsEmpty();
+    }
+    
+    // Children of a mirrored directory are loaded in background when it is shown, the view is updated then
+    if(m_DaemonClient && !m_IsVirtualView && m_Tree.GetRoot() != DirectoryTree::INVALID_NODE)
+        RequestDaemonLoad((m_CurrentNode == DirectoryTree::INVALID_NODE) ? m_Tree.GetRoot() : m_CurrentNode, 1, GetDaemonWindow());
+    
+    std::shared_lock lock(m_Tree.GetMutex());
+    
+    if(m_CurrentNode == DirectoryTree::INVALID_NODE)
+        m_CurrentNode = m_Tree.GetRoot();
+    
+    if(m_CurrentNode == DirectoryTree::INVALID_NODE)
+        return false;
+    
+    // The current directory may have been deleted, go to the closest remaining parent
+    while(m_Tree.GetNode(m_CurrentNode).isRemoved && m_Tree.GetNode(m_CurrentNode).parent != DirectoryTree::INVALID_NODE)
+        m_CurrentNode = m_Tree.GetNode(m_CurrentNode).parent;
+    
+    // Keep the selected entry selected, its position may change with new sizes
+    const DirectoryTree::NodeIndex selectedNode = GetSelectedNode();
+    
+    if(!m_IsVirtualView)
+    {
+        m_ViewEntries.clear();
+        m_Tree.GetChildren(m_CurrentNode, m_ViewEntries);
+        
+        if(!m_ShowAllFiles)
+            std::erase_if(m_ViewEntries, [this](const DirectoryTree::NodeIndex i) { return m_Tree.GetName(i).starts_with('.'); });
+    }
+    else
+    {
+        // Deleted search results
+        std::erase_if(m_ViewEntries, [this](const DirectoryTree::NodeIndex i) { return m_Tree.GetNode(i).isRemoved; });
+    }
+    
+    SortViewEntries();
+    
+    m_Menu->ClearEntries();
+    for(const DirectoryTree::NodeIndex i : m_ViewEntries)
+    {
+        const DirectoryTree::Node& node = m_Tree.GetNode(i);
+        
+        MenuComponent::MenuEntry entry;
+        entry.name = m_IsVirtualView ? m_Tree.GetPath(i).string() : std::string(m_Tree.GetName(i));
+        entry.isDirectory = (node.type == DirectoryTree::NodeType::DIRECTORY);
+        entry.count = node.count;
+        entry.size = node.size;
+        entry.isMarked = m_MarkedNodes.contains(i);
+        
+        m_Menu->AddEntry(entry);
+    }
+    
+    SelectNode(selectedNode);
+    
     return true;
 }
 
-ftxui::Element AppUI::Render()
+void AppUI::SortViewEntries()
 {
-    using namespace ftxui;
-
-    // Main menu view
-    auto mainView =
-            hbox({
-                m_Menu->Render() | flex | frame
+    // Caller holds a shared lock on the tree
+    if(m_FileSorting == Sorting::SIZE_DESCENDING)
+    {
+        std::stable_sort(m_ViewEntries.begin(), m_ViewEntries.end(), [this](const DirectoryTree::NodeIndex a, const DirectoryTree::NodeIndex b)
+        {
+            return m_Tree.GetNode(a).size > m_Tree.GetNode(b).size;
+        });
+    }
+    else
+    {
+        std::stable_sort(m_ViewEntries.begin(), m_ViewEntries.end(), [this](const DirectoryTree::NodeIndex a, const DirectoryTree::NodeIndex b)
+        {
+            return m_Tree.GetName(a) < m_Tree.GetName(b);
         });
+    }
+}
+
+void AppUI::SelectNode(const DirectoryTree::NodeIndex node)
+{
+    const auto it = std::find(m_ViewEntries.begin(), m_ViewEntries.end(), node);
     
-    // Bottom status line
-    auto statusLine = hbox({
-                //text(m_SpaceInfoText),
+    m_Menu->SetSelection(it == m_ViewEntries.end() ? 0 : static_cast<int32_t>(it - m_ViewEntries.begin()));
+}
+
+DirectoryTree::NodeIndex AppUI::GetSelectedNode() const
+{
+    const int32_t selection = m_Menu->GetCurrentSelection();
+    
+    if(selection < 0 || static_cast<std::size_t>(selection) >= m_ViewEntries.size())
+        return DirectoryTree::INVALID_NODE;
+    
+    return m_ViewEntries[static_cast<std::size_t>(selection)];
+}
+
+void AppUI::OnMenuEnter()
+{
+    if(IsDiffView())
+    {
+        OnDiffEnter();
+        return;
+    }
+    
+    const DirectoryTree::NodeIndex selected = GetSelectedNode();
+    if(selected == DirectoryTree::INVALID_NODE)
+        return;
+    
+    bool isDirectory = false;
+    DirectoryTree::NodeIndex parent = DirectoryTree::INVALID_NODE;
+    {
+        std::shared_lock lock(m_Tree.GetMutex());
+        isDirectory = (m_Tree.GetNode(selected).type == DirectoryTree::NodeType::DIRECTORY);
+        parent = m_Tree.GetNode(selected).parent;
+    }
+    
+    m_HotPath.clear();
+    
+    if(isDirectory)
+    {
+        // Open directory
+        m_CurrentNode = selected;
+        m_IsVirtualView = false;
+        UpdateMainView();
+    }
+    else if(m_IsVirtualView && parent != DirectoryTree::INVALID_NODE)
+    {
+        // Jump to the directory containing the found file
+        m_CurrentNode = parent;
+        m_IsVirtualView = false;
+        UpdateMainView();
+        SelectNode(selected);
+    }
+}
+
+void AppUI::NavigateUp()
+{
+    if(IsDiffView())
+    {
+        NavigateUpDiff();
+        return;
+    }
+    
+    m_HotPath.clear();
+    
+    // Leave virtual directory
+    if(m_IsVirtualView)
+    {
+        m_IsVirtualView = false;
+        UpdateMainView();
+        return;
+    }
+    
+    if(m_CurrentNode == DirectoryTree::INVALID_NODE)
+        return;
+    
+    DirectoryTree::NodeIndex parent = DirectoryTree::INVALID_NODE;
+    {
+        std::shared_lock lock(m_Tree.GetMutex());
+        parent = m_Tree.GetNode(m_CurrentNode).parent;
+    }
+    
+    if(parent == DirectoryTree::INVALID_NODE)
+        return;
+    
+    const DirectoryTree::NodeIndex previous = m_CurrentNode;
+    m_CurrentNode = parent;
+    UpdateMainView();
+    SelectNode(previous);
+}
+
+void AppUI::FollowHotPath()
+{
+    if(IsDiffView())
+    {
+        FollowGrowthPath();
+        return;
+    }
+    
+    if(m_IsVirtualView || m_CurrentNode == DirectoryTree::INVALID_NODE)
+        return;
+    
+    std::vector<DirectoryTree::NodeIndex> path;
+    DirectoryTree::NodeIndex target = DirectoryTree::INVALID_NODE;
+    DirectoryTree::NodeIndex selection = DirectoryTree::INVALID_NODE;
+    
+    // On request of the user, the largest child of each directory on the way
+    if(m_DaemonClient)
+    {
+        std::lock_guard daemonLock(m_DaemonClientMutex);
         
-                hbox({spinner(15, m_SpinnerValue), text(" Loading...")}) | ftxui::bold | size(WIDTH, GREATER_THAN, 14),
+        if(!m_DaemonClient->LoadHeaviestPath(m_Tree, m_CurrentNode, m_HotPathThreshold))
+            OnDaemonError(m_DaemonClient->IsStale(), m_DaemonClient->GetLastErrorMessage());
+    }
+    
+    {
+        std::shared_lock lock(m_Tree.GetMutex());
+        m_Tree.GetHeaviestPath(m_CurrentNode, m_HotPathThreshold, path);
         
-                text(onChangeFctStr) | bgcolor(Color::Yellow) | color(Color::Black) /*| flex*/ | size(WIDTH, EQUAL, 25),
+        if(path.empty())
+            return;
         
-                //text("["), gauge(m_GaugeValueUsedSpace) | flex | size(WIDTH, EQUAL, 10), text(std::format("] {:.2f}%", m_GaugeValueUsedSpace * 100.0f)),
-                //text("space"),
+        // Open the last directory of the chain and select its largest entry.
+        // If the chain ends in a file, open its directory and select the file.
+        const DirectoryTree::NodeIndex last = path.back();
+        if(m_Tree.GetNode(last).type == DirectoryTree::NodeType::DIRECTORY)
+        {
+            target = last;
+            selection = m_Tree.GetNode(last).heaviestChild;
+        }
+        else
+        {
+            target = m_Tree.GetNode(last).parent;
+            selection = last;
+        }
+    }
+    
+    // Continue an existing breadcrumb if we follow on from its end
+    if(m_HotPath.empty() || m_HotPath.back() != m_CurrentNode)
+        m_HotPath.assign(1, m_CurrentNode);
+    
+    m_HotPath.insert(m_HotPath.end(), path.begin(), path.end());
+    
+    m_CurrentNode = target;
+    UpdateMainView();
+    SelectNode(selection);
+}
+
+void AppUI::ToggleMark()
+{
+    const DirectoryTree::NodeIndex selected = GetSelectedNode();
+    if(selected == DirectoryTree::INVALID_NODE)
+        return;
+    
+    if(!m_MarkedNodes.erase(selected))
+        m_MarkedNodes.insert(selected);
+    
+    // Refresh the labels and continue with the next entry
+    const int32_t selection = m_Menu->GetCurrentSelection();
+    UpdateMainView();
+    m_Menu->SetSelection(selection + 1);
+}
+
+void AppUI::RequestDeletion()
+{
+    // The scanner still adds entries, only delete complete subtrees.
+    // Imported trees don't belong to this file system, the daemon's tree and snapshots aren't ours.
+    if(m_MarkedNodes.empty() || m_IsScanning || m_Deleter.IsRunning() || !m_ImportFile.empty() || m_DaemonClient || m_Tree.IsMapped())
+        return;
+    
+    std::size_t count = 0;
+    uintmax_t size = 0;
+    {
+        std::shared_lock lock(m_Tree.GetMutex());
         
-                text("Selected: " + std::to_string(m_Menu->GetCurrentSelection()) + ", Focused: " + std::to_string(m_Menu->GetCurrentFocus())) | center | flex | bgcolor(Color::Blue),
+        for(const DirectoryTree::NodeIndex i : m_MarkedNodes)
+        {
+            // Marked entries inside of another marked directory are counted with it
+            const bool isNested = std::any_of(m_MarkedNodes.begin(), m_MarkedNodes.end(), [&](const DirectoryTree::NodeIndex other) { return m_Tree.IsAncestor(other, i); });
+            
+            if(isNested || m_Tree.GetNode(i).isRemoved)
+                continue;
+            
+            count++;
+            size += m_Tree.GetNode(i).size;
+        }
+    }
+    
+    m_DeleteConfirmText = "Delete " + std::to_string(count) + " marked entries (" + Format::HumanReadableSize(size) + ")? [y/N]";
+    m_IsDeleteConfirmActive = true;
+}
+
+void AppUI::OnDeletionFinished()
+{
+    m_MarkedNodes.clear();
+    m_HotPath.clear();
+    
+    UpdateMainView();
+    UpdateSpaceInfo();
+    
+    DropPendingFileNodes();
+}
+
+void AppUI::AttachToDaemon()
+{
+    m_DaemonClient = std::make_unique<DaemonClient>();
+    
+    if(!m_DaemonClient->Connect(m_DaemonSocketPath))
+    {
+        m_ErrorMessage = "Attach failed: " + m_DaemonClient->GetLastErrorMessage();
+        return;
+    }
+    
+    ReloadFromDaemon();
+}
+
+void AppUI::ReloadFromDaemon()
+{
+    if(!m_DaemonClient)
+        return;
+    
+    std::vector<std::string> names;
+    std::string selectedName = "";
+    SaveLocation(names, selectedName);
+    
+    bool isScanning = false;
+    bool isAttached = false;
+    std::string errorMessage = "";
+    {
+        // Waits for a running load, the queued ones are dropped. Attaching is a single request.
+        std::lock_guard daemonLock(m_DaemonClientMutex);
+        
+        if(!m_DaemonClient->IsConnected())
+            return;
+        
+        m_DaemonAttachCount++;
+        ResetView();
+        
+        isAttached = m_DaemonClient->Attach(m_Tree, isScanning);
+        errorMessage = m_DaemonClient->GetLastErrorMessage();
+    }
+    
+    m_RequestedDaemonLoads.clear();
+    
+    if(!isAttached)
+    {
+        m_ErrorMessage = "Daemon: " + errorMessage;
+        m_IsScanning = false;
+        UpdateMainView();
+        return;
+    }
+    
+    m_ErrorMessage.clear();
+    m_IsScanning = isScanning;
+    
+    RestoreDaemonLocation(std::move(names), std::move(selectedName));
+}
+
+void AppUI::RestoreDaemonLocation(std::vector<std::string> names, std::string selectedName)
+{
+    // The root is shown until the directories on the way are loaded
+    UpdateMainView();
+    
+    const uint64_t attachCount = m_DaemonAttachCount;
+    m_DaemonPool.Submit([this, attachCount, names = std::move(names), selectedName = std::move(selectedName)]
+    {
+        DirectoryTree::NodeIndex node = DirectoryTree::INVALID_NODE;
+        bool isOk = true;
+        bool isStale = false;
+        std::string errorMessage = "";
+        {
+            std::lock_guard daemonLock(m_DaemonClientMutex);
+            
+            if(attachCount != m_DaemonAttachCount)
+                return;
+            
+            try {
+                node = m_Tree.GetRoot();
                 
-                text("abc") | bgcolor(Color::Blue)
+                // Completely, a name may be anywhere. Of the last directory the window shown first.
+                for(auto it = names.rbegin(); it != names.rend() && node != DirectoryTree::INVALID_NODE && isOk; ++it)
+                {
+                    isOk = m_DaemonClient->LoadChildren(m_Tree, {node});
+                    
+                    std::shared_lock treeLock(m_Tree.GetMutex());
+                    std::vector<DirectoryTree::NodeIndex> children;
+                    m_Tree.GetChildren(node, children);
+                    
+                    const auto child = std::find_if(children.begin(), children.end(), [&](const DirectoryTree::NodeIndex i) { return m_Tree.GetName(i) == *it; });
+                    if(child == children.end())
+                        break;
+                    
+                    node = *child;
+                }
+                
+                if(isOk && node != DirectoryTree::INVALID_NODE)
+                    isOk = m_DaemonClient->LoadChildren(m_Tree, {node}, DAEMON_WINDOW_STEP);
+            }
+            catch (const std::bad_alloc&) {
+                isOk = false;
+            }
+            
+            isStale = m_DaemonClient->IsStale();
+            errorMessage = m_DaemonClient->IsConnected() ? m_DaemonClient->GetLastErrorMessage() : "Out of memory";
+        }
+        
+        m_Screen->Post([this, attachCount, node, selectedName, isOk, isStale, errorMessage]
+        {
+            // The user went elsewhere meanwhile
+            if(attachCount != m_DaemonAttachCount || (m_CurrentNode != m_Tree.GetRoot() && m_CurrentNode != DirectoryTree::INVALID_NODE))
+                return;
+            
+            if(!isOk)
+                OnDaemonError(isStale, errorMessage);
+            
+            if(node != DirectoryTree::INVALID_NODE)
+                m_CurrentNode = node;
+            
+            UpdateMainView();
+            
+            DirectoryTree::NodeIndex selected = DirectoryTree::INVALID_NODE;
+            {
+                std::shared_lock lock(m_Tree.GetMutex());
+                const auto it = std::find_if(m_ViewEntries.begin(), m_ViewEntries.end(), [&](const DirectoryTree::NodeIndex i) { return m_Tree.GetName(i) == selectedName; });
+                if(it != m_ViewEntries.end())
+                    selected = *it;
+            }
+            
+            if(selected != DirectoryTree::INVALID_NODE)
+                SelectNode(selected);
         });
+    });
+}
+
+void AppUI::RequestDaemonLoad(const DirectoryTree::NodeIndex node, const uint32_t depth, const uint32_t window)
+{
+    // Every load once per attach, this is asked for on every frame
+    if(!m_RequestedDaemonLoads.emplace(node, depth, window).second)
+        return;
     
-    const std::wstring currentPathStr = L"Current path: " + m_StartingPath.wstring();
+    const uint64_t attachCount = m_DaemonAttachCount;
+    m_DaemonPool.Submit([this, attachCount, node, depth, window]
+    {
+        bool isOk = true;
+        bool isChanged = false;
+        bool isStale = false;
+        std::string errorMessage = "";
+        {
+            std::lock_guard daemonLock(m_DaemonClientMutex);
+            
+            // Node of the tree before the last attach
+            if(attachCount != m_DaemonAttachCount)
+                return;
+            
+            const uint64_t loadedCount = m_DaemonClient->GetLoadedRecordCount();
+            
+            try {
+                isOk = m_DaemonClient->LoadSubtree(m_Tree, node, depth, window);
+                errorMessage = m_DaemonClient->GetLastErrorMessage();
+            }
+            catch (const std::bad_alloc&) {
+                isOk = false;
+                errorMessage = "Out of memory";
+            }
+            
+            isStale = m_DaemonClient->IsStale();
+            isChanged = (m_DaemonClient->GetLoadedRecordCount() != loadedCount);
+        }
+        
+        if(isChanged || !isOk)
+            m_Screen->Post([this, attachCount, isOk, isStale, errorMessage] { OnDaemonLoaded(attachCount, isOk, isStale, errorMessage); });
+    });
+}
+
+uint32_t AppUI::GetDaemonWindow() const
+{
+    // Sorted by name, any of the children may come first
+    if(m_FileSorting != Sorting::SIZE_DESCENDING)
+        return DaemonClient::ALL_CHILDREN;
     
-    return window(text("DirStatsTUI") | ftxui::bold | center,
-                vbox({
-                    text(currentPathStr) | inverted,
-                    separator(),
-                    mainView | flex,
-                    separator(),
-                    text("Info about selected entry") | flex | size(HEIGHT, GREATER_THAN, 5),
-                    separator(),
-                    statusLine /*| bgcolor(Color::Blue)*/ /*| inverted*/
-            })
-            );
+    // The rows shown and a step ahead, the next step once the selection gets there
+    const std::size_t rowCount = static_cast<std::size_t>(std::max(m_MainViewBox.y_max - m_MainViewBox.y_min + 1, 0));
+    const std::size_t selection = static_cast<std::size_t>(std::max(m_Menu->GetCurrentSelection(), 0));
     
-    return window(text(L"REPLACE ME") | ftxui::bold | center, text("Content"));
+    return static_cast<uint32_t>(std::min<std::size_t>((selection + rowCount) / DAEMON_WINDOW_STEP + 1, UINT32_MAX / DAEMON_WINDOW_STEP) * DAEMON_WINDOW_STEP);
 }
 
-bool AppUI::OnEvent(ftxui::Event event)
+void AppUI::OnDaemonLoaded(const uint64_t attachCount, const bool isOk, const bool isStale, const std::string& errorMessage)
 {
-//    if (event == ftxui::Event::Character('h'))
-//    {
-//        return true;
-//    }
+    if(attachCount != m_DaemonAttachCount)
+        return;
+    
+    if(!isOk)
+    {
+        OnDaemonError(isStale, errorMessage);
+        return;
+    }
+    
+    UpdateMainView();
+}
 
-    if (event == ftxui::Event::Escape)
+void AppUI::LoadSnapshot()
+{
+    std::vector<std::string> names;
+    std::string selectedName = "";
+    SaveLocation(names, selectedName);
+    
+    // The old snapshot stays in use if the new one can't be loaded
+    if(!m_Snapshot.Load(m_SnapshotFile, m_Tree))
+    {
+        m_ErrorMessage = "Snapshot: " + m_Snapshot.GetLastErrorMessage();
+        UpdateMainView();
+        return;
+    }
+    
+    ResetView();
+    m_ErrorMessage.clear();
+    
+    RestoreLocation(names, selectedName);
+}
+
+void AppUI::CheckForUpdates()
+{
+    if(!m_SnapshotFile.empty())
+    {
+        // Search results refer to the current snapshot
+        if(!m_IsSearching && m_Snapshot.IsReplaced(m_SnapshotFile))
+            LoadSnapshot();
+        
+        return;
+    }
+    
+    // One query at a time, in background like the loads
+    if(!m_DaemonClient || m_IsQueryingDaemon.exchange(true))
+        return;
+    
+    const uint64_t attachCount = m_DaemonAttachCount;
+    m_DaemonPool.Submit([this, attachCount]
+    {
+        DaemonClient::Info info;
+        uint64_t generation = 0;
+        bool isOk = false;
+        bool isStale = false;
+        std::string errorMessage = "";
+        {
+            std::lock_guard daemonLock(m_DaemonClientMutex);
+            
+            if(!m_DaemonClient->IsConnected())
+            {
+                m_IsQueryingDaemon = false;
+                return;
+            }
+            
+            try {
+                isOk = m_DaemonClient->QueryInfo(info);
+                errorMessage = m_DaemonClient->GetLastErrorMessage();
+            }
+            catch (const std::bad_alloc&) {
+                errorMessage = "Out of memory";
+            }
+            
+            generation = m_DaemonClient->GetGeneration();
+            isStale = m_DaemonClient->IsStale();
+        }
+        
+        m_IsQueryingDaemon = false;
+        
+        m_Screen->Post([this, attachCount, isScanning = info.isScanning, daemonGeneration = info.generation, generation, isOk, isStale, errorMessage]
+        {
+            if(attachCount != m_DaemonAttachCount)
+                return;
+            
+            if(!isOk)
+            {
+                OnDaemonError(isStale, errorMessage);
+                return;
+            }
+            
+            // Totals grow while the daemon scans, a finished refresh is a new generation
+            if(isScanning || m_IsScanning || daemonGeneration != generation)
+                ReloadFromDaemon();
+        });
+    });
+}
+
+void AppUI::LoadDiff()
+{
+    // Both snapshots are mapped, the diff refers to their nodes
+    if(!m_DiffBaseSnapshot.Load(m_DiffBaseFile, m_DiffBaseTree))
+    {
+        m_ErrorMessage = "Diff: " + m_DiffBaseFile.string() + ": " + m_DiffBaseSnapshot.GetLastErrorMessage();
+        return;
+    }
+    
+    if(!m_Snapshot.Load(m_DiffNewFile, m_Tree))
+    {
+        m_ErrorMessage = "Diff: " + m_DiffNewFile.string() + ": " + m_Snapshot.GetLastErrorMessage();
+        return;
+    }
+    
+    try {
+        m_Diff.Compute(m_DiffBaseTree, m_Tree);
+    }
+    catch (const std::bad_alloc&) {
+        m_Diff.Clear();
+        m_ErrorMessage = "Diff: Out of memory";
+        return;
+    }
+    
+    m_DiffNode = m_Diff.GetRoot();
+    m_GrowthPath.clear();
+    
+    UpdateMainView();
+}
+
+void AppUI::UpdateDiffView()
+{
+    m_Menu->ClearEntries();
+    
+    if(m_Diff.IsEmpty())
     {
+        m_DiffEntries.clear();
+        return;
+    }
+    
+    if(m_DiffNode == TreeDiff::INVALID_NODE)
+        m_DiffNode = m_Diff.GetRoot();
+    
+    const TreeDiff::NodeIndex selectedNode = GetSelectedDiffNode();
+    
+    // Largest growth first
+    m_DiffEntries.clear();
+    m_Diff.GetChildren(m_DiffNode, m_DiffEntries);
+    
+    if(!m_ShowAllFiles)
+        std::erase_if(m_DiffEntries, [this](const TreeDiff::NodeIndex i) { return m_Diff.GetName(i).starts_with('.'); });
+    
+    for(const TreeDiff::NodeIndex i : m_DiffEntries)
+    {
+        const TreeDiff::Node& node = m_Diff.GetNode(i);
+        const DirectoryTree::Node& treeNode = m_Diff.GetTreeNode(i);
+        
+        std::string prefix = "";
+        if(node.change == TreeDiff::ChangeType::ADDED)
+            prefix = "[new] ";
+        else if(node.change == TreeDiff::ChangeType::REMOVED)
+            prefix = "[removed] ";
+        
+        MenuComponent::MenuEntry entry;
+        entry.name = prefix + std::string(m_Diff.GetName(i));
+        entry.isDirectory = (treeNode.type == DirectoryTree::NodeType::DIRECTORY);
+        entry.count = treeNode.count;
+        entry.size = m_Diff.GetNewSize(i);
+        entry.sizeLabel = Format::HumanReadableDelta(node.sizeDelta);
+        
+        m_Menu->AddEntry(entry);
+    }
+    
+    SelectDiffNode(selectedNode);
+}
+
+void AppUI::SelectDiffNode(const TreeDiff::NodeIndex node)
+{
+    const auto it = std::find(m_DiffEntries.begin(), m_DiffEntries.end(), node);
+    
+    m_Menu->SetSelection(it == m_DiffEntries.end() ? 0 : static_cast<int32_t>(it - m_DiffEntries.begin()));
+}
+
+TreeDiff::NodeIndex AppUI::GetSelectedDiffNode() const
+{
+    const int32_t selection = m_Menu->GetCurrentSelection();
+    
+    if(selection < 0 || static_cast<std::size_t>(selection) >= m_DiffEntries.size())
+        return TreeDiff::INVALID_NODE;
+    
+    return m_DiffEntries[static_cast<std::size_t>(selection)];
+}
+
+void AppUI::OnDiffEnter()
+{
+    const TreeDiff::NodeIndex selected = GetSelectedDiffNode();
+    
+    // Added and removed directories list no contents
+    if(selected == TreeDiff::INVALID_NODE || m_Diff.GetNode(selected).childCount == 0)
+        return;
+    
+    m_GrowthPath.clear();
+    m_DiffNode = selected;
+    UpdateDiffView();
+    m_Menu->SetSelection(0);
+}
+
+void AppUI::NavigateUpDiff()
+{
+    m_GrowthPath.clear();
+    
+    if(m_DiffNode == TreeDiff::INVALID_NODE || m_Diff.GetNode(m_DiffNode).parent == TreeDiff::INVALID_NODE)
+        return;
+    
+    const TreeDiff::NodeIndex previous = m_DiffNode;
+    m_DiffNode = m_Diff.GetNode(m_DiffNode).parent;
+    UpdateDiffView();
+    SelectDiffNode(previous);
+}
+
+void AppUI::FollowGrowthPath()
+{
+    if(m_DiffNode == TreeDiff::INVALID_NODE)
+        return;
+    
+    std::vector<TreeDiff::NodeIndex> path;
+    m_Diff.GetGrowthPath(m_DiffNode, m_HotPathThreshold, path);
+    
+    if(path.empty())
+        return;
+    
+    // Open the last directory of the chain, its children are sorted by growth.
+    // If the chain ends in a file or an added directory, select it in its parent.
+    TreeDiff::NodeIndex target = path.back();
+    TreeDiff::NodeIndex selection = TreeDiff::INVALID_NODE;
+    
+    if(m_Diff.GetNode(target).childCount == 0)
+    {
+        selection = target;
+        target = m_Diff.GetNode(target).parent;
+    }
+    
+    // Continue an existing breadcrumb if we follow on from its end
+    if(m_GrowthPath.empty() || m_GrowthPath.back() != m_DiffNode)
+        m_GrowthPath.assign(1, m_DiffNode);
+    
+    m_GrowthPath.insert(m_GrowthPath.end(), path.begin(), path.end());
+    
+    m_DiffNode = target;
+    UpdateDiffView();
+    SelectDiffNode(selection);
+}
+
+ftxui::Element AppUI::RenderDiffHeader()
+{
+    using namespace ftxui;
+    
+    if(m_Diff.IsEmpty())
+        return text("Changes from " + m_DiffBaseFile.string() + " to " + m_DiffNewFile.string());
+    
+    // Breadcrumb of the growth path with the growth of every step
+    if(!m_GrowthPath.empty())
+    {
+        std::wstring breadcrumb = L"Growth path: " + m_Diff.GetPath(m_GrowthPath.front()).wstring();
+        
+        for(std::size_t i = 1; i < m_GrowthPath.size(); i++)
+        {
+            breadcrumb += L" > " + std::filesystem::path(m_Diff.GetName(m_GrowthPath[i])).wstring()
+                        + L" (" + std::filesystem::path(Format::HumanReadableDelta(m_Diff.GetNode(m_GrowthPath[i]).sizeDelta)).wstring() + L")";
+        }
+        
+        return text(breadcrumb);
+    }
+    
+    const std::string dates = "Changes from " + Format::DateTime(m_DiffBaseSnapshot.GetHeader().createdTime)
+                            + " to " + Format::DateTime(m_Snapshot.GetHeader().createdTime) + ": ";
+    
+    return text(std::filesystem::path(dates).wstring() + m_Diff.GetPath(m_DiffNode).wstring());
+}
+
+ftxui::Element AppUI::RenderDiffDetails()
+{
+    using namespace ftxui;
+    
+    const TreeDiff::NodeIndex selected = GetSelectedDiffNode();
+    if(selected == TreeDiff::INVALID_NODE)
+        return text(m_Diff.IsEmpty() ? "No changes" : "No entry selected");
+    
+    const TreeDiff::Node& node = m_Diff.GetNode(selected);
+    const bool isDirectory = (m_Diff.GetTreeNode(selected).type == DirectoryTree::NodeType::DIRECTORY);
+    
+    std::string change = "Changed";
+    if(node.change == TreeDiff::ChangeType::ADDED)
+        change = "Added";
+    else if(node.change == TreeDiff::ChangeType::REMOVED)
+        change = "Removed";
+    
+    Elements lines;
+    lines.push_back(hbox({text(std::string(m_Diff.GetName(selected))) | ftxui::bold, text("  " + change + (isDirectory ? " directory" : " file"))}));
+    
+    lines.push_back(text("Size: " + Format::HumanReadableSize(m_Diff.GetOldSize(selected)) + " -> " + Format::HumanReadableSize(m_Diff.GetNewSize(selected))
+                         + " (" + Format::HumanReadableDelta(node.sizeDelta) + ")"));
+    
+    if(isDirectory)
+    {
+        lines.push_back(text("Entries: " + std::string(node.countDelta >= 0 ? "+" : "") + std::to_string(node.countDelta) + "  |  Added: "
+                             + std::to_string(node.addedCount) + " entries, " + Format::HumanReadableSize(node.addedSize) + "  |  Removed: "
+                             + std::to_string(node.removedCount) + " entries, " + Format::HumanReadableSize(node.removedSize)));
+    }
+    
+    lines.push_back(text(m_Diff.GetPath(selected).wstring()) | dim);
+    
+    return vbox(std::move(lines));
+}
+
+void AppUI::SaveLocation(std::vector<std::string>& out_names, std::string& out_selectedName)
+{
+    std::shared_lock lock(m_Tree.GetMutex());
+    
+    // Names from the current directory up to the root
+    for(DirectoryTree::NodeIndex i = m_CurrentNode; i != DirectoryTree::INVALID_NODE && m_Tree.GetNode(i).parent != DirectoryTree::INVALID_NODE; i = m_Tree.GetNode(i).parent)
+        out_names.emplace_back(m_Tree.GetName(i));
+    
+    if(GetSelectedNode() != DirectoryTree::INVALID_NODE)
+        out_selectedName = m_Tree.GetName(GetSelectedNode());
+}
+
+void AppUI::RestoreLocation(const std::vector<std::string>& names, const std::string& selectedName)
+{
+    m_CurrentNode = m_Tree.GetRoot();
+    
+    for(auto it = names.rbegin(); it != names.rend() && m_CurrentNode != DirectoryTree::INVALID_NODE; ++it)
+    {
+        std::vector<DirectoryTree::NodeIndex> children;
+        {
+            std::shared_lock lock(m_Tree.GetMutex());
+            m_Tree.GetChildren(m_CurrentNode, children);
+        }
+        
+        const auto child = std::find_if(children.begin(), children.end(), [&](const DirectoryTree::NodeIndex i) { return m_Tree.GetName(i) == *it; });
+        if(child == children.end())
+            break;
+        
+        m_CurrentNode = *child;
+    }
+    
+    UpdateMainView();
+    
+    const auto selected = std::find_if(m_ViewEntries.begin(), m_ViewEntries.end(), [&](const DirectoryTree::NodeIndex i) { return m_Tree.GetName(i) == selectedName; });
+    if(selected != m_ViewEntries.end())
+        SelectNode(*selected);
+}
+
+void AppUI::ResetView()
+{
+    // Node indices and name IDs are assigned anew
+    m_CurrentNode = DirectoryTree::INVALID_NODE;
+    m_IsVirtualView = false;
+    m_ViewEntries.clear();
+    m_MarkedNodes.clear();
+    m_HotPath.clear();
+    m_Treemap.Clear();
+    m_EntryDetails.Clear();
+    
+    std::lock_guard indexLock(m_NameIndexMutex);
+    m_NameIndex.Clear();
+}
+
+void AppUI::OnMemoryLimitReached()
+{
+    m_HasReachedMemoryLimit = true;
+    m_IsFileDropPending = true;
+    
+    DropPendingFileNodes();
+}
+
+void AppUI::DropPendingFileNodes()
+{
+    // Search results and deletions refer to the nodes, the files are dropped when they are done
+    if(!m_IsFileDropPending || m_IsSearching || m_Deleter.IsRunning())
+        return;
+    
+    m_IsFileDropPending = false;
+    
+    std::vector<std::string> names;
+    std::string selectedName = "";
+    SaveLocation(names, selectedName);
+    ResetView();
+    
+    m_Tree.DropFileNodes();
+    
+    RestoreLocation(names, selectedName);
+}
+
+void AppUI::AccountMemory(MemoryAccounting& accounting)
+{
+    {
+        std::shared_lock lock(m_Tree.GetMutex());
+        m_Tree.AccountMemory(accounting);
+    }
+    
+    // Left out while a search builds the index, the UI doesn't wait for it
+    {
+        std::unique_lock indexLock(m_NameIndexMutex, std::try_to_lock);
+        if(indexLock.owns_lock())
+            m_NameIndex.AccountMemory(accounting);
+    }
+    
+    m_Treemap.AccountMemory(accounting);
+    m_EntryDetails.AccountMemory(accounting);
+    m_Menu->AccountMemory(accounting);
+    
+    accounting.Add("View entries", MemoryAccounting::GetVectorBytes(m_ViewEntries) + MemoryAccounting::GetVectorBytes(m_HotPath) + MemoryAccounting::GetVectorBytes(m_TreemapRects)
+                   + MemoryAccounting::GetHashTableBytes(m_MarkedNodes), m_ViewEntries.size());
+}
+
+void AppUI::OnDaemonError(const bool isStale, const std::string& message)
+{
+    // The daemon refreshed its tree, start over with that one
+    if(isStale)
+        m_Screen->Post([this] { ReloadFromDaemon(); });
+    else
+        m_ErrorMessage = "Daemon: " + message;
+}
+
+bool AppUI::OnSearchInputEvent(ftxui::Event event)
+{
+    if (event == ftxui::Event::Escape)
+    {
+        m_IsSearchInputActive = false;
+        return true;
+    }
+    
+    if (event == ftxui::Event::Return)
+    {
+        m_IsSearchInputActive = false;
+        
+        // Only one search at a time
+        if(m_SearchQuery.empty() || m_IsSearching)
+            return true;
+        
+        if(m_SearchThread.joinable())
+            m_SearchThread.join();
+        
+        m_IsSearching = true;
+        m_SearchThread = std::thread(&AppUI::SearchTask, this, m_SearchQuery);
+        
+        return true;
+    }
+    
+    if (event == ftxui::Event::Backspace)
+    {
+        // Remove last UTF-8 character
+        while(!m_SearchQuery.empty() && (static_cast<uint8_t>(m_SearchQuery.back()) & 0xC0) == 0x80)
+            m_SearchQuery.pop_back();
+        
+        if(!m_SearchQuery.empty())
+            m_SearchQuery.pop_back();
+        
+        return true;
+    }
+    
+    if (event.is_character())
+        m_SearchQuery += event.character();
+    
+    // Swallow all other events while typing
+    return true;
+}
+
+ftxui::Element AppUI::RenderTreemap()
+{
+    using namespace ftxui;
+    
+    static const std::array<Color, 8> palette = {Color::Blue, Color::Green, Color::Yellow, Color::Magenta,
+                                                 Color::Cyan, Color::Red, Color::BlueLight, Color::GreenLight};
+    
+    // Size of the main view in the last frame. Estimate from the terminal before the first one.
+    int32_t width = m_MainViewBox.x_max - m_MainViewBox.x_min + 1;
+    int32_t height = m_MainViewBox.y_max - m_MainViewBox.y_min + 1;
+    
+    if(width <= 1 || height <= 1)
+    {
+        const Dimensions terminalSize = Terminal::Size();
+        width = terminalSize.dimx - 2;
+        height = terminalSize.dimy - 12;
+    }
+    
+    if(width <= 0 || height <= 0 || m_IsVirtualView)
+        return text("");
+    
+    struct Cell
+    {
+        std::string glyph = " ";
+        uint8_t     color = 0;  // 0: No color, else palette index + 1
+        bool        isLabel = false;
+        bool        isSelected = false;
+    };
+    
+    std::vector<Cell> cells(static_cast<std::size_t>(width) * static_cast<std::size_t>(height));
+    auto cellAt = [&](const int32_t x, const int32_t y) -> Cell& { return cells[static_cast<std::size_t>(y) * static_cast<std::size_t>(width) + static_cast<std::size_t>(x)]; };
+    
+    const DirectoryTree::NodeIndex selectedNode = GetSelectedNode();
+    
+    // Loaded in background, the treemap fills in when done. Small entries don't get a rect anyway.
+    if(m_DaemonClient && m_CurrentNode != DirectoryTree::INVALID_NODE)
+        RequestDaemonLoad(m_CurrentNode, m_Treemap.GetMaxDepth(), DAEMON_WINDOW_STEP);
+    
+    {
+        std::shared_lock lock(m_Tree.GetMutex());
+        m_Treemap.Layout(m_Tree, m_CurrentNode, width, height, m_TreemapRects);
+        
+        uint8_t color = 0;
+        bool isSelected = false;
+        std::size_t topLevelCount = 0;
+        
+        // Parents come before their children, later rects are drawn on top
+        for(const Treemap::Rect& r : m_TreemapRects)
+        {
+            if(r.depth == 1)
+            {
+                color = static_cast<uint8_t>(topLevelCount++ % palette.size() + 1);
+                isSelected = (r.node == selectedNode);
+            }
+            
+            const char* const fill = (r.depth == 1) ? "█" : ((r.depth == 2) ? "▓" : "▒");
+            
+            // Leave a gap at the right and bottom edge to separate neighbours
+            const int32_t fillWidth = (r.width > 1) ? r.width - 1 : r.width;
+            const int32_t fillHeight = (r.height > 1) ? r.height - 1 : r.height;
+            
+            for(int32_t y = r.y; y < r.y + r.height; y++)
+            {
+                for(int32_t x = r.x; x < r.x + r.width; x++)
+                {
+                    Cell& cell = cellAt(x, y);
+                    const bool isGap = (x >= r.x + fillWidth) || (y >= r.y + fillHeight);
+                    
+                    cell.glyph = isGap ? " " : fill;
+                    cell.color = isGap ? 0 : color;
+                    cell.isLabel = false;
+                    cell.isSelected = isSelected;
+                }
+            }
+            
+            // Name in the first row
+            std::string label = std::string(m_Tree.GetName(r.node));
+            if(r.depth == 1)
+                label += " " + Format::HumanReadableSize(m_Tree.GetNode(r.node).size);
+            
+            int32_t x = r.x;
+            for(std::size_t i = 0; i < label.size() && x < r.x + fillWidth; x++)
+            {
+                // One UTF-8 sequence per cell
+                std::size_t length = 1;
+                while(i + length < label.size() && (static_cast<uint8_t>(label[i + length]) & 0xC0) == 0x80)
+                    length++;
+                
+                Cell& cell = cellAt(x, r.y);
+                cell.glyph = label.substr(i, length);
+                cell.isLabel = true;
+                
+                i += length;
+            }
+        }
+    }
+    
+    // Merge cells with the same style into text runs
+    Elements rows;
+    for(int32_t y = 0; y < height; y++)
+    {
+        Elements runs;
+        std::string run;
+        const Cell* runStyle = nullptr;
+        
+        auto flushRun = [&]()
+        {
+            if(!runStyle)
+                return;
+            
+            Element e = text(run);
+            if(runStyle->isLabel)
+                e = e | bgcolor(runStyle->isSelected ? Color::White : palette[runStyle->color - 1]) | color(Color::Black);
+            else if(runStyle->color)
+                e = e | color(palette[runStyle->color - 1]);
+            
+            if(runStyle->isSelected && runStyle->isLabel)
+                e = e | ftxui::bold;
+            
+            runs.push_back(e);
+            run.clear();
+        };
+        
+        for(int32_t x = 0; x < width; x++)
+        {
+            const Cell& cell = cellAt(x, y);
+            
+            if(!runStyle || cell.color != runStyle->color || cell.isLabel != runStyle->isLabel || cell.isSelected != runStyle->isSelected)
+            {
+                flushRun();
+                runStyle = &cell;
+            }
+            
+            run += cell.glyph;
+        }
+        
+        flushRun();
+        rows.push_back(hbox(std::move(runs)));
+    }
+    
+    return vbox(std::move(rows));
+}
+
+ftxui::Element AppUI::RenderDetails()
+{
+    using namespace ftxui;
+    
+    if(IsDiffView())
+        return RenderDiffDetails();
+    
+    const DirectoryTree::NodeIndex selected = GetSelectedNode();
+    if(selected == DirectoryTree::INVALID_NODE)
+        return text("No entry selected");
+    
+    // Tree information is available right away
+    DirectoryTree::Node node;
+    std::string name = "";
+    
+    EntryDetails::Details details;
+    const bool hasDetails = m_EntryDetails.Get(selected, details);
+    
+    {
+        std::shared_lock lock(m_Tree.GetMutex());
+        node = m_Tree.GetNode(selected);
+        name = std::string(m_Tree.GetName(selected));
+        
+        // Everything else is loaded in background, never block the UI
+        if(!hasDetails && m_ImportFile.empty())
+            m_EntryDetails.Request(selected, m_Tree.GetPath(selected));
+    }
+    
+    // Mirrored directories: the number of children is known once the largest one is loaded.
+    // The window of the current directory grows while scrolling towards its end.
+    if(m_DaemonClient)
+    {
+        if(node.type == DirectoryTree::NodeType::DIRECTORY)
+            RequestDaemonLoad(selected, 1, 1);
+        
+        if(!m_IsVirtualView && m_CurrentNode != DirectoryTree::INVALID_NODE)
+            RequestDaemonLoad(m_CurrentNode, 1, GetDaemonWindow());
+    }
+    
+    std::string type = "Other";
+    switch(node.type)
+    {
+        case DirectoryTree::NodeType::REGULAR_FILE: type = "File"; break;
+        case DirectoryTree::NodeType::DIRECTORY:    type = "Directory"; break;
+        case DirectoryTree::NodeType::SYMLINK:      type = "Symbolic link"; break;
+        default: break;
+    }
+    
+    // Files of a rollup have no node, they are only in the totals
+    uintmax_t foldedCount = 0;
+    if(node.type == DirectoryTree::NodeType::DIRECTORY && (m_FileNodeLimit != FileSystem::ALL_FILES || m_HasReachedMemoryLimit))
+    {
+        std::shared_lock lock(m_Tree.GetMutex());
+        foldedCount = m_Tree.GetFoldedCount(selected);
+    }
+    
+    Elements lines;
+    lines.push_back(hbox({text(name) | ftxui::bold, text("  " + type + (node.hasError ? " (incomplete, not readable)" : ""))}));
+    
+    // Sizes
+    if(node.type == DirectoryTree::NodeType::DIRECTORY)
+    {
+        lines.push_back(text("Size: " + Format::HumanReadableSize(node.size) + " apparent, " + Format::HumanReadableSize(node.allocatedSize) + " allocated  |  "
+                             + std::to_string(node.childCount) + " children, " + std::to_string(node.count) + " entries in total, "
+                             + std::to_string(node.maxDepth) + " levels deep"
+                             + (foldedCount ? ", " + std::to_string(foldedCount) + " files only counted in the totals" : std::string())));
+    }
+    else
+    {
+        const uintmax_t allocated = hasDetails && details.isValid ? details.allocatedSize : node.allocatedSize;
+        lines.push_back(text("Size: " + Format::HumanReadableSize(node.size) + " apparent, " + Format::HumanReadableSize(allocated) + " allocated"));
+    }
+    
+    if(!m_ImportFile.empty())
+    {
+        lines.push_back(text("Imported from " + m_ImportFile.string() + ", no further details") | dim);
+    }
+    else if(!hasDetails)
+    {
+        lines.push_back(text("Loading details...") | dim);
+    }
+    else if(!details.isValid)
+    {
+        lines.push_back(text("Details not available: " + details.errorMessage) | dim);
+    }
+    else
+    {
+        lines.push_back(text(details.permissions + "  Owner: " + details.owner + " (" + std::to_string(details.userID) + ")"
+                             + "  Group: " + details.group + " (" + std::to_string(details.groupID) + ")"
+                             + "  Links: " + std::to_string(details.linkCount) + "  Inode: " + std::to_string(details.inode)
+                             + "  Xattrs: " + std::to_string(details.xattrCount)));
+        
+        lines.push_back(text("Modified: " + Format::DateTime(details.modificationTime) + "  Accessed: " + Format::DateTime(details.accessTime)
+                             + "  Changed: " + Format::DateTime(details.changeTime) + "  Created: " + Format::DateTime(details.birthTime)));
+    }
+    
+    return vbox(std::move(lines));
+}
+
+ftxui::Element AppUI::Render()
+{
+    using namespace ftxui;
+    
+    const AllocationCounter::ScopedPhase allocationPhase(AllocationCounter::Phase::UI_RENDER);
+    const Tracer::ScopedSpan span(Tracer::Category::UI, "render");
+    
+    // Timed only while the ui_frame probe is attached or the performance overlay is shown
+    const bool isProbingFrame = Probes::IsUIFrameEnabled();
+    const bool isTimingFrame = isProbingFrame || m_PerformanceOverlay.IsVisible();
+    const std::chrono::steady_clock::time_point frameStart = isTimingFrame ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+    m_FrameCount++;
+
+    // Main menu view, or the treemap of the current directory
+    auto mainView =
+            hbox({
+                (m_ShowTreemap && !m_IsVirtualView && !IsDiffView()) ? RenderTreemap() | flex : m_Menu->Render() | flex | frame
+        }) | reflect(m_MainViewBox);
+    
+    std::string statusText = m_IsSearching ? " Searching..." : (m_IsScanning ? (m_ImportFile.empty() ? " Scanning..." : " Importing...") : " Done");
+    if(m_DaemonClient)
+        statusText = m_IsScanning ? " Daemon scanning..." : " Attached to daemon";
+    
+    if(m_Tree.IsMapped() && !m_IsSearching)
+        statusText = " Snapshot " + std::to_string(m_Snapshot.GetHeader().generation) + " of " + Format::DateTime(m_Snapshot.GetHeader().createdTime);
+    
+    if(IsDiffView())
+        statusText = " " + std::to_string(m_Diff.IsEmpty() ? 0 : m_Diff.GetNodeCount() - 1) + " changed entries";
+    
+    if(m_HasReachedMemoryLimit)
+        statusText += ", memory limit reached: files only counted in their directories";
+    
+    if(!m_ErrorMessage.empty())
+        statusText = " " + m_ErrorMessage;
+
+    if(m_Deleter.IsRunning() || m_Deleter.GetRemovedEntries() || m_Deleter.GetErrorCount())
+    {
+        statusText = (m_Deleter.IsRunning() ? " Deleting... " : " Deleted ") + std::to_string(m_Deleter.GetRemovedEntries()) + " entries, "
+                    + Format::HumanReadableSize(m_Deleter.GetRemovedBytes()) + " freed";
+        
+        if(m_Deleter.GetErrorCount())
+            statusText += ", " + std::to_string(m_Deleter.GetErrorCount()) + " errors (" + m_Deleter.GetLastErrorMessage() + ")";
+    }
+    
+    // Bottom status line
+    auto statusLine = hbox({
+                //text(m_SpaceInfoText),
+        
+                hbox({spinner(15, m_SpinnerValue), text(statusText)}) | ftxui::bold | size(WIDTH, GREATER_THAN, 14),
+        
+                text(onChangeFctStr) | bgcolor(Color::Yellow) | color(Color::Black) /*| flex*/ | size(WIDTH, EQUAL, 25),
+        
+                //text("["), gauge(m_GaugeValueUsedSpace) | flex | size(WIDTH, EQUAL, 10), text(std::format("] {:.2f}%", m_GaugeValueUsedSpace * 100.0f)),
+                //text("space"),
+        
+                text("Selected: " + std::to_string(m_Menu->GetCurrentSelection()) + ", Focused: " + std::to_string(m_Menu->GetCurrentFocus())) | center | flex | bgcolor(Color::Blue),
+                
+                text("abc") | bgcolor(Color::Blue)
+        });
+    
+    // Header line
+    Element header;
+    if(m_IsSearchInputActive)
+    {
+        header = text("Find (substring or glob): " + m_SearchQuery + "_");
+    }
+    else if(m_IsDeleteConfirmActive)
+    {
+        header = text(m_DeleteConfirmText) | color(Color::Red);
+    }
+    else if(IsDiffView())
+    {
+        header = RenderDiffHeader();
+    }
+    else if(m_IsVirtualView)
+    {
+        header = text(m_VirtualViewTitle);
+    }
+    else if(!m_HotPath.empty())
+    {
+        // Breadcrumb of the hot path with the share of every step
+        std::wstring breadcrumb = L"Hot path: ";
+        
+        std::shared_lock lock(m_Tree.GetMutex());
+        breadcrumb += m_Tree.GetPath(m_HotPath.front()).wstring();
+        
+        for(std::size_t i = 1; i < m_HotPath.size(); i++)
+        {
+            const DirectoryTree::Node& node = m_Tree.GetNode(m_HotPath[i]);
+            const uintmax_t parentSize = m_Tree.GetNode(node.parent).size;
+            const int32_t percent = parentSize ? static_cast<int32_t>(100.0 * static_cast<double>(node.size) / static_cast<double>(parentSize)) : 0;
+            
+            breadcrumb += L" > " + std::filesystem::path(m_Tree.GetName(m_HotPath[i])).wstring() + L" (" + std::to_wstring(percent) + L"%)";
+        }
+        
+        header = text(breadcrumb);
+    }
+    else
+    {
+        std::wstring currentPathStr = L"Current path: ";
+        
+        std::shared_lock lock(m_Tree.GetMutex());
+        currentPathStr += (m_CurrentNode != DirectoryTree::INVALID_NODE) ? m_Tree.GetPath(m_CurrentNode).wstring() : m_StartingPath.wstring();
+        
+        header = text(currentPathStr);
+    }
+    
+    Element frame = window(text("DirStatsTUI") | ftxui::bold | center,
+                vbox({
+                    header | inverted,
+                    separator(),
+                    mainView | flex,
+                    separator(),
+                    RenderDetails() | size(HEIGHT, GREATER_THAN, 5),
+                    separator(),
+                    statusLine /*| bgcolor(Color::Blue)*/ /*| inverted*/
+            })
+            );
+    
+    if(isProbingFrame)
+        Probes::UIFrame(m_FrameCount, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - frameStart).count()));
+    
+    if(m_PerformanceOverlay.IsVisible())
+    {
+        if(m_PerformanceOverlay.OnFrame(frameStart))
+        {
+            MemoryAccounting memory;
+            AccountMemory(memory);
+            m_PerformanceOverlay.Sample(m_ScanProgress, memory);
+        }
+        
+        frame = dbox({frame, m_PerformanceOverlay.Render()});
+    }
+    
+    return frame;
+    
+    return window(text(L"REPLACE ME") | ftxui::bold | center, text("Content"));
+}
+
+bool AppUI::OnEvent(ftxui::Event event)
+{
+    const AllocationCounter::ScopedPhase allocationPhase(AllocationCounter::Phase::UI_EVENT);
+    const Tracer::ScopedSpan span(Tracer::Category::UI, "event");
+    
+//    if (event == ftxui::Event::Character('h'))
+//    {
+//        return true;
+//    }
+
+    // Custom events only request a new frame, they aren't input
+    if (m_PerformanceOverlay.IsVisible() && event != ftxui::Event::Custom)
+        m_PerformanceOverlay.OnInput();
+    
+    if (m_IsSearchInputActive)
+        return OnSearchInputEvent(event);
+    
+    if (m_IsDeleteConfirmActive)
+    {
+        // Everything but 'y' cancels
+        m_IsDeleteConfirmActive = false;
+        
+        if (event == ftxui::Event::Character('y') || event == ftxui::Event::Character('Y'))
+            m_Deleter.Start(std::vector<DirectoryTree::NodeIndex>(m_MarkedNodes.begin(), m_MarkedNodes.end()));
+        
+        return true;
+    }
+    
+    // The snapshots of a diff are read-only, marking, search and treemap need a single tree
+    if (IsDiffView() && (event == ftxui::Event::Character(' ') || event == ftxui::Event::Character('d')
+                         || event == ftxui::Event::Character('/') || event == ftxui::Event::Character('t')))
+        return true;
+    
+    if (event == ftxui::Event::Character(' '))
+    {
+        ToggleMark();
+        return true;
+    }
+    
+    if (event == ftxui::Event::Character('d'))
+    {
+        RequestDeletion();
+        return true;
+    }
+    
+    // Search needs the whole tree, the daemon's is only mirrored partially
+    if (event == ftxui::Event::Character('/') && !m_DaemonClient)
+    {
+        m_SearchQuery.clear();
+        m_IsSearchInputActive = true;
+        return true;
+    }
+    
+    if (event == ftxui::Event::Character('h'))
+    {
+        FollowHotPath();
+        return true;
+    }
+    
+    if (event == ftxui::Event::Character('t'))
+    {
+        m_ShowTreemap = !m_ShowTreemap;
+        return true;
+    }
+    
+    if (event == ftxui::Event::Character('p'))
+    {
+        m_PerformanceOverlay.Toggle();
+        return true;
+    }
+    
+    if (event == ftxui::Event::Backspace || event == ftxui::Event::ArrowLeft)
+    {
+        NavigateUp();
+        return true;
+    }
+
+    if (event == ftxui::Event::Escape)
+    {
+        // Leave search results first
+        if(m_IsVirtualView)
+        {
+            NavigateUp();
+            return true;
+        }
+        
         m_QuitFunction();
         return true;
     }
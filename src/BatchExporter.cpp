@@ -0,0 +1,490 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  BatchExporter.cpp                                               */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#include "DirStatsCore.hpp"
+
+bool BatchExporter::ParseFormat(const std::string& name, OutputFormat& out_format) noexcept
+{
+    if(name == "json")
+        out_format = OutputFormat::JSON;
+    else if(name == "ndjson")
+        out_format = OutputFormat::NDJSON;
+    else if(name == "csv")
+        out_format = OutputFormat::CSV;
+    else if(name == "folded")
+        out_format = OutputFormat::FOLDED;
+    else
+        return false;
+    
+    return true;
+}
+
+bool BatchExporter::Run(const FileSystem::Path& path, const FileSystem::Path& outputFile, const std::atomic<bool>& stop, const std::size_t threadCount)
+{
+    const char separator = static_cast<char>(FileSystem::Path::preferred_separator);
+    const std::shared_ptr<VirtualFileSystem> fileSystem = RealFileSystem::GetInstance();
+    
+    // Further links to a file already counted add no size, like in the scanner
+    FileSystem::InodeSet inodes;
+    
+    // The starting path must be readable
+    Listing rootListing;
+    rootListing.isComplete = fileSystem->ReadDirectory(path.string(), true, rootListing.names, rootListing.entries, rootListing.ids);
+    
+    if(!rootListing.isComplete && rootListing.entries.empty())
+    {
+        static_cast<std::error_code&>(m_LastError).assign(errno ? errno : EACCES, std::generic_category());
+        return false;
+    }
+    
+    if(!OpenOutput(outputFile))
+        return false;
+    
+    m_CurrentPath = path.string();
+    if(m_CurrentPath.size() > 1 && m_CurrentPath.back() == separator)
+        m_CurrentPath.pop_back();
+    
+    std::vector<Frame> stack;
+    stack.emplace_back();
+    stack.back().pathLength = m_CurrentPath.size();
+    
+    uintmax_t allocatedSize = 0;
+    fileSystem->GetDirectorySize(path.string(), stack.back().size, allocatedSize);
+    AddListing(rootListing, stack.back(), inodes);
+    
+    // Declared last, so no worker outlives the listings it reads into
+    ThreadPool pool(std::max<std::size_t>(threadCount, 1));
+    const std::size_t readAheadCount = pool.GetThreadCount() * READ_AHEAD_PER_THREAD;
+    
+    // Queue the listings of the next subdirectories of the directory in m_CurrentPath
+    auto readAhead = [&](Frame& frame)
+    {
+        while(frame.nextReadAhead < frame.subdirectories.size() && frame.readAhead.size() < readAheadCount)
+        {
+            std::shared_ptr<Listing> listing = std::make_shared<Listing>();
+            listing->path = m_CurrentPath;
+            
+            if(listing->path.empty() || listing->path.back() != separator)
+                listing->path += separator;
+            
+            listing->path += frame.subdirectories[frame.nextReadAhead++].first;
+            frame.readAhead.push_back(listing);
+            
+            pool.Submit([this, &fileSystem, listing] { ReadListing(*fileSystem, *listing); });
+        }
+    };
+    
+    readAhead(stack.back());
+    WriteBegin();
+    
+    bool isWriteOk = true;
+    
+    while(!stack.empty() && isWriteOk && !stop)
+    {
+        Frame& frame = stack.back();
+        
+        // Subtree complete, write it and add it to its parent
+        if(frame.nextSubdirectory == frame.subdirectories.size())
+        {
+            WriteRecord(frame.size, frame.count, frame.hasError);
+            
+            const uintmax_t size = frame.size;
+            const uintmax_t count = frame.count;
+            stack.pop_back();
+            
+            if(!stack.empty())
+            {
+                stack.back().size += size;
+                stack.back().count += count + 1;
+                m_CurrentPath.resize(stack.back().pathLength);
+            }
+            
+            if(m_Buffer.size() >= CHUNK_SIZE)
+                isWriteOk = Flush();
+            
+            continue;
+        }
+        
+        readAhead(frame);
+        
+        const std::shared_ptr<Listing> listing = std::move(frame.readAhead.front());
+        frame.readAhead.pop_front();
+        
+        // Own size of the subdirectory is part of its record
+        Frame child;
+        child.size = frame.subdirectories[frame.nextSubdirectory++].second;
+        
+        WaitForListing(*listing);
+        AddListing(*listing, child, inodes);
+        
+        m_CurrentPath = listing->path;
+        child.pathLength = m_CurrentPath.size();
+        
+        // Invalidates frame
+        stack.push_back(std::move(child));
+        readAhead(stack.back());
+    }
+    
+    if(isWriteOk && !stop)
+    {
+        WriteEnd();
+        isWriteOk = Flush();
+    }
+    
+    if(!CloseOutput(isWriteOk))
+        return false;
+    
+    if(stop)
+    {
+        static_cast<std::error_code&>(m_LastError).assign(ECANCELED, std::generic_category());
+        return false;
+    }
+    
+    return true;
+}
+
+void BatchExporter::ReadListing(VirtualFileSystem& fileSystem, Listing& listing)
+{
+    try {
+        listing.isComplete = fileSystem.ReadDirectory(listing.path, false, listing.names, listing.entries, listing.ids);
+        listing.error = errno;
+    }
+    catch (const std::bad_alloc&) {
+        listing.isOutOfMemory = true;
+    }
+    
+    {
+        std::lock_guard lock(m_ListingMutex);
+        listing.isReady = true;
+    }
+    
+    m_ListingReady.notify_all();
+}
+
+void BatchExporter::WaitForListing(Listing& listing)
+{
+    {
+        std::unique_lock lock(m_ListingMutex);
+        m_ListingReady.wait(lock, [&listing] { return listing.isReady; });
+    }
+    
+    if(listing.isOutOfMemory)
+        throw std::bad_alloc();
+}
+
+void BatchExporter::AddListing(Listing& listing, Frame& out_frame, FileSystem::InodeSet& inodes)
+{
+    // Unreadable directories and entries which can't be examined
+    out_frame.hasError = !listing.isComplete;
+    
+    for(std::size_t i = 0; i < listing.entries.size(); i++)
+    {
+        const DirectoryTree::Entry& entry = listing.entries[i];
+        
+        // Directories count when their subtree is complete
+        if(entry.type == DirectoryTree::NodeType::DIRECTORY)
+        {
+            out_frame.subdirectories.emplace_back(std::move(listing.names[i]), entry.size);
+            continue;
+        }
+        
+        out_frame.count++;
+        
+        if(listing.ids[i].linkCount > 1 && !inodes.emplace(listing.ids[i].device, listing.ids[i].inode).second)
+            continue;
+        
+        out_frame.size += entry.size;
+    }
+    
+    listing.names = {};
+    listing.entries = {};
+    listing.ids = {};
+}
+
+bool BatchExporter::Export(const DirectoryTree& tree, const FileSystem::Path& outputFile)
+{
+    const DirectoryTree::NodeIndex root = tree.GetRoot();
+    if(root == DirectoryTree::INVALID_NODE)
+    {
+        static_cast<std::error_code&>(m_LastError).assign(ENOENT, std::generic_category());
+        return false;
+    }
+    
+    if(m_Format == OutputFormat::FOLDED)
+        return ExportFolded(tree, outputFile);
+    
+    if(!OpenOutput(outputFile))
+        return false;
+    
+    const char separator = static_cast<char>(FileSystem::Path::preferred_separator);
+    
+    // Post-order like Run(): next child to visit of every open directory
+    struct TreeFrame
+    {
+        DirectoryTree::NodeIndex    node = DirectoryTree::INVALID_NODE;
+        uint32_t                    nextChild = 0;
+        std::size_t                 pathLength = 0;
+    };
+    
+    std::vector<TreeFrame> stack;
+    m_CurrentPath = tree.GetName(root);
+    stack.push_back({root, 0, m_CurrentPath.size()});
+    
+    WriteBegin();
+    bool isWriteOk = true;
+    
+    while(!stack.empty() && isWriteOk)
+    {
+        TreeFrame& frame = stack.back();
+        const DirectoryTree::Node& node = tree.GetNode(frame.node);
+        
+        if(frame.nextChild == node.childCount)
+        {
+            WriteRecord(node.size, node.count, node.hasError);
+            stack.pop_back();
+            
+            if(!stack.empty())
+                m_CurrentPath.resize(stack.back().pathLength);
+            
+            if(m_Buffer.size() >= CHUNK_SIZE)
+                isWriteOk = Flush();
+            
+            continue;
+        }
+        
+        const DirectoryTree::NodeIndex child = node.firstChild + frame.nextChild++;
+        const DirectoryTree::Node& childNode = tree.GetNode(child);
+        
+        if(childNode.type != DirectoryTree::NodeType::DIRECTORY || childNode.isRemoved)
+            continue;
+        
+        if(m_CurrentPath.empty() || m_CurrentPath.back() != separator)
+            m_CurrentPath += separator;
+        
+        m_CurrentPath += tree.GetName(child);
+        
+        // Invalidates frame
+        stack.push_back({child, 0, m_CurrentPath.size()});
+    }
+    
+    if(isWriteOk)
+    {
+        WriteEnd();
+        isWriteOk = Flush();
+    }
+    
+    return CloseOutput(isWriteOk);
+}
+
+bool BatchExporter::ExportFolded(const DirectoryTree& tree, const FileSystem::Path& outputFile)
+{
+    if(!OpenOutput(outputFile))
+        return false;
+    
+    const DirectoryTree::NodeIndex root = tree.GetRoot();
+    const uintmax_t minSize = static_cast<uintmax_t>(static_cast<double>(tree.GetNode(root).size) * m_FoldedThreshold);
+    
+    // Depth-first, m_CurrentPath holds the frames of the open directories only
+    struct FoldedFrame
+    {
+        DirectoryTree::NodeIndex    node = DirectoryTree::INVALID_NODE;
+        uint32_t                    nextChild = 0;
+        std::size_t                 stackLength = 0;    // Length of the frames in m_CurrentPath
+        uintmax_t                   childrenSize = 0;   // Of the children with an own line
+    };
+    
+    auto writeLine = [this](const uintmax_t size)
+    {
+        m_Buffer += m_CurrentPath;
+        m_Buffer += ' ';
+        m_Buffer += std::to_string(size);
+        m_Buffer += '\n';
+        m_RecordCount++;
+    };
+    
+    std::vector<FoldedFrame> stack;
+    m_CurrentPath.clear();
+    AppendFrameName(m_CurrentPath, tree.GetName(root));
+    stack.push_back({root, 0, m_CurrentPath.size(), 0});
+    
+    bool isWriteOk = true;
+    
+    while(!stack.empty() && isWriteOk)
+    {
+        FoldedFrame& frame = stack.back();
+        const DirectoryTree::Node& node = tree.GetNode(frame.node);
+        
+        if(frame.nextChild == node.childCount)
+        {
+            // Own size of the directory and its pruned children
+            if(node.size > frame.childrenSize)
+                writeLine(node.size - frame.childrenSize);
+            
+            stack.pop_back();
+            
+            if(!stack.empty())
+                m_CurrentPath.resize(stack.back().stackLength);
+            
+            if(m_Buffer.size() >= CHUNK_SIZE)
+                isWriteOk = Flush();
+            
+            continue;
+        }
+        
+        const DirectoryTree::NodeIndex child = node.firstChild + frame.nextChild++;
+        const DirectoryTree::Node& childNode = tree.GetNode(child);
+        
+        if(childNode.isRemoved || childNode.size == 0 || childNode.size < minSize)
+            continue;
+        
+        frame.childrenSize += childNode.size;
+        m_CurrentPath += ';';
+        AppendFrameName(m_CurrentPath, tree.GetName(child));
+        
+        if(childNode.type == DirectoryTree::NodeType::DIRECTORY && childNode.childCount > 0)
+        {
+            // Invalidates frame
+            stack.push_back({child, 0, m_CurrentPath.size(), 0});
+        }
+        else
+        {
+            writeLine(childNode.size);
+            m_CurrentPath.resize(frame.stackLength);
+        }
+    }
+    
+    if(isWriteOk)
+        isWriteOk = Flush();
+    
+    return CloseOutput(isWriteOk);
+}
+
+void BatchExporter::AppendFrameName(std::string& out, const std::string_view name)
+{
+    // Semicolons separate the frames, a line ends with the size
+    for(const char c : name)
+        out += (c == ';' || c == '\n' || c == '\r') ? '_' : c;
+}
+
+bool BatchExporter::OpenOutput(const FileSystem::Path& outputFile)
+{
+    m_Output = outputFile.empty() ? stdout : std::fopen(outputFile.string().c_str(), "wb");
+    if(!m_Output)
+    {
+        static_cast<std::error_code&>(m_LastError).assign(errno, std::generic_category());
+        return false;
+    }
+    
+    // Chunks are written with a single call, no need for stdio buffering
+    std::setvbuf(m_Output, nullptr, _IONBF, 0);
+    
+    m_Buffer.clear();
+    m_Buffer.reserve(CHUNK_SIZE + 4096);
+    m_RecordCount = 0;
+    
+    return true;
+}
+
+bool BatchExporter::CloseOutput(bool isWriteOk)
+{
+    if(m_Output != stdout && std::fclose(m_Output) != 0 && isWriteOk)
+    {
+        static_cast<std::error_code&>(m_LastError).assign(errno, std::generic_category());
+        isWriteOk = false;
+    }
+    
+    m_Output = nullptr;
+    
+    return isWriteOk;
+}
+
+void BatchExporter::WriteBegin()
+{
+    if(m_Format == OutputFormat::JSON)
+        m_Buffer += "[\n";
+    else if(m_Format == OutputFormat::CSV)
+        m_Buffer += "path,size,count,error\n";
+}
+
+void BatchExporter::WriteRecord(const uintmax_t size, const uintmax_t count, const bool hasError)
+{
+    if(m_Format == OutputFormat::CSV)
+    {
+        Format::AppendCsvField(m_Buffer, m_CurrentPath);
+        m_Buffer += ',' + std::to_string(size) + ',' + std::to_string(count) + (hasError ? ",1\n" : ",0\n");
+    }
+    else
+    {
+        if(m_Format == OutputFormat::JSON && m_RecordCount > 0)
+            m_Buffer += ",\n";
+        
+        m_Buffer += "{\"path\":";
+        Format::AppendJsonString(m_Buffer, m_CurrentPath);
+        
+        // The path has U+FFFD in place of invalid bytes, the raw bytes are kept in hex
+        if(!Format::IsValidUtf8(m_CurrentPath))
+        {
+            m_Buffer += ",\"path_bytes\":\"";
+            Format::AppendHex(m_Buffer, m_CurrentPath);
+            m_Buffer += '"';
+        }
+        m_Buffer += ",\"size\":" + std::to_string(size) + ",\"count\":" + std::to_string(count) + (hasError ? ",\"error\":true}" : ",\"error\":false}");
+        
+        if(m_Format == OutputFormat::NDJSON)
+            m_Buffer += '\n';
+    }
+    
+    m_RecordCount++;
+}
+
+void BatchExporter::WriteEnd()
+{
+    if(m_Format == OutputFormat::JSON)
+        m_Buffer += (m_RecordCount > 0) ? "\n]\n" : "]\n";
+}
+
+bool BatchExporter::Flush()
+{
+    if(m_Buffer.empty())
+        return true;
+    
+    if(std::fwrite(m_Buffer.data(), 1, m_Buffer.size(), m_Output) != m_Buffer.size())
+    {
+        static_cast<std::error_code&>(m_LastError).assign(errno, std::generic_category());
+        return false;
+    }
+    
+    m_Buffer.clear();
+    
+    return true;
+}
@@ -0,0 +1,503 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  Daemon.cpp                                                      */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#include "DirStatsCore.hpp"
+
+Daemon::Daemon(const FileSystem::Path& path, const std::string& socketPath, const std::chrono::seconds refreshInterval, const std::size_t threadCount)
+    : m_Path(path)
+    , m_SocketPath(socketPath)
+    , m_RefreshInterval(refreshInterval)
+    , m_ThreadCount(threadCount)
+    , m_Tree(std::make_shared<DirectoryTree>())
+    , m_Generation(1)
+{
+}
+
+void Daemon::Log(const std::string& message)
+{
+    static std::mutex logMutex;
+    std::lock_guard lock(logMutex);
+    
+    std::cerr << "[" << Format::DateTime(std::time(nullptr)) << "] " << message << std::endl;
+}
+
+void Daemon::RequestStop()
+{
+    {
+        std::lock_guard lock(m_StopMutex);
+        m_Stop = true;
+    }
+    
+    m_StopCondition.notify_all();
+}
+
+void Daemon::ScanTask()
+{
+    bool isFirstScan = true;
+    bool isRefresh = false; // The served tree is complete and can be refreshed
+    
+    // Files with more than one link in the served tree, see FileSystem::RefreshDirectoryTree()
+    FileSystem::InodeSet linkedInodes;
+    
+    while(!m_Stop)
+    {
+        try {
+            // The first scan is served while it runs, like a refresh. A full scan after a failed one replaces the tree when complete.
+            std::shared_ptr<DirectoryTree> tree;
+            if(isFirstScan || isRefresh)
+            {
+                std::lock_guard lock(m_TreeMutex);
+                tree = m_Tree;
+            }
+            else
+            {
+                tree = std::make_shared<DirectoryTree>();
+            }
+            
+            Log((isRefresh ? "Refreshing " : "Scanning ") + m_Path.string());
+            const auto start = std::chrono::steady_clock::now();
+            
+            FileSystem fileSystem;
+            fileSystem.SetFileNodeLimit(m_FileNodeLimit);
+            fileSystem.SetMemoryLimit(m_MemoryLimit);
+            fileSystem.SetLinkedInodes(&linkedInodes);
+            
+            // A failed refresh leaves a consistent tree, its changes so far are served
+            const bool wasRefresh = isRefresh;
+            std::size_t changeCount = 0;
+            bool isComplete = false;
+            m_IsScanning = true;
+            
+            if(wasRefresh)
+            {
+                isComplete = fileSystem.RefreshDirectoryTree(*tree, m_Stop, changeCount, m_ThreadCount);
+            }
+            else
+            {
+                linkedInodes.clear();
+                isComplete = fileSystem.ScanDirectoryTree(m_Path, *tree, m_Stop, m_ThreadCount);
+            }
+            
+            m_IsScanning = false;
+            isRefresh = wasRefresh || isComplete;
+            
+            uint64_t generation = 0;
+            {
+                std::unique_lock layoutLock(m_LayoutMutex);
+                
+                // The scanner stopped adding files at the limit, the files scanned before can go as well
+                bool isLayoutChanged = false;
+                if(isComplete && fileSystem.HasReachedMemoryLimit())
+                {
+                    Log("Memory limit reached: files folded into their directories, " + std::to_string(tree->DropFileNodes()) + " file nodes dropped");
+                    isLayoutChanged = true;
+                }
+                else if(isComplete && (tree->GetGarbageCount() > tree->GetNodeCount() / 4 || (!m_PublishFile.empty() && tree->GetGarbageCount() > 0)))
+                {
+                    // Snapshots need every directory before its children
+                    Log("Compacted the tree, " + std::to_string(tree->Compact()) + " removed nodes freed");
+                    isLayoutChanged = true;
+                }
+                
+                std::lock_guard lock(m_TreeMutex);
+                
+                // Clients still reading a replaced tree keep it alive until they are done
+                if(isComplete && tree != m_Tree)
+                {
+                    m_Tree = tree;
+                    m_Generation++;
+                }
+                else if(isLayoutChanged || (wasRefresh && changeCount > 0))
+                {
+                    m_Generation++;
+                }
+                
+                generation = m_Generation;
+            }
+            
+            if(isComplete)
+            {
+                const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+                if(wasRefresh)
+                    Log("Refreshed " + std::to_string(changeCount) + " changed entries in " + std::to_string(duration.count()) + " ms, generation " + std::to_string(generation));
+                else
+                    Log("Scanned " + std::to_string(tree->GetNodeCount()) + " entries in " + std::to_string(duration.count()) + " ms, generation " + std::to_string(generation));
+                
+                if(!m_PublishFile.empty())
+                {
+                    TreeSnapshot snapshot;
+                    std::shared_lock treeLock(tree->GetMutex());
+                    
+                    if(snapshot.Publish(*tree, m_PublishFile))
+                        Log("Published snapshot " + std::to_string(snapshot.GetHeader().generation) + " to " + m_PublishFile.string());
+                    else
+                        Log("Publishing failed: " + snapshot.GetLastErrorMessage());
+                }
+                
+                if(!m_HistoryFile.empty())
+                {
+                    uintmax_t capacity = 0;
+                    uintmax_t free = 0;
+                    uintmax_t available = 0;
+                    fileSystem.GetSpaceInfo(m_Path, capacity, free, available);
+                    
+                    HistoryStore history;
+                    std::shared_lock treeLock(tree->GetMutex());
+                    
+                    if(history.Append(*tree, m_HistoryFile, m_HistoryMinSize, capacity, available))
+                        Log("Appended scan to history " + m_HistoryFile.string());
+                    else
+                        Log("Appending to history failed: " + history.GetLastErrorMessage());
+                }
+                
+                if(!m_PrometheusFile.empty())
+                {
+                    PrometheusExporter exporter(m_PrometheusMaxDepth, m_PrometheusMinSize);
+                    std::shared_lock treeLock(tree->GetMutex());
+                    
+                    const PrometheusExporter::ScanInfo scanInfo = {static_cast<int64_t>(std::time(nullptr)), static_cast<double>(duration.count()) / 1000.0};
+                    if(!exporter.Write(*tree, m_PrometheusFile, scanInfo))
+                        Log("Writing metrics failed: " + exporter.GetLastErrorMessage());
+                }
+            }
+            else if(!m_Stop)
+            {
+                Log("Scan failed: " + fileSystem.GetLastError().GetMessage());
+            }
+        }
+        catch (const std::bad_alloc&) {
+            m_IsScanning = false;
+            isRefresh = false;
+            Log("Scan failed: Out of memory");
+        }
+        
+        isFirstScan = false;
+        
+        // Wait for the next refresh
+        std::unique_lock lock(m_StopMutex);
+        if(m_RefreshInterval.count() > 0)
+            m_StopCondition.wait_for(lock, m_RefreshInterval, [this] { return m_Stop.load(); });
+        else
+            m_StopCondition.wait(lock, [this] { return m_Stop.load(); });
+    }
+}
+
+void Daemon::HandleRequest(const std::string& request, std::string& out_response)
+{
+    using namespace DaemonProtocol;
+    
+    Reader reader(request);
+    const RequestType type = static_cast<RequestType>(reader.ReadByte());
+    
+    // Keep the tree of this generation alive while answering, even if a full scan replaces it
+    std::shared_lock layoutLock(m_LayoutMutex);
+    std::shared_ptr<DirectoryTree> tree;
+    uint64_t generation = 0;
+    {
+        std::lock_guard lock(m_TreeMutex);
+        tree = m_Tree;
+        generation = m_Generation;
+    }
+    
+    auto fail = [&](const Status status)
+    {
+        out_response.assign(1, static_cast<char>(status));
+        AppendVarint(out_response, generation);
+    };
+    
+    out_response.assign(1, static_cast<char>(Status::OK));
+    AppendVarint(out_response, generation);
+    
+    std::shared_lock treeLock(tree->GetMutex());
+    
+    if(type == RequestType::INFO && reader.IsOk())
+    {
+        AppendVarint(out_response, VERSION);
+        out_response += static_cast<char>(m_IsScanning ? 1 : 0);
+        AppendVarint(out_response, tree->GetNodeCount());
+        AppendString(out_response, m_Path.string());
+        
+        if(tree->GetRoot() != DirectoryTree::INVALID_NODE)
+            AppendRecord(out_response, *tree, tree->GetRoot());
+    }
+    else if(type == RequestType::CHILDREN)
+    {
+        const uint64_t requestedGeneration = reader.ReadVarint();
+        const uint64_t count = reader.ReadVarint();
+        
+        if(!reader.IsOk() || count > MAX_REQUEST_NODES)
+            return fail(Status::INVALID_REQUEST);
+        
+        if(requestedGeneration != generation)
+            return fail(Status::STALE_GENERATION);
+        
+        // Records of one node, their count goes first
+        std::string records;
+        std::vector<DirectoryTree::NodeIndex> children;
+        
+        for(uint64_t i = 0; i < count; i++)
+        {
+            const uint64_t node = reader.ReadVarint();
+            const uint64_t offset = reader.ReadVarint();
+            const uint64_t limit = reader.ReadVarint();
+            
+            if(!reader.IsOk() || node >= tree->GetNodeCount())
+                return fail(Status::INVALID_REQUEST);
+            
+            // Children are stored contiguously and only move with the generation
+            const DirectoryTree::Node& parent = tree->GetNode(static_cast<DirectoryTree::NodeIndex>(node));
+            if(offset > parent.childCount)
+                return fail(Status::INVALID_REQUEST);
+            
+            const uint64_t end = offset + std::min({limit, MAX_PAGE_RECORDS, parent.childCount - offset});
+            uint64_t recordCount = 0;
+            records.clear();
+            
+            // Largest first, only as far as asked for
+            children.resize(parent.childCount);
+            std::iota(children.begin(), children.end(), parent.firstChild);
+            std::partial_sort(children.begin(), children.begin() + static_cast<std::ptrdiff_t>(end), children.end(), [&tree](const DirectoryTree::NodeIndex a, const DirectoryTree::NodeIndex b)
+            {
+                const uintmax_t sizeA = tree->GetNode(a).size;
+                const uintmax_t sizeB = tree->GetNode(b).size;
+                return (sizeA != sizeB) ? sizeA > sizeB : a < b;
+            });
+            
+            for(uint64_t j = offset; j < end; j++)
+            {
+                // Cut large replies, the client asks again for the rest
+                if(out_response.size() + records.size() >= MAX_REPLY_SIZE && (i > 0 || recordCount > 0))
+                    break;
+                
+                AppendRecord(records, *tree, children[j]);
+                recordCount++;
+            }
+            
+            AppendVarint(out_response, parent.childCount);
+            AppendVarint(out_response, recordCount);
+            out_response += records;
+        }
+    }
+    else
+    {
+        fail(Status::INVALID_REQUEST);
+    }
+}
+
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_APPLE)
+void Daemon::ConnectionTask(Connection& connection)
+{
+    std::string request;
+    std::string response;
+    
+    try {
+        while(!m_Stop && DaemonProtocol::ReceiveFrame(connection.fd, request))
+        {
+            HandleRequest(request, response);
+            
+            if(!DaemonProtocol::SendFrame(connection.fd, response))
+                break;
+        }
+    }
+    catch (const std::bad_alloc&) {
+        // Drop this client
+    }
+    
+    connection.isDone = true;
+}
+
+void Daemon::JoinConnections(const bool all)
+{
+    for(auto it = m_Connections.begin(); it != m_Connections.end();)
+    {
+        // Unblock threads waiting for a request
+        if(all)
+            shutdown(it->fd, SHUT_RDWR);
+        
+        if(!all && !it->isDone)
+        {
+            ++it;
+            continue;
+        }
+        
+        if(it->thread.joinable())
+            it->thread.join();
+        
+        // Closed after the join, so the fd can't be reused while the thread still uses it
+        close(it->fd);
+        it = m_Connections.erase(it);
+    }
+}
+
+int Daemon::CreateListenSocket()
+{
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    
+    if(m_SocketPath.size() >= sizeof(address.sun_path))
+    {
+        Log("Socket path is too long: " + m_SocketPath);
+        return -1;
+    }
+    
+    std::memcpy(address.sun_path, m_SocketPath.c_str(), m_SocketPath.size() + 1);
+    
+    // A socket file left behind by a crashed daemon is replaced, a running daemon is not
+    const int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(probe >= 0)
+    {
+        const bool isInUse = (connect(probe, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0);
+        close(probe);
+        
+        if(isInUse)
+        {
+            Log("Another daemon is already listening on " + m_SocketPath);
+            return -1;
+        }
+    }
+    
+    unlink(m_SocketPath.c_str());
+    
+    const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(fd < 0)
+    {
+        Log("Can't create socket: " + std::string(std::strerror(errno)));
+        return -1;
+    }
+    
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+    
+    // Only the owner may connect. No other threads are running yet, so changing the umask is safe.
+    const mode_t oldMask = umask(0077);
+    const bool isBound = (bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0);
+    umask(oldMask);
+    
+    if(!isBound || listen(fd, SOMAXCONN) != 0)
+    {
+        Log("Can't listen on " + m_SocketPath + ": " + std::string(std::strerror(errno)));
+        close(fd);
+        return -1;
+    }
+    
+    return fd;
+}
+
+int Daemon::Run()
+{
+    // Block SIGINT and SIGTERM in all threads, the accept loop checks for them
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+    
+    // Disconnected clients are noticed by send() errors
+    std::signal(SIGPIPE, SIG_IGN);
+    
+    const int listenSocket = CreateListenSocket();
+    if(listenSocket < 0)
+        return 1;
+    
+    std::thread scanThread(&Daemon::ScanTask, this);
+    Log("Listening on " + m_SocketPath);
+    
+    while(!m_Stop)
+    {
+        pollfd descriptor = {listenSocket, POLLIN, 0};
+        const int result = poll(&descriptor, 1, 500);
+        
+        sigset_t pending;
+        sigpending(&pending);
+        if(sigismember(&pending, SIGINT) == 1 || sigismember(&pending, SIGTERM) == 1)
+        {
+            RequestStop();
+            break;
+        }
+        
+        JoinConnections(false);
+        
+        if(result <= 0)
+            continue;
+        
+        const int fd = accept(listenSocket, nullptr, nullptr);
+        if(fd < 0)
+            continue;
+        
+        fcntl(fd, F_SETFD, FD_CLOEXEC);
+        
+        // One thread per client, requests of a client are answered in order
+        Connection* connection = nullptr;
+        try {
+            connection = &m_Connections.emplace_back();
+            connection->fd = fd;
+            connection->thread = std::thread(&Daemon::ConnectionTask, this, std::ref(*connection));
+        }
+        catch (const std::exception&) {
+            // Out of memory or threads, drop this client
+            if(connection)
+                connection->isDone = true;
+            else
+                close(fd);
+        }
+    }
+    
+    Log("Stopping");
+    
+    JoinConnections(true);
+    scanThread.join();
+    
+    close(listenSocket);
+    unlink(m_SocketPath.c_str());
+    
+    return 0;
+}
+#else
+void Daemon::ConnectionTask(Connection&)
+{
+}
+
+void Daemon::JoinConnections(const bool)
+{
+}
+
+int Daemon::CreateListenSocket()
+{
+    return -1;
+}
+
+int Daemon::Run()
+{
+    std::cerr << "The daemon is only available on Linux and macOS" << std::endl;
+    return 1;
+}
+#endif
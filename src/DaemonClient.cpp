@@ -0,0 +1,407 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  DaemonClient.cpp                                                */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#include "DirStatsCore.hpp"
+
+DaemonClient::~DaemonClient()
+{
+    Disconnect();
+}
+
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_APPLE)
+bool DaemonClient::Connect(const std::string& socketPath)
+{
+    Disconnect();
+    
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    
+    if(socketPath.size() >= sizeof(address.sun_path))
+    {
+        m_LastErrorMessage = "Socket path is too long";
+        return false;
+    }
+    
+    std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+    
+    m_Socket = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(m_Socket < 0 || connect(m_Socket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+    {
+        m_LastErrorMessage = "No daemon on " + socketPath + ": " + std::string(std::strerror(errno));
+        Disconnect();
+        return false;
+    }
+    
+    fcntl(m_Socket, F_SETFD, FD_CLOEXEC);
+    
+    // A hanging daemon must not hang the UI
+    timeval timeout = {};
+    timeout.tv_sec = static_cast<decltype(timeout.tv_sec)>(REPLY_TIMEOUT.count());
+    setsockopt(m_Socket, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(m_Socket, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+    
+    return true;
+}
+
+void DaemonClient::Disconnect() noexcept
+{
+    if(m_Socket >= 0)
+        close(m_Socket);
+    
+    m_Socket = -1;
+}
+#else
+bool DaemonClient::Connect(const std::string&)
+{
+    m_LastErrorMessage = "The daemon is only available on Linux and macOS";
+    return false;
+}
+
+void DaemonClient::Disconnect() noexcept
+{
+}
+#endif
+
+bool DaemonClient::Exchange()
+{
+    if(m_Socket < 0)
+    {
+        m_LastErrorMessage = "Not connected to the daemon";
+        return false;
+    }
+    
+    if(!DaemonProtocol::SendFrame(m_Socket, m_Request) || !DaemonProtocol::ReceiveFrame(m_Socket, m_Response))
+    {
+        const bool isTimeout = (errno == EAGAIN || errno == EWOULDBLOCK);
+        m_LastErrorMessage = isTimeout ? "The daemon didn't answer within " + std::to_string(REPLY_TIMEOUT.count()) + " s" : "Connection to the daemon lost";
+        Disconnect();
+        return false;
+    }
+    
+    return true;
+}
+
+bool DaemonClient::ReadResponseHeader(DaemonProtocol::Reader& reader)
+{
+    const DaemonProtocol::Status status = static_cast<DaemonProtocol::Status>(reader.ReadByte());
+    reader.ReadVarint(); // Generation of the daemon's tree
+    
+    if(!reader.IsOk())
+    {
+        m_LastErrorMessage = "Invalid response of the daemon";
+        return false;
+    }
+    
+    if(status == DaemonProtocol::Status::STALE_GENERATION)
+    {
+        m_IsStale = true;
+        m_LastErrorMessage = "The daemon refreshed its tree";
+        return false;
+    }
+    
+    if(status != DaemonProtocol::Status::OK)
+    {
+        m_LastErrorMessage = "Request rejected by the daemon";
+        return false;
+    }
+    
+    return true;
+}
+
+bool DaemonClient::QueryInfo(Info& out_info)
+{
+    m_Request.assign(1, static_cast<char>(DaemonProtocol::RequestType::INFO));
+    
+    if(!Exchange())
+        return false;
+    
+    DaemonProtocol::Reader reader(m_Response);
+    const DaemonProtocol::Status status = static_cast<DaemonProtocol::Status>(reader.ReadByte());
+    out_info.generation = reader.ReadVarint();
+    
+    const uint64_t version = reader.ReadVarint();
+    out_info.isScanning = (reader.ReadByte() != 0);
+    out_info.nodeCount = reader.ReadVarint();
+    out_info.rootPath = reader.ReadString();
+    
+    if(out_info.nodeCount > 0)
+        reader.ReadRecord(out_info.root);
+    
+    if(!reader.IsOk() || status != DaemonProtocol::Status::OK)
+    {
+        m_LastErrorMessage = "Invalid response of the daemon";
+        return false;
+    }
+    
+    if(version != DaemonProtocol::VERSION)
+    {
+        m_LastErrorMessage = "Unsupported protocol version " + std::to_string(version) + " of the daemon";
+        return false;
+    }
+    
+    return true;
+}
+
+bool DaemonClient::Attach(DirectoryTree& tree, bool& out_isScanning)
+{
+    Info info;
+    if(!QueryInfo(info))
+        return false;
+    
+    out_isScanning = info.isScanning;
+    
+    m_Generation = info.generation;
+    m_IsStale = false;
+    m_RemoteNodes.clear();
+    m_ChildCounts.clear();
+    m_LoadedCounts.clear();
+    
+    // The daemon may not even have the root yet, right after it started
+    if(info.nodeCount == 0)
+    {
+        tree.CreateRoot(info.rootPath);
+        m_RemoteNodes.push_back(DirectoryTree::INVALID_NODE);
+        m_ChildCounts.push_back(0);
+        m_LoadedCounts.push_back(0);
+        
+        return true;
+    }
+    
+    const DirectoryTree::NodeIndex root = tree.CreateRoot(info.root.name);
+    tree.SetMirroredTotals(root, info.root.entry);
+    
+    m_RemoteNodes.push_back(info.root.node);
+    m_ChildCounts.push_back(info.root.childCount);
+    m_LoadedCounts.push_back(0);
+    
+    return true;
+}
+
+bool DaemonClient::LoadChildren(DirectoryTree& tree, const std::vector<DirectoryTree::NodeIndex>& nodes, const uint32_t window)
+{
+    std::vector<DirectoryTree::NodeIndex> pending;
+    for(const DirectoryTree::NodeIndex i : nodes)
+    {
+        if(i < m_LoadedCounts.size() && m_LoadedCounts[i] < std::min(window, m_ChildCounts[i]))
+            pending.push_back(i);
+    }
+    
+    std::sort(pending.begin(), pending.end());
+    pending.erase(std::unique(pending.begin(), pending.end()), pending.end());
+    
+    // Children of a large directory take several replies, they are added to the tree when complete
+    struct PendingDirectory
+    {
+        DirectoryTree::NodeIndex                node = DirectoryTree::INVALID_NODE;
+        uint32_t                                targetCount = 0; // Loaded when complete
+        std::vector<DaemonProtocol::Record>     records;
+    };
+    
+    std::vector<PendingDirectory> batch;
+    std::vector<DirectoryTree::Entry> entries;
+    std::size_t nextPending = 0;
+    
+    while(nextPending < pending.size() || !batch.empty())
+    {
+        while(batch.size() < DaemonProtocol::MAX_REQUEST_NODES && nextPending < pending.size())
+        {
+            const DirectoryTree::NodeIndex node = pending[nextPending++];
+            batch.push_back({node, std::min(window, m_ChildCounts[node]), {}});
+        }
+        
+        m_Request.assign(1, static_cast<char>(DaemonProtocol::RequestType::CHILDREN));
+        DaemonProtocol::AppendVarint(m_Request, m_Generation);
+        DaemonProtocol::AppendVarint(m_Request, batch.size());
+        
+        for(const PendingDirectory& i : batch)
+        {
+            const uint64_t offset = m_LoadedCounts[i.node] + i.records.size();
+            
+            DaemonProtocol::AppendVarint(m_Request, m_RemoteNodes[i.node]);
+            DaemonProtocol::AppendVarint(m_Request, offset);
+            DaemonProtocol::AppendVarint(m_Request, i.targetCount - offset);
+        }
+        
+        if(!Exchange())
+            return false;
+        
+        DaemonProtocol::Reader reader(m_Response);
+        if(!ReadResponseHeader(reader))
+            return false;
+        
+        for(PendingDirectory& directory : batch)
+        {
+            // Every record takes a few bytes at least, don't trust the counts blindly
+            const uint64_t childCount = reader.ReadVarint();
+            const uint64_t recordCount = reader.ReadVarint();
+            const uint64_t missingCount = directory.targetCount - m_LoadedCounts[directory.node] - directory.records.size();
+            
+            if(!reader.IsOk() || recordCount > m_Response.size() || recordCount > missingCount)
+            {
+                m_LastErrorMessage = "Invalid response of the daemon";
+                return false;
+            }
+            
+            // Known from the record of the directory, the daemon changed it meanwhile
+            if(childCount != m_ChildCounts[directory.node])
+            {
+                m_IsStale = true;
+                m_LastErrorMessage = "The daemon refreshed its tree";
+                return false;
+            }
+            
+            for(uint64_t j = 0; j < recordCount; j++)
+            {
+                if(!reader.ReadRecord(directory.records.emplace_back()))
+                {
+                    m_LastErrorMessage = "Invalid response of the daemon";
+                    return false;
+                }
+            }
+        }
+        
+        // Complete directories go to the tree, the others are asked for again
+        for(PendingDirectory& directory : batch)
+        {
+            const uint32_t loadedCount = m_LoadedCounts[directory.node];
+            if(loadedCount + directory.records.size() != directory.targetCount)
+                continue;
+            
+            entries.resize(directory.records.size());
+            for(std::size_t j = 0; j < directory.records.size(); j++)
+            {
+                entries[j] = directory.records[j].entry;
+                entries[j].name = directory.records[j].name;
+            }
+            
+            // The whole block is added with the first window, placeholders are filled later
+            DirectoryTree::NodeIndex firstChild = DirectoryTree::INVALID_NODE;
+            if(loadedCount == 0)
+            {
+                firstChild = tree.AddMirroredChildren(directory.node, entries, m_ChildCounts[directory.node]);
+                
+                m_RemoteNodes.resize(m_RemoteNodes.size() + m_ChildCounts[directory.node], DirectoryTree::INVALID_NODE);
+                m_ChildCounts.resize(m_RemoteNodes.size(), 0);
+                m_LoadedCounts.resize(m_RemoteNodes.size(), 0);
+            }
+            else
+            {
+                tree.FillMirroredChildren(directory.node, loadedCount, entries);
+                
+                std::shared_lock lock(tree.GetMutex());
+                firstChild = tree.GetNode(directory.node).firstChild;
+            }
+            
+            for(std::size_t j = 0; j < directory.records.size(); j++)
+            {
+                const std::size_t child = firstChild + loadedCount + j;
+                m_RemoteNodes[child] = directory.records[j].node;
+                m_ChildCounts[child] = directory.records[j].childCount;
+            }
+            
+            m_LoadedCounts[directory.node] = directory.targetCount;
+            m_LoadedRecordCount += directory.records.size();
+            directory.node = DirectoryTree::INVALID_NODE;
+        }
+        
+        std::erase_if(batch, [](const PendingDirectory& directory) { return directory.node == DirectoryTree::INVALID_NODE; });
+    }
+    
+    return true;
+}
+
+bool DaemonClient::LoadSubtree(DirectoryTree& tree, const DirectoryTree::NodeIndex node, const uint32_t depth, const uint32_t window)
+{
+    // Level by level, one request for all directories of a level
+    std::vector<DirectoryTree::NodeIndex> level = {node};
+    std::vector<DirectoryTree::NodeIndex> nextLevel;
+    std::size_t nodeCount = 0;
+    
+    for(uint32_t i = 0; i < depth && !level.empty(); i++)
+    {
+        if(!LoadChildren(tree, level, window))
+            return false;
+        
+        nextLevel.clear();
+        {
+            std::shared_lock lock(tree.GetMutex());
+            
+            for(const DirectoryTree::NodeIndex j : level)
+            {
+                const DirectoryTree::Node& current = tree.GetNode(j);
+                
+                for(uint32_t k = 0; k < current.childCount; k++)
+                {
+                    const DirectoryTree::Node& child = tree.GetNode(current.firstChild + k);
+                    if(child.type == DirectoryTree::NodeType::DIRECTORY && !child.isRemoved)
+                        nextLevel.push_back(current.firstChild + k);
+                }
+            }
+        }
+        
+        // Huge subtrees don't fit into a view anyway
+        nodeCount += nextLevel.size();
+        if(nodeCount > MAX_SUBTREE_NODES)
+            break;
+        
+        level.swap(nextLevel);
+    }
+    
+    return true;
+}
+
+bool DaemonClient::LoadHeaviestPath(DirectoryTree& tree, DirectoryTree::NodeIndex node, const double minShare)
+{
+    // Same steps as DirectoryTree::GetHeaviestPath(), loading the largest child of each directory on the way
+    while(node != DirectoryTree::INVALID_NODE)
+    {
+        if(!LoadChildren(tree, {node}, 1))
+            return false;
+        
+        std::shared_lock lock(tree.GetMutex());
+        
+        const DirectoryTree::Node& current = tree.GetNode(node);
+        const DirectoryTree::NodeIndex heaviest = current.heaviestChild;
+        
+        if(heaviest == DirectoryTree::INVALID_NODE || current.size == 0)
+            break;
+        
+        const double share = static_cast<double>(tree.GetNode(heaviest).size) / static_cast<double>(current.size);
+        if(share < minShare || tree.GetNode(heaviest).type != DirectoryTree::NodeType::DIRECTORY)
+            break;
+        
+        node = heaviest;
+    }
+    
+    return true;
+}
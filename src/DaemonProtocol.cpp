@@ -0,0 +1,237 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  DaemonProtocol.cpp                                              */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#include "DirStatsCore.hpp"
+
+namespace DaemonProtocol
+{
+uint8_t Reader::ReadByte() noexcept
+{
+    if(m_Position >= m_Data.size())
+    {
+        m_IsOk = false;
+        return 0;
+    }
+    
+    return static_cast<uint8_t>(m_Data[m_Position++]);
+}
+
+uint64_t Reader::ReadVarint() noexcept
+{
+    uint64_t value = 0;
+    
+    for(uint32_t shift = 0; shift < 64; shift += 7)
+    {
+        const uint8_t byte = ReadByte();
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        
+        if((byte & 0x80) == 0)
+            return value;
+    }
+    
+    m_IsOk = false;
+    return 0;
+}
+
+std::string_view Reader::ReadString() noexcept
+{
+    const uint64_t length = ReadVarint();
+    
+    if(!m_IsOk || length > m_Data.size() - m_Position)
+    {
+        m_IsOk = false;
+        return {};
+    }
+    
+    const std::string_view text = m_Data.substr(m_Position, static_cast<std::size_t>(length));
+    m_Position += static_cast<std::size_t>(length);
+    
+    return text;
+}
+
+bool Reader::ReadRecord(Record& out_record)
+{
+    out_record.node = static_cast<DirectoryTree::NodeIndex>(ReadVarint());
+    out_record.name = ReadString();
+    
+    DirectoryTree::Entry& entry = out_record.entry;
+    entry.type = static_cast<DirectoryTree::NodeType>(ReadByte());
+    
+    const uint8_t flags = ReadByte();
+    entry.hasError = (flags & 0x01) != 0;
+    entry.isHardLink = (flags & 0x02) != 0;
+    
+    entry.size = ReadVarint();
+    entry.allocatedSize = ReadVarint();
+    entry.count = ReadVarint();
+    entry.maxDepth = static_cast<uint16_t>(ReadVarint());
+    
+    // Zigzag encoded, may be negative
+    const uint64_t time = ReadVarint();
+    entry.lastWriteTime = static_cast<int64_t>(time >> 1) ^ -static_cast<int64_t>(time & 1);
+    
+    out_record.childCount = static_cast<uint32_t>(ReadVarint());
+    
+    if(entry.type > DirectoryTree::NodeType::OTHER)
+        m_IsOk = false;
+    
+    return m_IsOk;
+}
+
+std::string GetDefaultSocketPath()
+{
+    const char* const runtimeDirectory = std::getenv("XDG_RUNTIME_DIR");
+    if(runtimeDirectory && runtimeDirectory[0] != '\0')
+        return std::string(runtimeDirectory) + "/dirstats.sock";
+    
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_APPLE)
+    return "/tmp/dirstats-" + std::to_string(getuid()) + ".sock";
+#else
+    return "dirstats.sock";
+#endif
+}
+
+void AppendVarint(std::string& out, uint64_t value)
+{
+    while(value >= 0x80)
+    {
+        out += static_cast<char>((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    
+    out += static_cast<char>(value);
+}
+
+void AppendString(std::string& out, const std::string_view text)
+{
+    AppendVarint(out, text.size());
+    out += text;
+}
+
+void AppendRecord(std::string& out, const DirectoryTree& tree, const DirectoryTree::NodeIndex node)
+{
+    const DirectoryTree::Node& current = tree.GetNode(node);
+    
+    AppendVarint(out, node);
+    AppendString(out, tree.GetName(node));
+    
+    out += static_cast<char>(current.type);
+    out += static_cast<char>((current.hasError ? 0x01 : 0x00) | (current.isHardLink ? 0x02 : 0x00));
+    
+    AppendVarint(out, current.size);
+    AppendVarint(out, current.allocatedSize);
+    AppendVarint(out, current.count);
+    AppendVarint(out, current.maxDepth);
+    AppendVarint(out, (static_cast<uint64_t>(current.lastWriteTime) << 1) ^ static_cast<uint64_t>(current.lastWriteTime >> 63));
+    AppendVarint(out, current.childCount);
+}
+
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_APPLE)
+bool SendFrame(const int fd, const std::string& payload)
+{
+    if(payload.size() > MAX_FRAME_SIZE)
+        return false;
+    
+    const uint32_t length = static_cast<uint32_t>(payload.size());
+    const char header[4] = {static_cast<char>(length), static_cast<char>(length >> 8), static_cast<char>(length >> 16), static_cast<char>(length >> 24)};
+    
+    auto sendAll = [fd](const char* data, std::size_t size)
+    {
+        while(size > 0)
+        {
+#ifdef MSG_NOSIGNAL
+            const ssize_t sent = send(fd, data, size, MSG_NOSIGNAL);
+#else
+            const ssize_t sent = send(fd, data, size, 0);
+#endif
+            if(sent < 0 && errno == EINTR)
+                continue;
+            
+            if(sent <= 0)
+                return false;
+            
+            data += sent;
+            size -= static_cast<std::size_t>(sent);
+        }
+        
+        return true;
+    };
+    
+    return sendAll(header, sizeof(header)) && sendAll(payload.data(), payload.size());
+}
+
+bool ReceiveFrame(const int fd, std::string& out_payload)
+{
+    auto receiveAll = [fd](char* data, std::size_t size)
+    {
+        while(size > 0)
+        {
+            const ssize_t received = recv(fd, data, size, 0);
+            
+            if(received < 0 && errno == EINTR)
+                continue;
+            
+            if(received <= 0)
+                return false;
+            
+            data += received;
+            size -= static_cast<std::size_t>(received);
+        }
+        
+        return true;
+    };
+    
+    uint8_t header[4];
+    if(!receiveAll(reinterpret_cast<char*>(header), sizeof(header)))
+        return false;
+    
+    const uint32_t length = static_cast<uint32_t>(header[0]) | (static_cast<uint32_t>(header[1]) << 8) | (static_cast<uint32_t>(header[2]) << 16) | (static_cast<uint32_t>(header[3]) << 24);
+    if(length > MAX_FRAME_SIZE)
+        return false;
+    
+    out_payload.resize(length);
+    
+    return receiveAll(out_payload.data(), length);
+}
+#else
+bool SendFrame(const int, const std::string&)
+{
+    return false;
+}
+
+bool ReceiveFrame(const int, std::string&)
+{
+    return false;
+}
+#endif
+};
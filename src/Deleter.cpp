@@ -0,0 +1,494 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  Deleter.cpp                                                     */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#include "DirStatsCore.hpp"
+
+Deleter::Deleter(DirectoryTree& tree, const std::size_t threadCount)
+    : m_Tree(tree)
+    , m_Pool(threadCount)
+{
+}
+
+Deleter::~Deleter()
+{
+    m_Stop = true;
+    
+    if(m_ControlThread.joinable())
+        m_ControlThread.join();
+}
+
+bool Deleter::Start(const std::vector<DirectoryTree::NodeIndex>& nodes)
+{
+    if(m_IsRunning)
+        return false;
+    
+    if(m_ControlThread.joinable())
+        m_ControlThread.join();
+    
+    m_Stop = false;
+    m_RemovedEntries = 0;
+    m_RemovedBytes = 0;
+    m_ErrorCount = 0;
+    
+    {
+        std::lock_guard lock(m_ErrorMutex);
+        m_LastErrorMessage = "";
+    }
+    
+    m_IsRunning = true;
+    m_ControlThread = std::thread(&Deleter::ControlTask, this, nodes);
+    
+    return true;
+}
+
+std::string Deleter::GetLastErrorMessage()
+{
+    std::lock_guard lock(m_ErrorMutex);
+    
+    return m_LastErrorMessage;
+}
+
+void Deleter::RecordError(const std::string& name, const std::string& message)
+{
+    m_ErrorCount++;
+    
+    std::lock_guard lock(m_ErrorMutex);
+    m_LastErrorMessage = name + ": " + message;
+}
+
+std::string Deleter::GetSystemErrorMessage()
+{
+    return std::error_code(errno, std::generic_category()).message();
+}
+
+void Deleter::ControlTask(std::vector<DirectoryTree::NodeIndex> nodes)
+{
+    struct Target
+    {
+        DirectoryTree::NodeIndex    node = DirectoryTree::INVALID_NODE;
+        std::filesystem::path       path;
+        bool                        isDirectory = false;
+        uintmax_t                   size = 0;
+    };
+    
+    std::vector<Target> targets;
+    
+    {
+        std::shared_lock lock(m_Tree.GetMutex());
+        
+        // Entries inside of another target go together with it
+        std::sort(nodes.begin(), nodes.end());
+        nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+        
+        for(const DirectoryTree::NodeIndex i : nodes)
+        {
+            const bool isNested = std::any_of(nodes.begin(), nodes.end(), [&](const DirectoryTree::NodeIndex other) { return m_Tree.IsAncestor(other, i); });
+            const DirectoryTree::Node& node = m_Tree.GetNode(i);
+            
+            // Never delete the scanned directory itself
+            if(isNested || node.isRemoved || node.parent == DirectoryTree::INVALID_NODE)
+                continue;
+            
+            targets.push_back({i, m_Tree.GetPath(i), node.type == DirectoryTree::NodeType::DIRECTORY, node.size});
+        }
+    }
+    
+    for(const Target& target : targets)
+    {
+        if(m_Stop)
+            break;
+        
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_APPLE)
+        // Everything below works relative to the directory containing the target
+        std::shared_ptr<DirectoryState> parentState = std::make_shared<DirectoryState>();
+        parentState->isTargetParent = true;
+        parentState->path = target.path.parent_path();
+        
+        const int parentFd = AcquireDescriptor(*parentState);
+        if(parentFd < 0)
+        {
+            RecordError(parentState->path.string(), GetSystemErrorMessage());
+            continue;
+        }
+        
+        const std::string name = target.path.filename().string();
+        
+        if(!target.isDirectory)
+        {
+            if(unlinkat(parentFd, name.c_str(), 0) == 0)
+            {
+                m_RemovedEntries++;
+                m_RemovedBytes += target.size;
+                m_Tree.RemoveNodes({target.node});
+            }
+            else
+            {
+                RecordError(target.path.string(), GetSystemErrorMessage());
+            }
+        }
+        else
+        {
+            std::shared_ptr<DirectoryState> state = std::make_shared<DirectoryState>();
+            state->name = name;
+            state->node = target.node;
+            state->parent = parentState;
+            
+            parentState->pending++;
+            QueueDirectory(state);
+        }
+        
+        // Drop our own reference, the last finished job closes the directory
+        ReleaseDescriptor(*parentState);
+        ReleaseDirectory(parentState);
+#else
+        // No fd relative deletion here, remove the whole subtree at once
+        Error error;
+        const uintmax_t removed = std::filesystem::remove_all(target.path, error);
+        
+        if(error)
+        {
+            RecordError(target.path.string(), error.GetMessage());
+            continue;
+        }
+        
+        m_RemovedEntries += removed;
+        m_RemovedBytes += target.size;
+        m_Tree.RemoveNodes({target.node});
+#endif
+    }
+    
+    m_Pool.WaitIdle();
+    m_IsRunning = false;
+    
+    if(m_OnFinishedFunction)
+        m_OnFinishedFunction();
+}
+
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_APPLE)
+void Deleter::QueueDirectory(std::shared_ptr<DirectoryState> state)
+{
+    {
+        std::lock_guard lock(m_DirectoryMutex);
+        m_PendingDirectories.push_back(std::move(state));
+    }
+    
+    m_Pool.Submit([this] { ProcessNewestDirectory(); });
+}
+
+void Deleter::ProcessNewestDirectory()
+{
+    std::shared_ptr<DirectoryState> state;
+    
+    {
+        std::lock_guard lock(m_DirectoryMutex);
+        
+        // Newest first, so the deletion goes depth first and finished directories close early
+        state = std::move(m_PendingDirectories.back());
+        m_PendingDirectories.pop_back();
+    }
+    
+    ProcessDirectory(state);
+}
+
+void Deleter::ProcessDirectory(const std::shared_ptr<DirectoryState>& state)
+{
+    int fd = -1;
+    
+    if(!m_Stop)
+    {
+        fd = AcquireDescriptor(*state);
+        
+        if(fd < 0)
+            RecordError(state->name, GetSystemErrorMessage());
+        else
+            state->isOpened = true;
+    }
+    
+    // The listing needs its own descriptor, closedir() closes it
+    const int listingFd = (fd >= 0) ? dup(fd) : -1;
+    DIR* const directory = (listingFd >= 0) ? fdopendir(listingFd) : nullptr;
+    
+    if(fd >= 0 && !directory)
+    {
+        RecordError(state->name, GetSystemErrorMessage());
+        
+        if(listingFd >= 0)
+            close(listingFd);
+    }
+    
+    if(directory)
+    {
+        // Names of the known children, to find their nodes in the tree
+        std::unordered_map<std::string_view, DirectoryTree::NodeIndex> knownChildren;
+        std::vector<DirectoryTree::NodeIndex> children;
+        
+        if(state->node != DirectoryTree::INVALID_NODE)
+        {
+            std::shared_lock lock(m_Tree.GetMutex());
+            m_Tree.GetChildren(state->node, children);
+            
+            // Names are interned, the views stay valid while the tree is not cleared
+            for(const DirectoryTree::NodeIndex i : children)
+                knownChildren.emplace(m_Tree.GetName(i), i);
+        }
+        
+        std::vector<std::pair<std::string, DirectoryTree::NodeIndex>> files;
+        std::vector<std::pair<std::string, DirectoryTree::NodeIndex>> subdirectories;
+        
+        auto submitBatch = [&]()
+        {
+            state->pending++;
+            m_Pool.Submit([this, state, batch = std::move(files)]
+            {
+                RemoveBatch(state, batch);
+                ReleaseDirectory(state);
+            });
+            files.clear();
+        };
+        
+        while(!m_Stop)
+        {
+            const dirent* const entry = readdir(directory);
+            if(!entry)
+                break;
+            
+            const std::string name = entry->d_name;
+            if(name == "." || name == "..")
+                continue;
+            
+            bool isDirectory = (entry->d_type == DT_DIR);
+            if(entry->d_type == DT_UNKNOWN)
+            {
+                struct stat info;
+                isDirectory = (fstatat(fd, name.c_str(), &info, AT_SYMLINK_NOFOLLOW) == 0) && S_ISDIR(info.st_mode);
+            }
+            
+            const auto known = knownChildren.find(name);
+            const DirectoryTree::NodeIndex node = (known != knownChildren.end()) ? known->second : DirectoryTree::INVALID_NODE;
+            
+            if(isDirectory)
+                subdirectories.emplace_back(name, node);
+            else
+                files.emplace_back(name, node);
+            
+            // Split huge directories over all workers
+            if(files.size() >= BATCH_SIZE)
+                submitBatch();
+        }
+        
+        closedir(directory);
+        
+        if(!files.empty())
+            RemoveBatch(state, files);
+        
+        // Only queued here, the descriptor of this directory may be closed while they wait
+        for(auto& [name, node] : subdirectories)
+        {
+            std::shared_ptr<DirectoryState> child = std::make_shared<DirectoryState>();
+            child->name = std::move(name);
+            child->node = node;
+            child->parent = state;
+            
+            state->pending++;
+            QueueDirectory(std::move(child));
+        }
+    }
+    
+    if(fd >= 0)
+        ReleaseDescriptor(*state);
+    
+    ReleaseDirectory(state);
+}
+
+void Deleter::RemoveBatch(const std::shared_ptr<DirectoryState>& state, const std::vector<std::pair<std::string, DirectoryTree::NodeIndex>>& files)
+{
+    if(m_Stop)
+        return;
+    
+    const int fd = AcquireDescriptor(*state);
+    if(fd < 0)
+    {
+        RecordError(state->name, GetSystemErrorMessage());
+        return;
+    }
+    
+    std::vector<DirectoryTree::NodeIndex> removedNodes;
+    
+    for(const auto& [name, node] : files)
+    {
+        if(m_Stop)
+            break;
+        
+        if(unlinkat(fd, name.c_str(), 0) != 0)
+        {
+            RecordError(name, GetSystemErrorMessage());
+            continue;
+        }
+        
+        m_RemovedEntries++;
+        
+        if(node != DirectoryTree::INVALID_NODE)
+            removedNodes.push_back(node);
+    }
+    
+    ReleaseDescriptor(*state);
+    
+    if(!removedNodes.empty())
+    {
+        uintmax_t removedBytes = 0;
+        {
+            std::shared_lock lock(m_Tree.GetMutex());
+            
+            for(const DirectoryTree::NodeIndex i : removedNodes)
+                removedBytes += m_Tree.GetNode(i).size;
+        }
+        
+        m_RemovedBytes += removedBytes;
+        m_Tree.RemoveNodes(removedNodes);
+    }
+}
+
+void Deleter::ReleaseDirectory(std::shared_ptr<DirectoryState> state)
+{
+    // Walk up in a loop, deep trees must not grow the stack
+    while(state && --state->pending == 0)
+    {
+        {
+            std::lock_guard lock(m_DirectoryMutex);
+            CloseDescriptor(*state);
+        }
+        
+        // Directory containing a target, nothing more to do
+        if(state->isTargetParent)
+            break;
+        
+        // All children are gone, remove the directory itself
+        if(state->isOpened && !m_Stop)
+        {
+            const int parentFd = AcquireDescriptor(*state->parent);
+            
+            if(parentFd >= 0 && unlinkat(parentFd, state->name.c_str(), AT_REMOVEDIR) == 0)
+            {
+                m_RemovedEntries++;
+                
+                if(state->node != DirectoryTree::INVALID_NODE)
+                    m_Tree.RemoveNodes({state->node});
+            }
+            else
+            {
+                RecordError(state->name, GetSystemErrorMessage());
+            }
+            
+            if(parentFd >= 0)
+                ReleaseDescriptor(*state->parent);
+        }
+        
+        state = state->parent;
+    }
+}
+
+int Deleter::AcquireDescriptor(DirectoryState& state)
+{
+    std::lock_guard lock(m_DirectoryMutex);
+    
+    // Closed directories up to the first open ancestor, reopened top down
+    std::vector<DirectoryState*> closedDirectories;
+    for(DirectoryState* i = &state; i && i->fd < 0; i = i->parent.get())
+        closedDirectories.push_back(i);
+    
+    for(auto it = closedDirectories.rbegin(); it != closedDirectories.rend(); it++)
+    {
+        DirectoryState& directory = **it;
+        
+        // The parent is needed for openat(), keep it open
+        if(directory.parent)
+            directory.parent->users++;
+        
+        // Make room by closing the least recently used directories nobody works in
+        auto position = m_OpenDirectories.end();
+        while(m_OpenDirectories.size() >= MAX_OPEN_DIRECTORIES && position != m_OpenDirectories.begin())
+        {
+            position--;
+            
+            DirectoryState& candidate = **position;
+            if(candidate.users != 0)
+                continue;
+            
+            close(candidate.fd);
+            candidate.fd = -1;
+            position = m_OpenDirectories.erase(position);
+        }
+        
+        if(directory.parent)
+            directory.fd = openat(directory.parent->fd, directory.name.c_str(), O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+        else
+            directory.fd = open(directory.path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        
+        const int error = errno;
+        
+        if(directory.parent)
+            directory.parent->users--;
+        
+        if(directory.fd < 0)
+        {
+            errno = error;
+            return -1;
+        }
+        
+        m_OpenDirectories.push_front(&directory);
+        directory.openPosition = m_OpenDirectories.begin();
+    }
+    
+    // Mark as most recently used
+    m_OpenDirectories.splice(m_OpenDirectories.begin(), m_OpenDirectories, state.openPosition);
+    state.users++;
+    
+    return state.fd;
+}
+
+void Deleter::ReleaseDescriptor(DirectoryState& state)
+{
+    std::lock_guard lock(m_DirectoryMutex);
+    state.users--;
+}
+
+void Deleter::CloseDescriptor(DirectoryState& state)
+{
+    if(state.fd < 0)
+        return;
+    
+    close(state.fd);
+    state.fd = -1;
+    m_OpenDirectories.erase(state.openPosition);
+}
+#endif
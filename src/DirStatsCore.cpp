@@ -0,0 +1,387 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  DirStatsCore.cpp                                                */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#include "DirStatsCore.hpp"
+
+// Handle of the C interface
+struct dirstats_tree
+{
+    DirectoryTree       tree;
+    TreeSnapshot        snapshot;
+    std::atomic<bool>   stop = false;
+    std::string         lastError = "";
+};
+
+namespace
+{
+bool IsValidNode(const dirstats_tree* const handle, const dirstats_node node) noexcept
+{
+    return handle && node < handle->tree.GetNodeCount() && !handle->tree.GetNode(node).isRemoved;
+}
+
+void FillEntry(const DirectoryTree& tree, const DirectoryTree::NodeIndex node, dirstats_entry& out_entry) noexcept
+{
+    const DirectoryTree::Node& current = tree.GetNode(node);
+    const std::string_view name = tree.GetName(node);
+    
+    out_entry.name = name.data();
+    out_entry.name_length = name.size();
+    out_entry.parent = current.parent;
+    out_entry.child_count = current.childCount;
+    out_entry.size = current.size;
+    out_entry.allocated_size = current.allocatedSize;
+    out_entry.count = current.count;
+    out_entry.last_write_time = current.lastWriteTime;
+    out_entry.type = static_cast<uint8_t>(current.type);
+    out_entry.has_error = current.hasError ? 1 : 0;
+}
+}
+
+extern "C"
+{
+
+int dirstats_api_version(void)
+{
+    return DIRSTATS_API_VERSION;
+}
+
+dirstats_tree* dirstats_tree_create(void)
+{
+    return new (std::nothrow) dirstats_tree();
+}
+
+void dirstats_tree_destroy(dirstats_tree* const tree)
+{
+    delete tree;
+}
+
+const char* dirstats_last_error(const dirstats_tree* const tree)
+{
+    return tree ? tree->lastError.c_str() : "No tree";
+}
+
+int dirstats_scan(dirstats_tree* const tree, const char* const path, const uint32_t thread_count, const dirstats_progress_callback progress, void* const user_data)
+{
+    if(!tree || !path)
+        return -1;
+    
+    tree->stop = false;
+    tree->lastError.clear();
+    
+    const std::size_t threadCount = thread_count ? thread_count : std::max(std::thread::hardware_concurrency(), 1u);
+    
+    // Scan in background, progress is reported from the caller's thread
+    FileSystem fileSystem;
+    bool isComplete = false;
+    bool isOutOfMemory = false;
+    bool isDone = false;
+    std::mutex doneMutex;
+    std::condition_variable doneCondition;
+    
+    try {
+        std::thread scanThread([&]
+        {
+            try {
+                isComplete = fileSystem.ScanDirectoryTree(path, tree->tree, tree->stop, threadCount);
+            }
+            catch (const std::bad_alloc&) {
+                isOutOfMemory = true;
+            }
+            
+            std::lock_guard lock(doneMutex);
+            isDone = true;
+            doneCondition.notify_all();
+        });
+        
+        std::unique_lock lock(doneMutex);
+        while(!doneCondition.wait_for(lock, std::chrono::milliseconds(100), [&isDone] { return isDone; }))
+        {
+            if(!progress)
+                continue;
+            
+            uint64_t entryCount = 0;
+            {
+                std::shared_lock treeLock(tree->tree.GetMutex());
+                entryCount = tree->tree.GetNodeCount();
+            }
+            
+            // Not while holding the lock, the callback may take its time
+            lock.unlock();
+            if(progress(entryCount, user_data) != 0)
+                tree->stop = true;
+            lock.lock();
+        }
+        
+        lock.unlock();
+        scanThread.join();
+    }
+    catch (const std::system_error& e) {
+        tree->lastError = e.what();
+        return -1;
+    }
+    
+    if(isOutOfMemory)
+        tree->lastError = "Out of memory";
+    else if(tree->stop)
+        tree->lastError = "Stopped";
+    else if(!isComplete)
+        tree->lastError = fileSystem.GetLastError().GetMessage();
+    
+    return (isComplete && !isOutOfMemory) ? 0 : -1;
+}
+
+void dirstats_request_stop(dirstats_tree* const tree)
+{
+    if(tree)
+        tree->stop = true;
+}
+
+dirstats_node dirstats_root(const dirstats_tree* const tree)
+{
+    return tree ? tree->tree.GetRoot() : DIRSTATS_INVALID_NODE;
+}
+
+int dirstats_get_entry(const dirstats_tree* const tree, const dirstats_node node, dirstats_entry* const out_entry)
+{
+    if(!IsValidNode(tree, node) || !out_entry)
+        return -1;
+    
+    FillEntry(tree->tree, node, *out_entry);
+    return 0;
+}
+
+size_t dirstats_get_children(const dirstats_tree* const tree, const dirstats_node node, dirstats_node* const out_children, const size_t capacity)
+{
+    if(!IsValidNode(tree, node))
+        return 0;
+    
+    // Children are contiguous, removed ones are skipped
+    const DirectoryTree::Node& parent = tree->tree.GetNode(node);
+    std::size_t count = 0;
+    
+    for(uint32_t i = 0; i < parent.childCount; i++)
+    {
+        const dirstats_node child = parent.firstChild + i;
+        if(tree->tree.GetNode(child).isRemoved)
+            continue;
+        
+        if(out_children && count < capacity)
+            out_children[count] = child;
+        
+        count++;
+    }
+    
+    return count;
+}
+
+dirstats_node dirstats_find(const dirstats_tree* const tree, const char* const path)
+{
+    if(!tree || !path || tree->tree.GetRoot() == DirectoryTree::INVALID_NODE)
+        return DIRSTATS_INVALID_NODE;
+    
+    try {
+        const std::string root = tree->tree.GetPath(tree->tree.GetRoot()).lexically_normal().generic_string();
+        std::string relativePath = std::filesystem::path(path).lexically_normal().generic_string();
+        
+        // Absolute paths must be below the root
+        if(relativePath.starts_with('/'))
+        {
+            const std::string prefix = root.ends_with('/') ? root : root + "/";
+            
+            if(relativePath == root || relativePath + "/" == prefix)
+                return tree->tree.GetRoot();
+            
+            if(!relativePath.starts_with(prefix))
+                return DIRSTATS_INVALID_NODE;
+            
+            relativePath.erase(0, prefix.size());
+        }
+        
+        // One name after the other
+        DirectoryTree::NodeIndex node = tree->tree.GetRoot();
+        std::vector<DirectoryTree::NodeIndex> children;
+        std::string_view rest = relativePath;
+        
+        while(!rest.empty() && node != DirectoryTree::INVALID_NODE)
+        {
+            const std::size_t separator = rest.find('/');
+            const std::string_view name = rest.substr(0, separator);
+            rest = (separator == std::string_view::npos) ? std::string_view() : rest.substr(separator + 1);
+            
+            if(name.empty() || name == ".")
+                continue;
+            
+            children.clear();
+            tree->tree.GetChildren(node, children);
+            
+            const auto child = std::find_if(children.begin(), children.end(), [&](const DirectoryTree::NodeIndex i) { return tree->tree.GetName(i) == name; });
+            node = (child != children.end()) ? *child : DirectoryTree::INVALID_NODE;
+        }
+        
+        return node;
+    }
+    catch (const std::exception&) {
+        return DIRSTATS_INVALID_NODE;
+    }
+}
+
+size_t dirstats_get_path(const dirstats_tree* const tree, const dirstats_node node, char* const buffer, const size_t size)
+{
+    if(!IsValidNode(tree, node))
+        return 0;
+    
+    try {
+        const std::string path = tree->tree.GetPath(node).string();
+        
+        if(buffer && size > 0)
+        {
+            const std::size_t length = std::min(path.size(), size - 1);
+            std::memcpy(buffer, path.data(), length);
+            buffer[length] = '\0';
+        }
+        
+        return path.size();
+    }
+    catch (const std::exception&) {
+        return 0;
+    }
+}
+
+int dirstats_walk_directories(const dirstats_tree* const tree, const dirstats_node node, const uint32_t max_depth, const dirstats_directory_callback callback, void* const user_data)
+{
+    if(!IsValidNode(tree, node) || !callback)
+        return -1;
+    
+    const DirectoryTree& directoryTree = tree->tree;
+    
+    // Post-order like BatchExporter: next child to visit of every open directory
+    struct Frame
+    {
+        DirectoryTree::NodeIndex    node = DirectoryTree::INVALID_NODE;
+        uint32_t                    nextChild = 0;
+        std::size_t                 pathLength = 0;
+    };
+    
+    try {
+        std::string path = directoryTree.GetPath(node).string();
+        std::vector<Frame> stack;
+        stack.push_back({node, 0, path.size()});
+        
+        const char separator = static_cast<char>(FileSystem::Path::preferred_separator);
+        dirstats_entry entry;
+        
+        while(!stack.empty())
+        {
+            Frame& frame = stack.back();
+            const DirectoryTree::Node& current = directoryTree.GetNode(frame.node);
+            
+            // Children of directories at the maximum depth are not visited
+            const uint32_t childCount = (stack.size() > max_depth) ? 0 : current.childCount;
+            
+            if(frame.nextChild >= childCount)
+            {
+                FillEntry(directoryTree, frame.node, entry);
+                if(callback(path.c_str(), &entry, user_data) != 0)
+                    return 0;
+                
+                stack.pop_back();
+                
+                if(!stack.empty())
+                    path.resize(stack.back().pathLength);
+                
+                continue;
+            }
+            
+            const DirectoryTree::NodeIndex child = current.firstChild + frame.nextChild++;
+            const DirectoryTree::Node& childNode = directoryTree.GetNode(child);
+            
+            if(childNode.type != DirectoryTree::NodeType::DIRECTORY || childNode.isRemoved)
+                continue;
+            
+            if(path.empty() || path.back() != separator)
+                path += separator;
+            
+            path += directoryTree.GetName(child);
+            
+            // Invalidates frame
+            stack.push_back({child, 0, path.size()});
+        }
+    }
+    catch (const std::bad_alloc&) {
+        return -1;
+    }
+    
+    return 0;
+}
+
+int dirstats_snapshot_publish(dirstats_tree* const tree, const char* const file)
+{
+    if(!tree || !file)
+        return -1;
+    
+    try {
+        if(!tree->snapshot.Publish(tree->tree, file))
+        {
+            tree->lastError = tree->snapshot.GetLastErrorMessage();
+            return -1;
+        }
+    }
+    catch (const std::bad_alloc&) {
+        tree->lastError = "Out of memory";
+        return -1;
+    }
+    
+    return 0;
+}
+
+int dirstats_snapshot_load(dirstats_tree* const tree, const char* const file)
+{
+    if(!tree || !file)
+        return -1;
+    
+    try {
+        if(!tree->snapshot.Load(file, tree->tree))
+        {
+            tree->lastError = tree->snapshot.GetLastErrorMessage();
+            return -1;
+        }
+    }
+    catch (const std::bad_alloc&) {
+        tree->lastError = "Out of memory";
+        return -1;
+    }
+    
+    return 0;
+}
+
+}
@@ -0,0 +1,738 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  DirectoryTree.cpp                                               */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#include "DirStatsCore.hpp"
+
+void DirectoryTree::Clear()
+{
+    std::unique_lock lock(m_Mutex);
+    
+    m_Nodes.clear();
+    m_Names.Clear();
+    m_MappedNodes = {};
+    m_Mapping = nullptr;
+    m_GarbageCount = 0;
+}
+
+DirectoryTree::NodeIndex DirectoryTree::CreateRoot(const std::string& path, const uintmax_t size, const uintmax_t allocatedSize)
+{
+    std::unique_lock lock(m_Mutex);
+    
+    m_Nodes.clear();
+    m_Names.Clear();
+    m_MappedNodes = {};
+    m_Mapping = nullptr;
+    m_GarbageCount = 0;
+    
+    // The root is named after the full path that was scanned
+    Node root;
+    root.name = m_Names.Intern(path);
+    root.type = NodeType::DIRECTORY;
+    root.size = size;
+    root.allocatedSize = allocatedSize;
+    
+    m_Nodes.push_back(root);
+    
+    return 0;
+}
+
+DirectoryTree::NodeIndex DirectoryTree::AddChildren(const NodeIndex parent, const std::vector<Entry>& entries, const FoldedFiles& folded)
+{
+    std::unique_lock lock(m_Mutex);
+    
+    const NodeIndex firstChild = static_cast<NodeIndex>(m_Nodes.size());
+    
+    if(entries.empty())
+    {
+        if(folded.count > 0)
+            PropagateUp(parent, folded.size, folded.allocatedSize, folded.count);
+        
+        return firstChild;
+    }
+    
+    // Node indices are 32 bit
+    if(m_Nodes.size() + entries.size() >= INVALID_NODE)
+        throw std::bad_alloc();
+    
+    uintmax_t totalSize = 0;
+    uintmax_t totalAllocatedSize = 0;
+    
+    for(const Entry& i : entries)
+    {
+        Node node;
+        node.name = m_Names.Intern(i.name);
+        node.parent = parent;
+        node.size = i.size;
+        node.allocatedSize = i.allocatedSize;
+        node.lastWriteTime = i.lastWriteTime;
+        node.type = i.type;
+        node.isHardLink = i.isHardLink;
+        node.hasError = i.hasError;
+        node.changeStamp = i.changeStamp;
+        
+        m_Nodes.push_back(node);
+        
+        totalSize += i.size;
+        totalAllocatedSize += i.allocatedSize;
+    }
+    
+    m_Nodes[parent].firstChild = firstChild;
+    m_Nodes[parent].childCount = static_cast<uint32_t>(entries.size());
+    
+    // Directories of the new block are empty yet, so the heaviest child is the largest entry
+    NodeIndex heaviestChild = firstChild;
+    for(NodeIndex i = firstChild + 1; i < m_Nodes.size(); i++)
+    {
+        if(m_Nodes[i].size > m_Nodes[heaviestChild].size)
+            heaviestChild = i;
+    }
+    
+    m_Nodes[parent].heaviestChild = heaviestChild;
+    
+    // Update totals of all ancestors
+    PropagateUp(parent, totalSize + folded.size, totalAllocatedSize + folded.allocatedSize, entries.size() + folded.count);
+    
+    return firstChild;
+}
+
+void DirectoryTree::PropagateUp(NodeIndex node, const uintmax_t size, const uintmax_t allocatedSize, const uintmax_t count) noexcept
+{
+    NodeIndex grownChild = INVALID_NODE;
+    uint16_t depth = 1;
+    
+    while(node != INVALID_NODE)
+    {
+        Node& current = m_Nodes[node];
+        current.size += size;
+        current.allocatedSize += allocatedSize;
+        current.count += count;
+        current.maxDepth = std::max(current.maxDepth, depth);
+        
+        if(depth < UINT16_MAX)
+            depth++;
+        
+        // Sizes only grow here, so only the child on our path can become the heaviest one
+        if(grownChild != INVALID_NODE)
+            UpdateHeaviestChild(node, grownChild);
+        
+        grownChild = node;
+        node = current.parent;
+    }
+}
+
+void DirectoryTree::UpdateHeaviestChild(const NodeIndex node, const NodeIndex grownChild) noexcept
+{
+    Node& current = m_Nodes[node];
+    
+    if(current.heaviestChild == INVALID_NODE || m_Nodes[grownChild].size > m_Nodes[current.heaviestChild].size)
+        current.heaviestChild = grownChild;
+}
+
+void DirectoryTree::SubtractUp(NodeIndex node, NodeIndex shrunkChild, const uintmax_t size, const uintmax_t allocatedSize, const uintmax_t count) noexcept
+{
+    uint16_t shrunkChildOldDepth = m_Nodes[shrunkChild].maxDepth;
+    
+    while(node != INVALID_NODE)
+    {
+        Node& current = m_Nodes[node];
+        current.size -= std::min(current.size, size);
+        current.allocatedSize -= std::min(current.allocatedSize, allocatedSize);
+        current.count -= std::min(current.count, count);
+        
+        // Only if the shrunk child was the heaviest or the deepest one, another child may take over
+        const Node& child = m_Nodes[shrunkChild];
+        const uint16_t oldDepth = current.maxDepth;
+        const bool childDepthChanged = child.isRemoved || child.maxDepth != shrunkChildOldDepth;
+        
+        if(current.heaviestChild == shrunkChild || child.isRemoved || (childDepthChanged && oldDepth == shrunkChildOldDepth + 1))
+            RecomputeChildAggregates(node);
+        
+        shrunkChildOldDepth = oldDepth;
+        shrunkChild = node;
+        node = current.parent;
+    }
+}
+
+void DirectoryTree::AdjustUp(NodeIndex child, uint16_t childOldDepth, const uintmax_t size, const uintmax_t allocatedSize, const uintmax_t count, const bool isShrunk) noexcept
+{
+    NodeIndex node = m_Nodes[child].parent;
+    
+    while(node != INVALID_NODE)
+    {
+        Node& current = m_Nodes[node];
+        const Node& changed = m_Nodes[child];
+        current.size += size;
+        current.allocatedSize += allocatedSize;
+        current.count += count;
+        
+        // Only if the heaviest child shrank or the deepest one got shallower, another child may take over
+        const uint16_t oldDepth = current.maxDepth;
+        const bool isShallower = changed.maxDepth < childOldDepth && static_cast<uint32_t>(oldDepth) == childOldDepth + 1u;
+        
+        if((isShrunk && current.heaviestChild == child) || isShallower)
+        {
+            RecomputeChildAggregates(node);
+        }
+        else
+        {
+            current.maxDepth = std::max(current.maxDepth, static_cast<uint16_t>(std::min<uint32_t>(changed.maxDepth + 1u, UINT16_MAX)));
+            UpdateHeaviestChild(node, child);
+        }
+        
+        childOldDepth = oldDepth;
+        child = node;
+        node = current.parent;
+    }
+}
+
+void DirectoryTree::RecomputeChildAggregates(const NodeIndex node) noexcept
+{
+    Node& current = m_Nodes[node];
+    current.heaviestChild = INVALID_NODE;
+    current.maxDepth = 0;
+    
+    for(uint32_t i = 0; i < current.childCount; i++)
+    {
+        const NodeIndex childIndex = current.firstChild + i;
+        const Node& child = m_Nodes[childIndex];
+        
+        if(child.isRemoved)
+            continue;
+        
+        if(current.heaviestChild == INVALID_NODE || child.size > m_Nodes[current.heaviestChild].size)
+            current.heaviestChild = childIndex;
+        
+        current.maxDepth = std::max<uint16_t>(current.maxDepth, static_cast<uint16_t>(std::min<uint32_t>(child.maxDepth + 1u, UINT16_MAX)));
+    }
+}
+
+std::size_t DirectoryTree::MarkSubtreeRemoved(const NodeIndex node)
+{
+    std::vector<NodeIndex> pending = {node};
+    std::size_t markedCount = 0;
+    
+    while(!pending.empty())
+    {
+        Node& current = m_Nodes[pending.back()];
+        pending.pop_back();
+        markedCount++;
+        
+        current.size = 0;
+        current.allocatedSize = 0;
+        current.count = 0;
+        current.isRemoved = true;
+        
+        for(uint32_t i = 0; i < current.childCount; i++)
+        {
+            if(!m_Nodes[current.firstChild + i].isRemoved)
+                pending.push_back(current.firstChild + i);
+        }
+    }
+    
+    return markedCount;
+}
+
+void DirectoryTree::RemoveNodes(const std::vector<NodeIndex>& siblings)
+{
+    if(siblings.empty())
+        return;
+    
+    std::unique_lock lock(m_Mutex);
+    
+    uintmax_t totalSize = 0;
+    uintmax_t totalAllocatedSize = 0;
+    uintmax_t totalCount = 0;
+    
+    for(const NodeIndex i : siblings)
+    {
+        Node& node = m_Nodes[i];
+        if(node.isRemoved)
+            continue;
+        
+        totalSize += node.size;
+        totalAllocatedSize += node.allocatedSize;
+        totalCount += node.count + 1;
+        
+        m_GarbageCount += MarkSubtreeRemoved(i);
+    }
+    
+    const NodeIndex parent = m_Nodes[siblings.front()].parent;
+    if(parent == INVALID_NODE)
+        return;
+    
+    // Removed nodes are skipped, so the heaviest child is recomputed at the parent in any case
+    SubtractUp(parent, siblings.front(), totalSize, totalAllocatedSize, totalCount);
+}
+
+std::size_t DirectoryTree::DropFileNodes()
+{
+    std::unique_lock lock(m_Mutex);
+    
+    return CopyReachable(false);
+}
+
+std::size_t DirectoryTree::Compact()
+{
+    std::unique_lock lock(m_Mutex);
+    
+    return CopyReachable(true);
+}
+
+std::size_t DirectoryTree::CopyReachable(const bool keepFiles)
+{
+    if(m_Mapping || m_Nodes.empty())
+        return 0;
+    
+    // Unreachable nodes are at most counted, never kept
+    const std::size_t keptCount = static_cast<std::size_t>(std::count_if(m_Nodes.begin(), m_Nodes.end(), [keepFiles](const Node& node) { return (keepFiles || node.type == NodeType::DIRECTORY) && !node.isRemoved; }));
+    
+    std::vector<Node> nodes;
+    std::vector<NodeIndex> oldNodes; // Index in m_Nodes of every kept node
+    NamePool names;
+    
+    nodes.reserve(keptCount);
+    oldNodes.reserve(keptCount);
+    
+    nodes.push_back(m_Nodes.front());
+    nodes.front().name = names.Intern(m_Names.Get(m_Nodes.front().name));
+    oldNodes.push_back(0);
+    
+    // Breadth first, so the kept children of every directory stay contiguous
+    for(std::size_t i = 0; i < nodes.size(); i++)
+    {
+        const Node& oldNode = m_Nodes[oldNodes[i]];
+        const NodeIndex firstChild = static_cast<NodeIndex>(nodes.size());
+        NodeIndex heaviestChild = INVALID_NODE;
+        
+        for(uint32_t j = 0; j < oldNode.childCount; j++)
+        {
+            const Node& oldChild = m_Nodes[oldNode.firstChild + j];
+            if((!keepFiles && oldChild.type != NodeType::DIRECTORY) || oldChild.isRemoved)
+                continue;
+            
+            Node child = oldChild;
+            child.name = names.Intern(m_Names.Get(oldChild.name));
+            child.parent = static_cast<NodeIndex>(i);
+            
+            if(heaviestChild == INVALID_NODE || child.size > nodes[heaviestChild].size)
+                heaviestChild = static_cast<NodeIndex>(nodes.size());
+            
+            nodes.push_back(child);
+            oldNodes.push_back(oldNode.firstChild + j);
+        }
+        
+        Node& node = nodes[i];
+        node.childCount = static_cast<uint32_t>(nodes.size() - firstChild);
+        node.firstChild = node.childCount ? firstChild : INVALID_NODE;
+        node.heaviestChild = heaviestChild;
+    }
+    
+    const std::size_t droppedCount = m_Nodes.size() - nodes.size();
+    
+    m_Nodes.swap(nodes);
+    m_Names = std::move(names);
+    m_GarbageCount = 0;
+    
+    return droppedCount;
+}
+
+DirectoryTree::NodeIndex DirectoryTree::ReplaceChildren(const NodeIndex node, const Entry& self, const std::vector<Entry>& entries, const FoldedFiles& folded, std::vector<bool>& out_isKept)
+{
+    std::unique_lock lock(m_Mutex);
+    
+    out_isKept.assign(entries.size(), false);
+    
+    // Node indices are 32 bit
+    if(m_Nodes.size() + entries.size() >= INVALID_NODE)
+        throw std::bad_alloc();
+    
+    // Subdirectories still there keep their subtree
+    const NodeIndex oldFirstChild = m_Nodes[node].firstChild;
+    const uint32_t oldChildCount = m_Nodes[node].childCount;
+    
+    std::unordered_map<std::string_view, NodeIndex> oldDirectories;
+    for(uint32_t i = 0; i < oldChildCount; i++)
+    {
+        const Node& child = m_Nodes[oldFirstChild + i];
+        if(child.type == NodeType::DIRECTORY && !child.isRemoved && !child.isHardLink)
+            oldDirectories.emplace(m_Names.Get(child.name), oldFirstChild + i);
+    }
+    
+    std::vector<NodeIndex> oldNodes(entries.size(), INVALID_NODE);
+    for(std::size_t i = 0; i < entries.size(); i++)
+    {
+        if(entries[i].type != NodeType::DIRECTORY || entries[i].isHardLink)
+            continue;
+        
+        const auto it = oldDirectories.find(entries[i].name);
+        if(it != oldDirectories.end())
+        {
+            oldNodes[i] = it->second;
+            out_isKept[i] = true;
+        }
+    }
+    
+    const NodeIndex firstChild = static_cast<NodeIndex>(m_Nodes.size());
+    
+    Node totals;
+    totals.size = self.size + folded.size;
+    totals.allocatedSize = self.allocatedSize + folded.allocatedSize;
+    totals.count = folded.count;
+    
+    for(std::size_t i = 0; i < entries.size(); i++)
+    {
+        const Entry& entry = entries[i];
+        Node child;
+        
+        if(oldNodes[i] != INVALID_NODE)
+        {
+            // Its own refresh follows, until then it keeps its change stamp
+            child = m_Nodes[oldNodes[i]];
+            child.lastWriteTime = entry.lastWriteTime;
+        }
+        else
+        {
+            child.name = m_Names.Intern(entry.name);
+            child.size = entry.size;
+            child.allocatedSize = entry.allocatedSize;
+            child.lastWriteTime = entry.lastWriteTime;
+            child.type = entry.type;
+            child.isHardLink = entry.isHardLink;
+            child.hasError = entry.hasError;
+            child.changeStamp = entry.changeStamp;
+        }
+        
+        child.parent = node;
+        m_Nodes.push_back(child);
+        
+        totals.size += child.size;
+        totals.allocatedSize += child.allocatedSize;
+        totals.count += child.count + 1;
+    }
+    
+    // The kept subtrees hang below the copies now
+    for(std::size_t i = 0; i < entries.size(); i++)
+    {
+        if(oldNodes[i] == INVALID_NODE)
+            continue;
+        
+        const Node& child = m_Nodes[firstChild + i];
+        for(uint32_t j = 0; j < child.childCount; j++)
+            m_Nodes[child.firstChild + j].parent = firstChild + static_cast<NodeIndex>(i);
+        
+        m_Nodes[oldNodes[i]].isRemoved = true;
+        m_GarbageCount++;
+    }
+    
+    for(uint32_t i = 0; i < oldChildCount; i++)
+    {
+        const NodeIndex child = oldFirstChild + i;
+        if(!m_Nodes[child].isRemoved)
+            m_GarbageCount += MarkSubtreeRemoved(child);
+    }
+    
+    Node& current = m_Nodes[node];
+    const Node old = current;
+    
+    current.firstChild = entries.empty() ? INVALID_NODE : firstChild;
+    current.childCount = static_cast<uint32_t>(entries.size());
+    current.size = totals.size;
+    current.allocatedSize = totals.allocatedSize;
+    current.count = totals.count;
+    current.lastWriteTime = self.lastWriteTime;
+    current.changeStamp = self.changeStamp;
+    current.hasError = self.hasError;
+    
+    RecomputeChildAggregates(node);
+    AdjustUp(node, old.maxDepth, totals.size - old.size, totals.allocatedSize - old.allocatedSize, totals.count - old.count, totals.size < old.size);
+    
+    return firstChild;
+}
+
+void DirectoryTree::UpdateEntries(const std::vector<std::pair<NodeIndex, Entry>>& updates) noexcept
+{
+    std::unique_lock lock(m_Mutex);
+    
+    for(const auto& [index, entry] : updates)
+    {
+        Node& node = m_Nodes[index];
+        const Node old = node;
+        
+        node.size = entry.size;
+        node.allocatedSize = entry.allocatedSize;
+        node.lastWriteTime = entry.lastWriteTime;
+        
+        AdjustUp(index, old.maxDepth, node.size - old.size, node.allocatedSize - old.allocatedSize, 0, node.size < old.size);
+    }
+}
+
+void DirectoryTree::SetError(const NodeIndex node) noexcept
+{
+    std::unique_lock lock(m_Mutex);
+    
+    m_Nodes[node].hasError = true;
+}
+
+DirectoryTree::NodeIndex DirectoryTree::AddDetachedChildren(const std::vector<Entry>& entries, const std::vector<ChildBlock>& childBlocks)
+{
+    std::unique_lock lock(m_Mutex);
+    
+    const NodeIndex firstChild = static_cast<NodeIndex>(m_Nodes.size());
+    
+    // Node indices are 32 bit
+    if(m_Nodes.size() + entries.size() >= INVALID_NODE)
+        throw std::bad_alloc();
+    
+    for(const Entry& i : entries)
+    {
+        Node node;
+        node.name = m_Names.Intern(i.name);
+        node.size = i.size;
+        node.allocatedSize = i.allocatedSize;
+        node.lastWriteTime = i.lastWriteTime;
+        node.type = i.type;
+        node.isHardLink = i.isHardLink;
+        node.hasError = i.hasError;
+        
+        m_Nodes.push_back(node);
+    }
+    
+    for(std::size_t i = 0; i < entries.size(); i++)
+    {
+        if(childBlocks[i].childCount > 0)
+            LinkChildren(firstChild + static_cast<NodeIndex>(i), childBlocks[i]);
+    }
+    
+    return firstChild;
+}
+
+void DirectoryTree::AttachChildren(const NodeIndex node, const ChildBlock& block) noexcept
+{
+    std::unique_lock lock(m_Mutex);
+    
+    LinkChildren(node, block);
+}
+
+void DirectoryTree::LinkChildren(const NodeIndex node, const ChildBlock& block) noexcept
+{
+    Node& parent = m_Nodes[node];
+    parent.firstChild = block.firstChild;
+    parent.childCount = block.childCount;
+    
+    // The children are complete, so are their totals
+    for(uint32_t i = 0; i < block.childCount; i++)
+    {
+        const NodeIndex childIndex = block.firstChild + i;
+        Node& child = m_Nodes[childIndex];
+        child.parent = node;
+        
+        parent.size += child.size;
+        parent.allocatedSize += child.allocatedSize;
+        parent.count += child.count + 1;
+        parent.maxDepth = std::max<uint16_t>(parent.maxDepth, static_cast<uint16_t>(std::min<uint32_t>(child.maxDepth + 1u, UINT16_MAX)));
+        
+        if(parent.heaviestChild == INVALID_NODE || child.size > m_Nodes[parent.heaviestChild].size)
+            parent.heaviestChild = childIndex;
+    }
+}
+
+DirectoryTree::NodeIndex DirectoryTree::AddMirroredChildren(const NodeIndex parent, const std::vector<Entry>& entries, std::size_t childCount)
+{
+    std::unique_lock lock(m_Mutex);
+    
+    const NodeIndex firstChild = static_cast<NodeIndex>(m_Nodes.size());
+    childCount = std::max(childCount, entries.size());
+    
+    if(childCount == 0)
+        return firstChild;
+    
+    // Node indices are 32 bit
+    if(m_Nodes.size() + childCount >= INVALID_NODE)
+        throw std::bad_alloc();
+    
+    Node placeholder;
+    placeholder.name = m_Names.Intern("");
+    placeholder.parent = parent;
+    placeholder.isRemoved = true;
+    
+    m_Nodes.resize(m_Nodes.size() + childCount, placeholder);
+    
+    Node& parentNode = m_Nodes[parent];
+    parentNode.firstChild = firstChild;
+    parentNode.childCount = static_cast<uint32_t>(childCount);
+    
+    lock.unlock();
+    FillMirroredChildren(parent, 0, entries);
+    
+    return firstChild;
+}
+
+void DirectoryTree::FillMirroredChildren(const NodeIndex parent, const std::size_t offset, const std::vector<Entry>& entries)
+{
+    std::unique_lock lock(m_Mutex);
+    
+    Node& parentNode = m_Nodes[parent];
+    const NodeIndex first = parentNode.firstChild + static_cast<NodeIndex>(offset);
+    
+    for(std::size_t i = 0; i < entries.size() && offset + i < parentNode.childCount; i++)
+    {
+        const Entry& entry = entries[i];
+        Node& node = m_Nodes[first + i];
+        
+        node.name = m_Names.Intern(entry.name);
+        node.size = entry.size;
+        node.allocatedSize = entry.allocatedSize;
+        node.count = entry.count;
+        node.maxDepth = entry.maxDepth;
+        node.lastWriteTime = entry.lastWriteTime;
+        node.type = entry.type;
+        node.isHardLink = entry.isHardLink;
+        node.hasError = entry.hasError;
+        node.isRemoved = false;
+        
+        if(parentNode.heaviestChild == INVALID_NODE || node.size > m_Nodes[parentNode.heaviestChild].size)
+            parentNode.heaviestChild = first + static_cast<NodeIndex>(i);
+    }
+}
+
+void DirectoryTree::SetMirroredTotals(const NodeIndex node, const Entry& totals) noexcept
+{
+    std::unique_lock lock(m_Mutex);
+    
+    Node& current = m_Nodes[node];
+    current.size = totals.size;
+    current.allocatedSize = totals.allocatedSize;
+    current.count = totals.count;
+    current.maxDepth = totals.maxDepth;
+    current.lastWriteTime = totals.lastWriteTime;
+    current.hasError = totals.hasError;
+}
+
+void DirectoryTree::AttachMapped(const std::span<const Node> nodes, const char* const names, const uint64_t* const nameOffsets, const std::size_t nameCount, std::shared_ptr<const void> mapping)
+{
+    std::unique_lock lock(m_Mutex);
+    
+    // Release our own nodes, they are not used anymore
+    std::vector<Node>().swap(m_Nodes);
+    m_Names.Map(names, nameOffsets, nameCount);
+    
+    m_MappedNodes = nodes;
+    m_Mapping = std::move(mapping);
+}
+
+std::filesystem::path DirectoryTree::GetPath(NodeIndex node) const
+{
+    // Collect names from node up to the root
+    std::vector<std::string_view> names;
+    while(node != INVALID_NODE)
+    {
+        names.push_back(GetName(node));
+        node = GetNode(node).parent;
+    }
+    
+    std::filesystem::path path;
+    for(auto i = names.rbegin(); i != names.rend(); i++)
+        path /= *i;
+    
+    return path;
+}
+
+bool DirectoryTree::IsAncestor(const NodeIndex ancestor, NodeIndex node) const noexcept
+{
+    node = GetNode(node).parent;
+    
+    while(node != INVALID_NODE)
+    {
+        if(node == ancestor)
+            return true;
+        
+        node = GetNode(node).parent;
+    }
+    
+    return false;
+}
+
+void DirectoryTree::GetChildren(const NodeIndex node, std::vector<NodeIndex>& out_children) const
+{
+    const Node& parent = GetNode(node);
+    
+    for(uint32_t i = 0; i < parent.childCount; i++)
+    {
+        if(!GetNode(parent.firstChild + i).isRemoved)
+            out_children.push_back(parent.firstChild + i);
+    }
+}
+
+uintmax_t DirectoryTree::GetFoldedCount(const NodeIndex node) const noexcept
+{
+    const Node& parent = GetNode(node);
+    uintmax_t childrenCount = 0;
+    
+    for(uint32_t i = 0; i < parent.childCount; i++)
+    {
+        const Node& child = GetNode(parent.firstChild + i);
+        if(!child.isRemoved)
+            childrenCount += child.count + 1;
+    }
+    
+    return parent.count - std::min(parent.count, childrenCount);
+}
+
+void DirectoryTree::GetHeaviestPath(NodeIndex node, const double minShare, std::vector<NodeIndex>& out_path) const
+{
+    while(node != INVALID_NODE)
+    {
+        const Node& current = GetNode(node);
+        const NodeIndex heaviest = current.heaviestChild;
+        
+        if(heaviest == INVALID_NODE || current.size == 0)
+            break;
+        
+        const double share = static_cast<double>(GetNode(heaviest).size) / static_cast<double>(current.size);
+        if(share < minShare)
+            break;
+        
+        out_path.push_back(heaviest);
+        node = heaviest;
+    }
+}
+
+void DirectoryTree::AccountMemory(MemoryAccounting& accounting) const
+{
+    if(m_Mapping)
+        accounting.Add("Tree nodes", m_MappedNodes.size_bytes(), m_MappedNodes.size(), true);
+    else
+        accounting.Add("Tree nodes", MemoryAccounting::GetVectorBytes(m_Nodes), m_Nodes.size());
+    
+    m_Names.AccountMemory(accounting);
+}
@@ -0,0 +1,252 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  DiskUsage.cpp                                                   */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#include "DirStatsCore.hpp"
+
+DiskUsage::DiskUsage(const Options& options)
+    : m_Options(options)
+{
+    if(m_Options.unit == Unit::BYTES)
+        m_BlockSize = 1;
+    else if(m_Options.unit == Unit::MEGABYTES)
+        m_BlockSize = 1024 * 1024;
+    
+    if(m_Options.summarize)
+        m_Options.maxDepth = 0;
+}
+
+int DiskUsage::Run(const std::vector<std::string>& paths)
+{
+    const std::atomic<bool> stop = false;
+    
+    FileSystem fileSystem;
+    DirectoryTree tree;
+    
+    bool hasError = false;
+    uintmax_t total = 0;
+    
+    for(const std::string& path : paths)
+    {
+        // A file is printed on its own, regardless of -a
+        std::error_code error;
+        const std::filesystem::file_status status = std::filesystem::symlink_status(path, error);
+        
+        if(error)
+        {
+            std::cerr << "du: cannot access '" << path << "': " << error.message() << std::endl;
+            hasError = true;
+            continue;
+        }
+        
+        // Like du -P (the default), a symbolic link given as path is not followed, only "link/" is
+        if(status.type() != std::filesystem::file_type::directory)
+        {
+            uintmax_t size = 0;
+            
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_APPLE)
+            struct stat info;
+            if(lstat(path.c_str(), &info) == 0)
+            {
+                // Counted before, as another path or a link to it
+                if(paths.size() > 1 && !m_SeenInodes.emplace(static_cast<uint64_t>(info.st_dev), static_cast<uint64_t>(info.st_ino)).second)
+                    continue;
+                
+                size = m_Options.apparentSize ? static_cast<uintmax_t>(info.st_size) : static_cast<uintmax_t>(info.st_blocks) * 512;
+            }
+#else
+            size = std::filesystem::is_regular_file(status) ? std::filesystem::file_size(path, error) : 0;
+#endif
+            
+            PrintLine(size, path);
+            total += size;
+            continue;
+        }
+        
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_APPLE)
+        // Like du, skip a directory that was already counted as part of a previous path
+        struct stat info;
+        if(paths.size() > 1 && stat(path.c_str(), &info) == 0 && !m_SeenInodes.emplace(static_cast<uint64_t>(info.st_dev), static_cast<uint64_t>(info.st_ino)).second)
+            continue;
+#endif
+        
+        if(!fileSystem.ScanDirectoryTree(path, tree, stop, m_Options.threadCount, (paths.size() > 1) ? &m_SeenInodes : nullptr))
+        {
+            std::cerr << "du: cannot read directory '" << path << "': " << fileSystem.GetLastError().GetMessage() << std::endl;
+            hasError = true;
+            continue;
+        }
+        
+        PrintTree(tree, path, hasError);
+        
+        const DirectoryTree::Node& root = tree.GetNode(tree.GetRoot());
+        total += m_Options.apparentSize ? root.size : root.allocatedSize;
+    }
+    
+    if(m_Options.total)
+        PrintLine(total, "total");
+    
+    Flush();
+    
+    return (hasError || m_HasWriteError) ? 1 : 0;
+}
+
+void DiskUsage::PrintTree(const DirectoryTree& tree, const std::string& rootPath, bool& out_hasError)
+{
+    const char separator = static_cast<char>(FileSystem::Path::preferred_separator);
+    
+    struct Frame
+    {
+        DirectoryTree::NodeIndex    node = DirectoryTree::INVALID_NODE;
+        uint32_t                    nextChild = 0;
+        std::size_t                 pathLength = 0;
+    };
+    
+    std::string path = rootPath;
+    std::vector<Frame> stack = {{tree.GetRoot(), 0, path.size()}};
+    
+    // Depth first, a directory is printed after its contents like du does
+    while(!stack.empty())
+    {
+        Frame& frame = stack.back();
+        const DirectoryTree::Node& node = tree.GetNode(frame.node);
+        const int32_t depth = static_cast<int32_t>(stack.size()) - 1;
+        
+        path.resize(frame.pathLength);
+        
+        if(frame.nextChild < node.childCount)
+        {
+            const DirectoryTree::NodeIndex childIndex = node.firstChild + frame.nextChild++;
+            const DirectoryTree::Node& child = tree.GetNode(childIndex);
+            
+            // Further hard links are not listed
+            if(child.isRemoved || child.isHardLink)
+                continue;
+            
+            if(!path.empty() && path.back() != separator)
+                path += separator;
+            
+            path += tree.GetName(childIndex);
+            
+            if(child.type == DirectoryTree::NodeType::DIRECTORY)
+                stack.push_back({childIndex, 0, path.size()});
+            else if(m_Options.all && (m_Options.maxDepth < 0 || depth + 1 <= m_Options.maxDepth))
+                PrintLine(m_Options.apparentSize ? child.size : child.allocatedSize, path);
+            
+            continue;
+        }
+        
+        if(node.hasError)
+        {
+            std::cerr << "du: cannot read directory '" << path << "'" << std::endl;
+            out_hasError = true;
+        }
+        
+        if(m_Options.maxDepth < 0 || depth <= m_Options.maxDepth)
+            PrintLine(m_Options.apparentSize ? node.size : node.allocatedSize, path);
+        
+        stack.pop_back();
+    }
+}
+
+void DiskUsage::PrintLine(const uintmax_t size, const std::string& path)
+{
+    m_Buffer += FormatSize(size);
+    m_Buffer += '\t';
+    m_Buffer += path;
+    m_Buffer += m_Options.nullTerminated ? '\0' : '\n';
+    
+    if(m_Buffer.size() >= CHUNK_SIZE)
+        Flush();
+}
+
+std::string DiskUsage::FormatSize(const uintmax_t size) const
+{
+    if(m_Options.unit != Unit::HUMAN_READABLE && m_Options.unit != Unit::SI)
+        return std::to_string(size / m_BlockSize + ((size % m_BlockSize) ? 1 : 0));
+    
+    // Like du: Rounded up, one decimal below 10, no unit below one kilo
+    const bool isSi = (m_Options.unit == Unit::SI);
+    const long double base = isSi ? 1000.0L : 1024.0L;
+    const char* const units = isSi ? "kMGTPEZY" : "KMGTPEZY";
+    
+    long double value = static_cast<long double>(size);
+    int32_t exponent = -1;
+    
+    while(value >= base && exponent < 7)
+    {
+        value /= base;
+        exponent++;
+    }
+    
+    if(exponent < 0)
+        return std::to_string(size);
+    
+    char buffer[32];
+    
+    if(value < 10.0L)
+    {
+        const long double tenths = std::ceil(value * 10.0L);
+        
+        if(tenths < 100.0L)
+        {
+            std::snprintf(buffer, sizeof(buffer), "%.1Lf%c", tenths / 10.0L, units[exponent]);
+            return buffer;
+        }
+    }
+    
+    long double rounded = std::ceil(value);
+    
+    // Rounding up may reach the next unit
+    if(rounded >= base && exponent < 7)
+    {
+        std::snprintf(buffer, sizeof(buffer), "1.0%c", units[exponent + 1]);
+        return buffer;
+    }
+    
+    std::snprintf(buffer, sizeof(buffer), "%.0Lf%c", rounded, units[exponent]);
+    return buffer;
+}
+
+void DiskUsage::Flush()
+{
+    const bool isWriteOk = (std::fwrite(m_Buffer.data(), 1, m_Buffer.size(), stdout) == m_Buffer.size()) && (std::fflush(stdout) == 0);
+    
+    // Reported once, like du does when the output is closed or the disk is full
+    if(!isWriteOk && !m_HasWriteError)
+    {
+        std::cerr << "du: write error: " << std::error_code(errno, std::generic_category()).message() << std::endl;
+        m_HasWriteError = true;
+    }
+    
+    m_Buffer.clear();
+}
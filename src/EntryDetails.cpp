@@ -0,0 +1,407 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  EntryDetails.cpp                                                */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#include "DirStatsCore.hpp"
+
+namespace
+{
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_APPLE)
+std::string PermissionsFromMode(const mode_t mode)
+{
+    std::string result = "----------";
+    
+    if(S_ISDIR(mode))       result[0] = 'd';
+    else if(S_ISLNK(mode))  result[0] = 'l';
+    else if(S_ISCHR(mode))  result[0] = 'c';
+    else if(S_ISBLK(mode))  result[0] = 'b';
+    else if(S_ISFIFO(mode)) result[0] = 'p';
+    else if(S_ISSOCK(mode)) result[0] = 's';
+    
+    const char letters[] = "rwxrwxrwx";
+    for(std::size_t i = 0; i < 9; i++)
+    {
+        if(mode & (1u << (8 - i)))
+            result[i + 1] = letters[i];
+    }
+    
+    if(mode & S_ISUID) result[3] = (mode & S_IXUSR) ? 's' : 'S';
+    if(mode & S_ISGID) result[6] = (mode & S_IXGRP) ? 's' : 'S';
+    if(mode & S_ISVTX) result[9] = (mode & S_IXOTH) ? 't' : 'T';
+    
+    return result;
+}
+#endif
+}
+
+EntryDetails::EntryDetails(const std::size_t threadCount)
+    : m_Pool(threadCount)
+{
+}
+
+bool EntryDetails::Get(const DirectoryTree::NodeIndex node, Details& out_details)
+{
+    std::lock_guard lock(m_Mutex);
+    
+    const auto keyIt = m_NodeKeys.find(node);
+    if(keyIt == m_NodeKeys.end())
+    {
+        const auto failureIt = m_Failures.find(node);
+        if(failureIt == m_Failures.end())
+            return false;
+        
+        // Retry failed lookups, the entry may be readable by now
+        if(std::chrono::steady_clock::now() - failureIt->second.time >= FAILURE_RETRY_INTERVAL)
+        {
+            m_Failures.erase(failureIt);
+            return false;
+        }
+        
+        out_details = failureIt->second.details;
+        return true;
+    }
+    
+    const auto it = m_LRUIndex.find(keyIt->second);
+    if(it == m_LRUIndex.end())
+        return false;
+    
+    // Mark as most recently used
+    m_LRU.splice(m_LRU.begin(), m_LRU, it->second);
+    out_details = it->second->second;
+    
+    return true;
+}
+
+void EntryDetails::Request(const DirectoryTree::NodeIndex node, const std::filesystem::path& path)
+{
+    {
+        std::lock_guard lock(m_Mutex);
+        
+        if(m_Queued.contains(node))
+            return;
+        
+        // Only the latest requests matter when scrolling fast, drop the oldest
+        if(m_Pending.size() >= MAX_PENDING)
+        {
+            m_Queued.erase(m_Pending.front().node);
+            m_Pending.pop_front();
+        }
+        
+        m_Pending.push_back({node, path, m_Generation});
+        m_Queued.insert(node);
+    }
+    
+    m_Pool.Submit([this] { ProcessNewestRequest(); });
+}
+
+void EntryDetails::Clear()
+{
+    std::lock_guard lock(m_Mutex);
+    
+    m_LRU.clear();
+    m_LRUIndex.clear();
+    m_NodeKeys.clear();
+    m_Failures.clear();
+    m_Pending.clear();
+    m_Queued.clear();
+    
+    // Lookups still running belong to the old tree
+    m_Generation++;
+}
+
+void EntryDetails::AccountMemory(MemoryAccounting& accounting)
+{
+    uint64_t cacheBytes = 0;
+    uint64_t cacheCount = 0;
+    
+    {
+        std::lock_guard lock(m_Mutex);
+        
+        cacheBytes = MemoryAccounting::GetListBytes(m_LRU) + MemoryAccounting::GetHashTableBytes(m_LRUIndex)
+                    + MemoryAccounting::GetHashTableBytes(m_NodeKeys) + MemoryAccounting::GetHashTableBytes(m_Failures)
+                    + MemoryAccounting::GetHashTableBytes(m_Queued);
+        cacheCount = m_LRU.size() + m_Failures.size();
+        
+        for(const auto& [key, details] : m_LRU)
+        {
+            cacheBytes += MemoryAccounting::GetStringBytes(details.errorMessage) + MemoryAccounting::GetStringBytes(details.owner)
+                        + MemoryAccounting::GetStringBytes(details.group) + MemoryAccounting::GetStringBytes(details.permissions);
+        }
+        
+        for(const auto& [node, failure] : m_Failures)
+            cacheBytes += MemoryAccounting::GetStringBytes(failure.details.errorMessage);
+    }
+    
+    uint64_t nameBytes = 0;
+    uint64_t nameCount = 0;
+    
+    {
+        std::lock_guard lock(m_NameMutex);
+        
+        nameBytes = MemoryAccounting::GetHashTableBytes(m_UserNames) + MemoryAccounting::GetHashTableBytes(m_GroupNames);
+        nameCount = m_UserNames.size() + m_GroupNames.size();
+        
+        for(const auto& [id, name] : m_UserNames)
+            nameBytes += MemoryAccounting::GetStringBytes(name);
+        
+        for(const auto& [id, name] : m_GroupNames)
+            nameBytes += MemoryAccounting::GetStringBytes(name);
+    }
+    
+    accounting.Add("Details cache", cacheBytes, cacheCount);
+    accounting.Add("Owner names", nameBytes, nameCount);
+}
+
+void EntryDetails::ProcessNewestRequest()
+{
+    PendingRequest request;
+    
+    {
+        std::lock_guard lock(m_Mutex);
+        
+        // Request may have been dropped already
+        if(m_Pending.empty())
+            return;
+        
+        request = std::move(m_Pending.back());
+        m_Pending.pop_back();
+    }
+    
+    Details details;
+    Key key;
+    LoadDetails(request.path, details, key);
+    
+    {
+        std::lock_guard lock(m_Mutex);
+        
+        // Tree was replaced meanwhile, the node index may refer to another entry now
+        if(request.generation != m_Generation)
+            return;
+        
+        m_Queued.erase(request.node);
+        
+        // Failed lookups have no inode, they are only kept until retried
+        if(!details.isValid)
+        {
+            if(m_Failures.size() >= CACHE_CAPACITY)
+                m_Failures.clear();
+            
+            m_Failures[request.node] = {std::move(details), std::chrono::steady_clock::now()};
+        }
+        else
+        {
+            m_Failures.erase(request.node);
+            
+            // Simple bound, the cached details stay and are found again after one stat
+            if(m_NodeKeys.size() >= CACHE_CAPACITY * 4)
+                m_NodeKeys.clear();
+            
+            m_NodeKeys[request.node] = key;
+            
+            const auto it = m_LRUIndex.find(key);
+            if(it != m_LRUIndex.end())
+            {
+                it->second->second = details;
+                m_LRU.splice(m_LRU.begin(), m_LRU, it->second);
+            }
+            else
+            {
+                m_LRU.emplace_front(key, details);
+                m_LRUIndex[key] = m_LRU.begin();
+                
+                if(m_LRU.size() > CACHE_CAPACITY)
+                {
+                    m_LRUIndex.erase(m_LRU.back().first);
+                    m_LRU.pop_back();
+                }
+            }
+        }
+    }
+    
+    if(m_OnReadyFunction)
+        m_OnReadyFunction();
+}
+
+void EntryDetails::LoadDetails(const std::filesystem::path& path, Details& out_details, Key& out_key)
+{
+#if defined(PLATFORM_LINUX)
+    struct statx info;
+    if(statx(AT_FDCWD, path.c_str(), AT_SYMLINK_NOFOLLOW, STATX_BASIC_STATS | STATX_BTIME, &info) != 0)
+    {
+        out_details.errorMessage = std::strerror(errno);
+        return;
+    }
+    
+    out_details.userID = info.stx_uid;
+    out_details.groupID = info.stx_gid;
+    out_details.permissions = PermissionsFromMode(info.stx_mode);
+    out_details.accessTime = info.stx_atime.tv_sec;
+    out_details.modificationTime = info.stx_mtime.tv_sec;
+    out_details.changeTime = info.stx_ctime.tv_sec;
+    out_details.birthTime = ((info.stx_mask & STATX_BTIME) && info.stx_btime.tv_sec > 0) ? info.stx_btime.tv_sec : -1;
+    out_details.device = (static_cast<uint64_t>(info.stx_dev_major) << 32) | info.stx_dev_minor;
+    out_details.inode = info.stx_ino;
+    out_details.linkCount = info.stx_nlink;
+    out_details.apparentSize = info.stx_size;
+    out_details.allocatedSize = info.stx_blocks * 512;
+    
+    const ssize_t xattrListSize = llistxattr(path.c_str(), nullptr, 0);
+#elif defined(PLATFORM_APPLE)
+    struct stat info;
+    if(lstat(path.c_str(), &info) != 0)
+    {
+        out_details.errorMessage = std::strerror(errno);
+        return;
+    }
+    
+    out_details.userID = info.st_uid;
+    out_details.groupID = info.st_gid;
+    out_details.permissions = PermissionsFromMode(info.st_mode);
+    out_details.accessTime = info.st_atimespec.tv_sec;
+    out_details.modificationTime = info.st_mtimespec.tv_sec;
+    out_details.changeTime = info.st_ctimespec.tv_sec;
+    out_details.birthTime = info.st_birthtimespec.tv_sec;
+    out_details.device = static_cast<uint64_t>(info.st_dev);
+    out_details.inode = info.st_ino;
+    out_details.linkCount = info.st_nlink;
+    out_details.apparentSize = static_cast<uintmax_t>(info.st_size);
+    out_details.allocatedSize = static_cast<uintmax_t>(info.st_blocks) * 512;
+    
+    const ssize_t xattrListSize = listxattr(path.c_str(), nullptr, 0, XATTR_NOFOLLOW);
+#endif
+    
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_APPLE)
+    // Count attribute names in the zero separated list
+    if(xattrListSize > 0)
+    {
+        std::vector<char> names(static_cast<std::size_t>(xattrListSize));
+#if defined(PLATFORM_LINUX)
+        const ssize_t length = llistxattr(path.c_str(), names.data(), names.size());
+#else
+        const ssize_t length = listxattr(path.c_str(), names.data(), names.size(), XATTR_NOFOLLOW);
+#endif
+        for(ssize_t i = 0; i < length; i++)
+        {
+            if(names[static_cast<std::size_t>(i)] == '\0')
+                out_details.xattrCount++;
+        }
+    }
+    
+    // Name service lookups, these may be slow (LDAP, NIS)
+    out_details.owner = GetUserName(out_details.userID);
+    out_details.group = GetGroupName(out_details.groupID);
+    out_details.isValid = true;
+    
+    out_key.device = out_details.device;
+    out_key.inode = out_details.inode;
+#else
+    // No inodes and owners here, use what std::filesystem provides
+    Error error;
+    const std::filesystem::file_status status = std::filesystem::symlink_status(path, error);
+    if(error)
+    {
+        out_details.errorMessage = error.GetMessage();
+        return;
+    }
+    
+    const std::filesystem::perms perms = status.permissions();
+    const char letters[] = "rwxrwxrwx";
+    out_details.permissions = std::filesystem::is_directory(status) ? "d" : "-";
+    for(std::size_t i = 0; i < 9; i++)
+        out_details.permissions += ((static_cast<uint32_t>(perms) & (1u << (8 - i))) ? letters[i] : '-');
+    
+    if(std::filesystem::is_regular_file(status))
+        out_details.apparentSize = out_details.allocatedSize = std::filesystem::file_size(path, error);
+    
+    out_details.linkCount = std::filesystem::hard_link_count(path, error);
+    out_details.isValid = true;
+    
+    // Without inodes, key by a hash of the path
+    out_key.inode = std::hash<std::wstring>()(path.wstring());
+#endif
+}
+
+std::string EntryDetails::GetUserName(const uint32_t userID)
+{
+    {
+        std::lock_guard lock(m_NameMutex);
+        
+        const auto it = m_UserNames.find(userID);
+        if(it != m_UserNames.end())
+            return it->second;
+    }
+    
+    std::string name = std::to_string(userID);
+    
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_APPLE)
+    // Lookup without holding the lock
+    struct passwd entry;
+    struct passwd* result = nullptr;
+    std::vector<char> buffer(16384);
+    
+    if(getpwuid_r(static_cast<uid_t>(userID), &entry, buffer.data(), buffer.size(), &result) == 0 && result)
+        name = result->pw_name;
+#endif
+    
+    std::lock_guard lock(m_NameMutex);
+    m_UserNames[userID] = name;
+    
+    return name;
+}
+
+std::string EntryDetails::GetGroupName(const uint32_t groupID)
+{
+    {
+        std::lock_guard lock(m_NameMutex);
+        
+        const auto it = m_GroupNames.find(groupID);
+        if(it != m_GroupNames.end())
+            return it->second;
+    }
+    
+    std::string name = std::to_string(groupID);
+    
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_APPLE)
+    // Lookup without holding the lock
+    struct group entry;
+    struct group* result = nullptr;
+    std::vector<char> buffer(16384);
+    
+    if(getgrgid_r(static_cast<gid_t>(groupID), &entry, buffer.data(), buffer.size(), &result) == 0 && result)
+        name = result->gr_name;
+#endif
+    
+    std::lock_guard lock(m_NameMutex);
+    m_GroupNames[groupID] = name;
+    
+    return name;
+}
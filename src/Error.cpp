@@ -31,7 +31,7 @@ the following restrictions:
 /*  Created: 30.07.2024                                             */
 /*------------------------------------------------------------------*/
 
-#include "Main.hpp"
+#include "DirStatsCore.hpp"
 
 void Error::PrintErrorInformation() const
 {
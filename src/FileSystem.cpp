@@ -31,7 +31,7 @@ the following restrictions:
 /*  Created: 30.07.2024                                             */
 /*------------------------------------------------------------------*/
 
-#include "Main.hpp"
+#include "DirStatsCore.hpp"
 
 bool FileSystem::GetSpaceInfo(const Path& path, uintmax_t& out_capacity, uintmax_t& out_free, uintmax_t& out_available) noexcept
 {
@@ -50,6 +50,8 @@ bool FileSystem::GetSpaceInfo(const Path& path, uintmax_t& out_capacity, uintmax
 template<typename IteratorType>
 bool FileSystem::IterateDirectoryT(const Path& path, std::vector<DirectoryEntry>& out_iteratedDirectoryInfo)
 {
+    const AllocationCounter::ScopedPhase allocationPhase(AllocationCounter::Phase::SCAN_READ);
+    
     const std::filesystem::directory_options directoryOptions = std::filesystem::directory_options::skip_permission_denied;
     Path currentIteratedPath = "";
     
@@ -140,6 +142,7 @@ bool FileSystem::GetSizesOfDirectoryRecursively(const Path& path, std::unordered
     
     uintmax_t totalSubDirSize = 0;
     std::vector<DirectoryEntry> subDirElements;
+    std::vector<const DirectoryEntry*> files;
     
     // Iterate all elements of the requested path
     for(DirectoryEntry& i : currentPathElements)
@@ -177,6 +180,7 @@ bool FileSystem::GetSizesOfDirectoryRecursively(const Path& path, std::unordered
             stats.size = i.fileSize;
             stats.count = 1;
             out_directorySizes[i.path] = stats;
+            files.push_back(&i);
             
             out_totalSize += i.fileSize;
         }
@@ -185,9 +189,589 @@ bool FileSystem::GetSizesOfDirectoryRecursively(const Path& path, std::unordered
         std::cout << i.path << ": " << out_directorySizes[i.path].size << "B (count: " << out_directorySizes[i.path].count << ")" << std::endl;
     }
     
+    // Rollup like the scan: the smaller files only count into the total
+    if(files.size() > m_FileNodeLimit)
+    {
+        std::nth_element(files.begin(), files.begin() + static_cast<std::ptrdiff_t>(m_FileNodeLimit), files.end(), [](const DirectoryEntry* a, const DirectoryEntry* b) { return a->fileSize > b->fileSize; });
+        
+        for(auto it = files.begin() + static_cast<std::ptrdiff_t>(m_FileNodeLimit); it != files.end(); ++it)
+            out_directorySizes.erase((*it)->path);
+    }
+    
+    return true;
+}
+
+int64_t FileSystem::ToUnixTime(const std::filesystem::file_time_type& time) noexcept
+{
+    // file_clock has no portable epoch, convert via the current time of both clocks
+    const auto systemTime = std::chrono::time_point_cast<std::chrono::system_clock::duration>(time - std::filesystem::file_time_type::clock::now() + std::chrono::system_clock::now());
+    
+    return std::chrono::duration_cast<std::chrono::seconds>(systemTime.time_since_epoch()).count();
+}
+
+struct FileSystem::ScanContext
+{
+    DirectoryTree&              tree;
+    DirectoryTree::NodeIndex    root = DirectoryTree::INVALID_NODE; // Known before the workers start, the tree isn't read for it
+    VirtualFileSystem&          fileSystem;
+    const std::atomic<bool>&    stop;
+    std::atomic<bool>           isOutOfMemory = false;
+    ScanStatistics*             statistics;
+    ScanProgress*               progress;
+    
+    // Files beyond the limit are folded into their directories, all of them once the memory limit is reached
+    const uint32_t              fileNodeLimit;
+    const uint64_t              memoryLimit;
+    std::atomic<uint64_t>       memoryCheckCount = 0;
+    std::atomic<bool>           isMemoryLimitReached = false;
+    
+    // Files with more than one link, only the first one found is counted.
+    // Includes all directories if the set is shared over several scans.
+    std::mutex                  inodeMutex;
+    InodeSet                    ownInodes;
+    InodeSet&                   inodes;
+    const bool                  isCountingDirectories;
+    
+    // Directories and files changed by a refresh
+    std::atomic<std::size_t>    changeCount = 0;
+    
+    // Destroyed first, so no worker outlives the members above
+    ThreadPool                  pool;
+    
+    ScanContext(DirectoryTree& scanTree, VirtualFileSystem& scanFileSystem, const std::atomic<bool>& scanStop, ScanStatistics* scanStatistics, ScanProgress* scanProgress, const uint32_t scanFileNodeLimit, const uint64_t scanMemoryLimit, const std::size_t threadCount, InodeSet* sharedInodes, const bool countDirectories)
+        : tree(scanTree)
+        , fileSystem(scanFileSystem)
+        , stop(scanStop)
+        , statistics(scanStatistics)
+        , progress(scanProgress)
+        , fileNodeLimit(scanFileNodeLimit)
+        , memoryLimit(scanMemoryLimit)
+        , inodes(sharedInodes ? *sharedInodes : ownInodes)
+        , isCountingDirectories(countDirectories)
+        , pool(threadCount)
+    {
+    }
+};
+
+bool FileSystem::ReadDirectory(ScanContext& context, const std::string& path, const bool isRoot, std::vector<std::string>& out_names, std::vector<DirectoryTree::Entry>& out_entries, std::vector<VirtualFileSystem::FileId>& out_ids)
+{
+    bool isComplete = false;
+    {
+        const AllocationCounter::ScopedPhase allocationPhase(AllocationCounter::Phase::SCAN_READ);
+        isComplete = context.fileSystem.ReadDirectory(path, isRoot, out_names, out_entries, out_ids);
+    }
+    
+    const int error = errno;
+    const AllocationCounter::ScopedPhase allocationPhase(AllocationCounter::Phase::SCAN_LINKS);
+    const ScanStatistics::PhaseTimer linksTimer(ScanStatistics::Phase::LINKS);
+    const Tracer::ScopedSpan linksSpan(Tracer::Category::SCAN, "hard links");
+    
+    for(std::size_t i = 0; i < out_entries.size(); i++)
+    {
+        DirectoryTree::Entry& entry = out_entries[i];
+        
+        // Names are complete now, they don't move anymore
+        entry.name = out_names[i];
+        
+        if((entry.type == DirectoryTree::NodeType::DIRECTORY) ? context.isCountingDirectories : out_ids[i].linkCount > 1)
+        {
+            std::lock_guard lock(context.inodeMutex);
+            
+            if(!context.inodes.emplace(out_ids[i].device, out_ids[i].inode).second)
+            {
+                entry.isHardLink = true;
+                entry.size = 0;
+                entry.allocatedSize = 0;
+            }
+        }
+    }
+    
+    errno = error;
+    return isComplete;
+}
+
+bool FileSystem::IsOverMemoryLimit(ScanContext& context) noexcept
+{
+    if(context.memoryLimit == 0)
+        return false;
+    
+    if(context.isMemoryLimitReached.load(std::memory_order_relaxed))
+        return true;
+    
+    if(context.memoryCheckCount.fetch_add(1, std::memory_order_relaxed) % MEMORY_CHECK_INTERVAL != 0)
+        return false;
+    
+    if(ProcessStats::GetResidentBytes() < context.memoryLimit)
+        return false;
+    
+    context.isMemoryLimitReached = true;
     return true;
 }
 
+void FileSystem::FoldFiles(std::vector<DirectoryTree::Entry>& entries, std::vector<VirtualFileSystem::FileId>& ids, const uint32_t keepCount, DirectoryTree::FoldedFiles& out_folded)
+{
+    const auto isFile = [](const DirectoryTree::Entry& entry) { return entry.type != DirectoryTree::NodeType::DIRECTORY; };
+    
+    const std::size_t fileCount = static_cast<std::size_t>(std::count_if(entries.begin(), entries.end(), isFile));
+    if(fileCount <= keepCount)
+        return;
+    
+    // Files larger than the smallest one kept are kept, of those as large as it only as many as fit
+    uintmax_t minKeptSize = UINTMAX_MAX;
+    std::size_t keptAtMinCount = 0;
+    
+    if(keepCount > 0)
+    {
+        std::vector<uintmax_t> fileSizes;
+        fileSizes.reserve(fileCount);
+        
+        for(const DirectoryTree::Entry& i : entries)
+        {
+            if(isFile(i))
+                fileSizes.push_back(i.size);
+        }
+        
+        const auto minKept = fileSizes.begin() + static_cast<std::ptrdiff_t>(keepCount - 1);
+        std::nth_element(fileSizes.begin(), minKept, fileSizes.end(), std::greater<uintmax_t>());
+        
+        minKeptSize = *minKept;
+        keptAtMinCount = keepCount - static_cast<std::size_t>(std::count_if(fileSizes.begin(), minKept, [minKeptSize](const uintmax_t size) { return size > minKeptSize; }));
+    }
+    
+    // Kept entries keep their order, names are left alone as the entries still refer to them
+    std::size_t keptCount = 0;
+    
+    for(std::size_t i = 0; i < entries.size(); i++)
+    {
+        const DirectoryTree::Entry& entry = entries[i];
+        bool isKept = !isFile(entry) || (entry.size > minKeptSize);
+        
+        if(!isKept && entry.size == minKeptSize && keptAtMinCount > 0)
+        {
+            isKept = true;
+            keptAtMinCount--;
+        }
+        
+        if(!isKept)
+        {
+            out_folded.size += entry.size;
+            out_folded.allocatedSize += entry.allocatedSize;
+            out_folded.count++;
+            continue;
+        }
+        
+        if(keptCount != i)
+        {
+            entries[keptCount] = entry;
+            ids[keptCount] = ids[i];
+        }
+        
+        keptCount++;
+    }
+    
+    entries.erase(entries.begin() + static_cast<std::ptrdiff_t>(keptCount), entries.end());
+    ids.erase(ids.begin() + static_cast<std::ptrdiff_t>(keptCount), ids.end());
+}
+
+bool FileSystem::ScanDirectoryJob(ScanContext& context, const DirectoryTree::NodeIndex node, const std::string& path, uint64_t device, const bool isMountRoot)
+{
+    if(context.progress)
+        context.progress->OnDirectoryStarted();
+    
+    if(context.stop || context.isOutOfMemory)
+        return false;
+    
+    const char separator = static_cast<char>(Path::preferred_separator);
+    const bool isRoot = (node == context.root);
+    
+    try {
+        Tracer::ScopedSpan directorySpan(Tracer::Category::SCAN, "directory");
+        const ScanStatistics::ThreadScope statisticsScope(context.statistics);
+        ScanStatistics::Counters* const statistics = ScanStatistics::GetCurrentCounters();
+        const std::chrono::steady_clock::time_point readStart = statistics ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+        
+        std::vector<std::string> names;
+        std::vector<DirectoryTree::Entry> entries;
+        std::vector<VirtualFileSystem::FileId> ids;
+        
+        const bool isComplete = ReadDirectory(context, path, isRoot, names, entries, ids);
+        const int error = errno;
+        directorySpan.SetArgument("entries", entries.size());
+        
+        if(context.progress)
+            context.progress->OnDirectoryRead(entries.size());
+        
+        if(statistics)
+        {
+            // Files are on the device of their directory, only subdirectories can be mount points
+            if(isRoot)
+            {
+                const auto fileIt = std::find_if(entries.begin(), entries.end(), [](const DirectoryTree::Entry& entry) { return entry.type != DirectoryTree::NodeType::DIRECTORY; });
+                device = (fileIt != entries.end()) ? ids[static_cast<std::size_t>(fileIt - entries.begin())].device : (ids.empty() ? 0 : ids.front().device);
+            }
+            
+            const uint64_t readNanoseconds = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - readStart).count());
+            
+            statistics->entriesRead += entries.size();
+            statistics->AddDirectory(path, device, isMountRoot, readNanoseconds, entries.size());
+            
+            if(!isComplete)
+                statistics->errors[error]++;
+        }
+        
+        if(!isComplete)
+        {
+            DST_PROBE2(scan_error, path.c_str(), error);
+            
+            // The starting path must be readable
+            if(isRoot && entries.empty())
+            {
+                errno = error;
+                return false;
+            }
+            
+            // Keep what could be read
+            context.tree.SetError(node);
+        }
+        
+        // Files beyond the limit only count into the totals of their directory, all of them over the memory limit
+        DirectoryTree::FoldedFiles folded;
+        const uint32_t fileNodeLimit = IsOverMemoryLimit(context) ? 0 : context.fileNodeLimit;
+        
+        if(fileNodeLimit != ALL_FILES)
+            FoldFiles(entries, ids, fileNodeLimit, folded);
+        
+        DirectoryTree::NodeIndex firstChild = DirectoryTree::INVALID_NODE;
+        {
+            const AllocationCounter::ScopedPhase allocationPhase(AllocationCounter::Phase::SCAN_TREE);
+            const ScanStatistics::PhaseTimer treeTimer(ScanStatistics::Phase::TREE);
+            const Tracer::ScopedSpan treeSpan(Tracer::Category::SCAN, "aggregate");
+            firstChild = context.tree.AddChildren(node, entries, folded);
+        }
+        
+        const AllocationCounter::ScopedPhase allocationPhase(AllocationCounter::Phase::SCAN_QUEUE);
+        const std::string prefix = (!path.empty() && path.back() == separator) ? path : path + separator;
+        
+        // Subdirectories are scanned by all workers in parallel
+        std::size_t queuedCount = 0;
+        for(std::size_t i = 0; i < entries.size(); i++)
+        {
+            // Directories seen before in another scan are not entered again
+            if(entries[i].type != DirectoryTree::NodeType::DIRECTORY || entries[i].isHardLink)
+                continue;
+            
+            const DirectoryTree::NodeIndex child = firstChild + static_cast<DirectoryTree::NodeIndex>(i);
+            const uint64_t childDevice = ids[i].device;
+            if(context.progress)
+                context.progress->OnDirectoryQueued();
+            
+            context.pool.Submit([&context, child, childPath = std::string(prefix).append(entries[i].name), childDevice, isChildMountRoot = (childDevice != device)] { ScanDirectoryJob(context, child, childPath, childDevice, isChildMountRoot); });
+            queuedCount++;
+        }
+        
+        DST_PROBE3(entry_batch, path.c_str(), entries.size(), queuedCount);
+    }
+    catch (const std::bad_alloc&) {
+        context.isOutOfMemory = true;
+        return false;
+    }
+    
+    return true;
+}
+
+bool FileSystem::ScanDirectoryTree(const Path& path, DirectoryTree& out_tree, const std::atomic<bool>& stop, const std::size_t threadCount, InodeSet* const seenInodes)
+{
+    // Own size of the starting directory
+    uintmax_t size = 0;
+    uintmax_t allocatedSize = 0;
+    m_VirtualFileSystem->GetDirectorySize(path.string(), size, allocatedSize);
+    
+    const DirectoryTree::NodeIndex root = out_tree.CreateRoot(path.string(), size, allocatedSize);
+    
+    const Tracer::ScopedSpan scanSpan(Tracer::Category::SCAN, "scan");
+    DST_PROBE2(scan_phase, "scan", path.c_str());
+    
+    if(m_ScanStatistics)
+        m_ScanStatistics->StartScan(threadCount);
+    
+    ScanContext context(out_tree, *m_VirtualFileSystem, stop, m_ScanStatistics, m_ScanProgress, m_FileNodeLimit, m_MemoryLimit, threadCount, seenInodes ? seenInodes : m_LinkedInodes, seenInodes != nullptr);
+    context.root = root;
+    
+    if(m_ScanProgress)
+    {
+        m_ScanProgress->StartScan(context.pool.GetThreadCount());
+        m_ScanProgress->OnDirectoryQueued();
+    }
+    
+    // The device of the starting directory is known after reading it
+    const bool isRootReadable = ScanDirectoryJob(context, root, path.string(), 0, true);
+    const int rootError = errno;
+    context.pool.WaitIdle();
+    
+    if(m_ScanStatistics)
+        m_ScanStatistics->StopScan();
+    
+    if(m_ScanProgress)
+        m_ScanProgress->StopScan();
+    
+    m_HasReachedMemoryLimit = context.isMemoryLimitReached;
+    if(m_HasReachedMemoryLimit)
+        DST_PROBE2(scan_phase, "memory limit", path.c_str());
+    
+    DST_PROBE2(scan_phase, stop ? "stopped" : "done", path.c_str());
+    
+    if(context.isOutOfMemory)
+        throw std::bad_alloc();
+    
+    if(!isRootReadable)
+    {
+        static_cast<std::error_code&>(m_LastError).assign(rootError ? rootError : EACCES, std::generic_category());
+        return false;
+    }
+    
+    return !stop;
+}
+
+bool FileSystem::RefreshDirectoryJob(ScanContext& context, const DirectoryTree::NodeIndex node, const std::string& path)
+{
+    if(context.stop || context.isOutOfMemory)
+        return false;
+    
+    const char separator = static_cast<char>(Path::preferred_separator);
+    const bool isRoot = (node == context.root);
+    
+    struct OldChild
+    {
+        DirectoryTree::NodeIndex    index = DirectoryTree::INVALID_NODE;
+        std::string                 name = "";
+        DirectoryTree::Node         node;
+    };
+    
+    try {
+        const Tracer::ScopedSpan directorySpan(Tracer::Category::SCAN, "refresh directory");
+        
+        DirectoryTree::Entry self;
+        const bool hasChangeStamp = context.fileSystem.StatDirectory(path, self);
+        
+        if(!hasChangeStamp)
+        {
+            if(errno == ENOENT || errno == ENOTDIR)
+            {
+                if(isRoot)
+                    return false;
+                
+                context.tree.RemoveNodes({node});
+                context.changeCount++;
+                return true;
+            }
+            
+            self = DirectoryTree::Entry();
+            context.fileSystem.GetDirectorySize(path, self.size, self.allocatedSize);
+        }
+        
+        self.type = DirectoryTree::NodeType::DIRECTORY;
+        
+        // Folded files and errors have no nodes to examine, these directories are read again
+        std::vector<OldChild> oldChildren;
+        bool isListingChanged = !hasChangeStamp;
+        {
+            std::shared_lock lock(context.tree.GetMutex());
+            const DirectoryTree::Node& current = context.tree.GetNode(node);
+            
+            isListingChanged = isListingChanged || current.changeStamp != self.changeStamp || current.hasError || context.tree.GetFoldedCount(node) > 0;
+            self.lastWriteTime = hasChangeStamp ? self.lastWriteTime : current.lastWriteTime;
+            
+            oldChildren.reserve(current.childCount);
+            for(uint32_t i = 0; i < current.childCount; i++)
+            {
+                const DirectoryTree::NodeIndex child = current.firstChild + i;
+                if(!context.tree.GetNode(child).isRemoved)
+                    oldChildren.push_back({child, std::string(context.tree.GetName(child)), context.tree.GetNode(child)});
+            }
+        }
+        
+        const std::string prefix = (!path.empty() && path.back() == separator) ? path : path + separator;
+        
+        if(!isListingChanged)
+        {
+            // Same entries, only sizes and times of files may differ
+            std::vector<std::string> names;
+            std::vector<DirectoryTree::NodeIndex> files;
+            
+            for(const OldChild& i : oldChildren)
+            {
+                if(i.node.type != DirectoryTree::NodeType::DIRECTORY && !i.node.isHardLink)
+                {
+                    names.push_back(i.name);
+                    files.push_back(i.index);
+                }
+            }
+            
+            std::vector<DirectoryTree::Entry> stats;
+            if(context.fileSystem.StatEntries(path, names, stats))
+            {
+                std::vector<std::pair<DirectoryTree::NodeIndex, DirectoryTree::Entry>> updates;
+                for(std::size_t i = 0, j = 0; i < oldChildren.size(); i++)
+                {
+                    const DirectoryTree::Node& old = oldChildren[i].node;
+                    if(j == files.size() || files[j] != oldChildren[i].index)
+                        continue;
+                    
+                    const DirectoryTree::Entry& stat = stats[j++];
+                    if(stat.size != old.size || stat.allocatedSize != old.allocatedSize || stat.lastWriteTime != old.lastWriteTime)
+                        updates.emplace_back(oldChildren[i].index, stat);
+                }
+                
+                if(!updates.empty())
+                {
+                    context.tree.UpdateEntries(updates);
+                    context.changeCount += updates.size();
+                }
+                
+                for(const OldChild& i : oldChildren)
+                {
+                    if(i.node.type == DirectoryTree::NodeType::DIRECTORY && !i.node.isHardLink)
+                        context.pool.Submit([&context, child = i.index, childPath = std::string(prefix).append(i.name)] { RefreshDirectoryJob(context, child, childPath); });
+                }
+                
+                return true;
+            }
+            
+            // An entry is gone meanwhile, read it again
+        }
+        
+        std::vector<std::string> names;
+        std::vector<DirectoryTree::Entry> entries;
+        std::vector<VirtualFileSystem::FileId> ids;
+        
+        const bool isComplete = context.fileSystem.ReadDirectory(path, isRoot, names, entries, ids);
+        const int error = errno;
+        
+        if(!isComplete && entries.empty())
+        {
+            if(!isRoot && (error == ENOENT || error == ENOTDIR))
+            {
+                context.tree.RemoveNodes({node});
+                context.changeCount++;
+                return true;
+            }
+            
+            // Keep what was read before
+            context.tree.SetError(node);
+            errno = error;
+            return !isRoot;
+        }
+        
+        // Files seen before keep their role for hard links, only new ones are looked up
+        std::unordered_map<std::string_view, const DirectoryTree::Node*> oldFiles;
+        for(const OldChild& i : oldChildren)
+        {
+            if(i.node.type != DirectoryTree::NodeType::DIRECTORY)
+                oldFiles.emplace(i.name, &i.node);
+        }
+        
+        for(std::size_t i = 0; i < entries.size(); i++)
+        {
+            DirectoryTree::Entry& entry = entries[i];
+            entry.name = names[i];
+            
+            if(entry.type == DirectoryTree::NodeType::DIRECTORY || ids[i].linkCount <= 1)
+                continue;
+            
+            const auto it = oldFiles.find(entry.name);
+            const bool isKnown = (it != oldFiles.end() && it->second->type == entry.type);
+            
+            std::lock_guard lock(context.inodeMutex);
+            const bool isNew = context.inodes.emplace(ids[i].device, ids[i].inode).second;
+            
+            if(isKnown ? it->second->isHardLink : !isNew)
+            {
+                entry.isHardLink = true;
+                entry.size = 0;
+                entry.allocatedSize = 0;
+            }
+        }
+        
+        DirectoryTree::FoldedFiles folded;
+        const uint32_t fileNodeLimit = IsOverMemoryLimit(context) ? 0 : context.fileNodeLimit;
+        
+        if(fileNodeLimit != ALL_FILES)
+            FoldFiles(entries, ids, fileNodeLimit, folded);
+        
+        self.hasError = !isComplete;
+        
+        std::vector<bool> isKept;
+        const DirectoryTree::NodeIndex firstChild = context.tree.ReplaceChildren(node, self, entries, folded, isKept);
+        context.changeCount++;
+        
+        // Subdirectories seen before are refreshed, new ones scanned
+        for(std::size_t i = 0; i < entries.size(); i++)
+        {
+            if(entries[i].type != DirectoryTree::NodeType::DIRECTORY || entries[i].isHardLink)
+                continue;
+            
+            const DirectoryTree::NodeIndex child = firstChild + static_cast<DirectoryTree::NodeIndex>(i);
+            std::string childPath = std::string(prefix).append(entries[i].name);
+            
+            if(isKept[i])
+                context.pool.Submit([&context, child, childPath = std::move(childPath)] { RefreshDirectoryJob(context, child, childPath); });
+            else
+                context.pool.Submit([&context, child, childPath = std::move(childPath), childDevice = ids[i].device] { ScanDirectoryJob(context, child, childPath, childDevice, false); });
+        }
+    }
+    catch (const std::bad_alloc&) {
+        context.isOutOfMemory = true;
+        return false;
+    }
+    
+    return true;
+}
+
+bool FileSystem::RefreshDirectoryTree(DirectoryTree& tree, const std::atomic<bool>& stop, std::size_t& out_changeCount, const std::size_t threadCount)
+{
+    out_changeCount = 0;
+    
+    const DirectoryTree::NodeIndex root = tree.GetRoot();
+    if(root == DirectoryTree::INVALID_NODE || tree.IsMapped())
+    {
+        static_cast<std::error_code&>(m_LastError).assign(EINVAL, std::generic_category());
+        return false;
+    }
+    
+    // The root is named after the full path that was scanned
+    std::string path = "";
+    {
+        std::shared_lock lock(tree.GetMutex());
+        path = tree.GetName(root);
+    }
+    
+    const Tracer::ScopedSpan refreshSpan(Tracer::Category::SCAN, "refresh");
+    DST_PROBE2(scan_phase, "refresh", path.c_str());
+    
+    ScanContext context(tree, *m_VirtualFileSystem, stop, nullptr, nullptr, m_FileNodeLimit, m_MemoryLimit, threadCount, m_LinkedInodes, false);
+    context.root = root;
+    
+    const bool isRootReadable = RefreshDirectoryJob(context, root, path);
+    const int rootError = errno;
+    context.pool.WaitIdle();
+    
+    m_HasReachedMemoryLimit = context.isMemoryLimitReached;
+    out_changeCount = context.changeCount;
+    
+    DST_PROBE2(scan_phase, stop ? "stopped" : "done", path.c_str());
+    
+    if(context.isOutOfMemory)
+        throw std::bad_alloc();
+    
+    if(!isRootReadable)
+    {
+        static_cast<std::error_code&>(m_LastError).assign(rootError ? rootError : EACCES, std::generic_category());
+        return false;
+    }
+    
+    return !stop;
+}
+
 #ifndef NDEBUG
 void FileSystem::DebugPrintDirectoryEntry(const DirectoryEntry& entry)
 {
@@ -0,0 +1,246 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  Format.cpp                                                      */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#include "DirStatsCore.hpp"
+
+namespace Format
+{
+std::size_t GetUtf8SequenceLength(const std::string_view text, const std::size_t position) noexcept
+{
+    const uint8_t first = static_cast<uint8_t>(text[position]);
+    
+    if(first < 0x80)
+        return 1;
+    
+    std::size_t length = 0;
+    uint8_t minSecond = 0x80;
+    uint8_t maxSecond = 0xBF;
+    
+    if(first >= 0xC2 && first <= 0xDF)
+        length = 2;
+    else if(first >= 0xE0 && first <= 0xEF)
+    {
+        length = 3;
+        minSecond = (first == 0xE0) ? 0xA0 : 0x80;
+        maxSecond = (first == 0xED) ? 0x9F : 0xBF;
+    }
+    else if(first >= 0xF0 && first <= 0xF4)
+    {
+        length = 4;
+        minSecond = (first == 0xF0) ? 0x90 : 0x80;
+        maxSecond = (first == 0xF4) ? 0x8F : 0xBF;
+    }
+    else
+        return 0;
+    
+    if(text.size() - position < length)
+        return 0;
+    
+    const uint8_t second = static_cast<uint8_t>(text[position + 1]);
+    if(second < minSecond || second > maxSecond)
+        return 0;
+    
+    for(std::size_t i = 2; i < length; i++)
+    {
+        if((static_cast<uint8_t>(text[position + i]) & 0xC0) != 0x80)
+            return 0;
+    }
+    
+    return length;
+}
+
+std::string HumanReadableSize(const uintmax_t bytes, const bool si)
+{
+    const double unit = si ? 1000.0 : 1024.0;
+    const char* const siUnits[] = {"B", "kB", "MB", "GB", "TB", "PB", "EB"};
+    const char* const binaryUnits[] = {"B", "KiB", "MiB", "GiB", "TiB", "PiB", "EiB"};
+    
+    if(static_cast<double>(bytes) < unit)
+        return std::to_string(bytes) + " B";
+    
+    double value = static_cast<double>(bytes);
+    std::size_t exponent = 0;
+    
+    while(value >= unit && exponent < 6)
+    {
+        value /= unit;
+        exponent++;
+    }
+    
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.1f %s", value, si ? siUnits[exponent] : binaryUnits[exponent]);
+    
+    return buffer;
+}
+
+std::string HumanReadableDelta(const int64_t bytes, const bool si)
+{
+    if(bytes == 0)
+        return "0 B";
+    
+    // Magnitude without overflow for INT64_MIN
+    const uintmax_t magnitude = (bytes < 0) ? (0 - static_cast<uintmax_t>(bytes)) : static_cast<uintmax_t>(bytes);
+    
+    std::string delta = (bytes < 0) ? "-" : "+";
+    delta += HumanReadableSize(magnitude, si);
+    
+    return delta;
+}
+
+std::string PadLeft(const std::string& text, const std::size_t width)
+{
+    if(text.size() >= width)
+        return text;
+    
+    return std::string(width - text.size(), ' ') + text;
+}
+
+std::string DateTime(const int64_t secondsSinceEpoch)
+{
+    if(secondsSinceEpoch < 0)
+        return "-";
+    
+    const std::time_t time = static_cast<std::time_t>(secondsSinceEpoch);
+    std::tm localTime = {};
+    
+#ifdef PLATFORM_WINDOWS
+    localtime_s(&localTime, &time);
+#else
+    localtime_r(&time, &localTime);
+#endif
+    
+    char buffer[32];
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &localTime);
+    
+    return buffer;
+}
+
+bool IsValidUtf8(const std::string_view text) noexcept
+{
+    for(std::size_t i = 0; i < text.size();)
+    {
+        const std::size_t length = GetUtf8SequenceLength(text, i);
+        if(length == 0)
+            return false;
+        
+        i += length;
+    }
+    
+    return true;
+}
+
+void AppendHex(std::string& out, const std::string_view bytes)
+{
+    static const char* const hexDigits = "0123456789abcdef";
+    
+    for(const char c : bytes)
+    {
+        out += hexDigits[static_cast<uint8_t>(c) >> 4];
+        out += hexDigits[static_cast<uint8_t>(c) & 0x0F];
+    }
+}
+
+void AppendJsonString(std::string& out, const std::string_view text)
+{
+    static const char* const hexDigits = "0123456789abcdef";
+    
+    out += '"';
+    
+    for(std::size_t i = 0; i < text.size(); i++)
+    {
+        const char c = text[i];
+        
+        // Multi-byte sequences are copied whole, every invalid byte becomes U+FFFD
+        if(static_cast<uint8_t>(c) >= 0x80)
+        {
+            const std::size_t length = GetUtf8SequenceLength(text, i);
+            
+            if(length == 0)
+            {
+                out += "\\ufffd";
+            }
+            else
+            {
+                out.append(text.substr(i, length));
+                i += length - 1;
+            }
+            
+            continue;
+        }
+        
+        switch(c)
+        {
+            case '"':   out += "\\\""; break;
+            case '\\':  out += "\\\\"; break;
+            case '\n':  out += "\\n"; break;
+            case '\r':  out += "\\r"; break;
+            case '\t':  out += "\\t"; break;
+            default:
+                if(static_cast<uint8_t>(c) < 0x20)
+                {
+                    out += "\\u00";
+                    out += hexDigits[static_cast<uint8_t>(c) >> 4];
+                    out += hexDigits[static_cast<uint8_t>(c) & 0x0F];
+                }
+                else
+                {
+                    out += c;
+                }
+                break;
+        }
+    }
+    
+    out += '"';
+}
+
+void AppendCsvField(std::string& out, const std::string_view text)
+{
+    if(text.find_first_of(",\"\r\n") == std::string_view::npos)
+    {
+        out += text;
+        return;
+    }
+    
+    out += '"';
+    
+    for(const char c : text)
+    {
+        if(c == '"')
+            out += '"';
+        
+        out += c;
+    }
+    
+    out += '"';
+}
+};
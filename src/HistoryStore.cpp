@@ -0,0 +1,637 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  HistoryStore.cpp                                                */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#include "DirStatsCore.hpp"
+
+namespace
+{
+constexpr char MAGIC[8] = {'D', 'S', 'T', 'H', 'I', 'S', 'T', '\0'};
+constexpr std::size_t FILE_HEADER_SIZE = sizeof(MAGIC) + 1;
+
+// Behind every block
+struct Trailer
+{
+    uint64_t    start = 0;  // Offset of the block
+    int64_t     time = 0;
+    uint32_t    flags = 0;
+    char        tag[4] = {'D', 'S', 'T', 'B'};
+};
+
+constexpr uint32_t KEYFRAME_FLAG = 1;
+
+// Trailer ending at end, false if there is none
+bool ReadTrailer(std::FILE* input, const uint64_t end, Trailer& out_trailer)
+{
+    if(end < FILE_HEADER_SIZE + sizeof(Trailer))
+        return false;
+    
+    if(std::fseek(input, static_cast<long>(end - sizeof(Trailer)), SEEK_SET) != 0 || std::fread(&out_trailer, sizeof(Trailer), 1, input) != 1)
+        return false;
+    
+    return std::memcmp(out_trailer.tag, Trailer().tag, sizeof(out_trailer.tag)) == 0
+        && out_trailer.start >= FILE_HEADER_SIZE && out_trailer.start < end - sizeof(Trailer);
+}
+
+// End of the last complete block, walking forward. Only needed after an interrupted append.
+uint64_t FindValidEnd(std::FILE* input, const uint64_t fileSize)
+{
+    uint64_t position = FILE_HEADER_SIZE;
+    
+    while(true)
+    {
+        char buffer[10];
+        if(std::fseek(input, static_cast<long>(position), SEEK_SET) != 0)
+            return position;
+        
+        const std::size_t bytesRead = std::fread(buffer, 1, sizeof(buffer), input);
+        
+        DaemonProtocol::Reader reader(std::string_view(buffer, bytesRead));
+        const uint64_t length = reader.ReadVarint();
+        
+        if(!reader.IsOk() || length > fileSize - position - reader.GetPosition())
+            return position;
+        
+        const uint64_t end = position + reader.GetPosition() + length + sizeof(Trailer);
+        
+        Trailer trailer;
+        if(end > fileSize || !ReadTrailer(input, end, trailer) || trailer.start != position)
+            return position;
+        
+        position = end;
+    }
+}
+
+// Signed difference as unsigned varint, small in both directions
+uint64_t EncodeDelta(const uintmax_t value, const uintmax_t previous) noexcept
+{
+    const uint64_t delta = static_cast<uint64_t>(value - previous);
+    return (delta << 1) ^ (0 - (delta >> 63));
+}
+
+uintmax_t DecodeDelta(const uint64_t encoded, const uintmax_t previous) noexcept
+{
+    return previous + ((encoded >> 1) ^ (0 - (encoded & 1)));
+}
+
+// Absolute generic form without trailing separator, "/" stays
+std::string NormalizePath(const FileSystem::Path& path)
+{
+    std::error_code error;
+    const FileSystem::Path absolutePath = std::filesystem::absolute(path, error);
+    
+    std::string normalized = (error ? path : absolutePath).lexically_normal().generic_string();
+    
+    while(normalized.size() > 1 && normalized.back() == '/')
+        normalized.pop_back();
+    
+    return normalized;
+}
+
+// Slope of the least squares line through the points, per second
+bool FitSlope(const std::vector<std::pair<double, double>>& points, double& out_slope) noexcept
+{
+    if(points.size() < 2)
+        return false;
+    
+    double meanX = 0.0;
+    double meanY = 0.0;
+    for(const auto& [x, y] : points)
+    {
+        meanX += x;
+        meanY += y;
+    }
+    
+    meanX /= static_cast<double>(points.size());
+    meanY /= static_cast<double>(points.size());
+    
+    double covariance = 0.0;
+    double variance = 0.0;
+    for(const auto& [x, y] : points)
+    {
+        covariance += (x - meanX) * (y - meanY);
+        variance += (x - meanX) * (x - meanX);
+    }
+    
+    // All at the same time
+    if(variance <= 0.0)
+        return false;
+    
+    out_slope = covariance / variance;
+    return true;
+}
+}
+
+std::FILE* HistoryStore::OpenFile(const FileSystem::Path& file, uint64_t& out_fileSize)
+{
+    out_fileSize = 0;
+    
+    std::FILE* const input = std::fopen(file.string().c_str(), "rb");
+    if(!input)
+    {
+        m_LastErrorMessage = "Can't open " + file.string() + ": " + std::strerror(errno);
+        return nullptr;
+    }
+    
+    char header[FILE_HEADER_SIZE];
+    const bool isHeader = (std::fread(header, 1, sizeof(header), input) == sizeof(header)) && std::memcmp(header, MAGIC, sizeof(MAGIC)) == 0;
+    
+    if(!isHeader || static_cast<uint8_t>(header[sizeof(MAGIC)]) != VERSION)
+    {
+        m_LastErrorMessage = isHeader ? file.string() + " has an unsupported version" : file.string() + " is not a history file";
+        std::fclose(input);
+        return nullptr;
+    }
+    
+    const long size = (std::fseek(input, 0, SEEK_END) == 0) ? std::ftell(input) : -1;
+    if(size < 0)
+    {
+        m_LastErrorMessage = "Can't read " + file.string();
+        std::fclose(input);
+        return nullptr;
+    }
+    
+    out_fileSize = static_cast<uint64_t>(size);
+    return input;
+}
+
+bool HistoryStore::ReadIndex(std::FILE* input, const FileSystem::Path& file, const uint64_t fileSize, const int64_t windowSeconds, std::vector<BlockInfo>& out_blocks, uint64_t& out_validSize)
+{
+    out_blocks.clear();
+    
+    // An interrupted append leaves an incomplete block at the end, it is ignored
+    Trailer trailer;
+    uint64_t end = fileSize;
+    
+    if(end > FILE_HEADER_SIZE && !ReadTrailer(input, end, trailer))
+        end = FindValidEnd(input, fileSize);
+    
+    out_validSize = end;
+    
+    // Back to a keyframe, every later block depends on it
+    int64_t fromTime = INT64_MIN;
+    
+    while(end > FILE_HEADER_SIZE)
+    {
+        if(!ReadTrailer(input, end, trailer))
+        {
+            m_LastErrorMessage = file.string() + " is damaged";
+            return false;
+        }
+        
+        if(out_blocks.empty() && windowSeconds >= 0)
+            fromTime = trailer.time - windowSeconds;
+        
+        const BlockInfo info{trailer.start, end - sizeof(Trailer), trailer.time, (trailer.flags & KEYFRAME_FLAG) != 0};
+        out_blocks.push_back(info);
+        
+        if(info.isKeyframe && info.time <= fromTime)
+            break;
+        
+        end = trailer.start;
+    }
+    
+    std::reverse(out_blocks.begin(), out_blocks.end());
+    return true;
+}
+
+bool HistoryStore::ReadBlock(std::FILE* input, const FileSystem::Path& file, const BlockInfo& info, std::string& out_data, std::string_view& out_block)
+{
+    out_data.resize(static_cast<std::size_t>(info.end - info.start));
+    
+    if(std::fseek(input, static_cast<long>(info.start), SEEK_SET) != 0 || std::fread(out_data.data(), 1, out_data.size(), input) != out_data.size())
+    {
+        m_LastErrorMessage = "Can't read " + file.string();
+        return false;
+    }
+    
+    // The string fills the space up to the trailer
+    DaemonProtocol::Reader reader(out_data);
+    out_block = reader.ReadString();
+    
+    if(!reader.IsOk() || !reader.IsAtEnd())
+    {
+        m_LastErrorMessage = file.string() + " is damaged";
+        return false;
+    }
+    
+    return true;
+}
+
+bool HistoryStore::DecodeBlock(const std::string_view block, const bool isKeyframe, std::string& out_root, std::unordered_map<std::string, Values>& out_values)
+{
+    // Values are differences to those of the previous block, unless it starts a new chain
+    std::unordered_map<std::string, Values> previous;
+    previous.swap(out_values);
+    
+    if(isKeyframe)
+        previous.clear();
+    
+    DaemonProtocol::Reader reader(block);
+    reader.ReadVarint(); // Time
+    reader.ReadVarint(); // Capacity
+    reader.ReadVarint(); // Available
+    
+    out_root = reader.ReadString();
+    const uint64_t count = reader.ReadVarint();
+    
+    DaemonProtocol::Reader paths(reader.ReadString());
+    DaemonProtocol::Reader sizes(reader.ReadString());
+    DaemonProtocol::Reader allocatedSizes(reader.ReadString());
+    DaemonProtocol::Reader counts(reader.ReadString());
+    
+    std::string path = "";
+    for(uint64_t i = 0; i < count && reader.IsOk(); i++)
+    {
+        const uint64_t shared = paths.ReadVarint();
+        const std::string_view rest = paths.ReadString();
+        
+        if(!paths.IsOk() || shared > path.size())
+            return false;
+        
+        path.resize(static_cast<std::size_t>(shared));
+        path += rest;
+        
+        const auto it = previous.find(path);
+        const Values base = (it != previous.end()) ? it->second : Values();
+        
+        Values& values = out_values[path];
+        values.size = DecodeDelta(sizes.ReadVarint(), base.size);
+        values.allocatedSize = DecodeDelta(allocatedSizes.ReadVarint(), base.allocatedSize);
+        values.count = DecodeDelta(counts.ReadVarint(), base.count);
+    }
+    
+    return reader.IsOk() && sizes.IsOk() && allocatedSizes.IsOk() && counts.IsOk();
+}
+
+std::string HistoryStore::RelativePath(const std::string& root, const std::string& path, bool& out_isInside)
+{
+    out_isInside = true;
+    
+    if(path == root)
+        return "";
+    
+    const std::string prefix = root.ends_with('/') ? root : root + "/";
+    if(path.starts_with(prefix))
+        return path.substr(prefix.size());
+    
+    out_isInside = false;
+    return "";
+}
+
+bool HistoryStore::Append(const DirectoryTree& tree, const FileSystem::Path& file, const uintmax_t minSize, const uintmax_t capacity, const uintmax_t available)
+{
+    if(tree.GetRoot() == DirectoryTree::INVALID_NODE)
+    {
+        m_LastErrorMessage = "Nothing scanned";
+        return false;
+    }
+    
+    // Values of the last scan, the new ones are stored as differences to them
+    std::unordered_map<std::string, Values> previous;
+    std::string previousRoot = "";
+    std::vector<BlockInfo> blocks;
+    uint64_t fileSize = 0;
+    uint64_t validSize = FILE_HEADER_SIZE;
+    
+    const bool isNewFile = !std::filesystem::exists(file) || std::filesystem::is_empty(file);
+    if(!isNewFile)
+    {
+        std::FILE* const input = OpenFile(file, fileSize);
+        if(!input)
+            return false;
+        
+        // Only the blocks since the last keyframe
+        bool isRead = ReadIndex(input, file, fileSize, 0, blocks, validSize);
+        
+        std::string data = "";
+        for(std::size_t i = 0; i < blocks.size() && isRead; i++)
+        {
+            std::string_view block;
+            isRead = ReadBlock(input, file, blocks[i], data, block);
+            
+            if(isRead && !DecodeBlock(block, blocks[i].isKeyframe, previousRoot, previous))
+            {
+                m_LastErrorMessage = file.string() + " is damaged";
+                isRead = false;
+            }
+        }
+        
+        std::fclose(input);
+        
+        if(!isRead)
+            return false;
+    }
+    
+    // Paths of another root aren't comparable
+    const std::string root = NormalizePath(tree.GetPath(tree.GetRoot()));
+    const bool isKeyframe = blocks.empty() || root != previousRoot || blocks.size() >= KEYFRAME_INTERVAL;
+    
+    if(isKeyframe)
+        previous.clear();
+    
+    // Large directories with their path, a directory is never larger than its parent
+    std::vector<std::pair<std::string, DirectoryTree::NodeIndex>> directories;
+    directories.emplace_back("", tree.GetRoot());
+    
+    std::vector<DirectoryTree::NodeIndex> children;
+    for(std::size_t i = 0; i < directories.size(); i++)
+    {
+        children.clear();
+        tree.GetChildren(directories[i].second, children);
+        
+        for(const DirectoryTree::NodeIndex child : children)
+        {
+            const DirectoryTree::Node& node = tree.GetNode(child);
+            if(node.type != DirectoryTree::NodeType::DIRECTORY || node.size < minSize)
+                continue;
+            
+            const std::string& parentPath = directories[i].first;
+            directories.emplace_back(parentPath.empty() ? std::string(tree.GetName(child)) : parentPath + "/" + std::string(tree.GetName(child)), child);
+        }
+    }
+    
+    std::sort(directories.begin(), directories.end());
+    
+    // Columns
+    std::string paths = "";
+    std::string sizes = "";
+    std::string allocatedSizes = "";
+    std::string counts = "";
+    const std::string* lastPath = nullptr;
+    
+    for(const auto& [path, index] : directories)
+    {
+        // Front coding
+        std::size_t shared = 0;
+        if(lastPath)
+        {
+            const std::size_t maxShared = std::min(lastPath->size(), path.size());
+            while(shared < maxShared && (*lastPath)[shared] == path[shared])
+                shared++;
+        }
+        
+        DaemonProtocol::AppendVarint(paths, shared);
+        DaemonProtocol::AppendString(paths, std::string_view(path).substr(shared));
+        lastPath = &path;
+        
+        const auto it = previous.find(path);
+        const Values base = (it != previous.end()) ? it->second : Values();
+        const DirectoryTree::Node& node = tree.GetNode(index);
+        
+        DaemonProtocol::AppendVarint(sizes, EncodeDelta(node.size, base.size));
+        DaemonProtocol::AppendVarint(allocatedSizes, EncodeDelta(node.allocatedSize, base.allocatedSize));
+        DaemonProtocol::AppendVarint(counts, EncodeDelta(node.count, base.count));
+    }
+    
+    const int64_t time = std::max<int64_t>(std::time(nullptr), 0);
+    
+    std::string block = "";
+    DaemonProtocol::AppendVarint(block, static_cast<uint64_t>(time));
+    DaemonProtocol::AppendVarint(block, capacity);
+    DaemonProtocol::AppendVarint(block, available);
+    DaemonProtocol::AppendString(block, root);
+    DaemonProtocol::AppendVarint(block, directories.size());
+    DaemonProtocol::AppendString(block, paths);
+    DaemonProtocol::AppendString(block, sizes);
+    DaemonProtocol::AppendString(block, allocatedSizes);
+    DaemonProtocol::AppendString(block, counts);
+    
+    std::string output = "";
+    if(isNewFile)
+    {
+        output.append(MAGIC, sizeof(MAGIC));
+        output += static_cast<char>(VERSION);
+    }
+    
+    Trailer trailer;
+    trailer.start = validSize;
+    trailer.time = time;
+    trailer.flags = isKeyframe ? KEYFRAME_FLAG : 0;
+    
+    DaemonProtocol::AppendString(output, block);
+    output.append(reinterpret_cast<const char*>(&trailer), sizeof(Trailer));
+    
+    // Drop an incomplete block of an interrupted append
+    if(!isNewFile && validSize < fileSize)
+    {
+        std::error_code error;
+        std::filesystem::resize_file(file, validSize, error);
+        
+        if(error)
+        {
+            m_LastErrorMessage = "Can't repair " + file.string() + ": " + error.message();
+            return false;
+        }
+    }
+    
+    std::FILE* const outputFile = std::fopen(file.string().c_str(), "ab");
+    if(!outputFile)
+    {
+        m_LastErrorMessage = "Can't open " + file.string() + ": " + std::strerror(errno);
+        return false;
+    }
+    
+    const bool isWritten = (std::fwrite(output.data(), 1, output.size(), outputFile) == output.size());
+    const bool isClosed = (std::fclose(outputFile) == 0);
+    
+    if(!isWritten || !isClosed)
+    {
+        m_LastErrorMessage = "Can't write " + file.string() + ": " + std::strerror(errno);
+        return false;
+    }
+    
+    return true;
+}
+
+bool HistoryStore::Query(const FileSystem::Path& file, const FileSystem::Path& path, const int64_t windowSeconds, std::vector<Sample>& out_samples)
+{
+    out_samples.clear();
+    
+    uint64_t fileSize = 0;
+    std::FILE* const input = OpenFile(file, fileSize);
+    if(!input)
+        return false;
+    
+    std::vector<BlockInfo> blocks;
+    uint64_t validSize = 0;
+    
+    const bool isRead = ReadIndex(input, file, fileSize, windowSeconds, blocks, validSize) && QueryBlocks(input, file, blocks, NormalizePath(path), windowSeconds, out_samples);
+    std::fclose(input);
+    
+    return isRead;
+}
+
+bool HistoryStore::QueryBlocks(std::FILE* input, const FileSystem::Path& file, const std::vector<BlockInfo>& blocks, const std::string& target, const int64_t windowSeconds, std::vector<Sample>& out_samples)
+{
+    // Blocks before the window are only the base of the deltas
+    const int64_t fromTime = (windowSeconds < 0 || blocks.empty()) ? INT64_MIN : blocks.back().time - windowSeconds;
+    
+    // Values of the path in the previous block, the base of the deltas
+    bool wasFound = false;
+    Values previous;
+    std::string data = "";
+    
+    for(const BlockInfo& info : blocks)
+    {
+        std::string_view block;
+        if(!ReadBlock(input, file, info, data, block))
+            return false;
+        
+        DaemonProtocol::Reader reader(block);
+        
+        Sample sample;
+        sample.time = static_cast<int64_t>(reader.ReadVarint());
+        sample.capacity = reader.ReadVarint();
+        sample.available = reader.ReadVarint();
+        
+        const std::string root = std::string(reader.ReadString());
+        const uint64_t count = reader.ReadVarint();
+        
+        DaemonProtocol::Reader paths(reader.ReadString());
+        const std::string_view sizes = reader.ReadString();
+        const std::string_view allocatedSizes = reader.ReadString();
+        const std::string_view counts = reader.ReadString();
+        
+        if(!reader.IsOk())
+        {
+            m_LastErrorMessage = file.string() + " is damaged";
+            return false;
+        }
+        
+        bool isInside = false;
+        const std::string relativePath = RelativePath(root, target, isInside);
+        
+        // Paths are sorted, stop at the first one behind the searched one
+        uint64_t index = count;
+        std::string current = "";
+        
+        for(uint64_t i = 0; i < count && isInside; i++)
+        {
+            const uint64_t shared = paths.ReadVarint();
+            const std::string_view rest = paths.ReadString();
+            
+            if(!paths.IsOk() || shared > current.size())
+            {
+                m_LastErrorMessage = file.string() + " is damaged";
+                return false;
+            }
+            
+            current.resize(static_cast<std::size_t>(shared));
+            current += rest;
+            
+            if(current >= relativePath)
+            {
+                if(current == relativePath)
+                    index = i;
+                
+                break;
+            }
+        }
+        
+        // Only the values up to the index are decoded
+        auto readValue = [index](const std::string_view column, const uintmax_t base)
+        {
+            DaemonProtocol::Reader values(column);
+            for(uint64_t i = 0; i < index; i++)
+                values.ReadVarint();
+            
+            return DecodeDelta(values.ReadVarint(), base);
+        };
+        
+        if(index < count)
+        {
+            const Values base = (wasFound && !info.isKeyframe) ? previous : Values();
+            
+            sample.isFound = true;
+            sample.size = previous.size = readValue(sizes, base.size);
+            sample.allocatedSize = previous.allocatedSize = readValue(allocatedSizes, base.allocatedSize);
+            sample.count = previous.count = readValue(counts, base.count);
+        }
+        
+        wasFound = sample.isFound;
+        
+        if(info.time >= fromTime)
+            out_samples.push_back(sample);
+    }
+    
+    return true;
+}
+
+HistoryStore::Forecast HistoryStore::ForecastFill(const std::vector<Sample>& samples, const int64_t windowSeconds)
+{
+    Forecast forecast;
+    
+    if(samples.empty())
+        return forecast;
+    
+    const Sample& last = samples.back();
+    
+    // Times relative to the last sample, keeps the sums small
+    std::vector<std::pair<double, double>> used;
+    std::vector<std::pair<double, double>> sizes;
+    
+    for(const Sample& sample : samples)
+    {
+        if(sample.time < last.time - windowSeconds)
+            continue;
+        
+        const double time = static_cast<double>(sample.time - last.time);
+        used.emplace_back(time, static_cast<double>(sample.capacity - std::min(sample.available, sample.capacity)));
+        
+        if(sample.isFound)
+            sizes.emplace_back(time, static_cast<double>(sample.size));
+    }
+    
+    double usedSlope = 0.0;
+    if(!FitSlope(used, usedSlope))
+        return forecast;
+    
+    constexpr double SECONDS_PER_DAY = 24.0 * 60.0 * 60.0;
+    
+    forecast.isValid = true;
+    forecast.usedPerDay = usedSlope * SECONDS_PER_DAY;
+    
+    double sizeSlope = 0.0;
+    if(FitSlope(sizes, sizeSlope))
+        forecast.sizePerDay = sizeSlope * SECONDS_PER_DAY;
+    
+    if(usedSlope > 0.0)
+    {
+        // Far beyond any sensible date is "never" as well
+        const double secondsLeft = static_cast<double>(last.available) / usedSlope;
+        if(secondsLeft < 1000.0 * 365.0 * SECONDS_PER_DAY)
+            forecast.fullTime = last.time + static_cast<int64_t>(secondsLeft);
+    }
+    
+    return forecast;
+}
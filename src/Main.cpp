@@ -35,13 +35,17 @@ the following restrictions:
 
 int main(int argc, char** argv)
 {
-    MessageBox::Display(MessageBox::Type::INFO, MessageBox::Buttons::OK_CANCEL, "Header", "Message", 3);
-    return 0;
-    
     // Create App and run it
     std::unique_ptr<App> app = std::make_unique<App>(argc, argv);
     const int result = app->Run();
     
+    // Only in builds with DIRSTATS_COUNT_ALLOCATIONS
+    if(AllocationCounter::IsEnabled())
+    {
+        std::cerr << "Allocations by phase:" << std::endl;
+        AllocationCounter::PrintCounts(std::cerr, AllocationCounter::GetProcessCounts(), 1, "");
+    }
+    
     return result;
     
     
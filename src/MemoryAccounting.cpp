@@ -0,0 +1,108 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  MemoryAccounting.cpp                                            */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#include "DirStatsCore.hpp"
+
+void MemoryAccounting::Add(const std::string_view name, const uint64_t bytes, const uint64_t count, const bool isMapped)
+{
+    Item& item = m_Items.emplace_back();
+    item.name = name;
+    item.bytes = bytes;
+    item.count = count;
+    item.isMapped = isMapped;
+}
+
+uint64_t MemoryAccounting::GetHeapBytes() const noexcept
+{
+    uint64_t bytes = 0;
+    
+    for(const Item& i : m_Items)
+    {
+        if(!i.isMapped)
+            bytes += i.bytes;
+    }
+    
+    return bytes;
+}
+
+uint64_t MemoryAccounting::GetMappedBytes() const noexcept
+{
+    uint64_t bytes = 0;
+    
+    for(const Item& i : m_Items)
+    {
+        if(i.isMapped)
+            bytes += i.bytes;
+    }
+    
+    return bytes;
+}
+
+void MemoryAccounting::WriteText(std::ostream& out) const
+{
+    out << "Memory                         Bytes       Count\n";
+    
+    for(const Item& i : m_Items)
+    {
+        std::string name = i.name + (i.isMapped ? " (mapped)" : "");
+        name.resize(std::max<std::size_t>(name.size(), 24), ' ');
+        
+        out << "  " << name << Format::PadLeft(Format::HumanReadableSize(i.bytes), 12) << Format::PadLeft(i.count ? std::to_string(i.count) : std::string("-"), 12) << "\n";
+    }
+    
+    out << "  Total heap              " << Format::PadLeft(Format::HumanReadableSize(GetHeapBytes()), 12) << "\n";
+    out << "  Resident                " << Format::PadLeft(Format::HumanReadableSize(ProcessStats::GetResidentBytes()), 12) << "\n";
+    out << std::flush;
+}
+
+void MemoryAccounting::AppendJson(std::string& json) const
+{
+    json += "{\"heap_bytes\":" + std::to_string(GetHeapBytes());
+    json += ",\"mapped_bytes\":" + std::to_string(GetMappedBytes());
+    json += ",\"resident_bytes\":" + std::to_string(ProcessStats::GetResidentBytes());
+    json += ",\"items\":[";
+    
+    for(const Item& i : m_Items)
+    {
+        if(json.back() != '[')
+            json += ',';
+        
+        json += "{\"name\":";
+        Format::AppendJsonString(json, i.name);
+        json += ",\"bytes\":" + std::to_string(i.bytes);
+        json += ",\"count\":" + std::to_string(i.count);
+        json += i.isMapped ? ",\"mapped\":true}" : ",\"mapped\":false}";
+    }
+    
+    json += "]}";
+}
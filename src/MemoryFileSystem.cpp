@@ -0,0 +1,250 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  MemoryFileSystem.cpp                                            */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#include "DirStatsCore.hpp"
+
+namespace
+{
+    constexpr uint64_t  SIMULATED_DEVICE = 0x6d656d;
+    constexpr uintmax_t BLOCK_SIZE = 4096;
+    constexpr uint32_t  MAX_SIZE_BITS = 24; // Files are below 16 MiB
+    constexpr int64_t   NEWEST_WRITE_TIME = 1700000000;
+    
+    // SplitMix64 finalizer
+    uint64_t Mix(uint64_t value) noexcept
+    {
+        value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9;
+        value = (value ^ (value >> 27)) * 0x94d049bb133111eb;
+        return value ^ (value >> 31);
+    }
+    
+    uint64_t GetDirectoryHash(const uint64_t parentHash, const uint64_t index) noexcept
+    {
+        return Mix(parentHash ^ Mix(index + 1));
+    }
+    
+    uint64_t GetFileHash(const uint64_t parentHash, const uint64_t index) noexcept
+    {
+        return Mix(parentHash + Mix(~index));
+    }
+    
+    bool IsSeparator(const char character) noexcept
+    {
+        return character == '/' || character == '\\';
+    }
+    
+    uint64_t SaturatingAdd(const uint64_t a, const uint64_t b) noexcept
+    {
+        return (b > UINT64_MAX - a) ? UINT64_MAX : a + b;
+    }
+    
+    uint64_t SaturatingMultiply(const uint64_t a, const uint64_t b) noexcept
+    {
+        return (a != 0 && b > UINT64_MAX / a) ? UINT64_MAX : a * b;
+    }
+}
+
+MemoryFileSystem::MemoryFileSystem(const std::string& root, const std::vector<Level>& levels, const uint64_t seed)
+    : m_Root(root)
+    , m_Levels(levels)
+    , m_Seed(seed)
+{
+    // Paths of the scanner are compared without trailing separator
+    while(m_Root.size() > 1 && IsSeparator(m_Root.back()))
+        m_Root.pop_back();
+}
+
+bool MemoryFileSystem::FindDirectory(const std::string& path, std::size_t& out_level, uint64_t& out_hash) const noexcept
+{
+    if(path.compare(0, m_Root.size(), m_Root) != 0)
+        return false;
+    
+    std::size_t position = m_Root.size();
+    if(position < path.size() && !IsSeparator(path[position]) && !IsSeparator(m_Root.back()))
+        return false;
+    
+    out_level = 0;
+    out_hash = Mix(m_Seed);
+    
+    // Every component must be a simulated directory "d<index>"
+    while(position < path.size())
+    {
+        if(IsSeparator(path[position]))
+        {
+            position++;
+            continue;
+        }
+        
+        std::size_t end = position;
+        while(end < path.size() && !IsSeparator(path[end]))
+            end++;
+        
+        if(out_level >= m_Levels.size() || path[position] != 'd' || end - position < 2)
+            return false;
+        
+        // No leading zeros, "d01" would be a second name of "d1"
+        if(path[position + 1] == '0' && end - position > 2)
+            return false;
+        
+        uint64_t index = 0;
+        for(std::size_t i = position + 1; i < end; i++)
+        {
+            if(path[i] < '0' || path[i] > '9' || index > (UINT64_MAX - 9) / 10)
+                return false;
+            
+            index = index * 10 + static_cast<uint64_t>(path[i] - '0');
+        }
+        
+        if(index >= m_Levels[out_level].directoryCount)
+            return false;
+        
+        out_hash = GetDirectoryHash(out_hash, index);
+        out_level++;
+        position = end;
+    }
+    
+    return true;
+}
+
+bool MemoryFileSystem::ReadDirectory(const std::string& path, const bool isRoot, std::vector<std::string>& out_names, std::vector<DirectoryTree::Entry>& out_entries, std::vector<FileId>& out_ids)
+{
+    (void)isRoot;
+    
+    out_names.clear();
+    out_entries.clear();
+    out_ids.clear();
+    
+    m_ReadCount++;
+    
+    std::size_t level = 0;
+    uint64_t hash = 0;
+    if(!FindDirectory(path, level, hash))
+    {
+        errno = ENOENT;
+        return false;
+    }
+    
+    // The simulated latency counts as listing, there are no stat calls
+    const ScanStatistics::PhaseTimer listTimer(ScanStatistics::Phase::LIST);
+    const Tracer::ScopedSpan listSpan(Tracer::Category::SCAN, "list (simulated)");
+    if(ScanStatistics::Counters* const statistics = ScanStatistics::GetCurrentCounters())
+        statistics->directoriesOpened++;
+    
+    const Level shape = (level < m_Levels.size()) ? m_Levels[level] : Level();
+    const uint64_t entryCount = shape.directoryCount + shape.fileCount;
+    
+    out_names.reserve(entryCount);
+    out_entries.reserve(entryCount);
+    out_ids.reserve(entryCount);
+    
+    for(uint64_t i = 0; i < shape.directoryCount; i++)
+    {
+        const uint64_t childHash = GetDirectoryHash(hash, i);
+        
+        DirectoryTree::Entry entry;
+        entry.type = DirectoryTree::NodeType::DIRECTORY;
+        entry.size = BLOCK_SIZE;
+        entry.allocatedSize = BLOCK_SIZE;
+        entry.lastWriteTime = NEWEST_WRITE_TIME - static_cast<int64_t>((childHash >> 32) % (365 * 86400));
+        
+        FileId id;
+        id.device = SIMULATED_DEVICE;
+        id.inode = childHash;
+        
+        out_names.emplace_back(1, 'd') += std::to_string(i);
+        out_entries.push_back(entry);
+        out_ids.push_back(id);
+    }
+    
+    for(uint64_t i = 0; i < shape.fileCount; i++)
+    {
+        const uint64_t fileHash = GetFileHash(hash, i);
+        
+        // Sizes spread evenly over the powers of two
+        const uint64_t sizeBits = fileHash % (MAX_SIZE_BITS + 1);
+        const uint64_t size = (sizeBits == 0) ? 0 : (uint64_t(1) << (sizeBits - 1)) + ((fileHash >> 8) & ((uint64_t(1) << (sizeBits - 1)) - 1));
+        
+        DirectoryTree::Entry entry;
+        entry.type = DirectoryTree::NodeType::REGULAR_FILE;
+        entry.size = size;
+        entry.allocatedSize = (size + BLOCK_SIZE - 1) / BLOCK_SIZE * BLOCK_SIZE;
+        entry.lastWriteTime = NEWEST_WRITE_TIME - static_cast<int64_t>((fileHash >> 32) % (365 * 86400));
+        
+        FileId id;
+        id.device = SIMULATED_DEVICE;
+        id.inode = fileHash;
+        
+        out_names.emplace_back(1, 'f') += std::to_string(i);
+        out_entries.push_back(entry);
+        out_ids.push_back(id);
+    }
+    
+    const std::chrono::nanoseconds latency = m_DirectoryLatency + m_EntryLatency * static_cast<int64_t>(entryCount);
+    if(latency.count() > 0)
+        std::this_thread::sleep_for(latency);
+    
+    return true;
+}
+
+void MemoryFileSystem::GetDirectorySize(const std::string& path, uintmax_t& out_size, uintmax_t& out_allocatedSize) noexcept
+{
+    std::size_t level = 0;
+    uint64_t hash = 0;
+    const bool isDirectory = FindDirectory(path, level, hash);
+    
+    out_size = isDirectory ? BLOCK_SIZE : 0;
+    out_allocatedSize = out_size;
+}
+
+void MemoryFileSystem::SetLatency(const std::chrono::nanoseconds perDirectory, const std::chrono::nanoseconds perEntry) noexcept
+{
+    m_DirectoryLatency = perDirectory;
+    m_EntryLatency = perEntry;
+}
+
+uint64_t MemoryFileSystem::GetEntryCount() const noexcept
+{
+    uint64_t directoryCount = 1; // On the current level
+    uint64_t entryCount = 0;
+    
+    for(const Level& level : m_Levels)
+    {
+        entryCount = SaturatingAdd(entryCount, SaturatingMultiply(directoryCount, SaturatingAdd(level.directoryCount, level.fileCount)));
+        directoryCount = SaturatingMultiply(directoryCount, level.directoryCount);
+        
+        if(directoryCount == 0)
+            break;
+    }
+    
+    return entryCount;
+}
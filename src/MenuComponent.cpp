@@ -117,40 +117,20 @@ MenuComponent::MenuComponent()
     {
         return DirectoryEntryTransform(state);
     };
-    
-    // *******************************************************
-    // Add elements
-    for(uint32_t i = 0; i < 8; i++)
-    {
-        MenuEntry entry;
-        entry.isDirectory = false;
-        entry.name = "Entry File " + std::to_string(i);
-        
-        AddEntry(entry);
-    }
-    
-    for(uint32_t i = 0; i < 5; i++)
-    {
-        MenuEntry entry;
-        entry.isDirectory = true;
-        entry.name = "Entry Directory " + std::to_string(i);
-        
-        AddEntry(entry);
-    }
-    
-    // Select first entry
-    this->ChildAt(0)->SetActiveChild(this->ChildAt(0)->ChildAt(0));
-    m_CurrentSelection = 0;
 }
 
 void MenuComponent::AddEntry(const MenuEntry& entry)
 {
     m_Entries.push_back(entry);
     
+    // Label: Mark, size right aligned, then the name
+    const std::string sizeLabel = entry.sizeLabel.empty() ? Format::HumanReadableSize(entry.size) : entry.sizeLabel;
+    const std::string label = (entry.isMarked ? "* " : "  ") + Format::PadLeft(sizeLabel, 11) + "  " + entry.name + (entry.isDirectory ? "/" : "");
+    
     if(entry.isDirectory)
-        this->ChildAt(0)->Add(ftxui::MenuEntry(entry.name, m_EntryOptionDirectory));
+        this->ChildAt(0)->Add(ftxui::MenuEntry(label, m_EntryOptionDirectory));
     else
-        this->ChildAt(0)->Add(ftxui::MenuEntry(entry.name, m_EntryOptionFile));
+        this->ChildAt(0)->Add(ftxui::MenuEntry(label, m_EntryOptionFile));
 }
 
 void MenuComponent::ClearEntries()
@@ -161,6 +141,31 @@ void MenuComponent::ClearEntries()
     m_Entries.resize(0);
 }
 
+void MenuComponent::SetSelection(const int32_t selection)
+{
+    if(m_Entries.empty())
+    {
+        m_CurrentSelection = 0;
+        m_CurrentFocus = -1;
+        return;
+    }
+    
+    m_CurrentSelection = std::clamp<int32_t>(selection, 0, static_cast<int32_t>(m_Entries.size()) - 1);
+    m_CurrentFocus = m_CurrentSelection;
+    
+    this->ChildAt(0)->SetActiveChild(this->ChildAt(0)->ChildAt(static_cast<std::size_t>(m_CurrentSelection)));
+}
+
+void MenuComponent::AccountMemory(MemoryAccounting& accounting) const
+{
+    uint64_t bytes = MemoryAccounting::GetVectorBytes(m_Entries);
+    
+    for(const MenuEntry& i : m_Entries)
+        bytes += MemoryAccounting::GetStringBytes(i.name) + MemoryAccounting::GetStringBytes(i.sizeLabel);
+    
+    accounting.Add("Menu entries", bytes, m_Entries.size());
+}
+
 ftxui::Element MenuComponent::Render()
 {
     return ftxui::ComponentBase::Render();
@@ -171,6 +176,14 @@ bool MenuComponent::OnEvent(ftxui::Event event)
     //if (Focused())
     const int32_t oldSelection = m_CurrentSelection;
     
+    if (event == ftxui::Event::Return)
+    {
+        if(m_OnEnterFunction)
+            m_OnEnterFunction();
+        
+        return true;
+    }
+    
     // Process events
     const bool result = this->ChildAt(0)->OnEvent(event);
     
@@ -0,0 +1,117 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  NamePool.cpp                                                    */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#include "DirStatsCore.hpp"
+
+std::string_view NamePool::Store(std::string_view name)
+{
+    // Names longer than a block get a block of their own. It is inserted in front,
+    // so the back block stays the one currently being filled.
+    if(name.size() > BLOCK_SIZE)
+    {
+        std::unique_ptr<char[]> block = std::make_unique<char[]>(name.size());
+        std::memcpy(block.get(), name.data(), name.size());
+        
+        const std::string_view stored(block.get(), name.size());
+        m_Blocks.insert(m_Blocks.begin(), std::move(block));
+        m_BlockBytes += name.size();
+        
+        return stored;
+    }
+    
+    // Start a new block if the current one is full
+    if(m_BlockUsed + name.size() > BLOCK_SIZE)
+    {
+        m_Blocks.push_back(std::make_unique<char[]>(BLOCK_SIZE));
+        m_BlockUsed = 0;
+        m_BlockBytes += BLOCK_SIZE;
+    }
+    
+    char* const dest = m_Blocks.back().get() + m_BlockUsed;
+    std::memcpy(dest, name.data(), name.size());
+    m_BlockUsed += name.size();
+    
+    return std::string_view(dest, name.size());
+}
+
+NamePool::NameID NamePool::Intern(std::string_view name)
+{
+    // Already known?
+    const auto it = m_Lookup.find(name);
+    if(it != m_Lookup.end())
+        return it->second;
+    
+    const std::string_view stored = Store(name);
+    const NameID id = static_cast<NameID>(m_Names.size());
+    
+    m_Names.push_back(stored);
+    m_Lookup.emplace(stored, id);
+    
+    return id;
+}
+
+void NamePool::Clear() noexcept
+{
+    m_Lookup.clear();
+    m_Names.clear();
+    m_Blocks.clear();
+    m_BlockUsed = BLOCK_SIZE;
+    m_BlockBytes = 0;
+    
+    m_MappedData = nullptr;
+    m_MappedOffsets = nullptr;
+    m_MappedCount = 0;
+}
+
+void NamePool::Map(const char* const data, const uint64_t* const offsets, const std::size_t count) noexcept
+{
+    Clear();
+    
+    m_MappedData = data;
+    m_MappedOffsets = offsets;
+    m_MappedCount = count;
+}
+
+void NamePool::AccountMemory(MemoryAccounting& accounting) const
+{
+    if(m_MappedOffsets)
+    {
+        accounting.Add("Names", m_MappedOffsets[m_MappedCount], m_MappedCount, true);
+        accounting.Add("Name offsets", (m_MappedCount + 1) * sizeof(uint64_t), m_MappedCount + 1, true);
+        return;
+    }
+    
+    accounting.Add("Name blocks", m_BlockBytes, m_Blocks.size());
+    accounting.Add("Name views", MemoryAccounting::GetVectorBytes(m_Names) + MemoryAccounting::GetVectorBytes(m_Blocks), m_Names.size());
+    accounting.Add("Name lookup", MemoryAccounting::GetHashTableBytes(m_Lookup), m_Lookup.size());
+}
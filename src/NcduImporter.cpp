@@ -0,0 +1,573 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  NcduImporter.cpp                                                */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#include "DirStatsCore.hpp"
+
+bool NcduImporter::Import(const FileSystem::Path& file, DirectoryTree& out_tree, const std::atomic<bool>& stop)
+{
+    const bool isStdin = (file == "-");
+    m_File = isStdin ? stdin : std::fopen(file.string().c_str(), "rb");
+    
+    if(!m_File)
+        return Fail(file.string() + ": " + std::error_code(errno, std::generic_category()).message());
+    
+    m_Buffer.resize(READ_BUFFER_SIZE);
+    m_Position = 0;
+    m_End = 0;
+    m_Offset = 0;
+    m_HardLinks.clear();
+    
+    // [major, minor, {metadata}, [root directory]]
+    bool isOk = [&]()
+    {
+        uint64_t majorVersion = 0;
+        uint64_t minorVersion = 0;
+        
+        if(!Expect('[') || !ParseUnsigned(majorVersion) || !Expect(',') || !ParseUnsigned(minorVersion) || !Expect(','))
+            return false;
+        
+        if(majorVersion != 1)
+            return Fail("Unsupported ncdu export version " + std::to_string(majorVersion));
+        
+        if(!SkipValue() || !Expect(',') || !Expect('[') || !ParseInfo(m_Info))
+            return false;
+        
+        // The root is named after the full path
+        const DirectoryTree::NodeIndex root = out_tree.CreateRoot(m_Info.name, m_Info.apparentSize, m_Info.diskSize);
+        if(m_Info.hasReadError)
+            out_tree.SetError(root);
+        
+        std::size_t depth = 0;
+        if(m_Stack.empty())
+            m_Stack.emplace_back();
+        
+        m_Stack[0].device = m_Info.device;
+        m_Stack[0].entries.clear();
+        m_Stack[0].childBlocks.clear();
+        m_Stack[0].names.clear();
+        m_Stack[0].nameRanges.clear();
+        
+        uint32_t checkStop = 0;
+        
+        while(true)
+        {
+            if((++checkStop & 0xFFFF) == 0 && stop)
+                return Fail("Import stopped");
+            
+            SkipWhitespace();
+            const int32_t c = Get();
+            
+            if(c == ',')
+            {
+                SkipWhitespace();
+                
+                // File
+                if(Peek() == '{')
+                {
+                    if(!ParseInfo(m_Info))
+                        return false;
+                    
+                    AddEntry(m_Stack[depth], m_Info, {}, false);
+                    continue;
+                }
+                
+                // Subdirectory, its info object comes first
+                if(!Expect('[') || !ParseInfo(m_Info))
+                    return false;
+                
+                const uint64_t parentDevice = m_Stack[depth].device;
+                
+                if(++depth == m_Stack.size())
+                    m_Stack.emplace_back();
+                
+                OpenDirectory& directory = m_Stack[depth];
+                directory.device = m_Info.hasDevice ? m_Info.device : parentDevice;
+                directory.selfName = m_Info.name;
+                directory.self = {};
+                directory.self.type = DirectoryTree::NodeType::DIRECTORY;
+                directory.self.size = m_Info.apparentSize;
+                directory.self.allocatedSize = m_Info.diskSize;
+                directory.self.lastWriteTime = m_Info.modificationTime;
+                directory.self.hasError = m_Info.hasReadError;
+                directory.entries.clear();
+                directory.childBlocks.clear();
+                directory.names.clear();
+                directory.nameRanges.clear();
+                
+                continue;
+            }
+            
+            if(c != ']')
+                return Fail("Expected ',' or ']'");
+            
+            // Directory complete, all of its subdirectories are in the tree already
+            OpenDirectory& directory = m_Stack[depth];
+            
+            for(std::size_t i = 0; i < directory.entries.size(); i++)
+                directory.entries[i].name = std::string_view(directory.names).substr(directory.nameRanges[i].first, directory.nameRanges[i].second);
+            
+            DirectoryTree::ChildBlock block;
+            if(!directory.entries.empty())
+            {
+                block.firstChild = out_tree.AddDetachedChildren(directory.entries, directory.childBlocks);
+                block.childCount = static_cast<uint32_t>(directory.entries.size());
+            }
+            
+            if(depth == 0)
+            {
+                out_tree.AttachChildren(root, block);
+                break;
+            }
+            
+            depth--;
+            
+            m_Info.name = directory.selfName;
+            m_Info.apparentSize = directory.self.size;
+            m_Info.diskSize = directory.self.allocatedSize;
+            m_Info.modificationTime = directory.self.lastWriteTime;
+            m_Info.hasReadError = directory.self.hasError;
+            
+            AddEntry(m_Stack[depth], m_Info, block, true);
+        }
+        
+        return Expect(']');
+    }();
+    
+    if(!isStdin)
+        std::fclose(m_File);
+    
+    m_File = nullptr;
+    
+    return isOk;
+}
+
+void NcduImporter::AddEntry(OpenDirectory& directory, const Info& info, const DirectoryTree::ChildBlock& block, const bool isDirectory)
+{
+    DirectoryTree::Entry entry;
+    entry.size = info.apparentSize;
+    entry.allocatedSize = info.diskSize;
+    entry.lastWriteTime = info.modificationTime;
+    entry.hasError = info.hasReadError;
+    
+    if(isDirectory)
+        entry.type = DirectoryTree::NodeType::DIRECTORY;
+    else if(info.isExcluded || info.isNotRegular)
+        entry.type = DirectoryTree::NodeType::OTHER;
+    else
+        entry.type = DirectoryTree::NodeType::REGULAR_FILE;
+    
+    // ncdu lists every link, count only the first one
+    if(!isDirectory && info.isHardLink)
+    {
+        const uint64_t device = info.hasDevice ? info.device : directory.device;
+        
+        if(!m_HardLinks.emplace(device, info.inode).second)
+        {
+            entry.isHardLink = true;
+            entry.size = 0;
+            entry.allocatedSize = 0;
+        }
+    }
+    
+    directory.nameRanges.emplace_back(directory.names.size(), info.name.size());
+    directory.names += info.name;
+    directory.entries.push_back(entry);
+    directory.childBlocks.push_back(block);
+}
+
+bool NcduImporter::ParseInfo(Info& out_info)
+{
+    out_info = {};
+    
+    if(!Expect('{'))
+        return false;
+    
+    SkipWhitespace();
+    if(Peek() == '}')
+    {
+        Get();
+        return true;
+    }
+    
+    while(true)
+    {
+        SkipWhitespace();
+        if(!ParseString(m_Key) || !Expect(':'))
+            return false;
+        
+        SkipWhitespace();
+        
+        bool isOk = true;
+        
+        if(m_Key == "name")
+            isOk = ParseString(out_info.name);
+        else if(m_Key == "asize")
+            isOk = ParseUnsigned(out_info.apparentSize);
+        else if(m_Key == "dsize")
+            isOk = ParseUnsigned(out_info.diskSize);
+        else if(m_Key == "ino")
+            isOk = ParseUnsigned(out_info.inode);
+        else if(m_Key == "dev")
+        {
+            isOk = ParseUnsigned(out_info.device);
+            out_info.hasDevice = true;
+        }
+        else if(m_Key == "mtime")
+        {
+            uint64_t time = 0;
+            isOk = ParseUnsigned(time);
+            out_info.modificationTime = static_cast<int64_t>(time);
+        }
+        else if(m_Key == "hlnkc")
+            isOk = ParseBool(out_info.isHardLink);
+        else if(m_Key == "read_error")
+            isOk = ParseBool(out_info.hasReadError);
+        else if(m_Key == "notreg")
+            isOk = ParseBool(out_info.isNotRegular);
+        else if(m_Key == "excluded")
+        {
+            // Reason as string, e.g. "pattern" or "otherfs"
+            out_info.isExcluded = true;
+            isOk = SkipValue();
+        }
+        else
+            isOk = SkipValue();
+        
+        if(!isOk)
+            return false;
+        
+        SkipWhitespace();
+        const int32_t c = Get();
+        
+        if(c == '}')
+            return true;
+        
+        if(c != ',')
+            return Fail("Expected ',' or '}'");
+    }
+}
+
+bool NcduImporter::Refill()
+{
+    m_Offset += m_End;
+    m_Position = 0;
+    m_End = std::fread(m_Buffer.data(), 1, m_Buffer.size(), m_File);
+    
+    return m_End > 0;
+}
+
+int32_t NcduImporter::Peek()
+{
+    if(m_Position == m_End && !Refill())
+        return EOF;
+    
+    return static_cast<uint8_t>(m_Buffer[m_Position]);
+}
+
+int32_t NcduImporter::Get()
+{
+    if(m_Position == m_End && !Refill())
+        return EOF;
+    
+    return static_cast<uint8_t>(m_Buffer[m_Position++]);
+}
+
+void NcduImporter::SkipWhitespace()
+{
+    while(true)
+    {
+        const int32_t c = Peek();
+        
+        if(c != ' ' && c != '\n' && c != '\r' && c != '\t')
+            return;
+        
+        m_Position++;
+    }
+}
+
+bool NcduImporter::Expect(const char expected)
+{
+    SkipWhitespace();
+    
+    if(Get() != static_cast<uint8_t>(expected))
+        return Fail(std::string("Expected '") + expected + "'");
+    
+    return true;
+}
+
+bool NcduImporter::Fail(const std::string& message)
+{
+    // Position of the last character read
+    const uint64_t offset = m_Offset + m_Position;
+    m_LastErrorMessage = message + " at byte " + std::to_string(offset > 0 ? offset - 1 : 0);
+    
+    return false;
+}
+
+bool NcduImporter::ParseString(std::string& out_string)
+{
+    out_string.clear();
+    
+    if(Get() != '"')
+        return Fail("Expected string");
+    
+    while(true)
+    {
+        if(m_Position == m_End && !Refill())
+            return Fail("Unterminated string");
+        
+        // Copy everything up to the next quote or escape at once
+        const char* const start = m_Buffer.data() + m_Position;
+        const char* const end = m_Buffer.data() + m_End;
+        const char* current = start;
+        
+        while(current < end && *current != '"' && *current != '\\')
+            current++;
+        
+        out_string.append(start, current);
+        m_Position += static_cast<std::size_t>(current - start);
+        
+        if(current == end)
+            continue;
+        
+        if(Get() == '"')
+            return true;
+        
+        const int32_t c = Get();
+        switch(c)
+        {
+            case '"':
+            case '\\':
+            case '/': out_string += static_cast<char>(c); break;
+            case 'b': out_string += '\b'; break;
+            case 'f': out_string += '\f'; break;
+            case 'n': out_string += '\n'; break;
+            case 'r': out_string += '\r'; break;
+            case 't': out_string += '\t'; break;
+            case 'u':
+            {
+                auto parseHex = [this](uint32_t& out_value)
+                {
+                    out_value = 0;
+                    
+                    for(int32_t i = 0; i < 4; i++)
+                    {
+                        const int32_t digit = Get();
+                        out_value <<= 4;
+                        
+                        if(digit >= '0' && digit <= '9')
+                            out_value |= static_cast<uint32_t>(digit - '0');
+                        else if(digit >= 'a' && digit <= 'f')
+                            out_value |= static_cast<uint32_t>(digit - 'a' + 10);
+                        else if(digit >= 'A' && digit <= 'F')
+                            out_value |= static_cast<uint32_t>(digit - 'A' + 10);
+                        else
+                            return false;
+                    }
+                    
+                    return true;
+                };
+                
+                uint32_t codePoint = 0;
+                if(!parseHex(codePoint))
+                    return Fail("Invalid \\u escape");
+                
+                // Surrogate pair
+                if(codePoint >= 0xD800 && codePoint <= 0xDBFF && Peek() == '\\')
+                {
+                    Get();
+                    uint32_t low = 0;
+                    
+                    if(Get() != 'u' || !parseHex(low) || low < 0xDC00 || low > 0xDFFF)
+                        return Fail("Invalid surrogate pair");
+                    
+                    codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                }
+                
+                // Encode as UTF-8
+                if(codePoint < 0x80)
+                {
+                    out_string += static_cast<char>(codePoint);
+                }
+                else if(codePoint < 0x800)
+                {
+                    out_string += static_cast<char>(0xC0 | (codePoint >> 6));
+                    out_string += static_cast<char>(0x80 | (codePoint & 0x3F));
+                }
+                else if(codePoint < 0x10000)
+                {
+                    out_string += static_cast<char>(0xE0 | (codePoint >> 12));
+                    out_string += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+                    out_string += static_cast<char>(0x80 | (codePoint & 0x3F));
+                }
+                else
+                {
+                    out_string += static_cast<char>(0xF0 | (codePoint >> 18));
+                    out_string += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+                    out_string += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+                    out_string += static_cast<char>(0x80 | (codePoint & 0x3F));
+                }
+                
+                break;
+            }
+            default:
+                return Fail("Invalid escape sequence");
+        }
+    }
+}
+
+bool NcduImporter::ParseNumber(uint64_t& out_number, bool& out_isNegative)
+{
+    out_number = 0;
+    out_isNegative = false;
+    
+    if(Peek() == '-')
+    {
+        Get();
+        out_isNegative = true;
+    }
+    
+    int32_t c = Peek();
+    if(c < '0' || c > '9')
+        return Fail("Expected number");
+    
+    while(c >= '0' && c <= '9')
+    {
+        out_number = out_number * 10 + static_cast<uint64_t>(c - '0');
+        m_Position++;
+        c = Peek();
+    }
+    
+    // Fraction and exponent are not used by ncdu, skip them
+    while(c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-' || (c >= '0' && c <= '9'))
+    {
+        m_Position++;
+        c = Peek();
+    }
+    
+    return true;
+}
+
+bool NcduImporter::ParseUnsigned(uint64_t& out_number)
+{
+    SkipWhitespace();
+    
+    bool isNegative = false;
+    if(!ParseNumber(out_number, isNegative))
+        return false;
+    
+    if(isNegative)
+        out_number = 0;
+    
+    return true;
+}
+
+bool NcduImporter::ParseBool(bool& out_value)
+{
+    const int32_t c = Get();
+    
+    if(c == 't' && Get() == 'r' && Get() == 'u' && Get() == 'e')
+        out_value = true;
+    else if(c == 'f' && Get() == 'a' && Get() == 'l' && Get() == 's' && Get() == 'e')
+        out_value = false;
+    else
+        return Fail("Expected true or false");
+    
+    return true;
+}
+
+bool NcduImporter::SkipValue()
+{
+    // Nesting of arrays and objects
+    std::size_t depth = 0;
+    
+    do
+    {
+        SkipWhitespace();
+        const int32_t c = Peek();
+        
+        if(c == '"')
+        {
+            if(!ParseString(m_Key))
+                return false;
+        }
+        else if(c == '{' || c == '[')
+        {
+            Get();
+            depth++;
+            continue;
+        }
+        else if(c == '}' || c == ']')
+        {
+            if(depth == 0)
+                return Fail("Unexpected closing bracket");
+            
+            Get();
+            depth--;
+        }
+        else if(c == '-' || (c >= '0' && c <= '9'))
+        {
+            uint64_t number = 0;
+            bool isNegative = false;
+            
+            if(!ParseNumber(number, isNegative))
+                return false;
+        }
+        else if(c == 't' || c == 'f')
+        {
+            bool value = false;
+            if(!ParseBool(value))
+                return false;
+        }
+        else if(c == 'n')
+        {
+            if(Get() != 'n' || Get() != 'u' || Get() != 'l' || Get() != 'l')
+                return Fail("Expected null");
+        }
+        else
+        {
+            return Fail("Unexpected character");
+        }
+        
+        // Separators inside of a skipped container
+        if(depth > 0)
+        {
+            SkipWhitespace();
+            if(Peek() == ',' || Peek() == ':')
+                Get();
+        }
+    }
+    while(depth > 0);
+    
+    return true;
+}
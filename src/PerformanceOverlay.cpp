@@ -0,0 +1,202 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  PerformanceOverlay.cpp                                          */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#include "Main.hpp"
+
+namespace
+{
+    std::string FormatMilliseconds(const PerformanceOverlay::Clock::duration duration)
+    {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.2f ms", std::chrono::duration<double, std::milli>(duration).count());
+        
+        return buffer;
+    }
+    
+    std::string FormatRate(const uint64_t count, const double seconds)
+    {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.0f/s", (seconds > 0.0) ? static_cast<double>(count) / seconds : 0.0);
+        
+        return buffer;
+    }
+}
+
+void PerformanceOverlay::Toggle()
+{
+    m_IsVisible = !m_IsVisible;
+    
+    // Start over, so the first sample follows the first frame
+    m_FrameCount = 0;
+    m_FrameTime = Clock::duration::zero();
+    m_MaxFrameTime = Clock::duration::zero();
+    m_InputCount = 0;
+    m_InputLatency = Clock::duration::zero();
+    m_MaxInputLatency = Clock::duration::zero();
+    m_IsInputPending = false;
+    m_SampleTime = Clock::time_point();
+    m_ScanSample = ScanProgress::Sample();
+    m_Lines.clear();
+}
+
+void PerformanceOverlay::OnInput() noexcept
+{
+    if(m_IsInputPending)
+        return;
+    
+    m_PendingInputTime = Clock::now();
+    m_IsInputPending = true;
+}
+
+bool PerformanceOverlay::OnFrame(const Clock::time_point frameStart) noexcept
+{
+    const Clock::time_point now = Clock::now();
+    const Clock::duration frameTime = now - frameStart;
+    
+    m_FrameCount++;
+    m_FrameTime += frameTime;
+    m_MaxFrameTime = std::max(m_MaxFrameTime, frameTime);
+    
+    if(m_IsInputPending)
+    {
+        const Clock::duration latency = now - m_PendingInputTime;
+        
+        m_InputCount++;
+        m_InputLatency += latency;
+        m_MaxInputLatency = std::max(m_MaxInputLatency, latency);
+        m_IsInputPending = false;
+    }
+    
+    // The first sample is only the base of the rates
+    return m_SampleTime == Clock::time_point() || now - m_SampleTime >= SAMPLE_INTERVAL;
+}
+
+void PerformanceOverlay::Sample(const ScanProgress& progress, const MemoryAccounting& memory)
+{
+    const Clock::time_point now = Clock::now();
+    
+    ScanProgress::Sample scanSample;
+    progress.GetSample(scanSample);
+    
+    if(m_SampleTime == Clock::time_point())
+    {
+        m_SampleTime = now;
+        m_ScanSample = std::move(scanSample);
+        return;
+    }
+    
+    const double seconds = std::chrono::duration<double>(now - m_SampleTime).count();
+    
+    // Counters start over with every scan, rates are only taken against the same one
+    const bool isSameScan = (m_ScanSample.workers.size() == scanSample.workers.size());
+    
+    m_Lines.clear();
+    m_Lines.push_back("Frame:     " + FormatMilliseconds(m_FrameCount ? m_FrameTime / static_cast<Clock::rep>(m_FrameCount) : Clock::duration::zero()) + " avg, " + FormatMilliseconds(m_MaxFrameTime) + " max");
+    m_Lines.push_back("Redraws:   " + FormatRate(m_FrameCount, seconds));
+    m_Lines.push_back(m_InputCount ? "Input:     " + FormatMilliseconds(m_InputLatency / static_cast<Clock::rep>(m_InputCount)) + " avg, " + FormatMilliseconds(m_MaxInputLatency) + " max"
+                                   : std::string("Input:     -"));
+    
+    if(scanSample.isRunning || m_ScanSample.isRunning)
+    {
+        m_Lines.push_back("Queued:    " + std::to_string(scanSample.queuedDirectories) + " directories");
+        
+        uint64_t directoryCount = 0;
+        uint64_t entryCount = 0;
+        
+        for(std::size_t i = 0; i < scanSample.workers.size(); i++)
+        {
+            const ScanProgress::Worker& worker = scanSample.workers[i];
+            const ScanProgress::Worker previous = (isSameScan && worker.entryCount >= m_ScanSample.workers[i].entryCount) ? m_ScanSample.workers[i] : ScanProgress::Worker();
+            
+            directoryCount += worker.directoryCount - previous.directoryCount;
+            entryCount += worker.entryCount - previous.entryCount;
+            
+            if(i < MAX_WORKER_LINES)
+            {
+                m_Lines.push_back("Worker " + Format::PadLeft(std::to_string(i), 2) + ": " + FormatRate(worker.directoryCount - previous.directoryCount, seconds)
+                                  + " dirs, " + FormatRate(worker.entryCount - previous.entryCount, seconds) + " entries");
+            }
+        }
+        
+        if(scanSample.workers.size() > MAX_WORKER_LINES)
+            m_Lines.push_back("  and " + std::to_string(scanSample.workers.size() - MAX_WORKER_LINES) + " more workers");
+        
+        m_Lines.push_back("Scan:      " + FormatRate(directoryCount, seconds) + " dirs, " + FormatRate(entryCount, seconds) + " entries");
+    }
+    
+    // Memory by data structure, empty ones are left out
+    m_Lines.push_back("Resident:  " + Format::HumanReadableSize(ProcessStats::GetResidentBytes()));
+    m_Lines.push_back("Heap:      " + Format::HumanReadableSize(memory.GetHeapBytes()) + " accounted");
+    
+    for(const MemoryAccounting::Item& i : memory.GetItems())
+    {
+        if(i.bytes == 0)
+            continue;
+        
+        std::string name = "  " + i.name + (i.isMapped ? " (mapped)" : "");
+        name.resize(std::max<std::size_t>(name.size(), 22), ' ');
+        
+        m_Lines.push_back(name + Format::PadLeft(Format::HumanReadableSize(i.bytes), 11));
+    }
+    
+    m_FrameCount = 0;
+    m_FrameTime = Clock::duration::zero();
+    m_MaxFrameTime = Clock::duration::zero();
+    m_InputCount = 0;
+    m_InputLatency = Clock::duration::zero();
+    m_MaxInputLatency = Clock::duration::zero();
+    m_SampleTime = now;
+    m_ScanSample = std::move(scanSample);
+}
+
+ftxui::Element PerformanceOverlay::Render() const
+{
+    using namespace ftxui;
+    
+    Elements lines;
+    
+    if(m_Lines.empty())
+        lines.push_back(text("Sampling..."));
+    
+    for(const std::string& i : m_Lines)
+        lines.push_back(text(i));
+    
+    // Top right corner, over whatever is drawn below
+    return vbox({
+                hbox({
+                    filler(),
+                    window(text("Performance") | ftxui::bold, vbox(std::move(lines))) | clear_under
+                }),
+                filler()
+        });
+}
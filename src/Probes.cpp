@@ -0,0 +1,65 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  Probes.cpp                                                      */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#include "DirStatsCore.hpp"
+
+#ifdef DST_USDT_PROBES
+// Semaphores of the probes, in the section tracers look for them
+#define DST_PROBE_SEMAPHORE(name) volatile unsigned short dirstats_##name##_semaphore __attribute__((unused, section(".probes"))) = 0
+
+extern "C"
+{
+    DST_PROBE_SEMAPHORE(directory_open);
+    DST_PROBE_SEMAPHORE(directory_close);
+    DST_PROBE_SEMAPHORE(entry_batch);
+    DST_PROBE_SEMAPHORE(stat_latency);
+    DST_PROBE_SEMAPHORE(scan_error);
+    DST_PROBE_SEMAPHORE(scan_phase);
+    DST_PROBE_SEMAPHORE(ui_frame);
+}
+#endif
+
+bool Probes::IsUIFrameEnabled() noexcept
+{
+    return DST_PROBE_ENABLED(ui_frame);
+}
+
+void Probes::UIFrame(const uint64_t frame, const uint64_t nanoseconds) noexcept
+{
+    DST_PROBE2(ui_frame, frame, nanoseconds);
+}
+
+void Probes::ScanPhase(const char* const phase, const char* const path) noexcept
+{
+    DST_PROBE2(scan_phase, phase, path);
+}
@@ -0,0 +1,115 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  ProcessStats.cpp                                                */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#include "DirStatsCore.hpp"
+
+namespace
+{
+#ifdef PLATFORM_LINUX
+    // Value of a "Key: 123 kB" line of /proc/self/status in bytes, 0 if missing
+    uint64_t GetProcessStatusBytes(const std::string_view key) noexcept
+    {
+        std::FILE* const stream = std::fopen("/proc/self/status", "r");
+        if(!stream)
+            return 0;
+        
+        uint64_t bytes = 0;
+        char line[256];
+        
+        while(std::fgets(line, sizeof(line), stream))
+        {
+            const std::string_view lineView(line);
+            if(lineView.size() > key.size() && lineView.starts_with(key) && lineView[key.size()] == ':')
+            {
+                bytes = std::strtoull(line + key.size() + 1, nullptr, 10) * 1024;
+                break;
+            }
+        }
+        
+        std::fclose(stream);
+        return bytes;
+    }
+#endif
+}
+
+uint64_t ProcessStats::GetResidentBytes() noexcept
+{
+#ifdef PLATFORM_LINUX
+    return GetProcessStatusBytes("VmRSS");
+#else
+    return 0;
+#endif
+}
+
+uint64_t ProcessStats::GetPeakResidentBytes() noexcept
+{
+    uint64_t peakBytes = 0;
+    
+#ifdef PLATFORM_LINUX
+    peakBytes = GetProcessStatusBytes("VmHWM");
+#endif
+    
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_APPLE)
+    if(peakBytes == 0)
+    {
+        rusage usage;
+        if(getrusage(RUSAGE_SELF, &usage) == 0)
+        {
+#ifdef PLATFORM_APPLE
+            peakBytes = static_cast<uint64_t>(usage.ru_maxrss);
+#else
+            peakBytes = static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+        }
+    }
+#endif
+    
+    return peakBytes;
+}
+
+void ProcessStats::ResetPeakResidentBytes() noexcept
+{
+#ifdef PLATFORM_LINUX
+#ifdef __GLIBC__
+    // Memory freed before would still count as resident
+    malloc_trim(0);
+#endif
+    
+    std::FILE* const stream = std::fopen("/proc/self/clear_refs", "w");
+    if(stream)
+    {
+        std::fputs("5", stream);
+        std::fclose(stream);
+    }
+#endif
+}
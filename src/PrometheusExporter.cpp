@@ -0,0 +1,188 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  PrometheusExporter.cpp                                          */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#include "DirStatsCore.hpp"
+
+void PrometheusExporter::AppendLabel(std::string& out, const std::string_view path)
+{
+    // Backslash, double quote and line feed are escaped in label values. The textfile
+    // collector rejects the whole file for invalid UTF-8, such bytes are written as \xNN.
+    static const char* const hexDigits = "0123456789abcdef";
+    out += "{path=\"";
+    
+    for(std::size_t i = 0; i < path.size(); i++)
+    {
+        const char c = path[i];
+        
+        if(c == '\\')
+            out += "\\\\";
+        else if(c == '"')
+            out += "\\\"";
+        else if(c == '\n')
+            out += "\\n";
+        else if(static_cast<uint8_t>(c) < 0x80)
+            out += c;
+        else if(const std::size_t length = Format::GetUtf8SequenceLength(path, i); length > 0)
+        {
+            out.append(path.substr(i, length));
+            i += length - 1;
+        }
+        else
+        {
+            out += "\\\\x";
+            out += hexDigits[static_cast<uint8_t>(c) >> 4];
+            out += hexDigits[static_cast<uint8_t>(c) & 0x0F];
+        }
+    }
+    
+    out += "\"}";
+}
+
+bool PrometheusExporter::Write(const DirectoryTree& tree, const FileSystem::Path& file, const ScanInfo& info)
+{
+    const DirectoryTree::NodeIndex root = tree.GetRoot();
+    if(root == DirectoryTree::INVALID_NODE)
+    {
+        m_LastErrorMessage = "Nothing scanned";
+        return false;
+    }
+    
+    // All samples of a metric are grouped, collect them separately
+    std::string bytes = "# HELP dirstats_bytes Apparent size of the directory in bytes.\n# TYPE dirstats_bytes gauge\n";
+    std::string allocatedBytes = "# HELP dirstats_allocated_bytes Size of the directory on disk in bytes.\n# TYPE dirstats_allocated_bytes gauge\n";
+    std::string files = "# HELP dirstats_files Number of entries below the directory.\n# TYPE dirstats_files gauge\n";
+    
+    struct Frame
+    {
+        DirectoryTree::NodeIndex    node = DirectoryTree::INVALID_NODE;
+        uint32_t                    depth = 0;
+        std::string                 path = "";
+    };
+    
+    std::vector<Frame> stack;
+    stack.push_back({root, 0, tree.GetPath(root).generic_string()});
+    
+    uintmax_t errorCount = 0;
+    std::vector<DirectoryTree::NodeIndex> children;
+    
+    while(!stack.empty())
+    {
+        const Frame frame = std::move(stack.back());
+        stack.pop_back();
+        
+        const DirectoryTree::Node& node = tree.GetNode(frame.node);
+        
+        AppendLabel(bytes += "dirstats_bytes", frame.path);
+        bytes += " " + std::to_string(node.size) + "\n";
+        AppendLabel(allocatedBytes += "dirstats_allocated_bytes", frame.path);
+        allocatedBytes += " " + std::to_string(node.allocatedSize) + "\n";
+        AppendLabel(files += "dirstats_files", frame.path);
+        files += " " + std::to_string(node.count) + "\n";
+        
+        // Subdirectories are never larger than their parent, stop below the size
+        children.clear();
+        tree.GetChildren(frame.node, children);
+        
+        for(const DirectoryTree::NodeIndex child : children)
+        {
+            const DirectoryTree::Node& childNode = tree.GetNode(child);
+            if(childNode.type != DirectoryTree::NodeType::DIRECTORY || (frame.depth + 1 > m_MaxDepth && childNode.size < m_MinSize))
+                continue;
+            
+            const std::string separator = frame.path.ends_with('/') ? "" : "/";
+            stack.push_back({child, frame.depth + 1, frame.path + separator + std::string(tree.GetName(child))});
+        }
+    }
+    
+    // Directories not readable completely, in the whole tree
+    for(std::size_t i = 0; i < tree.GetNodeCount(); i++)
+    {
+        const DirectoryTree::Node& node = tree.GetNode(static_cast<DirectoryTree::NodeIndex>(i));
+        if(node.hasError && !node.isRemoved)
+            errorCount++;
+    }
+    
+    std::string output = std::move(bytes);
+    output += allocatedBytes;
+    output += files;
+    
+    output += "# HELP dirstats_scan_errors Directories that could not be read completely in the last scan.\n# TYPE dirstats_scan_errors gauge\n";
+    output += "dirstats_scan_errors " + std::to_string(errorCount) + "\n";
+    output += "# HELP dirstats_scan_timestamp_seconds End of the last scan.\n# TYPE dirstats_scan_timestamp_seconds gauge\n";
+    output += "dirstats_scan_timestamp_seconds " + std::to_string(info.time) + "\n";
+    
+    if(info.durationSeconds >= 0.0)
+    {
+        char duration[32];
+        std::snprintf(duration, sizeof(duration), "%.3f", info.durationSeconds);
+        
+        output += "# HELP dirstats_scan_duration_seconds Duration of the last scan.\n# TYPE dirstats_scan_duration_seconds gauge\n";
+        output += "dirstats_scan_duration_seconds " + std::string(duration) + "\n";
+    }
+    
+    // In the same directory, so the rename is atomic. The collector only reads *.prom files.
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_APPLE)
+    const std::string temporaryFile = file.string() + ".tmp." + std::to_string(getpid());
+#else
+    const std::string temporaryFile = file.string() + ".tmp";
+#endif
+    
+    std::FILE* const outputFile = std::fopen(temporaryFile.c_str(), "wb");
+    if(!outputFile)
+    {
+        m_LastErrorMessage = "Can't create " + temporaryFile + ": " + std::strerror(errno);
+        return false;
+    }
+    
+    const bool isWritten = (std::fwrite(output.data(), 1, output.size(), outputFile) == output.size());
+    const bool isClosed = (std::fclose(outputFile) == 0);
+    
+    if(!isWritten || !isClosed)
+    {
+        m_LastErrorMessage = "Can't write " + temporaryFile + ": " + std::strerror(errno);
+        std::remove(temporaryFile.c_str());
+        return false;
+    }
+    
+    std::error_code error;
+    std::filesystem::rename(temporaryFile, file, error);
+    
+    if(error)
+    {
+        m_LastErrorMessage = "Can't rename " + temporaryFile + " to " + file.string() + ": " + error.message();
+        std::remove(temporaryFile.c_str());
+        return false;
+    }
+    
+    return true;
+}
@@ -0,0 +1,81 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  ScanProgress.cpp                                                */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#include "DirStatsCore.hpp"
+
+void ScanProgress::StartScan(const std::size_t threadCount) noexcept
+{
+    for(WorkerCounters& i : m_Workers)
+    {
+        i.directoryCount.store(0, std::memory_order_relaxed);
+        i.entryCount.store(0, std::memory_order_relaxed);
+    }
+    
+    m_QueuedDirectories.store(0, std::memory_order_relaxed);
+    m_WorkerCount = std::clamp<std::size_t>(threadCount, 1, MAX_WORKER_COUNT);
+    m_IsRunning = true;
+}
+
+void ScanProgress::StopScan() noexcept
+{
+    m_IsRunning = false;
+}
+
+void ScanProgress::OnDirectoryRead(const uint64_t entryCount) noexcept
+{
+    // The starting directory is read by the calling thread, it counts to the last worker
+    const std::size_t workerCount = m_WorkerCount.load(std::memory_order_relaxed);
+    const std::size_t index = std::min(ThreadPool::GetCurrentWorkerIndex(), workerCount - 1);
+    
+    WorkerCounters& worker = m_Workers[index];
+    worker.directoryCount.fetch_add(1, std::memory_order_relaxed);
+    worker.entryCount.fetch_add(entryCount, std::memory_order_relaxed);
+}
+
+void ScanProgress::GetSample(Sample& out_sample) const
+{
+    const std::size_t workerCount = m_WorkerCount;
+    
+    out_sample.time = std::chrono::steady_clock::now();
+    out_sample.workers.resize(workerCount);
+    
+    for(std::size_t i = 0; i < workerCount; i++)
+    {
+        out_sample.workers[i].directoryCount = m_Workers[i].directoryCount.load(std::memory_order_relaxed);
+        out_sample.workers[i].entryCount = m_Workers[i].entryCount.load(std::memory_order_relaxed);
+    }
+    
+    // Started directories are counted down before they were counted up by another worker sometimes
+    out_sample.queuedDirectories = static_cast<uint64_t>(std::max<int64_t>(m_QueuedDirectories.load(std::memory_order_relaxed), 0));
+    out_sample.isRunning = m_IsRunning;
+}
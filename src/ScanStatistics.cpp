@@ -0,0 +1,507 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  ScanStatistics.cpp                                              */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#include "DirStatsCore.hpp"
+
+namespace
+{
+    // Counters of the scan job running on this thread
+    thread_local ScanStatistics::Counters* threadCounters = nullptr;
+    
+    // Counters of this thread in the statistics used last, saves the lock
+    thread_local uint64_t cachedStatisticsId = 0;
+    thread_local ScanStatistics::Counters* cachedCounters = nullptr;
+    
+    std::atomic<uint64_t> nextStatisticsId = 1;
+    
+    uint64_t GetNanosecondsSince(const std::chrono::steady_clock::time_point start) noexcept
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+    
+    void GetProcessTimes(double& out_userSeconds, double& out_systemSeconds) noexcept
+    {
+        out_userSeconds = 0.0;
+        out_systemSeconds = 0.0;
+        
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_APPLE)
+        rusage usage;
+        if(getrusage(RUSAGE_SELF, &usage) == 0)
+        {
+            out_userSeconds = static_cast<double>(usage.ru_utime.tv_sec) + static_cast<double>(usage.ru_utime.tv_usec) / 1e6;
+            out_systemSeconds = static_cast<double>(usage.ru_stime.tv_sec) + static_cast<double>(usage.ru_stime.tv_usec) / 1e6;
+        }
+#endif
+    }
+    
+    std::string FormatMilliseconds(const uint64_t nanoseconds)
+    {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.3f", static_cast<double>(nanoseconds) / 1e6);
+        return buffer;
+    }
+    
+    // Upper end of a latency bucket, e.g. "<= 64 us"
+    std::string GetBucketLabel(const std::size_t bucket)
+    {
+        if(bucket == 0)
+            return "< 1 us";
+        
+        if(bucket == ScanStatistics::LATENCY_BUCKET_COUNT - 1)
+            return ">= " + std::to_string(uint64_t(1) << (bucket - 1)) + " us";
+        
+        return "< " + std::to_string(uint64_t(1) << bucket) + " us";
+    }
+    
+    // Keeps the slowest directories first, at most SLOW_DIRECTORY_COUNT
+    void AddSlowDirectory(std::vector<ScanStatistics::Directory>& directories, const ScanStatistics::Directory& directory)
+    {
+        if(directories.size() == ScanStatistics::SLOW_DIRECTORY_COUNT && directories.back().nanoseconds >= directory.nanoseconds)
+            return;
+        
+        const auto position = std::upper_bound(directories.begin(), directories.end(), directory, [](const ScanStatistics::Directory& a, const ScanStatistics::Directory& b) { return a.nanoseconds > b.nanoseconds; });
+        directories.insert(position, directory);
+        
+        if(directories.size() > ScanStatistics::SLOW_DIRECTORY_COUNT)
+            directories.pop_back();
+    }
+}
+
+// *******************************************************************
+// Counters
+
+void ScanStatistics::Counters::AddPhase(const Phase phase, const uint64_t nanoseconds) noexcept
+{
+    PhaseCounters& counters = phases[static_cast<std::size_t>(phase)];
+    
+    counters.callCount++;
+    counters.nanoseconds += nanoseconds;
+    counters.maxNanoseconds = std::max(counters.maxNanoseconds, nanoseconds);
+    counters.latencyBuckets[GetLatencyBucket(nanoseconds)]++;
+}
+
+void ScanStatistics::Counters::AddDirectory(const std::string& path, const uint64_t device, const bool isMountRoot, const uint64_t nanoseconds, const uint64_t entryCount)
+{
+    // Only copies the path if it is among the slowest
+    if(slowestDirectories.size() < SLOW_DIRECTORY_COUNT || slowestDirectories.back().nanoseconds < nanoseconds)
+        AddSlowDirectory(slowestDirectories, {path, nanoseconds, entryCount});
+    
+    Mount& mount = mounts[device];
+    if(isMountRoot && (mount.path.empty() || path.size() < mount.path.size()))
+        mount.path = path;
+    
+    mount.directoryCount++;
+    mount.entryCount += entryCount;
+    mount.nanoseconds += nanoseconds;
+    mount.maxNanoseconds = std::max(mount.maxNanoseconds, nanoseconds);
+}
+
+void ScanStatistics::Counters::Add(const Counters& other)
+{
+    directoriesOpened += other.directoriesOpened;
+    entriesRead += other.entriesRead;
+    getdentsBytes += other.getdentsBytes;
+    busyNanoseconds += other.busyNanoseconds;
+    
+    for(const auto& [error, count] : other.errors)
+        errors[error] += count;
+    
+    for(std::size_t i = 0; i < phases.size(); i++)
+    {
+        phases[i].callCount += other.phases[i].callCount;
+        phases[i].nanoseconds += other.phases[i].nanoseconds;
+        phases[i].maxNanoseconds = std::max(phases[i].maxNanoseconds, other.phases[i].maxNanoseconds);
+        
+        for(std::size_t bucket = 0; bucket < LATENCY_BUCKET_COUNT; bucket++)
+            phases[i].latencyBuckets[bucket] += other.phases[i].latencyBuckets[bucket];
+    }
+    
+    for(const Directory& directory : other.slowestDirectories)
+        AddSlowDirectory(slowestDirectories, directory);
+    
+    for(const auto& [device, otherMount] : other.mounts)
+    {
+        Mount& mount = mounts[device];
+        if(!otherMount.path.empty() && (mount.path.empty() || otherMount.path.size() < mount.path.size()))
+            mount.path = otherMount.path;
+        
+        mount.directoryCount += otherMount.directoryCount;
+        mount.entryCount += otherMount.entryCount;
+        mount.nanoseconds += otherMount.nanoseconds;
+        mount.maxNanoseconds = std::max(mount.maxNanoseconds, otherMount.maxNanoseconds);
+    }
+}
+
+// *******************************************************************
+// Scopes
+
+ScanStatistics::ThreadScope::ThreadScope(ScanStatistics* const statistics)
+    : m_Counters(statistics ? &statistics->GetThreadCounters() : nullptr)
+    , m_PreviousCounters(threadCounters)
+{
+    threadCounters = m_Counters;
+    
+    if(m_Counters)
+        m_Start = std::chrono::steady_clock::now();
+}
+
+ScanStatistics::ThreadScope::~ThreadScope()
+{
+    if(m_Counters)
+        m_Counters->busyNanoseconds += GetNanosecondsSince(m_Start);
+    
+    threadCounters = m_PreviousCounters;
+}
+
+ScanStatistics::PhaseTimer::PhaseTimer(const Phase phase) noexcept
+    : m_Counters(threadCounters)
+    , m_Phase(phase)
+{
+    if(m_Counters)
+        m_Start = std::chrono::steady_clock::now();
+}
+
+ScanStatistics::PhaseTimer::~PhaseTimer()
+{
+    if(m_Counters)
+        m_Counters->AddPhase(m_Phase, GetNanosecondsSince(m_Start));
+}
+
+// *******************************************************************
+// Statistics
+
+ScanStatistics::ScanStatistics() noexcept
+    : m_Id(nextStatisticsId.fetch_add(1, std::memory_order_relaxed))
+{
+}
+
+ScanStatistics::Counters& ScanStatistics::GetThreadCounters()
+{
+    if(cachedStatisticsId == m_Id)
+        return *cachedCounters;
+    
+    std::lock_guard lock(m_Mutex);
+    
+    const std::thread::id id = std::this_thread::get_id();
+    auto threadCountersIt = std::find_if(m_ThreadCounters.begin(), m_ThreadCounters.end(), [id](const ThreadCounters& counters) { return counters.id == id; });
+    
+    if(threadCountersIt == m_ThreadCounters.end())
+    {
+        m_ThreadCounters.emplace_back().id = id;
+        threadCountersIt = std::prev(m_ThreadCounters.end());
+    }
+    
+    cachedStatisticsId = m_Id;
+    cachedCounters = &threadCountersIt->counters;
+    
+    return *cachedCounters;
+}
+
+void ScanStatistics::StartScan(const std::size_t threadCount) noexcept
+{
+    m_MaxThreadCount = std::max(m_MaxThreadCount, threadCount);
+    m_ScanStart = std::chrono::steady_clock::now();
+    GetProcessTimes(m_ScanStartUserSeconds, m_ScanStartSystemSeconds);
+}
+
+void ScanStatistics::StopScan() noexcept
+{
+    double userSeconds = 0.0;
+    double systemSeconds = 0.0;
+    GetProcessTimes(userSeconds, systemSeconds);
+    
+    m_ScanCount++;
+    m_WallSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - m_ScanStart).count();
+    m_UserSeconds += userSeconds - m_ScanStartUserSeconds;
+    m_SystemSeconds += systemSeconds - m_ScanStartSystemSeconds;
+}
+
+ScanStatistics::Counters ScanStatistics::GetTotal() const
+{
+    std::lock_guard lock(m_Mutex);
+    
+    Counters total;
+    for(const ThreadCounters& threadCounters : m_ThreadCounters)
+        total.Add(threadCounters.counters);
+    
+    return total;
+}
+
+void ScanStatistics::WriteText(std::ostream& out, const MemoryAccounting* const memory) const
+{
+    const Counters total = GetTotal();
+    
+    auto perSecond = [this](const uint64_t count)
+    {
+        return static_cast<uint64_t>(static_cast<double>(count) / std::max(m_WallSeconds, 1e-9));
+    };
+    
+    out << "Scan statistics" << "\n";
+    out << "  Wall time         " << FormatMilliseconds(static_cast<uint64_t>(m_WallSeconds * 1e9)) << " ms, " << m_ScanCount << " scan(s) with up to " << m_MaxThreadCount << " threads\n";
+    out << "  CPU time          " << FormatMilliseconds(static_cast<uint64_t>(m_UserSeconds * 1e9)) << " ms user, " << FormatMilliseconds(static_cast<uint64_t>(m_SystemSeconds * 1e9)) << " ms system\n";
+    out << "  Workers busy      " << FormatMilliseconds(total.busyNanoseconds) << " ms\n";
+    out << "  Directories       " << total.directoriesOpened << " (" << perSecond(total.directoriesOpened) << "/s)\n";
+    out << "  Entries           " << total.entriesRead << " (" << perSecond(total.entriesRead) << "/s)\n";
+    out << "  Stat calls        " << total.phases[static_cast<std::size_t>(Phase::STAT)].callCount << "\n";
+    out << "  getdents bytes    " << Format::HumanReadableSize(total.getdentsBytes) << "\n";
+    
+    // Errors
+    out << "\nErrors\n";
+    if(total.errors.empty())
+        out << "  none\n";
+    
+    for(const auto& [error, count] : total.errors)
+        out << Format::PadLeft(std::to_string(count), 10) << "  " << std::generic_category().message(error) << " (errno " << error << ")\n";
+    
+    // Phases with latency histograms
+    out << "\nPhase          Calls     Total ms      Avg us      Max ms\n";
+    for(std::size_t i = 0; i < total.phases.size(); i++)
+    {
+        const PhaseCounters& phase = total.phases[i];
+        
+        std::string name = GetPhaseName(static_cast<Phase>(i));
+        name.resize(10, ' ');
+        
+        const double average = phase.callCount ? static_cast<double>(phase.nanoseconds) / static_cast<double>(phase.callCount) / 1e3 : 0.0;
+        char averageText[32];
+        std::snprintf(averageText, sizeof(averageText), "%.2f", average);
+        
+        out << name << Format::PadLeft(std::to_string(phase.callCount), 10) << Format::PadLeft(FormatMilliseconds(phase.nanoseconds), 13)
+            << Format::PadLeft(averageText, 12) << Format::PadLeft(FormatMilliseconds(phase.maxNanoseconds), 12) << "\n";
+    }
+    
+    for(std::size_t i = 0; i < total.phases.size(); i++)
+    {
+        const PhaseCounters& phase = total.phases[i];
+        if(phase.callCount == 0)
+            continue;
+        
+        const uint64_t maxCount = *std::max_element(phase.latencyBuckets.begin(), phase.latencyBuckets.end());
+        
+        out << "\nLatency of " << GetPhaseName(static_cast<Phase>(i)) << "\n";
+        for(std::size_t bucket = 0; bucket < LATENCY_BUCKET_COUNT; bucket++)
+        {
+            if(phase.latencyBuckets[bucket] == 0)
+                continue;
+            
+            const std::size_t barLength = static_cast<std::size_t>(std::lround(static_cast<double>(phase.latencyBuckets[bucket]) / static_cast<double>(maxCount) * 40.0));
+            out << Format::PadLeft(GetBucketLabel(bucket), 14) << Format::PadLeft(std::to_string(phase.latencyBuckets[bucket]), 12) << "  " << std::string(barLength, '#') << "\n";
+        }
+    }
+    
+    // Where the time went
+    out << "\nSlowest directories      ms     Entries  Path\n";
+    for(const Directory& directory : total.slowestDirectories)
+        out << Format::PadLeft(FormatMilliseconds(directory.nanoseconds), 22) << Format::PadLeft(std::to_string(directory.entryCount), 12) << "  " << directory.path << "\n";
+    
+    std::vector<const Mount*> mounts;
+    for(const auto& [device, mount] : total.mounts)
+        mounts.push_back(&mount);
+    
+    std::sort(mounts.begin(), mounts.end(), [](const Mount* a, const Mount* b) { return a->nanoseconds > b->nanoseconds; });
+    
+    out << "\nMounts             Total ms      Max ms  Directories     Entries  Path\n";
+    for(const Mount* const mount : mounts)
+    {
+        out << Format::PadLeft(FormatMilliseconds(mount->nanoseconds), 24) << Format::PadLeft(FormatMilliseconds(mount->maxNanoseconds), 12)
+            << Format::PadLeft(std::to_string(mount->directoryCount), 13) << Format::PadLeft(std::to_string(mount->entryCount), 12) << "  " << mount->path << "\n";
+    }
+    
+    // Balance of the workers
+    std::lock_guard lock(m_Mutex);
+    
+    out << "\nThread      Busy ms  Directories     Entries\n";
+    for(std::size_t i = 0; i < m_ThreadCounters.size(); i++)
+    {
+        const Counters& counters = m_ThreadCounters[i].counters;
+        out << Format::PadLeft(std::to_string(i), 6) << Format::PadLeft(FormatMilliseconds(counters.busyNanoseconds), 13)
+            << Format::PadLeft(std::to_string(counters.directoriesOpened), 13) << Format::PadLeft(std::to_string(counters.entriesRead), 12) << "\n";
+    }
+    
+    if(memory)
+    {
+        out << "\n";
+        memory->WriteText(out);
+    }
+    
+    out << std::flush;
+}
+
+void ScanStatistics::WriteJson(std::ostream& out, const MemoryAccounting* const memory) const
+{
+    const Counters total = GetTotal();
+    
+    std::string json = "{\"scans\":" + std::to_string(m_ScanCount);
+    
+    auto appendNumber = [&json](const char* const name, const double value)
+    {
+        char buffer[64];
+        std::snprintf(buffer, sizeof(buffer), ",\"%s\":%.9g", name, value);
+        json += buffer;
+    };
+    
+    auto appendCount = [&json](const char* const name, const uint64_t value)
+    {
+        json += ",\"";
+        json += name;
+        json += "\":";
+        json += std::to_string(value);
+    };
+    
+    appendCount("max_threads", m_MaxThreadCount);
+    appendNumber("wall_seconds", m_WallSeconds);
+    appendNumber("user_seconds", m_UserSeconds);
+    appendNumber("system_seconds", m_SystemSeconds);
+    appendNumber("busy_seconds", static_cast<double>(total.busyNanoseconds) / 1e9);
+    appendCount("directories", total.directoriesOpened);
+    appendCount("entries", total.entriesRead);
+    appendCount("stat_calls", total.phases[static_cast<std::size_t>(Phase::STAT)].callCount);
+    appendCount("getdents_bytes", total.getdentsBytes);
+    
+    json += ",\"errors\":[";
+    for(const auto& [error, count] : total.errors)
+    {
+        if(json.back() != '[')
+            json += ',';
+        
+        json += "{\"errno\":" + std::to_string(error) + ",\"message\":";
+        Format::AppendJsonString(json, std::generic_category().message(error));
+        json += ",\"count\":" + std::to_string(count) + "}";
+    }
+    
+    // Bucket i of "latency_buckets" counts calls under 2^i µs
+    json += "],\"phases\":{";
+    for(std::size_t i = 0; i < total.phases.size(); i++)
+    {
+        const PhaseCounters& phase = total.phases[i];
+        
+        if(i > 0)
+            json += ',';
+        
+        Format::AppendJsonString(json, GetPhaseName(static_cast<Phase>(i)));
+        json += ":{\"calls\":" + std::to_string(phase.callCount);
+        appendNumber("seconds", static_cast<double>(phase.nanoseconds) / 1e9);
+        appendNumber("max_seconds", static_cast<double>(phase.maxNanoseconds) / 1e9);
+        json += ",\"latency_buckets\":[";
+        
+        for(std::size_t bucket = 0; bucket < LATENCY_BUCKET_COUNT; bucket++)
+        {
+            if(bucket > 0)
+                json += ',';
+            
+            json += std::to_string(phase.latencyBuckets[bucket]);
+        }
+        
+        json += "]}";
+    }
+    
+    json += "},\"slowest_directories\":[";
+    for(const Directory& directory : total.slowestDirectories)
+    {
+        if(json.back() != '[')
+            json += ',';
+        
+        json += "{\"path\":";
+        Format::AppendJsonString(json, directory.path);
+        appendNumber("seconds", static_cast<double>(directory.nanoseconds) / 1e9);
+        appendCount("entries", directory.entryCount);
+        json += '}';
+    }
+    
+    json += "],\"mounts\":[";
+    for(const auto& [device, mount] : total.mounts)
+    {
+        if(json.back() != '[')
+            json += ',';
+        
+        json += "{\"device\":" + std::to_string(device) + ",\"path\":";
+        Format::AppendJsonString(json, mount.path);
+        appendNumber("seconds", static_cast<double>(mount.nanoseconds) / 1e9);
+        appendNumber("max_seconds", static_cast<double>(mount.maxNanoseconds) / 1e9);
+        appendCount("directories", mount.directoryCount);
+        appendCount("entries", mount.entryCount);
+        json += '}';
+    }
+    
+    json += "],\"threads\":[";
+    {
+        std::lock_guard lock(m_Mutex);
+        
+        for(const ThreadCounters& threadCounters : m_ThreadCounters)
+        {
+            if(json.back() != '[')
+                json += ',';
+            
+            json += "{\"directories\":" + std::to_string(threadCounters.counters.directoriesOpened);
+            appendCount("entries", threadCounters.counters.entriesRead);
+            appendNumber("busy_seconds", static_cast<double>(threadCounters.counters.busyNanoseconds) / 1e9);
+            json += '}';
+        }
+    }
+    
+    json += ']';
+    
+    if(memory)
+    {
+        json += ",\"memory\":";
+        memory->AppendJson(json);
+    }
+    
+    json += '}';
+    out << json << std::endl;
+}
+
+ScanStatistics::Counters* ScanStatistics::GetCurrentCounters() noexcept
+{
+    return threadCounters;
+}
+
+std::size_t ScanStatistics::GetLatencyBucket(const uint64_t nanoseconds) noexcept
+{
+    return std::min<std::size_t>(static_cast<std::size_t>(std::bit_width(nanoseconds / 1000)), LATENCY_BUCKET_COUNT - 1);
+}
+
+const char* ScanStatistics::GetPhaseName(const Phase phase) noexcept
+{
+    switch(phase)
+    {
+        case Phase::OPEN:   return "open";
+        case Phase::LIST:   return "list";
+        case Phase::STAT:   return "stat";
+        case Phase::LINKS:  return "links";
+        case Phase::TREE:   return "tree";
+        case Phase::COUNT:  break;
+    }
+    
+    return "";
+}
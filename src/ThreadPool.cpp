@@ -0,0 +1,115 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  ThreadPool.cpp                                                  */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#include "DirStatsCore.hpp"
+
+namespace
+{
+    thread_local std::size_t threadWorkerIndex = ThreadPool::NO_WORKER;
+}
+
+ThreadPool::ThreadPool(const std::size_t threadCount)
+{
+    const std::size_t count = std::max<std::size_t>(threadCount, 1);
+    
+    for(std::size_t i = 0; i < count; i++)
+        m_Workers.emplace_back(&ThreadPool::WorkerTask, this, i);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard lock(m_Mutex);
+        m_Stop = true;
+        m_Jobs.clear();
+    }
+    
+    m_JobAvailable.notify_all();
+    
+    for(std::thread& i : m_Workers)
+        i.join();
+}
+
+void ThreadPool::WorkerTask(const std::size_t index)
+{
+    Tracer::SetThreadName("pool worker");
+    threadWorkerIndex = index;
+    
+    while(true)
+    {
+        std::function<void()> job;
+        
+        {
+            std::unique_lock lock(m_Mutex);
+            m_JobAvailable.wait(lock, [this] { return m_Stop || !m_Jobs.empty(); });
+            
+            if(m_Stop)
+                return;
+            
+            job = std::move(m_Jobs.front());
+            m_Jobs.pop_front();
+            m_RunningJobs++;
+        }
+        
+        job();
+        
+        {
+            std::lock_guard lock(m_Mutex);
+            m_RunningJobs--;
+            
+            if(m_Jobs.empty() && m_RunningJobs == 0)
+                m_Idle.notify_all();
+        }
+    }
+}
+
+void ThreadPool::Submit(std::function<void()> job)
+{
+    {
+        std::lock_guard lock(m_Mutex);
+        m_Jobs.push_back(std::move(job));
+    }
+    
+    m_JobAvailable.notify_one();
+}
+
+void ThreadPool::WaitIdle()
+{
+    std::unique_lock lock(m_Mutex);
+    m_Idle.wait(lock, [this] { return m_Jobs.empty() && m_RunningJobs == 0; });
+}
+
+std::size_t ThreadPool::GetCurrentWorkerIndex() noexcept
+{
+    return threadWorkerIndex;
+}
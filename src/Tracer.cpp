@@ -0,0 +1,253 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  Tracer.cpp                                                      */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#include "DirStatsCore.hpp"
+
+namespace
+{
+    struct Span
+    {
+        const char*         name = nullptr;
+        const char*         argumentName = nullptr;
+        uint64_t            argumentValue = 0;
+        uint64_t            start = 0;      // Nanoseconds since Enable()
+        uint64_t            duration = 0;
+        Tracer::Category    category = Tracer::Category::SCAN;
+    };
+    
+    // Written only by its thread, read when the trace is written
+    struct ThreadBuffer
+    {
+        uint32_t                threadId = 0;
+        const char*             threadName = nullptr;
+        std::vector<Span>       spans;
+        std::atomic<uint64_t>   writeCount = 0;
+    };
+    
+    std::atomic<bool> isEnabled = false;
+    std::atomic<uint64_t> traceGeneration = 0;
+    std::chrono::steady_clock::time_point traceStart;
+    
+    // Only locked when a thread records its first span of a trace
+    std::mutex bufferMutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> threadBuffers;
+    std::size_t spansPerBuffer = 0;
+    
+    thread_local std::shared_ptr<ThreadBuffer> threadBuffer;
+    thread_local uint64_t threadGeneration = 0;
+    thread_local const char* threadName = nullptr;
+    
+    uint64_t GetNanoseconds() noexcept
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - traceStart).count());
+    }
+    
+    // Buffer of the calling thread in the current trace, nullptr if out of memory
+    ThreadBuffer* GetThreadBuffer() noexcept
+    {
+        const uint64_t generation = traceGeneration.load(std::memory_order_acquire);
+        if(threadBuffer && threadGeneration == generation)
+            return threadBuffer.get();
+        
+        try {
+            std::shared_ptr<ThreadBuffer> buffer = std::make_shared<ThreadBuffer>();
+            buffer->threadName = threadName;
+            
+            std::lock_guard lock(bufferMutex);
+            
+            buffer->spans.resize(spansPerBuffer);
+            buffer->threadId = static_cast<uint32_t>(threadBuffers.size()) + 1;
+            threadBuffers.push_back(buffer);
+            
+            threadBuffer = std::move(buffer);
+            threadGeneration = generation;
+        }
+        catch (const std::bad_alloc&) {
+            return nullptr;
+        }
+        
+        return threadBuffer.get();
+    }
+    
+    void AppendMicroseconds(std::string& out, const uint64_t nanoseconds)
+    {
+        out += std::to_string(nanoseconds / 1000);
+        out += '.';
+        
+        const std::string fraction = std::to_string(nanoseconds % 1000);
+        out.append(3 - fraction.size(), '0');
+        out += fraction;
+    }
+}
+
+void Tracer::Enable(const std::size_t spansPerThread)
+{
+    std::lock_guard lock(bufferMutex);
+    
+    threadBuffers.clear();
+    spansPerBuffer = std::max<std::size_t>(spansPerThread, 1);
+    traceStart = std::chrono::steady_clock::now();
+    
+    traceGeneration.fetch_add(1, std::memory_order_release);
+    isEnabled.store(true, std::memory_order_release);
+}
+
+void Tracer::Disable() noexcept
+{
+    isEnabled.store(false, std::memory_order_release);
+}
+
+bool Tracer::IsEnabled() noexcept
+{
+    return isEnabled.load(std::memory_order_relaxed);
+}
+
+void Tracer::SetThreadName(const char* const name) noexcept
+{
+    threadName = name;
+}
+
+bool Tracer::WriteChromeTrace(const std::filesystem::path& path, std::string& out_errorMessage)
+{
+    std::FILE* const file = std::fopen(path.string().c_str(), "wb");
+    if(!file)
+    {
+        out_errorMessage = "Can't open " + path.string() + ": " + std::generic_category().message(errno);
+        return false;
+    }
+    
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+        std::lock_guard lock(bufferMutex);
+        buffers = threadBuffers;
+    }
+    
+    static constexpr const char* CATEGORY_NAMES[] = {"scan", "ui"};
+    
+    std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool isFirst = true;
+    bool isWritten = true;
+    
+    auto beginEvent = [&json, &isFirst]()
+    {
+        json += isFirst ? "\n" : ",\n";
+        isFirst = false;
+    };
+    
+    for(const std::shared_ptr<ThreadBuffer>& buffer : buffers)
+    {
+        const std::string threadId = std::to_string(buffer->threadId);
+        
+        // Name of the thread lane
+        beginEvent();
+        json += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + threadId + ",\"args\":{\"name\":";
+        Format::AppendJsonString(json, (buffer->threadName ? buffer->threadName : "thread ") + (buffer->threadName ? std::string() : threadId));
+        json += "}}";
+        
+        // Oldest span still in the ring first
+        const uint64_t writeCount = buffer->writeCount.load(std::memory_order_acquire);
+        const uint64_t capacity = buffer->spans.size();
+        
+        for(uint64_t i = (writeCount > capacity) ? writeCount - capacity : 0; i < writeCount; i++)
+        {
+            const Span& span = buffer->spans[static_cast<std::size_t>(i % capacity)];
+            
+            beginEvent();
+            json += "{\"name\":";
+            Format::AppendJsonString(json, span.name);
+            json += ",\"cat\":\"";
+            json += CATEGORY_NAMES[static_cast<std::size_t>(span.category)];
+            json += "\",\"ph\":\"X\",\"pid\":1,\"tid\":" + threadId + ",\"ts\":";
+            AppendMicroseconds(json, span.start);
+            json += ",\"dur\":";
+            AppendMicroseconds(json, span.duration);
+            
+            if(span.argumentName)
+            {
+                json += ",\"args\":{";
+                Format::AppendJsonString(json, span.argumentName);
+                json += ':' + std::to_string(span.argumentValue) + '}';
+            }
+            
+            json += '}';
+        }
+        
+        // Written in parts, a trace can have millions of spans
+        isWritten = isWritten && (std::fwrite(json.data(), 1, json.size(), file) == json.size());
+        json.clear();
+    }
+    
+    json += "\n]}\n";
+    isWritten = isWritten && (std::fwrite(json.data(), 1, json.size(), file) == json.size());
+    
+    const bool isClosed = (std::fclose(file) == 0);
+    if(!isWritten || !isClosed)
+    {
+        out_errorMessage = "Can't write " + path.string();
+        return false;
+    }
+    
+    return true;
+}
+
+Tracer::ScopedSpan::ScopedSpan(const Category category, const char* const name) noexcept
+{
+    if(!isEnabled.load(std::memory_order_relaxed))
+        return;
+    
+    m_Name = name;
+    m_Category = category;
+    m_Start = GetNanoseconds();
+}
+
+Tracer::ScopedSpan::~ScopedSpan()
+{
+    if(!m_Name)
+        return;
+    
+    ThreadBuffer* const buffer = GetThreadBuffer();
+    if(!buffer)
+        return;
+    
+    const uint64_t index = buffer->writeCount.load(std::memory_order_relaxed);
+    
+    Span& span = buffer->spans[static_cast<std::size_t>(index % buffer->spans.size())];
+    span.name = m_Name;
+    span.argumentName = m_ArgumentName;
+    span.argumentValue = m_ArgumentValue;
+    span.start = m_Start;
+    span.duration = GetNanoseconds() - m_Start;
+    span.category = m_Category;
+    
+    buffer->writeCount.store(index + 1, std::memory_order_release);
+}
@@ -0,0 +1,256 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  TreeDiff.cpp                                                    */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#include "DirStatsCore.hpp"
+
+void TreeDiff::Clear() noexcept
+{
+    m_Nodes.clear();
+    m_OldTree = nullptr;
+    m_NewTree = nullptr;
+}
+
+void TreeDiff::GetSortedChildren(const DirectoryTree& tree, const DirectoryTree::NodeIndex node, std::vector<DirectoryTree::NodeIndex>& out_children)
+{
+    out_children.clear();
+    tree.GetChildren(node, out_children);
+    
+    std::sort(out_children.begin(), out_children.end(), [&tree](const DirectoryTree::NodeIndex a, const DirectoryTree::NodeIndex b)
+    {
+        return tree.GetName(a) < tree.GetName(b);
+    });
+}
+
+void TreeDiff::AddNode(const NodeIndex parent, const DirectoryTree::NodeIndex oldNode, const DirectoryTree::NodeIndex newNode, const ChangeType change)
+{
+    // Node indices are 32 bit
+    if(m_Nodes.size() >= INVALID_NODE)
+        throw std::bad_alloc();
+    
+    Node node;
+    node.parent = parent;
+    node.oldNode = oldNode;
+    node.newNode = newNode;
+    node.change = change;
+    
+    const uintmax_t oldSize = (oldNode != DirectoryTree::INVALID_NODE) ? m_OldTree->GetNode(oldNode).size : 0;
+    const uintmax_t oldCount = (oldNode != DirectoryTree::INVALID_NODE) ? m_OldTree->GetNode(oldNode).count : 0;
+    const uintmax_t newSize = (newNode != DirectoryTree::INVALID_NODE) ? m_NewTree->GetNode(newNode).size : 0;
+    const uintmax_t newCount = (newNode != DirectoryTree::INVALID_NODE) ? m_NewTree->GetNode(newNode).count : 0;
+    
+    node.sizeDelta = static_cast<int64_t>(newSize - oldSize);
+    node.countDelta = static_cast<int64_t>(newCount - oldCount);
+    
+    // The entry itself counts as well
+    if(change == ChangeType::ADDED)
+    {
+        node.addedSize = newSize;
+        node.addedCount = newCount + 1;
+    }
+    else if(change == ChangeType::REMOVED)
+    {
+        node.removedSize = oldSize;
+        node.removedCount = oldCount + 1;
+    }
+    
+    m_Nodes.push_back(node);
+}
+
+void TreeDiff::Compute(const DirectoryTree& oldTree, const DirectoryTree& newTree)
+{
+    Clear();
+    
+    m_OldTree = &oldTree;
+    m_NewTree = &newTree;
+    
+    if(oldTree.GetRoot() == DirectoryTree::INVALID_NODE || newTree.GetRoot() == DirectoryTree::INVALID_NODE)
+        return;
+    
+    AddNode(INVALID_NODE, oldTree.GetRoot(), newTree.GetRoot(), ChangeType::CHANGED);
+    
+    // Directories in both trees whose children are still to be compared
+    std::vector<NodeIndex> pending = {0};
+    std::vector<DirectoryTree::NodeIndex> oldChildren;
+    std::vector<DirectoryTree::NodeIndex> newChildren;
+    
+    while(!pending.empty())
+    {
+        const NodeIndex current = pending.back();
+        pending.pop_back();
+        
+        GetSortedChildren(oldTree, m_Nodes[current].oldNode, oldChildren);
+        GetSortedChildren(newTree, m_Nodes[current].newNode, newChildren);
+        
+        // Children of a directory are stored contiguously, like in DirectoryTree
+        const NodeIndex firstChild = static_cast<NodeIndex>(m_Nodes.size());
+        
+        std::size_t i = 0;
+        std::size_t j = 0;
+        
+        while(i < oldChildren.size() || j < newChildren.size())
+        {
+            int32_t order = 0;
+            if(i == oldChildren.size())
+                order = 1;
+            else if(j == newChildren.size())
+                order = -1;
+            else
+                order = oldTree.GetName(oldChildren[i]).compare(newTree.GetName(newChildren[j]));
+            
+            if(order < 0)
+            {
+                AddNode(current, oldChildren[i++], DirectoryTree::INVALID_NODE, ChangeType::REMOVED);
+                continue;
+            }
+            
+            if(order > 0)
+            {
+                AddNode(current, DirectoryTree::INVALID_NODE, newChildren[j++], ChangeType::ADDED);
+                continue;
+            }
+            
+            const DirectoryTree::Node& oldNode = oldTree.GetNode(oldChildren[i]);
+            const DirectoryTree::Node& newNode = newTree.GetNode(newChildren[j]);
+            
+            // Same name, but e.g. a file replaced by a directory
+            if(oldNode.type != newNode.type)
+            {
+                AddNode(current, oldChildren[i++], DirectoryTree::INVALID_NODE, ChangeType::REMOVED);
+                AddNode(current, DirectoryTree::INVALID_NODE, newChildren[j++], ChangeType::ADDED);
+                continue;
+            }
+            
+            const bool isDirectory = (newNode.type == DirectoryTree::NodeType::DIRECTORY);
+            const bool isChanged = (oldNode.size != newNode.size) || (oldNode.allocatedSize != newNode.allocatedSize) || (oldNode.count != newNode.count)
+                                || (isDirectory && oldNode.lastWriteTime != newNode.lastWriteTime);
+            
+            if(isChanged)
+            {
+                if(isDirectory)
+                    pending.push_back(static_cast<NodeIndex>(m_Nodes.size()));
+                
+                AddNode(current, oldChildren[i], newChildren[j], ChangeType::CHANGED);
+            }
+            
+            i++;
+            j++;
+        }
+        
+        m_Nodes[current].firstChild = firstChild;
+        m_Nodes[current].childCount = static_cast<uint32_t>(m_Nodes.size() - firstChild);
+    }
+    
+    // Parents come before their children, sum up the added and removed entries bottom-up
+    for(std::size_t i = m_Nodes.size() - 1; i > 0; i--)
+    {
+        Node& parent = m_Nodes[m_Nodes[i].parent];
+        parent.addedSize += m_Nodes[i].addedSize;
+        parent.addedCount += m_Nodes[i].addedCount;
+        parent.removedSize += m_Nodes[i].removedSize;
+        parent.removedCount += m_Nodes[i].removedCount;
+    }
+}
+
+const DirectoryTree::Node& TreeDiff::GetTreeNode(const NodeIndex node) const noexcept
+{
+    const Node& current = m_Nodes[node];
+    
+    return (current.change == ChangeType::REMOVED) ? m_OldTree->GetNode(current.oldNode) : m_NewTree->GetNode(current.newNode);
+}
+
+std::string_view TreeDiff::GetName(const NodeIndex node) const noexcept
+{
+    const Node& current = m_Nodes[node];
+    
+    return (current.change == ChangeType::REMOVED) ? m_OldTree->GetName(current.oldNode) : m_NewTree->GetName(current.newNode);
+}
+
+std::filesystem::path TreeDiff::GetPath(const NodeIndex node) const
+{
+    const Node& current = m_Nodes[node];
+    
+    return (current.change == ChangeType::REMOVED) ? m_OldTree->GetPath(current.oldNode) : m_NewTree->GetPath(current.newNode);
+}
+
+uintmax_t TreeDiff::GetOldSize(const NodeIndex node) const noexcept
+{
+    const Node& current = m_Nodes[node];
+    
+    return (current.oldNode != DirectoryTree::INVALID_NODE) ? m_OldTree->GetNode(current.oldNode).size : 0;
+}
+
+uintmax_t TreeDiff::GetNewSize(const NodeIndex node) const noexcept
+{
+    const Node& current = m_Nodes[node];
+    
+    return (current.newNode != DirectoryTree::INVALID_NODE) ? m_NewTree->GetNode(current.newNode).size : 0;
+}
+
+void TreeDiff::GetChildren(const NodeIndex node, std::vector<NodeIndex>& out_children) const
+{
+    const Node& parent = m_Nodes[node];
+    const std::size_t start = out_children.size();
+    
+    for(uint32_t i = 0; i < parent.childCount; i++)
+        out_children.push_back(parent.firstChild + i);
+    
+    std::stable_sort(out_children.begin() + static_cast<std::ptrdiff_t>(start), out_children.end(), [this](const NodeIndex a, const NodeIndex b)
+    {
+        return m_Nodes[a].sizeDelta > m_Nodes[b].sizeDelta;
+    });
+}
+
+void TreeDiff::GetGrowthPath(NodeIndex node, const double minShare, std::vector<NodeIndex>& out_path) const
+{
+    while(node != INVALID_NODE && m_Nodes[node].sizeDelta > 0)
+    {
+        const Node& current = m_Nodes[node];
+        
+        NodeIndex largest = INVALID_NODE;
+        for(uint32_t i = 0; i < current.childCount; i++)
+        {
+            if(largest == INVALID_NODE || m_Nodes[current.firstChild + i].sizeDelta > m_Nodes[largest].sizeDelta)
+                largest = current.firstChild + i;
+        }
+        
+        if(largest == INVALID_NODE || m_Nodes[largest].sizeDelta <= 0)
+            break;
+        
+        const double share = static_cast<double>(m_Nodes[largest].sizeDelta) / static_cast<double>(current.sizeDelta);
+        if(share < minShare)
+            break;
+        
+        out_path.push_back(largest);
+        node = largest;
+    }
+}
@@ -0,0 +1,306 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  TreeSnapshot.cpp                                                */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#include "DirStatsCore.hpp"
+
+bool TreeSnapshot::IsValid(const Header& header, const uintmax_t fileSize) const noexcept
+{
+    const Header expected;
+    
+    if(std::memcmp(header.magic, expected.magic, sizeof(header.magic)) != 0 || header.version != expected.version
+       || header.headerSize != expected.headerSize || header.nodeSize != expected.nodeSize || header.byteOrder != expected.byteOrder)
+        return false;
+    
+    if(header.fileSize != fileSize || header.nodeCount >= DirectoryTree::INVALID_NODE || header.nameCount >= NamePool::INVALID_NAME)
+        return false;
+    
+    // Sections in order, aligned and inside of the file
+    if(header.nodesOffset < sizeof(Header) || header.nodesOffset > fileSize || header.nodesOffset % alignof(DirectoryTree::Node) != 0)
+        return false;
+    
+    if(header.nodeCount > (fileSize - header.nodesOffset) / sizeof(DirectoryTree::Node))
+        return false;
+    
+    if(header.nameOffsetsOffset != header.nodesOffset + header.nodeCount * sizeof(DirectoryTree::Node) || header.nameOffsetsOffset % alignof(uint64_t) != 0)
+        return false;
+    
+    if(header.nameCount + 1 > (fileSize - header.nameOffsetsOffset) / sizeof(uint64_t))
+        return false;
+    
+    return header.namesOffset == header.nameOffsetsOffset + (header.nameCount + 1) * sizeof(uint64_t);
+}
+
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_APPLE)
+TreeSnapshot::Mapping::~Mapping()
+{
+    if(data)
+        munmap(data, size);
+}
+
+bool TreeSnapshot::ReadHeader(const FileSystem::Path& file, Header& out_header) const
+{
+    const int fd = open(file.c_str(), O_RDONLY | O_CLOEXEC);
+    if(fd < 0)
+        return false;
+    
+    const bool isRead = (pread(fd, &out_header, sizeof(Header), 0) == static_cast<ssize_t>(sizeof(Header)));
+    close(fd);
+    
+    return isRead && std::memcmp(out_header.magic, Header().magic, sizeof(out_header.magic)) == 0;
+}
+
+bool TreeSnapshot::Publish(const DirectoryTree& tree, const FileSystem::Path& file)
+{
+    const NamePool& names = tree.GetNamePool();
+    
+    Header header;
+    Header previous;
+    header.generation = ReadHeader(file, previous) ? previous.generation + 1 : 1;
+    header.createdTime = static_cast<int64_t>(std::time(nullptr));
+    header.nodeCount = tree.GetNodeCount();
+    header.nameCount = names.GetCount();
+    header.nodesOffset = (sizeof(Header) + 63) / 64 * 64;
+    header.nameOffsetsOffset = header.nodesOffset + header.nodeCount * sizeof(DirectoryTree::Node);
+    header.namesOffset = header.nameOffsetsOffset + (header.nameCount + 1) * sizeof(uint64_t);
+    header.fileSize = header.namesOffset;
+    
+    for(NamePool::NameID i = 0; i < names.GetCount(); i++)
+        header.fileSize += names.Get(i).size();
+    
+    // In the same directory, so the rename is atomic
+    const std::string temporaryFile = file.string() + ".tmp." + std::to_string(getpid());
+    
+    const int fd = open(temporaryFile.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if(fd < 0)
+    {
+        m_LastErrorMessage = "Can't create " + temporaryFile + ": " + std::strerror(errno);
+        return false;
+    }
+    
+    auto writeAll = [&](const char* data, std::size_t size)
+    {
+        while(size > 0)
+        {
+            const ssize_t written = write(fd, data, size);
+            
+            if(written < 0 && errno == EINTR)
+                continue;
+            
+            if(written <= 0)
+            {
+                m_LastErrorMessage = "Can't write " + temporaryFile + ": " + std::strerror(errno);
+                return false;
+            }
+            
+            data += written;
+            size -= static_cast<std::size_t>(written);
+        }
+        
+        return true;
+    };
+    
+    std::string buffer(reinterpret_cast<const char*>(&header), sizeof(Header));
+    buffer.resize(static_cast<std::size_t>(header.nodesOffset), '\0');
+    bool isOk = writeAll(buffer.data(), buffer.size());
+    
+    // Nodes are stored contiguously, write them straight from the tree
+    if(isOk && header.nodeCount > 0)
+        isOk = writeAll(reinterpret_cast<const char*>(&tree.GetNode(0)), static_cast<std::size_t>(header.nodeCount) * sizeof(DirectoryTree::Node));
+    
+    // Name offsets, then the names
+    buffer.clear();
+    uint64_t offset = 0;
+    
+    for(std::size_t i = 0; i <= names.GetCount() && isOk; i++)
+    {
+        buffer.append(reinterpret_cast<const char*>(&offset), sizeof(offset));
+        
+        if(i < names.GetCount())
+            offset += names.Get(static_cast<NamePool::NameID>(i)).size();
+        
+        if(buffer.size() >= CHUNK_SIZE)
+        {
+            isOk = writeAll(buffer.data(), buffer.size());
+            buffer.clear();
+        }
+    }
+    
+    for(std::size_t i = 0; i < names.GetCount() && isOk; i++)
+    {
+        buffer += names.Get(static_cast<NamePool::NameID>(i));
+        
+        if(buffer.size() >= CHUNK_SIZE)
+        {
+            isOk = writeAll(buffer.data(), buffer.size());
+            buffer.clear();
+        }
+    }
+    
+    if(isOk)
+        isOk = writeAll(buffer.data(), buffer.size());
+    
+    if(close(fd) != 0 && isOk)
+    {
+        m_LastErrorMessage = "Can't write " + temporaryFile + ": " + std::strerror(errno);
+        isOk = false;
+    }
+    
+    // Readers of the old snapshot keep their mapping of the replaced file
+    if(isOk && rename(temporaryFile.c_str(), file.c_str()) != 0)
+    {
+        m_LastErrorMessage = "Can't replace " + file.string() + ": " + std::strerror(errno);
+        isOk = false;
+    }
+    
+    if(!isOk)
+    {
+        unlink(temporaryFile.c_str());
+        return false;
+    }
+    
+    m_Header = header;
+    
+    return true;
+}
+
+bool TreeSnapshot::Load(const FileSystem::Path& file, DirectoryTree& out_tree)
+{
+    std::shared_ptr<Mapping> mapping = std::make_shared<Mapping>();
+    
+    const int fd = open(file.c_str(), O_RDONLY | O_CLOEXEC);
+    if(fd < 0)
+    {
+        m_LastErrorMessage = "Can't open " + file.string() + ": " + std::strerror(errno);
+        return false;
+    }
+    
+    struct stat status;
+    if(fstat(fd, &status) != 0 || static_cast<uintmax_t>(status.st_size) < sizeof(Header))
+    {
+        close(fd);
+        m_LastErrorMessage = file.string() + " is not a snapshot";
+        return false;
+    }
+    
+    // The file stays mapped after closing it, even if it is replaced
+    mapping->size = static_cast<std::size_t>(status.st_size);
+    void* const data = mmap(nullptr, mapping->size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    
+    if(data == MAP_FAILED)
+    {
+        m_LastErrorMessage = "Can't map " + file.string() + ": " + std::strerror(errno);
+        return false;
+    }
+    
+    mapping->data = data;
+    
+    Header header;
+    std::memcpy(&header, data, sizeof(Header));
+    
+    if(!IsValid(header, mapping->size))
+    {
+        m_LastErrorMessage = file.string() + " is not a snapshot of this version and architecture";
+        return false;
+    }
+    
+    const char* const base = static_cast<const char*>(data);
+    const std::span<const DirectoryTree::Node> nodes(reinterpret_cast<const DirectoryTree::Node*>(base + header.nodesOffset), static_cast<std::size_t>(header.nodeCount));
+    const uint64_t* const nameOffsets = reinterpret_cast<const uint64_t*>(base + header.nameOffsetsOffset);
+    
+    // Every name and node index must stay inside of the file
+    bool isValid = (nameOffsets[0] == 0) && (nameOffsets[header.nameCount] == header.fileSize - header.namesOffset);
+    
+    for(std::size_t i = 0; i < header.nameCount && isValid; i++)
+        isValid = (nameOffsets[i] <= nameOffsets[i + 1]);
+    
+    // Parents come before their children, so walking up or down always ends
+    for(std::size_t i = 0; i < nodes.size() && isValid; i++)
+    {
+        const DirectoryTree::Node& node = nodes[i];
+        
+        isValid = (node.name < header.nameCount)
+                && (node.type <= DirectoryTree::NodeType::OTHER)
+                && (node.parent == DirectoryTree::INVALID_NODE ? i == 0 : node.parent < i)
+                && (node.childCount == 0 || (node.firstChild > i && node.firstChild < nodes.size() && node.childCount <= nodes.size() - node.firstChild))
+                && (node.heaviestChild == DirectoryTree::INVALID_NODE || (node.heaviestChild >= node.firstChild && node.heaviestChild - node.firstChild < node.childCount));
+        
+        for(std::size_t j = node.firstChild; j < node.firstChild + node.childCount && isValid; j++)
+            isValid = (nodes[j].parent == i);
+    }
+    
+    if(!isValid)
+    {
+        m_LastErrorMessage = file.string() + " is damaged";
+        return false;
+    }
+    
+    out_tree.AttachMapped(nodes, base + header.namesOffset, nameOffsets, static_cast<std::size_t>(header.nameCount), mapping);
+    m_Header = header;
+    
+    return true;
+}
+
+bool TreeSnapshot::IsReplaced(const FileSystem::Path& file) const
+{
+    Header current;
+    
+    return ReadHeader(file, current) && (current.generation != m_Header.generation || current.createdTime != m_Header.createdTime);
+}
+#else
+TreeSnapshot::Mapping::~Mapping()
+{
+}
+
+bool TreeSnapshot::ReadHeader(const FileSystem::Path&, Header&) const
+{
+    return false;
+}
+
+bool TreeSnapshot::Publish(const DirectoryTree&, const FileSystem::Path&)
+{
+    m_LastErrorMessage = "Snapshots are only available on Linux and macOS";
+    return false;
+}
+
+bool TreeSnapshot::Load(const FileSystem::Path&, DirectoryTree&)
+{
+    m_LastErrorMessage = "Snapshots are only available on Linux and macOS";
+    return false;
+}
+
+bool TreeSnapshot::IsReplaced(const FileSystem::Path&) const
+{
+    return false;
+}
+#endif
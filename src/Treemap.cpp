@@ -0,0 +1,259 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  Treemap.cpp                                                     */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#include "Main.hpp"
+
+namespace
+{
+struct FloatRect
+{
+    double x = 0.0;
+    double y = 0.0;
+    double width = 0.0;
+    double height = 0.0;
+};
+
+// Worst aspect ratio of a row of areas laid out along a side of the given length
+double WorstAspectRatio(const double sum, const double minArea, const double maxArea, const double side) noexcept
+{
+    const double sideSquared = side * side;
+    const double sumSquared = sum * sum;
+    
+    return std::max((sideSquared * maxArea) / sumSquared, sumSquared / (sideSquared * minArea));
+}
+}
+
+void Treemap::Squarify(const DirectoryTree& tree, const DirectoryTree::NodeIndex node, const int32_t width, const int32_t height, std::vector<Rect>& out_rects)
+{
+    out_rects.clear();
+    
+    // Children with a size, largest first
+    std::vector<DirectoryTree::NodeIndex> children;
+    tree.GetChildren(node, children);
+    std::erase_if(children, [&tree](const DirectoryTree::NodeIndex i) { return tree.GetNode(i).size == 0; });
+    
+    std::sort(children.begin(), children.end(), [&tree](const DirectoryTree::NodeIndex a, const DirectoryTree::NodeIndex b)
+    {
+        return tree.GetNode(a).size > tree.GetNode(b).size;
+    });
+    
+    uintmax_t totalSize = 0;
+    for(const DirectoryTree::NodeIndex i : children)
+        totalSize += tree.GetNode(i).size;
+    
+    if(children.empty() || width <= 0 || height <= 0)
+        return;
+    
+    // Area of every child in cells
+    const double scale = (static_cast<double>(width) * static_cast<double>(height)) / static_cast<double>(totalSize);
+    std::vector<double> areas(children.size());
+    for(std::size_t i = 0; i < children.size(); i++)
+        areas[i] = static_cast<double>(tree.GetNode(children[i]).size) * scale;
+    
+    // Place a row along the shorter side of the remaining rectangle
+    FloatRect remaining = {0.0, 0.0, static_cast<double>(width), static_cast<double>(height)};
+    
+    auto placeRow = [&](const std::size_t first, const std::size_t last, const double rowArea)
+    {
+        const bool horizontal = remaining.width >= remaining.height; // Row is a column on the left
+        const double thickness = rowArea / (horizontal ? remaining.height : remaining.width);
+        double offset = 0.0;
+        
+        for(std::size_t i = first; i < last; i++)
+        {
+            const double length = areas[i] / thickness;
+            
+            FloatRect r;
+            if(horizontal)
+                r = {remaining.x, remaining.y + offset, thickness, length};
+            else
+                r = {remaining.x + offset, remaining.y, length, thickness};
+            
+            offset += length;
+            
+            // Snap edges to cells
+            Rect cell;
+            cell.x = static_cast<int32_t>(std::lround(r.x));
+            cell.y = static_cast<int32_t>(std::lround(r.y));
+            cell.width = static_cast<int32_t>(std::lround(r.x + r.width)) - cell.x;
+            cell.height = static_cast<int32_t>(std::lround(r.y + r.height)) - cell.y;
+            cell.node = children[i];
+            cell.depth = 1;
+            
+            if(cell.width > 0 && cell.height > 0)
+                out_rects.push_back(cell);
+        }
+        
+        if(horizontal)
+        {
+            remaining.x += thickness;
+            remaining.width -= thickness;
+        }
+        else
+        {
+            remaining.y += thickness;
+            remaining.height -= thickness;
+        }
+    };
+    
+    std::size_t rowStart = 0;
+    double rowArea = 0.0;
+    double rowMin = 0.0;
+    double rowMax = 0.0;
+    
+    for(std::size_t i = 0; i < areas.size(); i++)
+    {
+        const double side = std::min(remaining.width, remaining.height);
+        const double area = areas[i];
+        
+        if(i == rowStart)
+        {
+            rowArea = area;
+            rowMin = area;
+            rowMax = area;
+            continue;
+        }
+        
+        // Keep adding to the row as long as the aspect ratio doesn't get worse
+        const double current = WorstAspectRatio(rowArea, rowMin, rowMax, side);
+        const double extended = WorstAspectRatio(rowArea + area, std::min(rowMin, area), std::max(rowMax, area), side);
+        
+        if(extended <= current)
+        {
+            rowArea += area;
+            rowMin = std::min(rowMin, area);
+            rowMax = std::max(rowMax, area);
+        }
+        else
+        {
+            placeRow(rowStart, i, rowArea);
+            
+            rowStart = i;
+            rowArea = area;
+            rowMin = area;
+            rowMax = area;
+        }
+    }
+    
+    placeRow(rowStart, areas.size(), rowArea);
+}
+
+const std::vector<Treemap::Rect>& Treemap::GetChildLayout(const DirectoryTree& tree, const DirectoryTree::NodeIndex node, const int32_t width, const int32_t height)
+{
+    const DirectoryTree::Node& treeNode = tree.GetNode(node);
+    
+    auto it = m_Cache.find(node);
+    if(it != m_Cache.end())
+    {
+        const CacheEntry& entry = it->second;
+        
+        // Still valid?
+        if(entry.width == width && entry.height == height && entry.size == treeNode.size && entry.childCount == treeNode.childCount)
+            return entry.rects;
+    }
+    else
+    {
+        it = m_Cache.emplace(node, CacheEntry()).first;
+    }
+    
+    CacheEntry& entry = it->second;
+    entry.width = width;
+    entry.height = height;
+    entry.size = treeNode.size;
+    entry.childCount = treeNode.childCount;
+    
+    Squarify(tree, node, width, height, entry.rects);
+    
+    return entry.rects;
+}
+
+void Treemap::LayoutRecursive(const DirectoryTree& tree, const Rect& rect, std::vector<Rect>& out_rects)
+{
+    if(rect.depth >= m_MaxDepth)
+        return;
+    
+    // Keep the first row free for the name of the parent
+    const int32_t top = (rect.depth > 0 && rect.height >= 3) ? 1 : 0;
+    
+    if(rect.depth > 0 && (rect.width < 3 || rect.height < 3))
+        return;
+    
+    const std::vector<Rect>& children = GetChildLayout(tree, rect.node, rect.width, rect.height - top);
+    
+    for(const Rect& i : children)
+    {
+        Rect child = i;
+        child.x += rect.x;
+        child.y += rect.y + top;
+        child.depth = rect.depth + 1;
+        
+        out_rects.push_back(child);
+        
+        if(tree.GetNode(child.node).type == DirectoryTree::NodeType::DIRECTORY)
+            LayoutRecursive(tree, child, out_rects);
+    }
+}
+
+void Treemap::Layout(const DirectoryTree& tree, const DirectoryTree::NodeIndex node, const int32_t width, const int32_t height, std::vector<Rect>& out_rects)
+{
+    out_rects.clear();
+    
+    if(node == DirectoryTree::INVALID_NODE || width <= 0 || height <= 0)
+        return;
+    
+    // Simple bound on memory. Only done here, LayoutRecursive() holds references into the cache.
+    if(m_Cache.size() >= MAX_CACHE_ENTRIES)
+        m_Cache.clear();
+    
+    Rect root;
+    root.width = width;
+    root.height = height;
+    root.node = node;
+    root.depth = 0;
+    
+    LayoutRecursive(tree, root, out_rects);
+}
+
+void Treemap::AccountMemory(MemoryAccounting& accounting) const
+{
+    uint64_t rectCount = 0;
+    uint64_t bytes = MemoryAccounting::GetHashTableBytes(m_Cache);
+    
+    for(const auto& [node, entry] : m_Cache)
+    {
+        rectCount += entry.rects.size();
+        bytes += MemoryAccounting::GetVectorBytes(entry.rects);
+    }
+    
+    accounting.Add("Treemap cache", bytes, rectCount);
+}
@@ -0,0 +1,453 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  TrigramIndex.cpp                                                */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#include "DirStatsCore.hpp"
+
+namespace
+{
+char ToLowerASCII(const char c) noexcept
+{
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+// Match one pattern element (literal, '?', escaped char or [class]) at position p.
+// On success out_next is the position of the next pattern element.
+bool MatchGlobElement(const std::string_view pattern, const std::size_t p, const char c, std::size_t& out_next) noexcept
+{
+    const char lower = ToLowerASCII(c);
+    
+    switch(pattern[p])
+    {
+        case '?':
+            out_next = p + 1;
+            return true;
+            
+        case '\\':
+            if(p + 1 < pattern.size())
+            {
+                out_next = p + 2;
+                return ToLowerASCII(pattern[p + 1]) == lower;
+            }
+            break;
+            
+        case '[':
+        {
+            std::size_t i = p + 1;
+            const bool negate = i < pattern.size() && (pattern[i] == '!' || pattern[i] == '^');
+            if(negate)
+                i++;
+            
+            bool matched = false;
+            bool first = true;
+            
+            // A ']' directly after the opening bracket is a literal
+            while(i < pattern.size() && (pattern[i] != ']' || first))
+            {
+                first = false;
+                
+                const char from = ToLowerASCII(pattern[i]);
+                if(i + 2 < pattern.size() && pattern[i + 1] == '-' && pattern[i + 2] != ']')
+                {
+                    const char to = ToLowerASCII(pattern[i + 2]);
+                    matched |= (lower >= from && lower <= to);
+                    i += 3;
+                }
+                else
+                {
+                    matched |= (lower == from);
+                    i++;
+                }
+            }
+            
+            // Unclosed bracket, treat '[' as a literal
+            if(i >= pattern.size())
+                break;
+            
+            out_next = i + 1;
+            return matched != negate;
+        }
+            
+        default:
+            break;
+    }
+    
+    out_next = p + 1;
+    return ToLowerASCII(pattern[p]) == lower;
+}
+}
+
+void TrigramIndex::CollectTrigrams(const std::string_view text, std::vector<Trigram>& out_trigrams)
+{
+    if(text.size() < 3)
+        return;
+    
+    for(std::size_t i = 0; i + 2 < text.size(); i++)
+    {
+        const Trigram trigram = (static_cast<Trigram>(static_cast<uint8_t>(ToLowerASCII(text[i]))) << 16)
+                              | (static_cast<Trigram>(static_cast<uint8_t>(ToLowerASCII(text[i + 1]))) << 8)
+                              | static_cast<Trigram>(static_cast<uint8_t>(ToLowerASCII(text[i + 2])));
+        
+        out_trigrams.push_back(trigram);
+    }
+}
+
+void TrigramIndex::CollectPatternTrigrams(const std::string_view pattern, const bool isGlob, std::vector<Trigram>& out_trigrams)
+{
+    if(!isGlob)
+    {
+        CollectTrigrams(pattern, out_trigrams);
+    }
+    else
+    {
+        // Only literal runs between wildcards are required in a matching name
+        std::string literal;
+        
+        for(std::size_t i = 0; i < pattern.size(); i++)
+        {
+            const char c = pattern[i];
+            
+            if(c == '\\' && i + 1 < pattern.size())
+            {
+                literal += pattern[++i];
+                continue;
+            }
+            
+            if(c != '*' && c != '?' && c != '[')
+            {
+                literal += c;
+                continue;
+            }
+            
+            CollectTrigrams(literal, out_trigrams);
+            literal.clear();
+            
+            // Skip over character class
+            if(c == '[')
+            {
+                std::size_t start = i + 1;
+                if(start < pattern.size() && (pattern[start] == '!' || pattern[start] == '^'))
+                    start++;
+                
+                const std::size_t end = pattern.find(']', start + 1);
+                if(end == std::string_view::npos)
+                    break;
+                
+                i = end;
+            }
+        }
+        
+        CollectTrigrams(literal, out_trigrams);
+    }
+    
+    std::sort(out_trigrams.begin(), out_trigrams.end());
+    out_trigrams.erase(std::unique(out_trigrams.begin(), out_trigrams.end()), out_trigrams.end());
+}
+
+void TrigramIndex::Build(const DirectoryTree& tree)
+{
+    Clear();
+    
+    const NamePool& names = tree.GetNamePool();
+    const std::size_t nameCount = names.GetCount();
+    
+    std::vector<Trigram> nameTrigrams;
+    auto collectUnique = [&](const NamePool::NameID id)
+    {
+        nameTrigrams.clear();
+        CollectTrigrams(names.Get(id), nameTrigrams);
+        
+        std::sort(nameTrigrams.begin(), nameTrigrams.end());
+        nameTrigrams.erase(std::unique(nameTrigrams.begin(), nameTrigrams.end()), nameTrigrams.end());
+    };
+    
+    // Pass 1: Count names per trigram
+    std::unordered_map<Trigram, uint32_t> trigramCounts;
+    for(NamePool::NameID id = 0; id < nameCount; id++)
+    {
+        collectUnique(id);
+        
+        for(const Trigram i : nameTrigrams)
+            trigramCounts[i]++;
+    }
+    
+    m_Trigrams.reserve(trigramCounts.size());
+    for(const auto& [trigram, count] : trigramCounts)
+        m_Trigrams.push_back(trigram);
+    
+    std::sort(m_Trigrams.begin(), m_Trigrams.end());
+    
+    m_PostingOffsets.resize(m_Trigrams.size() + 1, 0);
+    for(std::size_t i = 0; i < m_Trigrams.size(); i++)
+    {
+        m_PostingOffsets[i + 1] = m_PostingOffsets[i] + trigramCounts[m_Trigrams[i]];
+        
+        // From now on the count is used as the write position
+        trigramCounts[m_Trigrams[i]] = m_PostingOffsets[i];
+    }
+    
+    // Pass 2: Fill posting lists. They end up sorted by name ID.
+    m_Postings.resize(m_PostingOffsets.back());
+    for(NamePool::NameID id = 0; id < nameCount; id++)
+    {
+        collectUnique(id);
+        
+        for(const Trigram i : nameTrigrams)
+            m_Postings[trigramCounts[i]++] = id;
+    }
+    
+    // Name -> nodes. The root is named after the full scanned path, skip it.
+    const std::size_t nodeCount = tree.GetNodeCount();
+    const DirectoryTree::NodeIndex root = tree.GetRoot();
+    
+    m_NodeOffsets.resize(nameCount + 1, 0);
+    for(DirectoryTree::NodeIndex i = 0; i < nodeCount; i++)
+    {
+        if(i != root)
+            m_NodeOffsets[tree.GetNode(i).name + 1]++;
+    }
+    
+    for(std::size_t i = 0; i < nameCount; i++)
+        m_NodeOffsets[i + 1] += m_NodeOffsets[i];
+    
+    std::vector<uint32_t> writePositions(m_NodeOffsets.begin(), m_NodeOffsets.end() - 1);
+    m_NodesByName.resize(m_NodeOffsets.back());
+    
+    for(DirectoryTree::NodeIndex i = 0; i < nodeCount; i++)
+    {
+        if(i != root)
+            m_NodesByName[writePositions[tree.GetNode(i).name]++] = i;
+    }
+    
+    m_IndexedNameCount = nameCount;
+    m_IndexedNodeCount = nodeCount;
+    m_IsBuilt = true;
+}
+
+void TrigramIndex::Clear() noexcept
+{
+    m_Trigrams = {};
+    m_PostingOffsets = {};
+    m_Postings = {};
+    m_NodeOffsets = {};
+    m_NodesByName = {};
+    
+    m_IndexedNameCount = 0;
+    m_IndexedNodeCount = 0;
+    m_IsBuilt = false;
+}
+
+std::span<const NamePool::NameID> TrigramIndex::GetPostings(const Trigram trigram) const noexcept
+{
+    const auto it = std::lower_bound(m_Trigrams.begin(), m_Trigrams.end(), trigram);
+    if(it == m_Trigrams.end() || *it != trigram)
+        return {};
+    
+    const std::size_t i = static_cast<std::size_t>(it - m_Trigrams.begin());
+    
+    return std::span<const NamePool::NameID>(m_Postings.data() + m_PostingOffsets[i], m_PostingOffsets[i + 1] - m_PostingOffsets[i]);
+}
+
+void TrigramIndex::Search(const DirectoryTree& tree, const std::string_view pattern, SearchResult& out_result) const
+{
+    out_result = SearchResult();
+    
+    if(pattern.empty())
+        return;
+    
+    const NamePool& names = tree.GetNamePool();
+    const bool isGlob = IsGlobPattern(pattern);
+    
+    auto isMatch = [&](const NamePool::NameID id)
+    {
+        return isGlob ? MatchGlob(pattern, names.Get(id)) : ContainsSubstring(names.Get(id), pattern);
+    };
+    
+    std::vector<Trigram> requiredTrigrams;
+    CollectPatternTrigrams(pattern, isGlob, requiredTrigrams);
+    
+    // Find all matching names. The list stays sorted, indexed names are followed by newer ones.
+    std::vector<NamePool::NameID> nameMatches;
+    NamePool::NameID firstUnindexedName = 0;
+    
+    if(m_IsBuilt && !requiredTrigrams.empty())
+    {
+        // Intersect the posting lists, shortest first
+        std::vector<std::span<const NamePool::NameID>> postingLists;
+        for(const Trigram i : requiredTrigrams)
+            postingLists.push_back(GetPostings(i));
+        
+        std::sort(postingLists.begin(), postingLists.end(), [](const auto& a, const auto& b) { return a.size() < b.size(); });
+        
+        std::vector<NamePool::NameID> candidates(postingLists.front().begin(), postingLists.front().end());
+        std::vector<NamePool::NameID> intersection;
+        
+        for(std::size_t i = 1; i < postingLists.size() && !candidates.empty(); i++)
+        {
+            intersection.clear();
+            std::set_intersection(candidates.begin(), candidates.end(), postingLists[i].begin(), postingLists[i].end(), std::back_inserter(intersection));
+            candidates.swap(intersection);
+        }
+        
+        // Trigrams are only a filter, verify the candidates
+        for(const NamePool::NameID i : candidates)
+        {
+            if(isMatch(i))
+                nameMatches.push_back(i);
+        }
+        
+        firstUnindexedName = static_cast<NamePool::NameID>(m_IndexedNameCount);
+    }
+    
+    // Patterns shorter than a trigram have to check every name
+    for(NamePool::NameID i = firstUnindexedName; i < names.GetCount(); i++)
+    {
+        if(isMatch(i))
+            nameMatches.push_back(i);
+    }
+    
+    // Map the matching names to their nodes
+    const DirectoryTree::NodeIndex root = tree.GetRoot();
+    DirectoryTree::NodeIndex firstUnindexedNode = 0;
+    
+    if(m_IsBuilt)
+    {
+        for(const NamePool::NameID name : nameMatches)
+        {
+            if(name >= m_IndexedNameCount)
+                break;
+            
+            for(uint32_t i = m_NodeOffsets[name]; i < m_NodeOffsets[name + 1]; i++)
+                out_result.nodes.push_back(m_NodesByName[i]);
+        }
+        
+        firstUnindexedNode = static_cast<DirectoryTree::NodeIndex>(m_IndexedNodeCount);
+    }
+    
+    if(!nameMatches.empty())
+    {
+        for(DirectoryTree::NodeIndex i = firstUnindexedNode; i < tree.GetNodeCount(); i++)
+        {
+            if(i != root && std::binary_search(nameMatches.begin(), nameMatches.end(), tree.GetNode(i).name))
+                out_result.nodes.push_back(i);
+        }
+    }
+    
+    // Deleted entries stay in the tree, but are not part of any result
+    std::erase_if(out_result.nodes, [&tree](const DirectoryTree::NodeIndex i) { return tree.GetNode(i).isRemoved; });
+    
+    std::sort(out_result.nodes.begin(), out_result.nodes.end(), [&tree](const DirectoryTree::NodeIndex a, const DirectoryTree::NodeIndex b)
+    {
+        return tree.GetNode(a).size > tree.GetNode(b).size;
+    });
+    
+    // Sum up, without counting matches inside of other matches twice
+    const std::unordered_set<DirectoryTree::NodeIndex> isResult(out_result.nodes.begin(), out_result.nodes.end());
+    
+    for(const DirectoryTree::NodeIndex i : out_result.nodes)
+    {
+        bool isNested = false;
+        for(DirectoryTree::NodeIndex parent = tree.GetNode(i).parent; parent != DirectoryTree::INVALID_NODE && !isNested; parent = tree.GetNode(parent).parent)
+            isNested = isResult.contains(parent);
+        
+        if(isNested)
+            continue;
+        
+        out_result.totalSize += tree.GetNode(i).size;
+        out_result.totalCount += tree.GetNode(i).count + 1;
+    }
+}
+
+bool TrigramIndex::IsGlobPattern(const std::string_view pattern) noexcept
+{
+    return pattern.find_first_of("*?[") != std::string_view::npos;
+}
+
+bool TrigramIndex::MatchGlob(const std::string_view pattern, const std::string_view name) noexcept
+{
+    std::size_t p = 0;
+    std::size_t n = 0;
+    
+    // Position of the last '*' for backtracking
+    std::size_t starPattern = std::string_view::npos;
+    std::size_t starName = 0;
+    
+    while(n < name.size())
+    {
+        if(p < pattern.size())
+        {
+            if(pattern[p] == '*')
+            {
+                starPattern = p++;
+                starName = n;
+                continue;
+            }
+            
+            std::size_t next = 0;
+            if(MatchGlobElement(pattern, p, name[n], next))
+            {
+                p = next;
+                n++;
+                continue;
+            }
+        }
+        
+        // Let the last '*' consume one more character
+        if(starPattern == std::string_view::npos)
+            return false;
+        
+        p = starPattern + 1;
+        n = ++starName;
+    }
+    
+    while(p < pattern.size() && pattern[p] == '*')
+        p++;
+    
+    return p == pattern.size();
+}
+
+bool TrigramIndex::ContainsSubstring(const std::string_view name, const std::string_view pattern) noexcept
+{
+    const auto it = std::search(name.begin(), name.end(), pattern.begin(), pattern.end(), [](const char a, const char b)
+    {
+        return ToLowerASCII(a) == ToLowerASCII(b);
+    });
+    
+    return it != name.end() || pattern.empty();
+}
+
+void TrigramIndex::AccountMemory(MemoryAccounting& accounting) const
+{
+    accounting.Add("Name index trigrams", MemoryAccounting::GetVectorBytes(m_Trigrams) + MemoryAccounting::GetVectorBytes(m_PostingOffsets), m_Trigrams.size());
+    accounting.Add("Name index postings", MemoryAccounting::GetVectorBytes(m_Postings), m_Postings.size());
+    accounting.Add("Name index nodes", MemoryAccounting::GetVectorBytes(m_NodeOffsets) + MemoryAccounting::GetVectorBytes(m_NodesByName), m_NodesByName.size());
+}
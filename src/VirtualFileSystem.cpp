@@ -0,0 +1,346 @@
+/*
+    The zlib License
+
+    Copyright (C) 2024 Marc Schöndorf
+ 
+This software is provided 'as-is', without any express or implied warranty. In
+no event will the authors be held liable for any damages arising from the use of
+this software.
+
+Permission is granted to anyone to use this software for any purpose, including
+commercial applications, and to alter it and redistribute it freely, subject to
+the following restrictions:
+
+1.  The origin of this software must not be misrepresented; you must not claim
+    that you wrote the original software. If you use this software in a product,
+    an acknowledgment in the product documentation would be appreciated but is
+    not required.
+
+2.  Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+3.  This notice may not be removed or altered from any source distribution.
+*/
+
+/*------------------------------------------------------------------*/
+/*                                                                  */
+/*                      (C) 2024 Marc Schöndorf                     */
+/*                            See license                           */
+/*                                                                  */
+/*  VirtualFileSystem.cpp                                           */
+/*  Created: 19.10.2026                                             */
+/*------------------------------------------------------------------*/
+
+#include "DirStatsCore.hpp"
+
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_APPLE)
+namespace
+{
+// Low bits of the status change time in ns. It changes with every entry added, removed
+// or renamed in a directory, even within the same second.
+uint32_t GetChangeStamp(const struct stat& info) noexcept
+{
+#ifdef PLATFORM_APPLE
+    const int64_t nanoseconds = static_cast<int64_t>(info.st_ctimespec.tv_sec) * 1000000000 + info.st_ctimespec.tv_nsec;
+#else
+    const int64_t nanoseconds = static_cast<int64_t>(info.st_ctim.tv_sec) * 1000000000 + info.st_ctim.tv_nsec;
+#endif
+    
+    return static_cast<uint32_t>(nanoseconds);
+}
+}
+#endif
+
+bool VirtualFileSystem::StatDirectory(const std::string& path, DirectoryTree::Entry& out_entry) noexcept
+{
+    (void)path;
+    out_entry = DirectoryTree::Entry();
+    
+    errno = ENOTSUP;
+    return false;
+}
+
+bool VirtualFileSystem::StatEntries(const std::string& path, const std::vector<std::string>& names, std::vector<DirectoryTree::Entry>& out_entries)
+{
+    out_entries.clear();
+    
+    std::vector<std::string> listedNames;
+    std::vector<DirectoryTree::Entry> entries;
+    std::vector<FileId> ids;
+    
+    if(!ReadDirectory(path, false, listedNames, entries, ids))
+        return false;
+    
+    std::unordered_map<std::string_view, std::size_t> indices;
+    for(std::size_t i = 0; i < listedNames.size(); i++)
+        indices.emplace(listedNames[i], i);
+    
+    for(const std::string& name : names)
+    {
+        const auto it = indices.find(name);
+        if(it == indices.end())
+        {
+            out_entries.clear();
+            errno = ENOENT;
+            return false;
+        }
+        
+        out_entries.push_back(entries[it->second]);
+    }
+    
+    return true;
+}
+
+bool RealFileSystem::ReadDirectory(const std::string& path, const bool isRoot, std::vector<std::string>& out_names, std::vector<DirectoryTree::Entry>& out_entries, std::vector<FileId>& out_ids)
+{
+    out_names.clear();
+    out_entries.clear();
+    out_ids.clear();
+    
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_APPLE)
+    ScanStatistics::Counters* const statistics = ScanStatistics::GetCurrentCounters();
+    
+    // Only the starting path may be a symbolic link to a directory
+    DIR* directory = nullptr;
+    {
+        const ScanStatistics::PhaseTimer openTimer(ScanStatistics::Phase::OPEN);
+        const Tracer::ScopedSpan openSpan(Tracer::Category::SCAN, "open");
+        
+        const int fd = open(path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC | (isRoot ? 0 : O_NOFOLLOW));
+        DST_PROBE2(directory_open, path.c_str(), (fd >= 0) ? fd : -errno);
+        
+        if(fd < 0)
+            return false;
+        
+        directory = fdopendir(fd);
+        if(!directory)
+        {
+            const int error = errno;
+            close(fd);
+            errno = error;
+            return false;
+        }
+    }
+    
+    if(statistics)
+        statistics->directoriesOpened++;
+    
+    // Listing time is the time of the loop without the stat calls
+    const std::chrono::steady_clock::time_point listStart = statistics ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+    const uint64_t statNanosecondsBefore = statistics ? statistics->phases[static_cast<std::size_t>(ScanStatistics::Phase::STAT)].nanoseconds : 0;
+    
+    Tracer::ScopedSpan listSpan(Tracer::Category::SCAN, "list and stat");
+    bool isComplete = true;
+    int error = 0;
+    
+    while(true)
+    {
+        errno = 0;
+        const dirent* const entry = readdir(directory);
+        
+        if(!entry)
+        {
+            isComplete = (errno == 0);
+            error = errno;
+            break;
+        }
+        
+        if(statistics)
+            statistics->getdentsBytes += entry->d_reclen;
+        
+        if(std::strcmp(entry->d_name, ".") == 0 || std::strcmp(entry->d_name, "..") == 0)
+            continue;
+        
+        // Relative to the open directory, saves the path lookup
+        struct stat info;
+        int statResult = 0;
+        {
+            const ScanStatistics::PhaseTimer statTimer(ScanStatistics::Phase::STAT);
+            const bool isProbingStat = DST_PROBE_ENABLED(stat_latency);
+            const std::chrono::steady_clock::time_point statStart = isProbingStat ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+            
+            statResult = fstatat(dirfd(directory), entry->d_name, &info, AT_SYMLINK_NOFOLLOW);
+            
+            if(isProbingStat)
+                DST_PROBE2(stat_latency, entry->d_name, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - statStart).count());
+        }
+        
+        if(statResult != 0)
+        {
+            // Entries vanishing while scanning are simply skipped
+            if(errno != ENOENT)
+            {
+                isComplete = false;
+                error = errno;
+            }
+            
+            continue;
+        }
+        
+        DirectoryTree::Entry treeEntry;
+        treeEntry.size = static_cast<uintmax_t>(info.st_size);
+        treeEntry.allocatedSize = static_cast<uintmax_t>(info.st_blocks) * 512;
+        treeEntry.lastWriteTime = static_cast<int64_t>(info.st_mtime);
+        treeEntry.changeStamp = GetChangeStamp(info);
+        
+        // Symbolic links are not followed, they don't use space of their target
+        if(S_ISDIR(info.st_mode))
+            treeEntry.type = DirectoryTree::NodeType::DIRECTORY;
+        else if(S_ISREG(info.st_mode))
+            treeEntry.type = DirectoryTree::NodeType::REGULAR_FILE;
+        else if(S_ISLNK(info.st_mode))
+            treeEntry.type = DirectoryTree::NodeType::SYMLINK;
+        else
+            treeEntry.type = DirectoryTree::NodeType::OTHER;
+        
+        FileId id;
+        id.device = static_cast<uint64_t>(info.st_dev);
+        id.inode = static_cast<uint64_t>(info.st_ino);
+        id.linkCount = static_cast<uint64_t>(info.st_nlink);
+        
+        out_names.emplace_back(entry->d_name);
+        out_entries.push_back(treeEntry);
+        out_ids.push_back(id);
+    }
+    
+    listSpan.SetArgument("entries", out_entries.size());
+    
+    if(statistics)
+    {
+        const uint64_t loopNanoseconds = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - listStart).count());
+        const uint64_t statNanoseconds = statistics->phases[static_cast<std::size_t>(ScanStatistics::Phase::STAT)].nanoseconds - statNanosecondsBefore;
+        
+        statistics->AddPhase(ScanStatistics::Phase::LIST, loopNanoseconds - std::min(statNanoseconds, loopNanoseconds));
+    }
+    
+    closedir(directory);
+    DST_PROBE3(directory_close, path.c_str(), out_entries.size(), isComplete ? 1 : 0);
+    
+    // Error of the listing, not of closedir()
+    if(!isComplete)
+        errno = error;
+    
+    return isComplete;
+#else
+    (void)isRoot;
+    
+    FileSystem fileSystem;
+    std::vector<FileSystem::DirectoryEntry> directoryEntries;
+    const bool isComplete = fileSystem.IterateDirectory(path, directoryEntries);
+    
+    for(const FileSystem::DirectoryEntry& entry : directoryEntries)
+    {
+        DirectoryTree::Entry treeEntry;
+        treeEntry.lastWriteTime = FileSystem::ToUnixTime(entry.lastWriteTime);
+        
+        // Symbolic links are not followed, they don't use space of their target
+        if(entry.isSymbolicLink)
+            treeEntry.type = DirectoryTree::NodeType::SYMLINK;
+        else if(entry.isDirectory)
+            treeEntry.type = DirectoryTree::NodeType::DIRECTORY;
+        else if(entry.isRegularFile)
+        {
+            treeEntry.type = DirectoryTree::NodeType::REGULAR_FILE;
+            treeEntry.size = entry.fileSize;
+        }
+        else
+            treeEntry.type = DirectoryTree::NodeType::OTHER;
+        
+        treeEntry.allocatedSize = treeEntry.size;
+        
+        out_names.push_back(entry.path.filename().string());
+        out_entries.push_back(treeEntry);
+        out_ids.emplace_back();
+    }
+    
+    if(!isComplete)
+        errno = fileSystem.GetLastError().GetCode();
+    
+    return isComplete;
+#endif
+}
+
+void RealFileSystem::GetDirectorySize(const std::string& path, uintmax_t& out_size, uintmax_t& out_allocatedSize) noexcept
+{
+    out_size = 0;
+    out_allocatedSize = 0;
+    
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_APPLE)
+    struct stat info;
+    if(stat(path.c_str(), &info) == 0)
+    {
+        out_size = static_cast<uintmax_t>(info.st_size);
+        out_allocatedSize = static_cast<uintmax_t>(info.st_blocks) * 512;
+    }
+#else
+    (void)path;
+#endif
+}
+
+bool RealFileSystem::StatDirectory(const std::string& path, DirectoryTree::Entry& out_entry) noexcept
+{
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_APPLE)
+    out_entry = DirectoryTree::Entry();
+    out_entry.type = DirectoryTree::NodeType::DIRECTORY;
+    
+    struct stat info;
+    if(stat(path.c_str(), &info) != 0)
+        return false;
+    
+    if(!S_ISDIR(info.st_mode))
+    {
+        errno = ENOTDIR;
+        return false;
+    }
+    
+    out_entry.size = static_cast<uintmax_t>(info.st_size);
+    out_entry.allocatedSize = static_cast<uintmax_t>(info.st_blocks) * 512;
+    out_entry.lastWriteTime = static_cast<int64_t>(info.st_mtime);
+    out_entry.changeStamp = GetChangeStamp(info);
+    
+    return true;
+#else
+    return VirtualFileSystem::StatDirectory(path, out_entry);
+#endif
+}
+
+bool RealFileSystem::StatEntries(const std::string& path, const std::vector<std::string>& names, std::vector<DirectoryTree::Entry>& out_entries)
+{
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_APPLE)
+    out_entries.clear();
+    
+    const int fd = open(path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if(fd < 0)
+        return false;
+    
+    // Relative to the open directory, like a listing
+    for(const std::string& name : names)
+    {
+        struct stat info;
+        if(fstatat(fd, name.c_str(), &info, AT_SYMLINK_NOFOLLOW) != 0)
+        {
+            const int error = errno;
+            close(fd);
+            errno = error;
+            return false;
+        }
+        
+        DirectoryTree::Entry entry;
+        entry.size = static_cast<uintmax_t>(info.st_size);
+        entry.allocatedSize = static_cast<uintmax_t>(info.st_blocks) * 512;
+        entry.lastWriteTime = static_cast<int64_t>(info.st_mtime);
+        out_entries.push_back(entry);
+    }
+    
+    close(fd);
+    return true;
+#else
+    return VirtualFileSystem::StatEntries(path, names, out_entries);
+#endif
+}
+
+std::shared_ptr<VirtualFileSystem> RealFileSystem::GetInstance()
+{
+    static const std::shared_ptr<VirtualFileSystem> instance = std::make_shared<RealFileSystem>();
+    return instance;
+}